@@ -15,6 +15,8 @@ enum {
 	DARRAY_CAPACITY,
 	DARRAY_LENGTH,
 	DARRAY_STRIDE,
+	// Pads the header to 32 bytes, so elements are 16 byte aligned, as SIMD types such as mat4 need.
+	DARRAY_RESERVED,
 	DARRAY_FIELD_LENGTH
 };
 
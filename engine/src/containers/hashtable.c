@@ -1,23 +1,20 @@
 #include "hashtable.h"
 
 #include "core/kmemory.h"
+#include "core/kstring.h"
 #include "core/logger.h"
 
 u64 hash_name(const char* name, u32 element_count) {
-    // A multipler to use when generating a hash. Prime to hopefully avoid collisions.
-    static const u64 multiplier = 97;
-
-    unsigned const char* us;
-    u64 hash = 0;
-
-    for (us = (unsigned const char*)name; *us; us++) {
-        hash = hash * multiplier + *us;
-    }
-
     // Mod it against the size of the table.
-    hash %= element_count;
+    return string_hash(name) % element_count;
+}
 
-    return hash;
+u64 hash_namei(const char* name, u32 element_count) {
+    return string_hashi(name) % element_count;
+}
+
+static u64 table_index(const hashtable* table, const char* name) {
+    return table->ignore_case ? hash_namei(name, table->element_count) : hash_name(name, table->element_count);
 }
 
 void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable) {
@@ -35,9 +32,17 @@ void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_p
     out_hashtable->element_count = element_count;
     out_hashtable->element_size = element_size;
     out_hashtable->is_pointer_type = is_pointer_type;
+    out_hashtable->ignore_case = false;
     kzero_memory(out_hashtable->memory, element_size * element_count);
 }
 
+void hashtable_create_ignore_case(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable) {
+    hashtable_create(element_size, element_count, memory, is_pointer_type, out_hashtable);
+    if (out_hashtable) {
+        out_hashtable->ignore_case = true;
+    }
+}
+
 void hashtable_destroy(hashtable* table) {
     if (table) {
         // TODO: If using allocator above, free memory here.
@@ -55,7 +60,7 @@ b8 hashtable_set(hashtable* table, const char* name, void* value) {
         return false;
     }
 
-    u64 hash = hash_name(name, table->element_count);
+    u64 hash = table_index(table, name);
     kcopy_memory(table->memory + (table->element_size * hash), value, table->element_size);
     return true;
 }
@@ -70,7 +75,7 @@ b8 hashtable_set_ptr(hashtable* table, const char* name, void** value) {
         return false;
     }
 
-    u64 hash = hash_name(name, table->element_count);
+    u64 hash = table_index(table, name);
     ((void**)table->memory)[hash] = value ? *value : 0;
     return true;
 }
@@ -84,7 +89,7 @@ b8 hashtable_get(hashtable* table, const char* name, void* out_value) {
         KERROR("hashtable_get should not be used with tables that have pointer types. Use hashtable_set_ptr instead.");
         return false;
     }
-    u64 hash = hash_name(name, table->element_count);
+    u64 hash = table_index(table, name);
     kcopy_memory(out_value, table->memory + (table->element_size * hash), table->element_size);
     return true;
 }
@@ -99,7 +104,7 @@ b8 hashtable_get_ptr(hashtable* table, const char* name, void** out_value) {
         return false;
     }
 
-    u64 hash = hash_name(name, table->element_count);
+    u64 hash = table_index(table, name);
     *out_value = ((void**)table->memory)[hash];
     return *out_value != 0;
 }
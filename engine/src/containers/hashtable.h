@@ -10,11 +10,15 @@
  * pointer types, make sure to use the _ptr setter and getter. Table
  * does not take ownership of pointers or associated memory allocations,
  * and should be managed externally.
+ *
+ * Names are case-sensitive, unless the table was created with
+ * hashtable_create_ignore_case.
  */
 typedef struct hashtable {
     u64 element_size;
     u32 element_count;
     b8 is_pointer_type;
+    b8 ignore_case;
     void* memory;
 } hashtable;
 
@@ -29,6 +33,12 @@ typedef struct hashtable {
  */
 KAPI void hashtable_create(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable);
 
+/**
+ * @brief As hashtable_create, but names are hashed ignoring case, as resource names
+ * are compared, so "Paving" and "paving" refer to the same entry.
+ */
+KAPI void hashtable_create_ignore_case(u64 element_size, u32 element_count, void* memory, b8 is_pointer_type, hashtable* out_hashtable);
+
 /**
  * @brief Destroys the provided hashtable. Does not release memory for pointer types.
  * 
@@ -8,12 +8,22 @@
 #include "core/event.h"
 #include "core/input.h"
 #include "core/clock.h"
+#include "core/profiler.h"
+#include "core/frame_stats.h"
+#include "core/frame_pacer.h"
+#include "core/perf_counters.h"
+#include "core/telemetry.h"
 
 #include "memory/linear_allocator.h"
 
 #include "renderer/renderer_frontend.h"
 
 // systems
+#include "systems/job_system.h"
+#include "systems/async_io_system.h"
+#include "systems/vfs_system.h"
+#include "systems/cooked_cache_system.h"
+#include "systems/task_graph.h"
 #include "systems/texture_system.h"
 #include "systems/material_system.h"
 
@@ -28,6 +38,13 @@ typedef struct application_state {
 
 	linear_allocator systems_allocator;
 
+	// Rebuilt each frame from the engine's and game's tasks.
+	task_graph frame_graph;
+	f64 frame_delta;
+	render_packet frame_packet;
+	// Set to write the next frame's graph out.
+	b8 dump_frame_graph;
+
 	u64 event_system_memory_requirement;
     void* event_system_state;
 
@@ -37,12 +54,39 @@ typedef struct application_state {
     u64 logging_system_memory_requirement;
     void* logging_system_state;
 
+    u64 profiler_memory_requirement;
+    void* profiler_state;
+
+    u64 perf_counters_memory_requirement;
+    void* perf_counters_state;
+
+    u64 frame_stats_memory_requirement;
+    void* frame_stats_state;
+
+    u64 frame_pacer_memory_requirement;
+    void* frame_pacer_state;
+
+    u64 telemetry_memory_requirement;
+    void* telemetry_state;
+
 	u64 input_system_memory_requirement;
     void* input_system_state;
 
 	u64 platform_system_memory_requirement;
     void* platform_system_state;
 
+    u64 job_system_memory_requirement;
+    void* job_system_state;
+
+    u64 async_io_system_memory_requirement;
+    void* async_io_system_state;
+
+    u64 vfs_system_memory_requirement;
+    void* vfs_system_state;
+
+    u64 cooked_cache_system_memory_requirement;
+    void* cooked_cache_system_state;
+
 	u64 renderer_system_memory_requirement;
     void* renderer_system_state;
 
@@ -76,6 +120,11 @@ b8 application_create(game* game_inst)
     u64 systems_allocator_total_size = 64 * 1024 * 1024;  // 64 mb
     linear_allocator_create(systems_allocator_total_size, 0, &app_state->systems_allocator);
 
+    // Performance counters, first so other systems can register theirs as they start.
+    perf_counters_initialize(&app_state->perf_counters_memory_requirement, 0);
+    app_state->perf_counters_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->perf_counters_memory_requirement);
+    perf_counters_initialize(&app_state->perf_counters_memory_requirement, app_state->perf_counters_state);
+
     // Events
     event_system_initialize(&app_state->event_system_memory_requirement, 0);
     app_state->event_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->event_system_memory_requirement);
@@ -93,6 +142,32 @@ b8 application_create(game* game_inst)
         KERROR("Failed to initialize logging system; shutting down.");
         return false;
     }
+
+#if KPROFILER_ENABLED == 1
+    // Profiler
+    profiler_initialize(&app_state->profiler_memory_requirement, 0);
+    app_state->profiler_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->profiler_memory_requirement);
+    profiler_initialize(&app_state->profiler_memory_requirement, app_state->profiler_state);
+#endif
+
+    // Frame statistics
+    frame_stats_initialize(&app_state->frame_stats_memory_requirement, 0);
+    app_state->frame_stats_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->frame_stats_memory_requirement);
+    frame_stats_initialize(&app_state->frame_stats_memory_requirement, app_state->frame_stats_state);
+
+    // Frame pacing
+    frame_pacer_config pacer_config;
+    pacer_config.mode = game_inst->app_config.frame_pacing;
+    pacer_config.target_fps = game_inst->app_config.target_fps;
+    frame_pacer_initialize(&app_state->frame_pacer_memory_requirement, 0, pacer_config);
+    app_state->frame_pacer_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->frame_pacer_memory_requirement);
+    frame_pacer_initialize(&app_state->frame_pacer_memory_requirement, app_state->frame_pacer_state, pacer_config);
+
+    // Telemetry
+    const char* telemetry_name = game_inst->app_config.publish_telemetry ? game_inst->app_config.name : 0;
+    telemetry_initialize(&app_state->telemetry_memory_requirement, 0, telemetry_name);
+    app_state->telemetry_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->telemetry_memory_requirement);
+    telemetry_initialize(&app_state->telemetry_memory_requirement, app_state->telemetry_state, telemetry_name);
 	
     // Input
     input_system_initialize(&app_state->input_system_memory_requirement, 0);
@@ -123,6 +198,57 @@ b8 application_create(game* game_inst)
 
 	}
 
+    // Job system
+    job_system_config job_sys_config;
+    job_sys_config.worker_count = 0;
+    job_system_initialize(&app_state->job_system_memory_requirement, 0, job_sys_config);
+    app_state->job_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->job_system_memory_requirement);
+    if (!job_system_initialize(&app_state->job_system_memory_requirement, app_state->job_system_state, job_sys_config)) {
+        KFATAL("Failed to initialize job system; shutting down.");
+        return false;
+    }
+
+    // Async IO system
+    async_io_system_config async_io_config;
+    async_io_config.disable_kernel_queue = false;
+    async_io_system_initialize(&app_state->async_io_system_memory_requirement, 0, async_io_config);
+    app_state->async_io_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->async_io_system_memory_requirement);
+    if (!async_io_system_initialize(&app_state->async_io_system_memory_requirement, app_state->async_io_system_state, async_io_config)) {
+        KFATAL("Failed to initialize async IO system; shutting down.");
+        return false;
+    }
+
+    // Virtual filesystem
+    vfs_system_config vfs_config;
+    vfs_config.asset_directory = "assets";
+    vfs_config.pack_path = "assets.kpak";
+#ifdef _DEBUG
+    // Edited assets show up without rebuilding the pack.
+    vfs_config.prefer_loose_files = true;
+    // Reloads textures and materials when they are saved.
+    vfs_config.watch_for_changes = true;
+#else
+    vfs_config.prefer_loose_files = false;
+    vfs_config.watch_for_changes = false;
+#endif
+    vfs_system_initialize(&app_state->vfs_system_memory_requirement, 0, vfs_config);
+    app_state->vfs_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->vfs_system_memory_requirement);
+    if (!vfs_system_initialize(&app_state->vfs_system_memory_requirement, app_state->vfs_system_state, vfs_config)) {
+        KFATAL("Failed to initialize virtual filesystem; shutting down.");
+        return false;
+    }
+
+    // Cooked asset cache
+    cooked_cache_config cache_config;
+    cache_config.cache_directory = "cache";
+    cache_config.max_size = 512 * 1024 * 1024;  // 512 mb
+    cooked_cache_system_initialize(&app_state->cooked_cache_system_memory_requirement, 0, cache_config);
+    app_state->cooked_cache_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->cooked_cache_system_memory_requirement);
+    if (!cooked_cache_system_initialize(&app_state->cooked_cache_system_memory_requirement, app_state->cooked_cache_system_state, cache_config)) {
+        KFATAL("Failed to initialize cooked asset cache; shutting down.");
+        return false;
+    }
+
     // Renderer system
     renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0);
     app_state->renderer_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->renderer_system_memory_requirement);
@@ -134,6 +260,7 @@ b8 application_create(game* game_inst)
 	// Texture system.
     texture_system_config texture_sys_config;
     texture_sys_config.max_texture_count = 65536;
+    texture_sys_config.stream_textures = true;
     texture_system_initialize(&app_state->texture_system_memory_requirement, 0, texture_sys_config);
     app_state->texture_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->texture_system_memory_requirement);
     if (!texture_system_initialize(&app_state->texture_system_memory_requirement, app_state->texture_system_state, texture_sys_config)) {
@@ -163,6 +290,60 @@ b8 application_create(game* game_inst)
 	return true;
 }
 
+static b8 frame_task_game_update(void* params) {
+	application_state* state = params;
+	return state->game_inst->update(state->game_inst, (f32)state->frame_delta);
+}
+
+static b8 frame_task_game_render(void* params) {
+	application_state* state = params;
+	return state->game_inst->render(state->game_inst, (f32)state->frame_delta);
+}
+
+static b8 frame_task_draw(void* params) {
+	application_state* state = params;
+	// TODO: Refactor the packet creation
+	state->frame_packet.delta_time = (f32)state->frame_delta;
+	return renderer_draw_frame(&state->frame_packet);
+}
+
+static b8 frame_task_input_update(void* params) {
+	application_state* state = params;
+	input_update(state->frame_delta);
+	return true;
+}
+
+/**
+ * Declares the frame as tasks. The engine's own run on the main thread, as the game
+ * update and render may touch the window or renderer; the game's tasks fill in between.
+ */
+static b8 build_frame_graph(task_graph* graph, f64 delta) {
+	app_state->frame_delta = delta;
+	task_graph_reset(graph);
+
+	task_id update = task_graph_add(graph, "game update", frame_task_game_update, app_state, TASK_FLAG_MAIN_THREAD);
+	task_graph_reads(graph, update, "input");
+	task_graph_writes(graph, update, "game");
+
+	if (app_state->game_inst->build_frame_graph && !app_state->game_inst->build_frame_graph(app_state->game_inst, graph, (f32)delta)) {
+		KERROR("Game failed to build the frame graph.");
+		return false;
+	}
+
+	task_id render = task_graph_add(graph, "game render", frame_task_game_render, app_state, TASK_FLAG_MAIN_THREAD);
+	task_graph_reads(graph, render, "game");
+	task_graph_writes(graph, render, "render packet");
+
+	task_id draw = task_graph_add(graph, "draw frame", frame_task_draw, app_state, TASK_FLAG_MAIN_THREAD);
+	task_graph_reads(graph, draw, "render packet");
+
+	// NOTE: Input update/state copying should always be handled after any input should be recorded.
+	// Writing it puts it after everything which reads it.
+	task_id input = task_graph_add(graph, "input update", frame_task_input_update, app_state, TASK_FLAG_MAIN_THREAD);
+	task_graph_writes(graph, input, "input");
+	return true;
+}
+
 b8 application_run()
 {
     app_state->is_running = true;
@@ -171,11 +352,15 @@ b8 application_run()
     app_state->last_time = app_state->clock.elapsed;
 
 	f64 running_time = 0.0;
-	u8 frame_count = 0;
-	f64 target_frame_seconds = 1.0f / 60;
+	u64 frame_count = 0;
 
-	//We are technically leaking memory here, but it's just called once
-	KINFO(get_memory_usage_str());
+	// A line per tag; fits on the stack, but grows onto the heap if need be.
+	char report_buffer[2048];
+	kstring_builder report;
+	string_builder_create_from_buffer(report_buffer, sizeof(report_buffer), 0, &report);
+	memory_usage_append(&report);
+	KINFO("%s", report.data);
+	string_builder_destroy(&report);
 
 	while (app_state->is_running)
 	{
@@ -184,50 +369,57 @@ b8 application_run()
 		}
 
 		if (!app_state->is_suspended) {
+			KPROFILE_ZONE_BEGIN("frame");
 			// Update the clock and get the delta time
 			clock_update(&app_state->clock);
 			f64 current_time = app_state->clock.elapsed;
 			f64 delta = (current_time - app_state->last_time);
 			f64 frame_start_time = platform_get_absolute_time();
 
-			if (!app_state->game_inst->update(app_state->game_inst, (f32)delta)) {
-				KFATAL("Failed to update game, shutting down.");
-				app_state->is_running = false;
-				break;
-			}
+			// Hands reads which finished since last frame to whoever asked for them.
+			async_io_system_update();
+			// Reloads assets edited since last frame.
+			vfs_system_update();
 
-			// Call the game's renderer routine
-			if (!app_state->game_inst->render(app_state->game_inst, (f32)delta)) {
-				KFATAL("Failed to render game, shutting down.");
+			b8 frame_succeeded = build_frame_graph(&app_state->frame_graph, delta) && task_graph_execute(&app_state->frame_graph);
+			if (app_state->dump_frame_graph) {
+				task_graph_dump(&app_state->frame_graph, "frame_graph.dot");
+				app_state->dump_frame_graph = false;
+			}
+			if (!frame_succeeded) {
+				KFATAL("Frame failed, shutting down.");
 				app_state->is_running = false;
+				KPROFILE_ZONE_END();
+				KPROFILE_FRAME_MARK();
 				break;
 			}
-
-			// TODO: Refactor the packet creation
-			render_packet packet;
-			packet.delta_time = (f32)delta;
-			renderer_draw_frame(&packet);
+			// The game update is always the first task.
+			f64 update_end_time = app_state->frame_graph.execute_start_time + app_state->frame_graph.tasks[0].end_time;
 
 			// Figure out how long the frame took
 			f64 frame_end_time = platform_get_absolute_time();
 			f64 frame_elapsed = frame_end_time - frame_start_time;
 			running_time += frame_elapsed;
-			// How long we should wait before the next frame
-			f64 remaining_time = target_frame_seconds - frame_elapsed;
-
-			if (remaining_time > 0.0) {
-				// If there is time left, sleep for the remaining time
-				b8 limit_frames = false;
-				if (remaining_time > 0.0 && limit_frames) {
-					platform_sleep((u64)(remaining_time * 1000.0)-1);
-				}
 
-				frame_count++;
+			// The first frame has no previous frame to measure from.
+			if (frame_count > 0) {
+				frame_stats_record(update_end_time - frame_start_time, frame_end_time - update_end_time, delta);
 			}
+			// Counts made during the frame become its values.
+			perf_counters_snapshot(frame_count);
+
+			renderer_stats render_stats;
+			telemetry_publish(frame_count, renderer_stats_get(&render_stats) ? &render_stats : 0);
+			frame_count++;
+
+			// Log output is buffered during the frame and written out once here.
+			logger_flush();
 
-			// NOTE: Input update/sate copying sgould always be handled after any input should be recorded
-			// As a safety, input is the last thing to be updated before the frame ends
-			input_update(delta);
+			// Wait for the next frame, if paced.
+			frame_pacer_wait();
+
+			KPROFILE_ZONE_END();
+			KPROFILE_FRAME_MARK();
 
 			app_state->last_time = current_time;
 		}
@@ -242,14 +434,37 @@ b8 application_run()
 
 	input_system_shutdown(app_state->input_system_state);
 
+	// Reads still in flight are waited on, possibly by workers.
+	async_io_system_shutdown(app_state->async_io_system_state);
+
+	job_system_shutdown(app_state->job_system_state);
+
 	material_system_shutdown(app_state->material_system_state);
 
 	texture_system_shutdown(app_state->texture_system_state);
 
     renderer_system_shutdown(app_state->renderer_system_state);
 
+	cooked_cache_system_shutdown(app_state->cooked_cache_system_state);
+
+	vfs_system_shutdown(app_state->vfs_system_state);
+
     platform_system_shutdown(app_state->platform_system_state);
 
+	telemetry_shutdown(app_state->telemetry_state);
+
+	frame_pacer_shutdown(app_state->frame_pacer_state);
+
+	frame_stats_shutdown(app_state->frame_stats_state);
+
+	perf_counters_shutdown(app_state->perf_counters_state);
+
+#if KPROFILER_ENABLED == 1
+	profiler_shutdown(app_state->profiler_state);
+#endif
+
+	shutdown_logging(app_state->logging_system_state);
+
 	memory_system_shutdown(app_state->memory_system_state);
 
 	event_system_shutdown(app_state->event_system_state);
@@ -301,9 +516,31 @@ b8 application_on_key(u16 code, void* sender, void* listener_inst, event_context
 		}
 #if defined(_DEBUG)
 		 else if (key_code == KEY_M){
-			KDEBUG(get_memory_usage_str());
+			char report_buffer[2048];
+			kstring_builder report;
+			string_builder_create_from_buffer(report_buffer, sizeof(report_buffer), 0, &report);
+			memory_usage_append(&report);
+			KDEBUG("%s", report.data);
+			string_builder_destroy(&report);
 		}
 #endif 
+#if KPROFILER_ENABLED == 1
+		 else if (key_code == KEY_P) {
+			profiler_export_chrome_trace("profile.json");
+		}
+#endif
+		 else if (key_code == KEY_G) {
+			// Writes the next frame's task graph, with its critical path, to a Graphviz file.
+			app_state->dump_frame_graph = true;
+		}
+		 else if (key_code == KEY_C) {
+			// Toggles streaming performance counters to a CSV file.
+			if (perf_counters_capturing()) {
+				perf_counters_capture_end();
+			} else {
+				perf_counters_capture_begin("perf_counters.csv");
+			}
+		}
 		else {
 			KDEBUG("Key %c released", key_code);
 		}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "defines.h"
+#include "core/frame_pacer.h"
 
 struct game;
 
@@ -19,6 +20,15 @@ typedef struct application_config {
 
 	// The application name used in windowing, if applicable.
 	char* name;
+
+	// How frames are paced. Unlimited if left at 0.
+	frame_pacing_mode frame_pacing;
+
+	// The target number of frames per second when paced. 0 is unlimited.
+	u16 target_fps;
+
+	// Publishes live stats to shared memory, for the telemetry tool to watch.
+	b8 publish_telemetry;
 } application_config;
 
 KAPI b8 application_create(struct game* game_inst);
@@ -1,6 +1,7 @@
 #include "core/event.h"
 #include "core/kmemory.h"
 #include "core/logger.h"
+#include "core/perf_counters.h"
 #include "containers/darray.h"
 
 typedef struct registered_event {
@@ -18,6 +19,7 @@ typedef struct event_code_entr {
 // State structure
 typedef struct event_system_state {
 	event_code_entry registered[MAX_MESSAGE_CODES];
+	perf_counter_id events_fired_counter;
 } event_system_state;
 
 /**
@@ -32,8 +34,9 @@ void event_system_initialize(u64* memory_requirement, void* state) {
         return;
 	}
 
-    kzero_memory(state, sizeof(state));
+    kzero_memory(state, sizeof(event_system_state));
     state_ptr = state;
+    state_ptr->events_fired_counter = perf_counter_register("events fired");
 }
 
 void event_system_shutdown(void* state) {
@@ -90,6 +93,8 @@ b8 event_unregister(u16 code, void* listener, PFN_on_event on_event)
 		return false;
 	}
 
+	KPERF_COUNTER_ADD(state_ptr->events_fired_counter, 1);
+
 	u64 registered_count = darray_length(state_ptr->registered[code].events);
 	for (u64 i = 0; i < registered_count; ++i) {
 		registered_event e = state_ptr->registered[code].events[i];
@@ -106,6 +106,13 @@ typedef enum system_event_code {
      */
     EVENT_CODE_RESIZED = 0x08,
 
+    // A file under the asset directory was written, while the vfs is watching for changes.
+    /** Context usage:
+     * const char* path = (const char*)data.data.u64[0];
+     * Relative to the asset directory, i.e. "textures/paving.png". Only valid during the event.
+     */
+    EVENT_CODE_ASSET_CHANGED = 0x09,
+
     EVENT_CODE_DEBUG0 = 0x10,
     EVENT_CODE_DEBUG1 = 0x11,
     EVENT_CODE_DEBUG2 = 0x12,
@@ -0,0 +1,161 @@
+#include "frame_pacer.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/profiler.h"
+#include "platform/platform.h"
+
+// Time always left to spinning, on top of how late sleeps have been waking up, in seconds.
+#define FRAME_PACER_MIN_SPIN 0.0002
+// Initial guess of how late sleeps wake up, in seconds. Corrected as sleeps are measured.
+#define FRAME_PACER_INITIAL_OVERSHOOT 0.002
+// Most of the interval sleeps are assumed to overrun by. Past it, a single late wake up
+// (i.e. a debugger break) would leave no time to sleep in, and every later frame would spin.
+#define FRAME_PACER_MAX_OVERSHOOT_FRACTION 0.25
+// Weight given to each newer, smaller overshoot, and how much of it is let go each frame no sleep is taken.
+#define FRAME_PACER_OVERSHOOT_DECAY 0.05
+// Weight of the newest frame in the smoothed frame cost.
+#define FRAME_PACER_SMOOTHING 0.1
+// How far over a whole multiple of the target interval the frame cost must be before adaptive pacing drops to the next one.
+#define FRAME_PACER_ADAPTIVE_HYSTERESIS 0.05
+// Lowest fraction of the target rate adaptive pacing drops to, i.e. 4 is 15fps for a 60fps target.
+#define FRAME_PACER_ADAPTIVE_MAX_DIVISOR 4
+
+typedef struct frame_pacer_state {
+    frame_pacer_config config;
+    // Time the current frame was scheduled to start. 0 before the first frame.
+    f64 frame_start;
+    // Interval the last frame was paced at.
+    f64 interval;
+    // Smoothed time frames take before waiting, including blocking on present.
+    f64 frame_cost;
+    // Smoothed amount of time sleeps wake up later than requested.
+    f64 sleep_overshoot;
+} frame_pacer_state;
+
+static frame_pacer_state* state_ptr;
+
+b8 frame_pacer_initialize(u64* memory_requirement, void* state, frame_pacer_config config) {
+    *memory_requirement = sizeof(frame_pacer_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(frame_pacer_state));
+    state_ptr->config = config;
+    state_ptr->sleep_overshoot = FRAME_PACER_INITIAL_OVERSHOOT;
+
+    if (config.mode == FRAME_PACING_UNLIMITED || config.target_fps == 0) {
+        KINFO("Frame pacing disabled.");
+    } else {
+        KINFO("Frame pacing at %u fps (%s).", config.target_fps, config.mode == FRAME_PACING_ADAPTIVE ? "adaptive" : "fixed");
+    }
+    return true;
+}
+
+void frame_pacer_shutdown(void* state) {
+    state_ptr = 0;
+}
+
+static f64 compute_interval() {
+    if (state_ptr->config.mode == FRAME_PACING_UNLIMITED || state_ptr->config.target_fps == 0) {
+        return 0;
+    }
+
+    f64 target = 1.0 / state_ptr->config.target_fps;
+    if (state_ptr->config.mode != FRAME_PACING_ADAPTIVE) {
+        return target;
+    }
+
+    // Pace at the smallest whole multiple of the target the frames actually fit in.
+    f64 ratio = state_ptr->frame_cost / target - FRAME_PACER_ADAPTIVE_HYSTERESIS;
+    u32 divisor = 1;
+    while (divisor < FRAME_PACER_ADAPTIVE_MAX_DIVISOR && ratio > divisor) {
+        divisor++;
+    }
+    return target * divisor;
+}
+
+static void wait_until(f64 deadline, f64 interval) {
+    f64 max_overshoot = interval * FRAME_PACER_MAX_OVERSHOOT_FRACTION;
+    b8 slept = false;
+    // Sleep while there is comfortably more time left than sleeps tend to overrun by.
+    for (;;) {
+        f64 now = platform_get_absolute_time();
+        f64 sleep_time = deadline - now - (FRAME_PACER_MIN_SPIN + state_ptr->sleep_overshoot);
+        u64 ms = sleep_time > 0 ? (u64)(sleep_time * 1000.0) : 0;
+        if (ms == 0) {
+            break;
+        }
+
+        platform_sleep(ms);
+        slept = true;
+        f64 overshoot = (platform_get_absolute_time() - now) - ms / 1000.0;
+        if (overshoot > state_ptr->sleep_overshoot) {
+            // A late wake up costs a missed deadline, so adjust for it right away...
+            state_ptr->sleep_overshoot = overshoot < max_overshoot ? overshoot : max_overshoot;
+        } else {
+            // ...but only trust a run of better ones slowly.
+            state_ptr->sleep_overshoot += (overshoot - state_ptr->sleep_overshoot) * FRAME_PACER_OVERSHOOT_DECAY;
+        }
+    }
+    if (!slept) {
+        // Nothing was measured, so the overshoot could otherwise stay too large to ever sleep again.
+        state_ptr->sleep_overshoot -= state_ptr->sleep_overshoot * FRAME_PACER_OVERSHOOT_DECAY;
+    }
+
+    // Spin for the rest.
+    while (platform_get_absolute_time() < deadline) {
+    }
+}
+
+void frame_pacer_wait() {
+    if (!state_ptr) {
+        return;
+    }
+
+    f64 now = platform_get_absolute_time();
+    if (state_ptr->frame_start == 0) {
+        state_ptr->frame_start = now;
+        return;
+    }
+
+    f64 cost = now - state_ptr->frame_start;
+    if (state_ptr->frame_cost == 0) {
+        state_ptr->frame_cost = cost;
+    } else {
+        state_ptr->frame_cost += (cost - state_ptr->frame_cost) * FRAME_PACER_SMOOTHING;
+    }
+
+    state_ptr->interval = compute_interval();
+    f64 deadline = state_ptr->frame_start + state_ptr->interval;
+    if (state_ptr->interval == 0 || now >= deadline) {
+        // Unlimited, or already late. Start the next frame now rather than trying to catch up.
+        state_ptr->frame_start = now;
+        return;
+    }
+
+    KPROFILE_ZONE_BEGIN("frame pacer wait");
+    wait_until(deadline, state_ptr->interval);
+    KPROFILE_ZONE_END();
+
+    // Schedule from the deadline rather than the wake up time, so small overshoots do not add up.
+    state_ptr->frame_start = deadline;
+}
+
+void frame_pacer_mode_set(frame_pacing_mode mode) {
+    if (state_ptr) {
+        state_ptr->config.mode = mode;
+    }
+}
+
+void frame_pacer_target_fps_set(u16 target_fps) {
+    if (state_ptr) {
+        state_ptr->config.target_fps = target_fps;
+    }
+}
+
+f64 frame_pacer_interval_get() {
+    return state_ptr ? state_ptr->interval : 0;
+}
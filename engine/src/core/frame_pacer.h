@@ -0,0 +1,50 @@
+#pragma once
+
+#include "defines.h"
+
+typedef enum frame_pacing_mode {
+    // Frames are not limited at all.
+    FRAME_PACING_UNLIMITED = 0,
+    // Frames are started at a fixed rate of target_fps.
+    FRAME_PACING_FIXED = 1,
+    /**
+     * Like FIXED, but when frames take longer than the target (including waiting on
+     * present), paces at a whole fraction of the target instead, i.e. 30 instead of 60,
+     * so frame times stay even rather than alternating between fast and slow.
+     */
+    FRAME_PACING_ADAPTIVE = 2
+} frame_pacing_mode;
+
+typedef struct frame_pacer_config {
+    frame_pacing_mode mode;
+    // The target number of frames per second. 0 is unlimited regardless of mode.
+    u16 target_fps;
+} frame_pacer_config;
+
+/**
+ * @brief Initializes the frame pacer. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param config The initial pacing configuration.
+ * @return b8 True on success; otherwise false.
+ */
+b8 frame_pacer_initialize(u64* memory_requirement, void* state, frame_pacer_config config);
+void frame_pacer_shutdown(void* state);
+
+/**
+ * @brief Waits until the next frame should start. Called by the application once per
+ * frame, after the frame has been presented. Sleeps for as long as the platform can
+ * be trusted to wake up in time, then spins for the remainder.
+ */
+void frame_pacer_wait();
+
+/** @brief Changes the pacing mode at runtime. */
+KAPI void frame_pacer_mode_set(frame_pacing_mode mode);
+
+/** @brief Changes the target frame rate at runtime. 0 is unlimited. */
+KAPI void frame_pacer_target_fps_set(u16 target_fps);
+
+/** @brief Gets the interval frames are currently paced at, in seconds. 0 if unlimited. */
+KAPI f64 frame_pacer_interval_get();
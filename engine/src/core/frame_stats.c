@@ -0,0 +1,125 @@
+#include "frame_stats.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+
+#include <stdlib.h>
+
+typedef struct frame_stats_state {
+    u64 frame_count;
+    // Ring buffers of the last FRAME_STATS_WINDOW_SIZE frames.
+    f64 update_times[FRAME_STATS_WINDOW_SIZE];
+    f64 render_times[FRAME_STATS_WINDOW_SIZE];
+    f64 frame_times[FRAME_STATS_WINDOW_SIZE];
+
+    // Scratch space used to sort a series when computing percentiles.
+    f64 sorted[FRAME_STATS_WINDOW_SIZE];
+
+    f64 time_since_log;
+} frame_stats_state;
+
+static frame_stats_state* state_ptr;
+
+b8 frame_stats_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(frame_stats_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(frame_stats_state));
+    return true;
+}
+
+void frame_stats_shutdown(void* state) {
+    state_ptr = 0;
+}
+
+static void log_stats() {
+    frame_stats stats;
+    if (!frame_stats_get(&stats)) {
+        return;
+    }
+    KINFO("Frame stats over %u frames: frame ms min %.2f / mean %.2f / p50 %.2f / p95 %.2f / p99 %.2f / max %.2f, %u hitch(es).",
+          stats.sample_count, stats.frame.min * 1000.0, stats.frame.mean * 1000.0, stats.frame.p50 * 1000.0,
+          stats.frame.p95 * 1000.0, stats.frame.p99 * 1000.0, stats.frame.max * 1000.0, stats.hitch_count);
+    KDEBUG("Frame stats: update ms mean %.2f / p99 %.2f, render ms mean %.2f / p99 %.2f.",
+           stats.update.mean * 1000.0, stats.update.p99 * 1000.0, stats.render.mean * 1000.0, stats.render.p99 * 1000.0);
+}
+
+void frame_stats_record(f64 update_seconds, f64 render_seconds, f64 frame_seconds) {
+    if (!state_ptr) {
+        return;
+    }
+
+    u32 index = (u32)(state_ptr->frame_count % FRAME_STATS_WINDOW_SIZE);
+    state_ptr->update_times[index] = update_seconds;
+    state_ptr->render_times[index] = render_seconds;
+    state_ptr->frame_times[index] = frame_seconds;
+    state_ptr->frame_count++;
+
+    if (FRAME_STATS_LOG_INTERVAL > 0) {
+        state_ptr->time_since_log += frame_seconds;
+        if (state_ptr->time_since_log >= FRAME_STATS_LOG_INTERVAL) {
+            state_ptr->time_since_log = 0;
+            log_stats();
+        }
+    }
+}
+
+static int compare_times(const void* a, const void* b) {
+    f64 left = *(const f64*)a;
+    f64 right = *(const f64*)b;
+    return (left > right) - (left < right);
+}
+
+// Nearest-rank percentile of a sorted series.
+static f64 percentile(const f64* sorted, u32 count, u32 percent) {
+    u32 rank = (percent * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void summarize(const f64* times, u32 count, frame_time_summary* out_summary) {
+    f64* sorted = state_ptr->sorted;
+    kcopy_memory(sorted, times, sizeof(f64) * count);
+    // Frame times arrive in no useful order, so this is a full sort; telemetry asks every frame.
+    qsort(sorted, count, sizeof(f64), compare_times);
+
+    f64 total = 0;
+    for (u32 i = 0; i < count; ++i) {
+        total += sorted[i];
+    }
+
+    out_summary->min = sorted[0];
+    out_summary->max = sorted[count - 1];
+    out_summary->mean = total / count;
+    out_summary->p50 = percentile(sorted, count, 50);
+    out_summary->p95 = percentile(sorted, count, 95);
+    out_summary->p99 = percentile(sorted, count, 99);
+}
+
+b8 frame_stats_get(frame_stats* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return false;
+    }
+
+    kzero_memory(out_stats, sizeof(frame_stats));
+    out_stats->frame_count = state_ptr->frame_count;
+    u32 count = state_ptr->frame_count < FRAME_STATS_WINDOW_SIZE ? (u32)state_ptr->frame_count : FRAME_STATS_WINDOW_SIZE;
+    out_stats->sample_count = count;
+    if (count == 0) {
+        return true;
+    }
+
+    summarize(state_ptr->update_times, count, &out_stats->update);
+    summarize(state_ptr->render_times, count, &out_stats->render);
+    summarize(state_ptr->frame_times, count, &out_stats->frame);
+
+    f64 hitch_threshold = out_stats->frame.p50 * FRAME_STATS_HITCH_MULTIPLIER;
+    for (u32 i = 0; i < count; ++i) {
+        if (state_ptr->frame_times[i] > hitch_threshold) {
+            out_stats->hitch_count++;
+        }
+    }
+    return true;
+}
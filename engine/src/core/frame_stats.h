@@ -0,0 +1,65 @@
+#pragma once
+
+#include "defines.h"
+
+// Number of frames kept in the rolling window.
+#define FRAME_STATS_WINDOW_SIZE 512
+// A frame counts as a hitch when it takes this many times longer than the median frame.
+#define FRAME_STATS_HITCH_MULTIPLIER 2.0
+// Number of seconds between periodic frame statistics logs. 0 disables them.
+#define FRAME_STATS_LOG_INTERVAL 5.0
+
+// Summary of one series of times in the window, in seconds.
+typedef struct frame_time_summary {
+    f64 min;
+    f64 mean;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+    f64 max;
+} frame_time_summary;
+
+typedef struct frame_stats {
+    // Total number of frames recorded since startup.
+    u64 frame_count;
+    // Number of frames in the window the summaries below were computed over.
+    u32 sample_count;
+    // Number of frames in the window which took longer than FRAME_STATS_HITCH_MULTIPLIER times the median.
+    u32 hitch_count;
+    // Time spent updating the game.
+    frame_time_summary update;
+    // Time spent rendering, including the renderer.
+    frame_time_summary render;
+    // Total time from one frame to the next, including any waiting.
+    frame_time_summary frame;
+} frame_stats;
+
+/**
+ * @brief Initializes the frame statistics system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @return b8 True on success; otherwise false.
+ */
+b8 frame_stats_initialize(u64* memory_requirement, void* state);
+void frame_stats_shutdown(void* state);
+
+/**
+ * @brief Records the times of a single frame. Called by the application once per frame,
+ * which also logs a summary every FRAME_STATS_LOG_INTERVAL seconds.
+ *
+ * @param update_seconds Time spent updating the game.
+ * @param render_seconds Time spent rendering.
+ * @param frame_seconds Total time since the previous frame.
+ */
+KAPI void frame_stats_record(f64 update_seconds, f64 render_seconds, f64 frame_seconds);
+
+/**
+ * @brief Computes statistics over the current window.
+ * NOTE: Sorts the window, so avoid calling it more than once per frame.
+ *
+ * @param out_stats A pointer to hold the statistics.
+ * @return True on success; false if the system is not initialized.
+ */
+KAPI b8 frame_stats_get(frame_stats* out_stats);
@@ -30,18 +30,18 @@ void input_system_initialize(u64* memory_requirement, void* state) {
     }
     kzero_memory(state, sizeof(input_state));
     state_ptr = state;
-	KINFO("Input subsystem initialized");
+	KINFO_CH(INPUT, "Input subsystem initialized");
 }
 
 void input_system_shutdown(void* state) {
 	// TODO: Add shutdown routines when needed.
 	state_ptr = 0;
-	KINFO("Input subsystem shut down");
+	KINFO_CH(INPUT, "Input subsystem shut down");
 }
 
 void input_update(f64 delta_time) {
 	if (!state_ptr) {
-		KERROR("Trying to update input subsystem that has not been initialized");
+		KERROR_CH(INPUT, "Trying to update input subsystem that has not been initialized");
 		return;
 	}
 
@@ -55,21 +55,21 @@ void input_process_key(keys key, b8 pressed) {
 	if (state_ptr && state_ptr->keyboard_current.keys[key] != pressed) {
 
 	if (key == KEY_LALT) {
-        KINFO("Left alt %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Left alt %s.", pressed ? "pressed" : "released");
     } else if (key == KEY_RALT) {
-        KINFO("Right alt %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Right alt %s.", pressed ? "pressed" : "released");
     }
 
     if (key == KEY_LCONTROL) {
-        KINFO("Left ctrl %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Left ctrl %s.", pressed ? "pressed" : "released");
     } else if (key == KEY_RCONTROL) {
-        KINFO("Right ctrl %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Right ctrl %s.", pressed ? "pressed" : "released");
     }
 
     if (key == KEY_LSHIFT) {
-        KINFO("Left shift %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Left shift %s.", pressed ? "pressed" : "released");
     } else if (key == KEY_RSHIFT) {
-        KINFO("Right shift %s.", pressed ? "pressed" : "released");
+        KINFO_CH(INPUT, "Right shift %s.", pressed ? "pressed" : "released");
     }
 
 	
@@ -102,7 +102,7 @@ void input_process_mouse_move(i16 x, i16 y) {
 	// Only handle this if the state actually changed
 	if (state_ptr->mouse_current.x != x || state_ptr->mouse_current.y != y) {
 		// NOTE: Enable this if debugging
-		// KDEBUG("Mouse moved to (%i, %i)", x, y);
+		// KDEBUG_CH(INPUT, "Mouse moved to (%i, %i)", x, y);
 		
 		// Update the current state
 		state_ptr->mouse_current.x = x;
@@ -127,7 +127,7 @@ void input_process_mouse_wheel(i8 delta) {
 
 b8 input_is_key_down(keys key) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a key is down on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a key is down on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -136,7 +136,7 @@ b8 input_is_key_down(keys key) {
 
 b8 input_is_key_up(keys key) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a key is up on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a key is up on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -145,7 +145,7 @@ b8 input_is_key_up(keys key) {
 
 b8 input_was_key_down(keys key) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a key was down on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a key was down on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -154,7 +154,7 @@ b8 input_was_key_down(keys key) {
 
 b8 input_was_key_up(keys key) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a key was up on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a key was up on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -163,7 +163,7 @@ b8 input_was_key_up(keys key) {
 
 b8 input_is_button_down(buttons button) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a button is down on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a button is down on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -172,7 +172,7 @@ b8 input_is_button_down(buttons button) {
 
 b8 input_is_button_up(buttons button) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a button is up on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a button is up on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -181,7 +181,7 @@ b8 input_is_button_up(buttons button) {
 
 b8 input_was_button_down(buttons button) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a button was down on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a button was down on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -190,7 +190,7 @@ b8 input_was_button_down(buttons button) {
 
 b8 input_was_button_up(buttons button) {
 	if (!state_ptr) {
-		KERROR("Trying to check if a button was up on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to check if a button was up on an uninitialized input subsystem");
 		return false;
 	}
 
@@ -199,7 +199,7 @@ b8 input_was_button_up(buttons button) {
 
 void input_get_mouse_position(i32* x, i32* y) {
 	if (!state_ptr) {
-		KERROR("Trying to get the mouse position on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to get the mouse position on an uninitialized input subsystem");
 		return;
 	}
 
@@ -209,7 +209,7 @@ void input_get_mouse_position(i32* x, i32* y) {
 
 void input_get_previous_mouse_position(i32* x, i32* y) {
 	if (!state_ptr) {
-		KERROR("Trying to get the previous mouse position on an uninitialized input subsystem");
+		KERROR_CH(INPUT, "Trying to get the previous mouse position on an uninitialized input subsystem");
 		return;
 	}
 
@@ -0,0 +1,88 @@
+#include "khash.h"
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+// Little endian, whatever the platform. Compiles to a single load where it can.
+KINLINE u64 read_u64(const u8* p) {
+    return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24) |
+           ((u64)p[4] << 32) | ((u64)p[5] << 40) | ((u64)p[6] << 48) | ((u64)p[7] << 56);
+}
+
+KINLINE u32 read_u32(const u8* p) {
+    return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+KINLINE u64 rotate_left(u64 value, u32 count) {
+    return (value << count) | (value >> (64 - count));
+}
+
+KINLINE u64 round64(u64 accumulator, u64 input) {
+    accumulator += input * PRIME64_2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * PRIME64_1;
+}
+
+KINLINE u64 merge_round(u64 accumulator, u64 value) {
+    accumulator ^= round64(0, value);
+    return accumulator * PRIME64_1 + PRIME64_4;
+}
+
+u64 khash64(const void* data, u64 size, u64 seed) {
+    const u8* p = data;
+    const u8* end = p + size;
+    u64 hash;
+
+    if (size >= 32) {
+        // Four independent lanes, so the multiplies overlap.
+        u64 v1 = seed + PRIME64_1 + PRIME64_2;
+        u64 v2 = seed + PRIME64_2;
+        u64 v3 = seed;
+        u64 v4 = seed - PRIME64_1;
+        const u8* limit = end - 32;
+        do {
+            v1 = round64(v1, read_u64(p));
+            v2 = round64(v2, read_u64(p + 8));
+            v3 = round64(v3, read_u64(p + 16));
+            v4 = round64(v4, read_u64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        hash = merge_round(hash, v1);
+        hash = merge_round(hash, v2);
+        hash = merge_round(hash, v3);
+        hash = merge_round(hash, v4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+    hash += size;
+
+    // The tail, 8, 4, then 1 byte at a time.
+    while (end - p >= 8) {
+        hash ^= round64(0, read_u64(p));
+        hash = rotate_left(hash, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        hash ^= (u64)read_u32(p) * PRIME64_1;
+        hash = rotate_left(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= (*p) * PRIME64_5;
+        hash = rotate_left(hash, 11) * PRIME64_1;
+        p++;
+    }
+
+    // Spreads the last bits over the whole hash.
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * @brief Hashes a block of memory with XXH64, which reads 32 bytes per round and runs
+ * at several GB/s; fast enough to hash whole asset files on load. Matches the reference
+ * implementation, so hashes can also be produced by other tools.
+ * Not for security; collisions can be found on purpose.
+ *
+ * @param data The memory to hash.
+ * @param size The size of the memory, in bytes.
+ * @param seed Changes every hash, i.e. to tell versions of a format apart.
+ * @return u64 The hash.
+ */
+KAPI u64 khash64(const void* data, u64 size, u64 seed);
@@ -1,17 +1,10 @@
 #include "kmemory.h"
 
 #include "core/logger.h"
+#include "core/perf_counters.h"
+#include "platform/katomic.h"
 #include "platform/platform.h"
 
-// TODO: custom string library
-#include <string.h>
-#include <stdio.h>
-
-struct memory_stats {
-	u64 total_allocated;
-	u64 tagged_allocations[MEMORY_TAG_MAX_TAGS];
-};
-
 static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
 	"UNKNOWN          ",
 	"ARRAY            ",
@@ -30,12 +23,14 @@ static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
 	"TRANSFORM        ",
 	"ENTITY           ",
 	"ENTITY_NODE      ",
-	"SCENE            "
+	"SCENE            ",
+	"FILE             "
 };
 
 typedef struct memory_system_state {
-    struct memory_stats stats;
+    memory_stats stats;
     u64 alloc_count;
+    perf_counter_id allocations_counter;
 } memory_system_state;
 
 // TODO: implement a memory struct to keep track of the size of each allocation and not have to put the tag and size in free
@@ -53,6 +48,7 @@ void memory_system_initialize(u64* memory_requirement, void* state) {
     state_ptr = state;
     state_ptr->alloc_count = 0;
     platform_zero_memory(&state_ptr->stats, sizeof(state_ptr->stats));
+    state_ptr->allocations_counter = perf_counter_register("allocations");
 }
 
 void memory_system_shutdown(void* state) {
@@ -61,12 +57,14 @@ void memory_system_shutdown(void* state) {
 
 void* kallocate(u64 size, memory_tag tag) {
 	if (tag == MEMORY_TAG_UNKNOWN) {
-		KWARN("kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation")
+		KWARN_CH(MEMORY, "kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation")
 	}
 	if (state_ptr) {
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->alloc_count++;
+        // Job system workers allocate too, so the stats are kept atomically.
+        katomic_fetch_add_u64(&state_ptr->stats.total_allocated, size, KATOMIC_RELAXED);
+        katomic_fetch_add_u64(&state_ptr->stats.tagged_allocations[tag], size, KATOMIC_RELAXED);
+        katomic_fetch_add_u64(&state_ptr->alloc_count, 1, KATOMIC_RELAXED);
+        KPERF_COUNTER_ADD_LOCAL(state_ptr->allocations_counter, 1);
     }
 
 	// TODO: Add memory alignment
@@ -77,12 +75,12 @@ void* kallocate(u64 size, memory_tag tag) {
 
 void kfree(void* block, u64 size, memory_tag tag) {
 	if (tag == MEMORY_TAG_UNKNOWN) {
-		KWARN("kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation")
+		KWARN_CH(MEMORY, "kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation")
 	}
 
 	if (state_ptr) {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+        katomic_fetch_sub_u64(&state_ptr->stats.total_allocated, size, KATOMIC_RELAXED);
+        katomic_fetch_sub_u64(&state_ptr->stats.tagged_allocations[tag], size, KATOMIC_RELAXED);
     }
 
 	platform_free(block, false);
@@ -100,48 +98,60 @@ void* kset_memory(void* dest, i32 value, u64 size) {
 	return platform_set_memory(dest, value, size);
 }
 
-char* get_memory_usage_str() {
+void memory_usage_append(kstring_builder* builder) {
 	// We want to output the memory usage in KB/MB/GB/...
 	const u64 gib = 1024 * 1024 * 1024;
 	const u64 mib = 1024 * 1024;
 	const u64 kib = 1024;
-	
-	// TODO: determine the size of the buffer
-	char buffer[8000] = "System memory use (tagged):\n";
-	u64 offset = strlen(buffer);
 
+	string_builder_append(builder, "System memory use (tagged):\n");
 	for (u32 i =0; i< MEMORY_TAG_MAX_TAGS; i++) {
 
+		u64 allocated = katomic_load_u64(&state_ptr->stats.tagged_allocations[i], KATOMIC_RELAXED);
+
 		// Decide the unit
 		char unit[4] = "XiB";
 		float amount = 1.0f;
-		if (state_ptr->stats.tagged_allocations[i] > gib) {
+		if (allocated > gib) {
 			unit[0] = 'G';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)gib;
-		} else if (state_ptr->stats.tagged_allocations[i] > mib) {
+			amount = allocated / (float)gib;
+		} else if (allocated > mib) {
 			unit[0] = 'M';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)mib;
-		} else if (state_ptr->stats.tagged_allocations[i] > kib) {
+			amount = allocated / (float)mib;
+		} else if (allocated > kib) {
 			unit[0] = 'K';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)kib;
+			amount = allocated / (float)kib;
 		} else {
 			unit[0] = 'B';
 			unit[1] = '\0';
-			amount = state_ptr->stats.tagged_allocations[i];
+			amount = allocated;
 		}
 
-		i32 length = snprintf(buffer + offset, 8000 - offset, "%s: %.2f %s\n", memory_tag_strings[i], amount, unit);
-		offset += length;
+		string_builder_appendf(builder, "%s: %.2f %s\n", memory_tag_strings[i], amount, unit);
 	}
-	//On renvoit une copie du buffer pour éviter qu'il soit détruit à la fin de la fonction
-	//Il faudra penser à le libérer après utilisation (après l'avoir affiché par exemple)
-	char* out_string = _strdup(buffer);
-    return out_string;
 }
 
 u64 get_memory_alloc_count() {
     if (state_ptr) {
-        return state_ptr->alloc_count;
+        return katomic_load_u64(&state_ptr->alloc_count, KATOMIC_RELAXED);
     }
     return 0;
+}
+
+b8 memory_system_stats_get(memory_stats* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return false;
+    }
+    out_stats->total_allocated = katomic_load_u64(&state_ptr->stats.total_allocated, KATOMIC_RELAXED);
+    for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        out_stats->tagged_allocations[i] = katomic_load_u64(&state_ptr->stats.tagged_allocations[i], KATOMIC_RELAXED);
+    }
+    return true;
+}
+
+const char* memory_tag_name(memory_tag tag) {
+    if (tag >= MEMORY_TAG_MAX_TAGS) {
+        return 0;
+    }
+    return memory_tag_strings[tag];
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "defines.h"
+#include "core/kstring_builder.h"
 
 typedef enum memory_tag {
 	MEMORY_TAG_UNKNOWN,
@@ -21,10 +22,16 @@ typedef enum memory_tag {
 	MEMORY_TAG_ENTITY,
 	MEMORY_TAG_ENTITY_NODE,
 	MEMORY_TAG_SCENE,
+	MEMORY_TAG_FILE,
 
 	MEMORY_TAG_MAX_TAGS // Keep this at the end
 } memory_tag;
 
+typedef struct memory_stats {
+	u64 total_allocated;
+	u64 tagged_allocations[MEMORY_TAG_MAX_TAGS];
+} memory_stats;
+
 KAPI void memory_system_initialize(u64* memory_requirement, void* state);
 KAPI void memory_system_shutdown(void* state);
 
@@ -33,5 +40,23 @@ KAPI void kfree(void* block, u64 size, memory_tag tag);
 KAPI void* kzero_memory(void* block, u64 size);
 KAPI void* kcopy_memory(void* dest, const void* src, u64 size);
 KAPI void* kset_memory(void* dest, i32 value, u64 size);
-KAPI char* get_memory_usage_str();
-KAPI u64 get_memory_alloc_count();
\ No newline at end of file
+
+/**
+ * @brief Appends a report of memory in use, per tag, one line each.
+ *
+ * @param builder The string builder to append to.
+ */
+KAPI void memory_usage_append(kstring_builder* builder);
+
+KAPI u64 get_memory_alloc_count();
+
+/**
+ * @brief Gets the number of bytes currently allocated, in total and per tag.
+ *
+ * @param out_stats A pointer to hold the stats.
+ * @return True on success; false if the memory system is not initialized.
+ */
+KAPI b8 memory_system_stats_get(memory_stats* out_stats);
+
+/** @brief Gets the name of a memory tag, padded to the width of the longest one. */
+KAPI const char* memory_tag_name(memory_tag tag);
\ No newline at end of file
@@ -3,16 +3,217 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>  // strtod, for numbers the fast path cannot convert exactly
 #include <stdarg.h>
 #include <ctype.h>   // isspace
 
-#ifndef _MSC_VER
-#include <strings.h>
+/*
+ * Strings are scanned a block of 16 bytes at a time, with SSE2 on x64, NEON on ARM and
+ * plain loops elsewhere. Every backend gives the same results, hashes included.
+ *
+ * A block is read whole, even past the terminator. That cannot fault so long as it stays
+ * within a page; one which would cross into the next page is read byte by byte instead.
+ * The address sanitizer would report those reads, so it is told to look away from them.
+ */
+#define KSTRING_BLOCK_SIZE 16
+// The smallest page size of any supported platform.
+#define KSTRING_PAGE_SIZE 4096
+
+#if defined(__clang__) || defined(__GNUC__)
+#define KSTRING_NO_ASAN __attribute__((no_sanitize_address))
+#elif defined(_MSC_VER)
+#define KSTRING_NO_ASAN __declspec(no_sanitize_address)
+#else
+#define KSTRING_NO_ASAN
 #endif
 
-u64 string_length(const char* str) {
-    return strlen(str);
+// KSTRING_NO_SIMD forces the plain loops, i.e. to check the other backends against them.
+#if defined(KSTRING_NO_SIMD)
+#define KSTRING_SCALAR 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#define KSTRING_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define KSTRING_NEON 1
+#include <arm_neon.h>
+#else
+#define KSTRING_SCALAR 1
+#endif
+
+#if KSTRING_SSE2
+typedef __m128i kblock;
+// Masks of bytes hold this many bits per byte.
+#define KSTRING_MASK_BITS 1
+
+KSTRING_NO_ASAN KINLINE kblock block_load(const char* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+// Lowers 'A' to 'Z', and nothing else, as strcasecmp does in the C locale.
+KINLINE kblock block_fold(kblock block) {
+    // Moves 'A' to the bottom of the signed range, so one compare finds all 26 letters.
+    __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+    return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+KINLINE u64 block_zero_mask(kblock block) {
+    return (u64)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()));
+}
+
+KINLINE u64 block_diff_mask(kblock a, kblock b) {
+    return (u64)(~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF);
+}
+
+// Zeroes every byte from count on.
+KINLINE kblock block_keep(kblock block, u32 count) {
+    __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_and_si128(block, _mm_cmplt_epi8(index, _mm_set1_epi8((char)count)));
+}
+
+KINLINE u64 block_low(kblock block) {
+    return (u64)_mm_cvtsi128_si64(block);
+}
+
+KINLINE u64 block_high(kblock block) {
+    return (u64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(block, block));
+}
+#elif KSTRING_NEON
+typedef uint8x16_t kblock;
+// NEON has no movemask, so compares are narrowed to 4 bits per byte instead.
+#define KSTRING_MASK_BITS 4
+
+KSTRING_NO_ASAN KINLINE kblock block_load(const char* p) {
+    return vld1q_u8((const u8*)p);
+}
+
+KINLINE kblock block_fold(kblock block) {
+    uint8x16_t upper = vcleq_u8(vsubq_u8(block, vdupq_n_u8('A')), vdupq_n_u8(25));
+    return vorrq_u8(block, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+KINLINE u64 compare_mask(uint8x16_t compare) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(compare), 4)), 0);
+}
+
+KINLINE u64 block_zero_mask(kblock block) {
+    return compare_mask(vceqq_u8(block, vdupq_n_u8(0)));
+}
+
+KINLINE u64 block_diff_mask(kblock a, kblock b) {
+    return compare_mask(vmvnq_u8(vceqq_u8(a, b)));
+}
+
+KINLINE kblock block_keep(kblock block, u32 count) {
+    static const u8 index[KSTRING_BLOCK_SIZE] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    return vandq_u8(block, vcltq_u8(vld1q_u8(index), vdupq_n_u8((u8)count)));
+}
+
+KINLINE u64 block_low(kblock block) {
+    return vgetq_lane_u64(vreinterpretq_u64_u8(block), 0);
+}
+
+KINLINE u64 block_high(kblock block) {
+    return vgetq_lane_u64(vreinterpretq_u64_u8(block), 1);
+}
+#else
+typedef struct kblock {
+    u8 bytes[KSTRING_BLOCK_SIZE];
+} kblock;
+#define KSTRING_MASK_BITS 1
+
+KSTRING_NO_ASAN KINLINE kblock block_load(const char* p) {
+    kblock block;
+    for (u32 i = 0; i < KSTRING_BLOCK_SIZE; ++i) {
+        block.bytes[i] = (u8)p[i];
+    }
+    return block;
+}
+
+KINLINE kblock block_fold(kblock block) {
+    for (u32 i = 0; i < KSTRING_BLOCK_SIZE; ++i) {
+        if ((u8)(block.bytes[i] - 'A') < 26) {
+            block.bytes[i] |= 0x20;
+        }
+    }
+    return block;
+}
+
+KINLINE u64 block_zero_mask(kblock block) {
+    u64 mask = 0;
+    for (u32 i = 0; i < KSTRING_BLOCK_SIZE; ++i) {
+        mask |= (u64)(block.bytes[i] == 0) << i;
+    }
+    return mask;
+}
+
+KINLINE u64 block_diff_mask(kblock a, kblock b) {
+    u64 mask = 0;
+    for (u32 i = 0; i < KSTRING_BLOCK_SIZE; ++i) {
+        mask |= (u64)(a.bytes[i] != b.bytes[i]) << i;
+    }
+    return mask;
+}
+
+KINLINE kblock block_keep(kblock block, u32 count) {
+    for (u32 i = count; i < KSTRING_BLOCK_SIZE; ++i) {
+        block.bytes[i] = 0;
+    }
+    return block;
+}
+
+// Little endian, as on every supported platform.
+KINLINE u64 block_low(kblock block) {
+    u64 value = 0;
+    for (u32 i = 0; i < 8; ++i) {
+        value |= (u64)block.bytes[i] << (i * 8);
+    }
+    return value;
+}
+
+KINLINE u64 block_high(kblock block) {
+    u64 value = 0;
+    for (u32 i = 0; i < 8; ++i) {
+        value |= (u64)block.bytes[8 + i] << (i * 8);
+    }
+    return value;
+}
+#endif
+
+// Index of the first byte set in a mask from the above. The mask must not be 0.
+KINLINE u32 mask_first(u64 mask) {
+    return (u32)__builtin_ctzll(mask) / KSTRING_MASK_BITS;
+}
+
+// Reads the block at p. Near the end of a page, only up to the terminator is read, and the rest is zero.
+KSTRING_NO_ASAN KINLINE kblock block_read(const char* p) {
+    if (((u64)p & (KSTRING_PAGE_SIZE - 1)) <= KSTRING_PAGE_SIZE - KSTRING_BLOCK_SIZE) {
+        return block_load(p);
+    }
+    char bytes[KSTRING_BLOCK_SIZE] = {0};
+    for (u32 i = 0; i < KSTRING_BLOCK_SIZE && p[i]; ++i) {
+        bytes[i] = p[i];
+    }
+    return block_load(bytes);
 }
+
+KSTRING_NO_ASAN u64 string_length(const char* str) {
+    // Aligned blocks never cross a page. The first starts before str, so the bytes ahead of it are shifted out.
+    u64 offset = (u64)str & (KSTRING_BLOCK_SIZE - 1);
+    const char* p = str - offset;
+    u64 zeros = block_zero_mask(block_load(p)) >> (offset * KSTRING_MASK_BITS);
+    if (zeros) {
+        return mask_first(zeros);
+    }
+    for (;;) {
+        p += KSTRING_BLOCK_SIZE;
+        zeros = block_zero_mask(block_load(p));
+        if (zeros) {
+            return (u64)(p - str) + mask_first(zeros);
+        }
+    }
+}
+
 char* string_duplicate(const char* str) {
     u64 length = string_length(str);
     char* copy = kallocate(length + 1, MEMORY_TAG_STRING);
@@ -20,20 +221,85 @@ char* string_duplicate(const char* str) {
     return copy;
 }
 
-// Case-sensitive string comparison. True if the same, otherwise false.
-b8 strings_equal(const char* str0, const char* str1) {
-    return strcmp(str0, str1) == 0;
+KSTRING_NO_ASAN KINLINE b8 blocks_equal(const char* str0, const char* str1, b8 fold) {
+    for (u64 i = 0;; i += KSTRING_BLOCK_SIZE) {
+        kblock a = block_read(str0 + i);
+        kblock b = block_read(str1 + i);
+        if (fold) {
+            a = block_fold(a);
+            b = block_fold(b);
+        }
+        u64 diff = block_diff_mask(a, b);
+        u64 zeros = block_zero_mask(a);
+        if (zeros) {
+            // Only the bytes up to and including str0's terminator count.
+            return (diff & (zeros ^ (zeros - 1))) == 0;
+        }
+        if (diff) {
+            return false;
+        }
+    }
 }
 
 // Case-sensitive string comparison. True if the same, otherwise false.
-b8 strings_equali(const char* str0, const char* str1) {
-#if defined(__GNUC__)
-    return strcasecmp(str0, str1) ==0;
-#elif (defined _MSC_VER)
-    return _strcmpi(str0, str1) == 0;
+KSTRING_NO_ASAN b8 strings_equal(const char* str0, const char* str1) {
+    return blocks_equal(str0, str1, false);
+}
+
+// Case-insensitive string comparison. True if the same, otherwise false.
+KSTRING_NO_ASAN b8 strings_equali(const char* str0, const char* str1) {
+    return blocks_equal(str0, str1, true);
+}
+
+// wyhash's secrets; odd, with half their bits set.
+#define KSTRING_HASH_SECRET0 0xa0761d6478bd642fULL
+#define KSTRING_HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define KSTRING_HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+
+// Multiplies to 128 bits and folds the halves together.
+KINLINE u64 hash_mix(u64 a, u64 b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)a * b;
+    return (u64)product ^ (u64)(product >> 64);
+#else
+    u64 a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+    u64 b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+    u64 low_low = a_low * b_low, low_high = a_low * b_high;
+    u64 high_low = a_high * b_low, high_high = a_high * b_high;
+    u64 middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+    u64 low = (low_low & 0xFFFFFFFF) | (middle << 32);
+    u64 high = high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+    return low ^ high;
 #endif
 }
 
+KSTRING_NO_ASAN KINLINE u64 blocks_hash(const char* str, b8 fold) {
+    u64 seed = KSTRING_HASH_SECRET0;
+    for (u64 length = 0;; length += KSTRING_BLOCK_SIZE) {
+        kblock block = block_read(str + length);
+        if (fold) {
+            block = block_fold(block);
+        }
+        u64 zeros = block_zero_mask(block);
+        if (zeros) {
+            // Whatever follows the terminator is dropped, so the last block is zero padded.
+            u32 count = mask_first(zeros);
+            block = block_keep(block, count);
+            seed = hash_mix(block_low(block) ^ KSTRING_HASH_SECRET1, block_high(block) ^ seed);
+            return hash_mix(seed ^ KSTRING_HASH_SECRET2, (length + count) ^ KSTRING_HASH_SECRET1);
+        }
+        seed = hash_mix(block_low(block) ^ KSTRING_HASH_SECRET1, block_high(block) ^ seed);
+    }
+}
+
+KSTRING_NO_ASAN u64 string_hash(const char* str) {
+    return blocks_hash(str, false);
+}
+
+KSTRING_NO_ASAN u64 string_hashi(const char* str) {
+    return blocks_hash(str, true);
+}
+
 i32 string_format(char* dest, const char* format, ...) {
     if (dest) {
         __builtin_va_list arg_ptr;
@@ -47,17 +313,30 @@ i32 string_format(char* dest, const char* format, ...) {
 
 i32 string_format_v(char* dest, const char* format, void* va_listp) {
     if (dest) {
-        // Big, but can fit on the stack.
-        char buffer[32000];
-        i32 written = vsnprintf(buffer, 32000, format, va_listp);
-        buffer[written] = 0;
-        kcopy_memory(dest, buffer, written + 1);
+        // Straight into dest, which is trusted to be big enough.
+        return vsprintf(dest, format, va_listp);
+    }
+    return -1;
+}
 
+i32 string_format_n(char* dest, u64 dest_size, const char* format, ...) {
+    if (dest) {
+        __builtin_va_list arg_ptr;
+        va_start(arg_ptr, format);
+        i32 written = string_format_n_v(dest, dest_size, format, arg_ptr);
+        va_end(arg_ptr);
         return written;
     }
     return -1;
 }
 
+i32 string_format_n_v(char* dest, u64 dest_size, const char* format, void* va_listp) {
+    if (dest && dest_size > 0) {
+        return vsnprintf(dest, dest_size, format, va_listp);
+    }
+    return -1;
+}
+
 char* string_copy(char* dest, const char* source) {
     return strcpy(dest, source);
 }
@@ -124,14 +403,294 @@ i32 string_index_of(char* str, char c) {
     return -1;
 }
 
+// Number parsing. Decimal digits are read by hand, and converted with a single
+// exact multiply or divide where the result is sure to be correctly rounded. The
+// rare numbers where it is not (more than 19 digits, huge exponents, inf, nan)
+// go through strtod. Either way, nothing depends on the locale or allocates.
+
+KINLINE b8 is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+KINLINE b8 is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Every power of ten f64 holds exactly.
+static const f64 exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Largest integer below which every integer is exact in f64.
+#define F64_EXACT_INTEGER_LIMIT (1ULL << 53)
+
+/**
+ * Reads a decimal number as mantissa * 10^exponent, without converting it. Returns
+ * false if there was no number, or it has too many digits to hold exactly.
+ */
+static b8 scan_decimal(const char* str, const char** out_end, b8* out_negative, u64* out_mantissa, i64* out_exponent) {
+    const char* p = str;
+    *out_negative = false;
+    if (*p == '-' || *p == '+') {
+        *out_negative = *p == '-';
+        p++;
+    }
+
+    u64 mantissa = 0;
+    i64 exponent = 0;
+    u32 digits = 0;
+    u32 significant = 0;
+    for (; is_digit(*p); ++p, ++digits) {
+        // Leading zeros do not count towards the 19 digits a u64 holds.
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (u64)(*p - '0');
+            significant += mantissa != 0;
+        } else {
+            return false;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        for (; is_digit(*p); ++p, ++digits) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (u64)(*p - '0');
+                significant += mantissa != 0;
+                exponent--;
+            } else if (*p != '0') {
+                return false;
+            }
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+
+    // Only an exponent if digits follow; otherwise the 'e' is not part of the number.
+    if (*p == 'e' || *p == 'E') {
+        const char* e = p + 1;
+        b8 negative_exponent = false;
+        if (*e == '-' || *e == '+') {
+            negative_exponent = *e == '-';
+            e++;
+        }
+        if (is_digit(*e)) {
+            i64 value = 0;
+            for (; is_digit(*e); ++e) {
+                // Far beyond any f64, and short of overflowing.
+                if (value < 100000) {
+                    value = value * 10 + (*e - '0');
+                }
+            }
+            exponent += negative_exponent ? -value : value;
+            p = e;
+        }
+    }
+
+    *out_end = p;
+    *out_mantissa = mantissa;
+    *out_exponent = exponent;
+    return true;
+}
+
+/**
+ * Converts mantissa * 10^exponent with one rounding, where that is possible. Both are
+ * then exact in f64, so IEEE arithmetic rounds the result correctly.
+ */
+static b8 exact_decimal_to_f64(u64 mantissa, i64 exponent, f64* out_value) {
+    if (mantissa == 0) {
+        *out_value = 0.0;
+        return true;
+    }
+    if (mantissa > F64_EXACT_INTEGER_LIMIT) {
+        return false;
+    }
+    f64 value = (f64)mantissa;
+    if (exponent < 0) {
+        if (exponent < -22) {
+            return false;
+        }
+        *out_value = value / exact_powers_of_ten[-exponent];
+        return true;
+    }
+    if (exponent > 22) {
+        // i.e. 12e25; the mantissa can take some of the exponent while staying exact.
+        i64 shifted = exponent - 22;
+        if (shifted > 15) {
+            return false;
+        }
+        u64 scaled = mantissa;
+        for (i64 i = 0; i < shifted; ++i) {
+            // Checked before each step, as a u64 would wrap long before the loop ends.
+            if (scaled > F64_EXACT_INTEGER_LIMIT / 10) {
+                return false;
+            }
+            scaled *= 10;
+        }
+        value = (f64)scaled;
+        exponent = 22;
+    }
+    *out_value = value * exact_powers_of_ten[exponent];
+    return true;
+}
+
+static b8 parse_f64(const char* str, const char** out_end, f64* out_value) {
+    while (is_space(*str)) {
+        str++;
+    }
+    b8 negative;
+    u64 mantissa;
+    i64 exponent;
+    if (scan_decimal(str, out_end, &negative, &mantissa, &exponent) && exact_decimal_to_f64(mantissa, exponent, out_value)) {
+        if (negative) {
+            *out_value = -*out_value;
+        }
+        return true;
+    }
+
+    char* end;
+    *out_value = strtod(str, &end);
+    *out_end = end;
+    return end != str;
+}
+
+static b8 parse_f32(const char* str, const char** out_end, f32* out_value) {
+    while (is_space(*str)) {
+        str++;
+    }
+    b8 negative;
+    u64 mantissa;
+    i64 exponent;
+    f64 exact;
+    if (scan_decimal(str, out_end, &negative, &mantissa, &exponent) && exact_decimal_to_f64(mantissa, exponent, &exact)) {
+        // Rounding the (correctly rounded) f64 again is only wrong when it landed exactly
+        // halfway between two f32s, as every such point is itself an f64.
+        union {
+            f32 f;
+            u32 u;
+        } rounded, neighbour;
+        rounded.f = (f32)exact;
+        b8 ambiguous = false;
+        if ((f64)rounded.f != exact) {
+            if ((rounded.u & 0x7F800000) == 0x7F800000) {
+                // Overflowed; let strtof decide what is close enough to FLT_MAX.
+                ambiguous = true;
+            } else {
+                // Both are positive here, and the next f32 up is one up in its bits.
+                neighbour.u = exact > rounded.f ? rounded.u + 1 : rounded.u - 1;
+                ambiguous = ((f64)rounded.f + (f64)neighbour.f) * 0.5 == exact;
+            }
+        }
+        if (!ambiguous) {
+            *out_value = negative ? -rounded.f : rounded.f;
+            return true;
+        }
+    }
+
+    char* end;
+    *out_value = strtof(str, &end);
+    *out_end = end;
+    return end != str;
+}
+
+// Reads an unsigned decimal or 0x prefixed hexadecimal integer, failing on overflow.
+static b8 parse_magnitude(const char* p, const char** out_end, u64* out_value) {
+    u64 value = 0;
+    const char* start;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+        start = p;
+        for (;; ++p) {
+            u32 digit;
+            if (is_digit(*p)) {
+                digit = (u32)(*p - '0');
+            } else if (*p >= 'a' && *p <= 'f') {
+                digit = (u32)(*p - 'a' + 10);
+            } else if (*p >= 'A' && *p <= 'F') {
+                digit = (u32)(*p - 'A' + 10);
+            } else {
+                break;
+            }
+            if (value >> 60) {
+                return false;
+            }
+            value = (value << 4) | digit;
+        }
+    } else {
+        start = p;
+        for (; is_digit(*p); ++p) {
+            u64 digit = (u64)(*p - '0');
+            if (value > (0xFFFFFFFFFFFFFFFFULL - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+    }
+    *out_end = p;
+    *out_value = value;
+    return p != start;
+}
+
+static b8 parse_signed(const char* str, i64 min, i64 max, i64* out_value) {
+    while (is_space(*str)) {
+        str++;
+    }
+    b8 negative = *str == '-';
+    if (*str == '-' || *str == '+') {
+        str++;
+    }
+    const char* end;
+    u64 magnitude;
+    if (!parse_magnitude(str, &end, &magnitude)) {
+        return false;
+    }
+    if (negative) {
+        // -min does not fit in i64 when min is the smallest i64, so it is compared as unsigned.
+        if (magnitude > (u64)(-(min + 1)) + 1) {
+            return false;
+        }
+        *out_value = magnitude == 0 ? 0 : (i64)(0 - magnitude);
+    } else {
+        if (magnitude > (u64)max) {
+            return false;
+        }
+        *out_value = (i64)magnitude;
+    }
+    return true;
+}
+
+static b8 parse_unsigned(const char* str, u64 max, u64* out_value) {
+    while (is_space(*str)) {
+        str++;
+    }
+    if (*str == '+') {
+        str++;
+    }
+    const char* end;
+    u64 value;
+    if (!parse_magnitude(str, &end, &value) || value > max) {
+        return false;
+    }
+    *out_value = value;
+    return true;
+}
+
+// Reads count space-delimited floats.
+static b8 parse_f32s(const char* str, u32 count, f32* out_values) {
+    for (u32 i = 0; i < count; ++i) {
+        if (!parse_f32(str, &str, &out_values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 b8 string_to_vec4(char* str, vec4* out_vector) {
     if (!str) {
         return false;
     }
 
     kzero_memory(out_vector, sizeof(vec4));
-    i32 result = sscanf(str, "%f %f %f %f", &out_vector->x, &out_vector->y, &out_vector->z, &out_vector->w);
-    return result != -1;
+    return parse_f32s(str, 4, out_vector->elements);
 }
 
 b8 string_to_vec3(char* str, vec3* out_vector) {
@@ -140,8 +699,7 @@ b8 string_to_vec3(char* str, vec3* out_vector) {
     }
 
     kzero_memory(out_vector, sizeof(vec3));
-    i32 result = sscanf(str, "%f %f %f", &out_vector->x, &out_vector->y, &out_vector->z);
-    return result != -1;
+    return parse_f32s(str, 3, out_vector->elements);
 }
 
 b8 string_to_vec2(char* str, vec2* out_vector) {
@@ -150,8 +708,7 @@ b8 string_to_vec2(char* str, vec2* out_vector) {
     }
 
     kzero_memory(out_vector, sizeof(vec2));
-    i32 result = sscanf(str, "%f %f", &out_vector->x, &out_vector->y);
-    return result != -1;
+    return parse_f32s(str, 2, out_vector->elements);
 }
 
 b8 string_to_f32(char* str, f32* f) {
@@ -160,8 +717,8 @@ b8 string_to_f32(char* str, f32* f) {
     }
 
     *f = 0;
-    i32 result = sscanf(str, "%f", f);
-    return result != -1;
+    const char* end;
+    return parse_f32(str, &end, f);
 }
 
 b8 string_to_f64(char* str, f64* f) {
@@ -170,8 +727,8 @@ b8 string_to_f64(char* str, f64* f) {
     }
 
     *f = 0;
-    i32 result = sscanf(str, "%lf", f);
-    return result != -1;
+    const char* end;
+    return parse_f64(str, &end, f);
 }
 
 b8 string_to_i8(char* str, i8* i) {
@@ -180,8 +737,12 @@ b8 string_to_i8(char* str, i8* i) {
     }
 
     *i = 0;
-    i32 result = sscanf(str, "%hhi", i);
-    return result != -1;
+    i64 value;
+    if (!parse_signed(str, -128, 127, &value)) {
+        return false;
+    }
+    *i = (i8)value;
+    return true;
 }
 
 b8 string_to_i16(char* str, i16* i) {
@@ -190,8 +751,12 @@ b8 string_to_i16(char* str, i16* i) {
     }
 
     *i = 0;
-    i32 result = sscanf(str, "%hi", i);
-    return result != -1;
+    i64 value;
+    if (!parse_signed(str, -32768, 32767, &value)) {
+        return false;
+    }
+    *i = (i16)value;
+    return true;
 }
 
 b8 string_to_i32(char* str, i32* i) {
@@ -200,8 +765,12 @@ b8 string_to_i32(char* str, i32* i) {
     }
 
     *i = 0;
-    i32 result = sscanf(str, "%i", i);
-    return result != -1;
+    i64 value;
+    if (!parse_signed(str, -2147483647LL - 1, 2147483647LL, &value)) {
+        return false;
+    }
+    *i = (i32)value;
+    return true;
 }
 
 b8 string_to_i64(char* str, i64* i) {
@@ -210,8 +779,7 @@ b8 string_to_i64(char* str, i64* i) {
     }
 
     *i = 0;
-    i32 result = sscanf(str, "%lli", i);
-    return result != -1;
+    return parse_signed(str, -9223372036854775807LL - 1, 9223372036854775807LL, i);
 }
 
 b8 string_to_u8(char* str, u8* u) {
@@ -220,8 +788,12 @@ b8 string_to_u8(char* str, u8* u) {
     }
 
     *u = 0;
-    i32 result = sscanf(str, "%hhu", u);
-    return result != -1;
+    u64 value;
+    if (!parse_unsigned(str, 0xFF, &value)) {
+        return false;
+    }
+    *u = (u8)value;
+    return true;
 }
 
 b8 string_to_u16(char* str, u16* u) {
@@ -230,8 +802,12 @@ b8 string_to_u16(char* str, u16* u) {
     }
 
     *u = 0;
-    i32 result = sscanf(str, "%hu", u);
-    return result != -1;
+    u64 value;
+    if (!parse_unsigned(str, 0xFFFF, &value)) {
+        return false;
+    }
+    *u = (u16)value;
+    return true;
 }
 
 b8 string_to_u32(char* str, u32* u) {
@@ -240,8 +816,12 @@ b8 string_to_u32(char* str, u32* u) {
     }
 
     *u = 0;
-    i32 result = sscanf(str, "%u", u);
-    return result != -1;
+    u64 value;
+    if (!parse_unsigned(str, 0xFFFFFFFF, &value)) {
+        return false;
+    }
+    *u = (u32)value;
+    return true;
 }
 
 b8 string_to_u64(char* str, u64* u) {
@@ -250,8 +830,7 @@ b8 string_to_u64(char* str, u64* u) {
     }
 
     *u = 0;
-    i32 result = sscanf(str, "%llu", u);
-    return result != -1;
+    return parse_unsigned(str, 0xFFFFFFFFFFFFFFFFULL, u);
 }
 
 b8 string_to_bool(char* str, b8* b) {
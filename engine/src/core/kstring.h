@@ -13,19 +13,58 @@ KAPI b8 strings_equal(const char* str0, const char* str1);
 // Case-insensitive string comparison. True if the same, otherwise false.
 KAPI b8 strings_equali(const char* str0, const char* str1);
 
+/**
+ * @brief Hashes a string. Reads 16 bytes per step, wyhash style; much faster than hashing
+ * byte by byte. The same on every platform and backend, so hashes can be stored. Not for security.
+ *
+ * @param str The string to hash.
+ * @return u64 The hash.
+ */
+KAPI u64 string_hash(const char* str);
+
+/**
+ * @brief As string_hash, but ignoring case, so strings equal by strings_equali hash the
+ * same. A lowercase string hashes as it does with string_hash.
+ *
+ * @param str The string to hash.
+ * @return u64 The hash.
+ */
+KAPI u64 string_hashi(const char* str);
+
 // Performs string formatting to dest given format string and parameters.
+// dest must be big enough for the result; prefer string_format_n where its size is known.
 KAPI i32 string_format(char* dest, const char* format, ...);
 
 //
 /**
  * Performs variadic string formatting to dest given format string and va_list.
- * @param dest The destination for the formatted string.
+ * @param dest The destination for the formatted string. Must be big enough for the result.
  * @param format The string to be formatted.
  * @param va_list The variadic argument list.
  * @returns The size of the data written.
  */
 KAPI i32 string_format_v(char* dest, const char* format, void* va_list);
 
+/**
+ * Performs string formatting to dest, writing at most dest_size bytes (including
+ * the terminator) straight into it. Always terminated, even if cut short.
+ * @param dest The destination for the formatted string.
+ * @param dest_size The size of dest, in bytes.
+ * @param format The string to be formatted.
+ * @returns The length of the whole formatted string; if it is dest_size or more, the output was cut short. -1 on error.
+ */
+KAPI i32 string_format_n(char* dest, u64 dest_size, const char* format, ...);
+
+/**
+ * Performs variadic string formatting to dest, writing at most dest_size bytes. See string_format_n.
+ * @param dest The destination for the formatted string.
+ * @param dest_size The size of dest, in bytes.
+ * @param format The string to be formatted.
+ * @param va_list The variadic argument list.
+ * @returns The length of the whole formatted string; if it is dest_size or more, the output was cut short. -1 on error.
+ */
+KAPI i32 string_format_n_v(char* dest, u64 dest_size, const char* format, void* va_list);
+
 KAPI char* string_copy(char* dest, const char* source);
 
 KAPI char* string_ncopy(char* dest, const char* source, i64 length);
@@ -43,6 +82,14 @@ KAPI void string_mid(char* dest, const char* source, i32 start, i32 length);
  */
 KAPI i32 string_index_of(char* str, char c);
 
+/*
+ * Number parsing skips leading whitespace and stops at the first character which is not
+ * part of the number. Floats are correctly rounded, so printing one with enough digits
+ * (%.9g for f32, %.17g for f64) and parsing it back gives the same value. Integers may
+ * be decimal or 0x prefixed hexadecimal, and fail when out of range for their type.
+ * None depend on the locale.
+ */
+
 /**
  * @brief Attempts to parse a vector from the provided string.
  * 
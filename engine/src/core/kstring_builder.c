@@ -0,0 +1,148 @@
+#include "core/kstring_builder.h"
+
+#include "core/kmemory.h"
+#include "core/kstring.h"
+
+#include <stdarg.h>
+
+// Makes room for a string of required bytes, terminator included.
+static void grow(kstring_builder* builder, u64 required) {
+    if (required <= builder->capacity) {
+        return;
+    }
+    // Doubles, so a string built one append at a time is copied O(log n) times.
+    u64 capacity = builder->capacity * 2;
+    if (capacity < required) {
+        capacity = required;
+    }
+
+    linear_allocator* allocator = builder->allocator;
+    if (allocator && allocator->memory) {
+        u8* start = allocator->memory;
+        u8* top = start + allocator->allocated;
+        u64 remaining = allocator->total_size - allocator->allocated;
+        // Still the allocator's latest allocation, so it is extended where it is without a copy.
+        if ((u8*)builder->data >= start && (u8*)builder->data + builder->capacity == top) {
+            u64 extra = capacity - builder->capacity;
+            if (extra > remaining) {
+                extra = required - builder->capacity;
+            }
+            if (extra <= remaining) {
+                allocator->allocated += extra;
+                builder->capacity += extra;
+                return;
+            }
+        }
+        // Leaves room for the allocator to align it.
+        if (capacity + LINEAR_ALLOCATOR_MAX_ALIGNMENT > remaining) {
+            capacity = required;
+        }
+        if (capacity + LINEAR_ALLOCATOR_MAX_ALIGNMENT <= remaining) {
+            char* data = linear_allocator_allocate(allocator, capacity);
+            kcopy_memory(data, builder->data, builder->length + 1);
+            if (builder->owns_data) {
+                kfree(builder->data, builder->capacity, MEMORY_TAG_STRING);
+            }
+            builder->data = data;
+            builder->capacity = capacity;
+            builder->owns_data = false;
+            return;
+        }
+        // Out of room; the heap takes over rather than cutting the string short.
+    }
+
+    char* data = kallocate(capacity, MEMORY_TAG_STRING);
+    kcopy_memory(data, builder->data, builder->length + 1);
+    if (builder->owns_data) {
+        kfree(builder->data, builder->capacity, MEMORY_TAG_STRING);
+    }
+    builder->data = data;
+    builder->capacity = capacity;
+    builder->owns_data = true;
+}
+
+void string_builder_create(u64 initial_capacity, linear_allocator* allocator, kstring_builder* out_builder) {
+    // Starts out as an empty string with no memory of its own, which the first grow replaces.
+    static char empty = 0;
+    kzero_memory(out_builder, sizeof(kstring_builder));
+    out_builder->data = &empty;
+    out_builder->allocator = allocator;
+    grow(out_builder, initial_capacity ? initial_capacity : 1);
+}
+
+void string_builder_create_from_buffer(char* buffer, u64 buffer_size, linear_allocator* allocator, kstring_builder* out_builder) {
+    kzero_memory(out_builder, sizeof(kstring_builder));
+    out_builder->data = buffer;
+    out_builder->capacity = buffer_size;
+    out_builder->allocator = allocator;
+    buffer[0] = 0;
+}
+
+void string_builder_destroy(kstring_builder* builder) {
+    if (builder->owns_data) {
+        kfree(builder->data, builder->capacity, MEMORY_TAG_STRING);
+    }
+    kzero_memory(builder, sizeof(kstring_builder));
+}
+
+void string_builder_clear(kstring_builder* builder) {
+    builder->length = 0;
+    builder->data[0] = 0;
+}
+
+void string_builder_truncate(kstring_builder* builder, u64 length) {
+    if (length < builder->length) {
+        builder->length = length;
+        builder->data[length] = 0;
+    }
+}
+
+void string_builder_reserve(kstring_builder* builder, u64 additional) {
+    grow(builder, builder->length + additional + 1);
+}
+
+void string_builder_append(kstring_builder* builder, const char* str) {
+    string_builder_append_n(builder, str, string_length(str));
+}
+
+void string_builder_append_n(kstring_builder* builder, const char* str, u64 length) {
+    grow(builder, builder->length + length + 1);
+    kcopy_memory(builder->data + builder->length, str, length);
+    builder->length += length;
+    builder->data[builder->length] = 0;
+}
+
+void string_builder_append_char(kstring_builder* builder, char c) {
+    grow(builder, builder->length + 2);
+    builder->data[builder->length++] = c;
+    builder->data[builder->length] = 0;
+}
+
+b8 string_builder_appendf(kstring_builder* builder, const char* format, ...) {
+    __builtin_va_list args;
+    va_start(args, format);
+    b8 result = string_builder_appendf_v(builder, format, args);
+    va_end(args);
+    return result;
+}
+
+b8 string_builder_appendf_v(kstring_builder* builder, const char* format, __builtin_va_list args) {
+    // Kept in case the first attempt does not fit, as formatting uses the arguments up.
+    __builtin_va_list retry_args;
+    va_copy(retry_args, args);
+
+    u64 available = builder->capacity - builder->length;
+    i32 written = string_format_n_v(builder->data + builder->length, available, format, args);
+    if (written >= 0 && (u64)written >= available) {
+        grow(builder, builder->length + written + 1);
+        written = string_format_n_v(builder->data + builder->length, builder->capacity - builder->length, format, retry_args);
+    }
+    va_end(retry_args);
+
+    if (written < 0) {
+        builder->data[builder->length] = 0;
+        return false;
+    }
+    builder->length += written;
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "defines.h"
+#include "memory/linear_allocator.h"
+
+/**
+ * @brief Builds a string by appending to it, growing as needed. Formatted appends are
+ * written straight into the string, without going through a buffer of their own.
+ *
+ * It can start out in a caller's buffer, i.e. on the stack, and only grows into
+ * allocated memory once that is full. Memory is taken from a linear allocator, such
+ * as one reset every frame, or from the heap if none is given or it runs out. The
+ * string is always null terminated, so data can be passed wherever a string is expected.
+ */
+typedef struct kstring_builder {
+    // The string so far. Null terminated.
+    char* data;
+    // The length of the string, without the terminator.
+    u64 length;
+    // The size of data in bytes, terminator included.
+    u64 capacity;
+    // Where grown memory comes from; 0 for the heap.
+    linear_allocator* allocator;
+    // Set while data is memory the builder took from the heap, to be freed on destroy.
+    b8 owns_data;
+} kstring_builder;
+
+/**
+ * @brief Creates a string builder with memory of its own.
+ *
+ * @param initial_capacity The number of bytes to start with, terminator included.
+ * @param allocator The linear allocator to take memory from; 0 to use the heap.
+ * @param out_builder A pointer to hold the builder.
+ */
+KAPI void string_builder_create(u64 initial_capacity, linear_allocator* allocator, kstring_builder* out_builder);
+
+/**
+ * @brief Creates a string builder which starts out in the given buffer, i.e. on the
+ * stack, and only allocates if the string outgrows it. The buffer must outlive the builder.
+ *
+ * @param buffer The memory to start in.
+ * @param buffer_size The size of buffer in bytes. Must be at least 1.
+ * @param allocator The linear allocator to grow into; 0 to use the heap.
+ * @param out_builder A pointer to hold the builder.
+ */
+KAPI void string_builder_create_from_buffer(char* buffer, u64 buffer_size, linear_allocator* allocator, kstring_builder* out_builder);
+
+/**
+ * @brief Frees any memory the builder took from the heap. Memory taken from a linear
+ * allocator is left to be freed along with the rest of it.
+ */
+KAPI void string_builder_destroy(kstring_builder* builder);
+
+/** @brief Empties the string, keeping its memory. */
+KAPI void string_builder_clear(kstring_builder* builder);
+
+/** @brief Cuts the string back to its first length characters. Longer lengths leave it as it is. */
+KAPI void string_builder_truncate(kstring_builder* builder, u64 length);
+
+/** @brief Makes room for at least additional more characters, so a run of appends grows only once. */
+KAPI void string_builder_reserve(kstring_builder* builder, u64 additional);
+
+/** @brief Appends a string. */
+KAPI void string_builder_append(kstring_builder* builder, const char* str);
+
+/** @brief Appends length characters of a string, which need not be terminated. */
+KAPI void string_builder_append_n(kstring_builder* builder, const char* str, u64 length);
+
+/** @brief Appends a single character. */
+KAPI void string_builder_append_char(kstring_builder* builder, char c);
+
+/**
+ * @brief Appends a formatted string, as string_format would produce, written straight
+ * into the builder. It is formatted a second time only if it has to grow first.
+ *
+ * @return b8 True on success; false if the format could not be applied, leaving the string as it was.
+ */
+KAPI b8 string_builder_appendf(kstring_builder* builder, const char* format, ...);
+
+/** @brief As string_builder_appendf, taking a va_list. */
+KAPI b8 string_builder_appendf_v(kstring_builder* builder, const char* format, __builtin_va_list args);
@@ -2,11 +2,27 @@
 #include "asserts.h"
 #include "platform/platform.h"
 #include "platform/filesystem.h"
+#include "platform/kmutex.h"
 #include "core/kstring.h"
+#include "core/kstring_builder.h"
 #include "core/kmemory.h"
 
 // TODO: temporary
 #include <stdarg.h>
+#include <stdio.h>
+
+// Size of the buffer text lines are gathered in before being written to console.log.
+#define LOG_TEXT_BUFFER_SIZE 16384
+// Size of the buffer binary records are gathered in before being written to disk.
+#define LOG_BINARY_BUFFER_SIZE 65536
+// Maximum number of distinct format strings in a binary log.
+#define LOG_BINARY_MAX_FORMATS 4096
+// Size of the format lookup table. Must be a power of 2, larger than LOG_BINARY_MAX_FORMATS.
+#define LOG_BINARY_LOOKUP_SIZE 8192
+// Maximum size of the packed arguments of a single message.
+#define LOG_BINARY_MAX_ARGUMENT_SIZE 2048
+// Format id reserved for messages which are logged pre-formatted as a single string.
+#define LOG_BINARY_FORMAT_ID_STRING 0
 
 void report_assertion_failure(const char* expression, const char* message, const char* file, i32 line)
 {
@@ -14,17 +30,77 @@ void report_assertion_failure(const char* expression, const char* message, const
 }
 
 typedef struct logger_system_state {
+    // Jobs log from worker threads, so everything below is only touched with this held.
+    kmutex write_mutex;
+
     file_handle log_file_handle;
+    file_writer log_writer;
+
+    b8 binary_mode;
+    file_handle binary_file_handle;
+    file_writer binary_writer;
+
+    // Registered format strings, indexed by format id.
+    u32 format_count;
+    const char* formats[LOG_BINARY_MAX_FORMATS];
+    // Open-addressed lookup from format string pointer to format id + 1 (0 is empty).
+    u32 format_lookup[LOG_BINARY_LOOKUP_SIZE];
+
+    u8 log_buffer[LOG_TEXT_BUFFER_SIZE];
+    u8 binary_buffer[LOG_BINARY_BUFFER_SIZE];
 } logger_system_state;
 
 static logger_system_state* state_ptr;
 
-void append_to_log_file(const char* message) {
+// Runtime thresholds. Not part of the state so they can be set before the logger starts.
+u8 log_channel_levels[LOG_CHANNEL_MAX] = {
+    LOG_CHANNEL_GENERAL_LEVEL,
+    LOG_CHANNEL_RENDERER_LEVEL,
+    LOG_CHANNEL_VULKAN_LEVEL,
+    LOG_CHANNEL_TEXTURE_LEVEL,
+    LOG_CHANNEL_MATERIAL_LEVEL,
+    LOG_CHANNEL_INPUT_LEVEL,
+    LOG_CHANNEL_MEMORY_LEVEL};
+
+static const char* channel_names[LOG_CHANNEL_MAX] = {
+    "general",
+    "renderer",
+    "vulkan",
+    "texture",
+    "material",
+    "input",
+    "memory"};
+
+typedef enum log_argument_type {
+    LOG_ARGUMENT_NONE,
+    LOG_ARGUMENT_I32,
+    LOG_ARGUMENT_I64,
+    LOG_ARGUMENT_F64,
+    LOG_ARGUMENT_STRING,
+    LOG_ARGUMENT_POINTER
+} log_argument_type;
+
+// A single conversion specification within a format string, i.e. "%-8.3f".
+typedef struct log_format_spec {
+    // Points at the '%'.
+    const char* start;
+    // Flags, width and precision, without the length modifier or conversion.
+    u32 prefix_length;
+    // Number of '*' width/precision arguments consumed before the value.
+    u8 star_count;
+    char conversion;
+    log_argument_type type;
+} log_format_spec;
+
+static void log_write_text(log_channel channel, log_level level, const char* message, __builtin_va_list args);
+static void log_write_binary(log_channel channel, log_level level, u32* format_id, const char* message, __builtin_va_list args);
+
+void append_to_log_file(const char* message, b8 flush) {
     if (state_ptr && state_ptr->log_file_handle.is_valid) {
         // Since the message already contains a '\n', just write the bytes directly.
         u64 length = string_length(message);
-        u64 written = 0;
-        if (!filesystem_write(&state_ptr->log_file_handle, length, message, &written)) {
+        if (!filesystem_writer_write(&state_ptr->log_writer, length, message) ||
+            (flush && !filesystem_writer_flush(&state_ptr->log_writer))) {
             platform_console_write_error("ERROR writing to console.log.", LOG_LEVEL_ERROR);
         }
     }
@@ -36,6 +112,12 @@ b8 initialize_logging(u64* memory_requirement, void* state) {
         return true;
     }
 
+    kzero_memory(state, sizeof(logger_system_state));
+    // Created before the logger is in use, as a failure here is itself logged.
+    if (!kmutex_create(&((logger_system_state*)state)->write_mutex)) {
+        platform_console_write_error("ERROR: Unable to create the logger's mutex.", LOG_LEVEL_ERROR);
+        return false;
+    }
     state_ptr = state;
 
     // Create new/wipe existing log file, then open it.
@@ -43,6 +125,11 @@ b8 initialize_logging(u64* memory_requirement, void* state) {
         platform_console_write_error("ERROR: Unable to open console.log for writing.", LOG_LEVEL_ERROR);
         return false;
     }
+    filesystem_writer_create(&state_ptr->log_file_handle, LOG_TEXT_BUFFER_SIZE, state_ptr->log_buffer, &state_ptr->log_writer);
+
+    if (LOG_BINARY_MODE_DEFAULT && !logger_binary_mode_set(true)) {
+        platform_console_write_error("ERROR: Unable to start binary logging, falling back to text.", LOG_LEVEL_ERROR);
+    }
 
     // TODO: Remove this
     KFATAL("A test message: %f", 3.14f);
@@ -52,45 +139,554 @@ b8 initialize_logging(u64* memory_requirement, void* state) {
     KDEBUG("A test message: %f", 3.14f);
     KTRACE("A test message: %f", 3.14f);
 
-	// TODO: create log file.
 	return true;
 }
 void shutdown_logging(void * state)
 {
-	// TODO: cleanup logging/write queued logs
+    if (state_ptr) {
+        logger_binary_mode_set(false);
+        logger_system_state* old_state = state_ptr;
+        kmutex_lock(&old_state->write_mutex);
+        filesystem_writer_destroy(&old_state->log_writer);
+        filesystem_close(&old_state->log_file_handle);
+        state_ptr = 0;
+        kmutex_unlock(&old_state->write_mutex);
+        kmutex_destroy(&old_state->write_mutex);
+    }
 	state_ptr = 0;
 }
 
+static void log_write(log_channel channel, log_level level, u32* format_id, const char* message, __builtin_va_list args) {
+    // Before the logger starts, lines only go to the console, which needs no lock.
+    logger_system_state* state = state_ptr;
+    if (!state) {
+        log_write_text(channel, level, message, args);
+        return;
+    }
+
+    kmutex_lock(&state->write_mutex);
+    if (state->binary_mode) {
+        log_write_binary(channel, level, format_id, message, args);
+    } else {
+        log_write_text(channel, level, message, args);
+    }
+    kmutex_unlock(&state->write_mutex);
+}
+
 void log_output(log_level level, const char* message, ...) {
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, message);
+    log_write(LOG_CHANNEL_GENERAL, level, 0, message, arg_ptr);
+    va_end(arg_ptr);
+}
+
+void log_output_channel(log_channel channel, log_level level, u32* format_id, const char* message, ...) {
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, message);
+    log_write(channel, level, format_id, message, arg_ptr);
+    va_end(arg_ptr);
+}
+
+void log_channel_level_set(log_channel channel, log_level level) {
+    if (channel < LOG_CHANNEL_MAX) {
+        log_channel_levels[channel] = (u8)level;
+    }
+}
+
+log_level log_channel_level_get(log_channel channel) {
+    return channel < LOG_CHANNEL_MAX ? (log_level)log_channel_levels[channel] : LOG_LEVEL_TRACE;
+}
+
+const char* log_channel_name(log_channel channel) {
+    return channel < LOG_CHANNEL_MAX ? channel_names[channel] : "unknown";
+}
+
+static void log_write_text(log_channel channel, log_level level, const char* message, __builtin_va_list args) {
 	// TODO: These string operations are all pretty slow. This needs to be
     // moved to another thread eventually, along with the file writes, to
     // avoid slowing things down while the engine is trying to run.
 	const char* level_str[6] = {
-		"[FATAL]: ",
-		"[ERROR]: ",
-		"[WARN]: ",
-		"[INFO]: ",
-		"[DEBUG]: ",
-		"[TRACE]: "
+		"[FATAL]",
+		"[ERROR]",
+		"[WARN]",
+		"[INFO]",
+		"[DEBUG]",
+		"[TRACE]"
 	};
 	b8 is_error = level < LOG_LEVEL_WARN;
 
-	char out_message[32000];
-    kzero_memory(out_message, sizeof(out_message));
-
-	__builtin_va_list arg_ptr;
-	va_start(arg_ptr, message);
-	string_format_v(out_message, message, arg_ptr);
-	va_end(arg_ptr);
+	// Most lines fit on the stack. Longer ones grow onto the heap rather than being cut short.
+	char line_buffer[2048];
+	kstring_builder line;
+	string_builder_create_from_buffer(line_buffer, sizeof(line_buffer), 0, &line);
 
-	// Prepend log level to message.
-    string_format(out_message, "%s%s\n", level_str[level], out_message);
+	// Log level and channel first, then the message formatted straight in after them. The general channel is left implicit.
+    if (channel == LOG_CHANNEL_GENERAL) {
+        string_builder_appendf(&line, "%s: ", level_str[level]);
+    } else {
+        string_builder_appendf(&line, "%s[%s]: ", level_str[level], channel_names[channel]);
+    }
+    string_builder_appendf_v(&line, message, args);
+    string_builder_append_char(&line, '\n');
 
 	if (is_error) {
-		platform_console_write_error(out_message, level);
+		platform_console_write_error(line.data, level);
 	} else {
-		platform_console_write(out_message, level);
+		platform_console_write(line.data, level);
 	}
 
-	append_to_log_file(out_message);
+	// Errors go to disk right away in case of a crash. Everything else waits for logger_flush.
+	append_to_log_file(line.data, is_error);
+	string_builder_destroy(&line);
+}
+
+// Binary logging
+
+static void binary_flush() {
+    if (!filesystem_writer_flush(&state_ptr->binary_writer)) {
+        platform_console_write_error("ERROR writing to console.klog.", LOG_LEVEL_ERROR);
+    }
+}
+
+static void binary_append(const void* data, u64 size) {
+    if (!filesystem_writer_write(&state_ptr->binary_writer, size, data)) {
+        platform_console_write_error("ERROR writing to console.klog.", LOG_LEVEL_ERROR);
+    }
+}
+
+static u32 format_lookup_index(const char* format) {
+    // Fibonacci hash of the pointer value. Format strings are literals, so their address is their identity.
+    u64 key = (u64)format >> 3;
+    return (u32)((key * 11400714819323198485llu) >> 51) & (LOG_BINARY_LOOKUP_SIZE - 1);
+}
+
+static u32 binary_register_format(const char* format) {
+    u32 id = state_ptr->format_count++;
+    state_ptr->formats[id] = format;
+
+    u32 index = format_lookup_index(format);
+    while (state_ptr->format_lookup[index] != 0) {
+        index = (index + 1) & (LOG_BINARY_LOOKUP_SIZE - 1);
+    }
+    state_ptr->format_lookup[index] = id + 1;
+
+    // Tell the decoder about the new format.
+    u32 length = (u32)string_length(format);
+    u8 record_header[9];
+    record_header[0] = LOG_BINARY_RECORD_FORMAT;
+    kcopy_memory(record_header + 1, &id, sizeof(u32));
+    kcopy_memory(record_header + 5, &length, sizeof(u32));
+    binary_append(record_header, sizeof(record_header));
+    binary_append(format, length);
+    return id;
+}
+
+static u32 binary_format_id(const char* format, u32* cached_id) {
+    // Fast path: the call site already knows its id.
+    if (cached_id && *cached_id < state_ptr->format_count && state_ptr->formats[*cached_id] == format) {
+        return *cached_id;
+    }
+
+    u32 index = format_lookup_index(format);
+    while (state_ptr->format_lookup[index] != 0) {
+        u32 id = state_ptr->format_lookup[index] - 1;
+        if (state_ptr->formats[id] == format) {
+            if (cached_id) {
+                *cached_id = id;
+            }
+            return id;
+        }
+        index = (index + 1) & (LOG_BINARY_LOOKUP_SIZE - 1);
+    }
+
+    if (state_ptr->format_count >= LOG_BINARY_MAX_FORMATS) {
+        return INVALID_ID;
+    }
+
+    u32 id = binary_register_format(format);
+    if (cached_id) {
+        *cached_id = id;
+    }
+    return id;
+}
+
+/**
+ * Parses the next conversion specification from format. Literal text and "%%" are skipped.
+ * Returns a pointer just past the specification, or 0 if there are no more.
+ */
+static const char* log_next_spec(const char* format, log_format_spec* out_spec) {
+    const char* p = format;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+
+        out_spec->start = p;
+        out_spec->star_count = 0;
+        p++;
+
+        // Flags, width and precision.
+        while (*p && (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '.' || *p == '*' || (*p >= '1' && *p <= '9'))) {
+            if (*p == '*') {
+                out_spec->star_count++;
+            }
+            p++;
+        }
+        out_spec->prefix_length = (u32)(p - out_spec->start);
+
+        // Length modifier.
+        b8 is_64 = false;
+        while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'j' || *p == 'z' || *p == 't' || *p == 'q') {
+            if ((*p == 'l' && (p[1] == 'l' || sizeof(long) == 8)) || *p == 'j' || *p == 'z' || *p == 't' || *p == 'q') {
+                is_64 = true;
+            }
+            p++;
+        }
+
+        out_spec->conversion = *p;
+        switch (*p) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                out_spec->type = is_64 ? LOG_ARGUMENT_I64 : LOG_ARGUMENT_I32;
+                break;
+            case 'c':
+                out_spec->type = LOG_ARGUMENT_I32;
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                out_spec->type = LOG_ARGUMENT_F64;
+                break;
+            case 's':
+                out_spec->type = LOG_ARGUMENT_STRING;
+                break;
+            case 'p':
+                out_spec->type = LOG_ARGUMENT_POINTER;
+                break;
+            case 0:
+                // Dangling '%' at the end of the string.
+                return 0;
+            default:
+                // Unsupported (i.e. %n). Consumes no argument.
+                out_spec->type = LOG_ARGUMENT_NONE;
+                break;
+        }
+        return p + 1;
+    }
+    return 0;
+}
+
+static u64 log_pack_arguments(const char* format, __builtin_va_list args, u8* out_buffer, u64 buffer_size) {
+    u64 offset = 0;
+    log_format_spec spec;
+    const char* p = format;
+    while ((p = log_next_spec(p, &spec)) != 0) {
+        for (u8 i = 0; i < spec.star_count; ++i) {
+            i32 value = va_arg(args, i32);
+            if (offset + sizeof(i32) > buffer_size) {
+                return offset;
+            }
+            kcopy_memory(out_buffer + offset, &value, sizeof(i32));
+            offset += sizeof(i32);
+        }
+
+        switch (spec.type) {
+            case LOG_ARGUMENT_I32: {
+                i32 value = va_arg(args, i32);
+                if (offset + sizeof(i32) > buffer_size) {
+                    return offset;
+                }
+                kcopy_memory(out_buffer + offset, &value, sizeof(i32));
+                offset += sizeof(i32);
+            } break;
+            case LOG_ARGUMENT_I64:
+            case LOG_ARGUMENT_POINTER: {
+                i64 value = spec.type == LOG_ARGUMENT_POINTER ? (i64)(u64)va_arg(args, void*) : va_arg(args, i64);
+                if (offset + sizeof(i64) > buffer_size) {
+                    return offset;
+                }
+                kcopy_memory(out_buffer + offset, &value, sizeof(i64));
+                offset += sizeof(i64);
+            } break;
+            case LOG_ARGUMENT_F64: {
+                f64 value = spec.start[spec.prefix_length] == 'L' ? (f64)va_arg(args, long double) : va_arg(args, f64);
+                if (offset + sizeof(f64) > buffer_size) {
+                    return offset;
+                }
+                kcopy_memory(out_buffer + offset, &value, sizeof(f64));
+                offset += sizeof(f64);
+            } break;
+            case LOG_ARGUMENT_STRING: {
+                const char* value = va_arg(args, const char*);
+                if (!value) {
+                    value = "(null)";
+                }
+                if (offset + sizeof(u32) > buffer_size) {
+                    return offset;
+                }
+                // Strings are truncated to whatever space is left.
+                u64 length = string_length(value);
+                u64 available = buffer_size - offset - sizeof(u32);
+                u32 stored = (u32)(length < available ? length : available);
+                kcopy_memory(out_buffer + offset, &stored, sizeof(u32));
+                kcopy_memory(out_buffer + offset + sizeof(u32), value, stored);
+                offset += sizeof(u32) + stored;
+            } break;
+            case LOG_ARGUMENT_NONE:
+                break;
+        }
+    }
+    return offset;
+}
+
+static void log_write_binary(log_channel channel, log_level level, u32* format_id, const char* message, __builtin_va_list args) {
+    // Errors are always formatted immediately as well, so they are never hidden from the console.
+    if (level < LOG_LEVEL_WARN) {
+        __builtin_va_list text_args;
+        va_copy(text_args, args);
+        log_write_text(channel, level, message, text_args);
+        va_end(text_args);
+    }
+
+    u8 arguments[LOG_BINARY_MAX_ARGUMENT_SIZE];
+    u32 argument_size = 0;
+    u32 id = binary_format_id(message, format_id);
+    if (id == INVALID_ID) {
+        // Out of format slots. Fall back to storing the formatted string.
+        char formatted[LOG_BINARY_MAX_ARGUMENT_SIZE];
+        vsnprintf(formatted, sizeof(formatted), message, args);
+        u32 length = (u32)string_length(formatted);
+        kcopy_memory(arguments, &length, sizeof(u32));
+        kcopy_memory(arguments + sizeof(u32), formatted, length);
+        argument_size = sizeof(u32) + length;
+        id = LOG_BINARY_FORMAT_ID_STRING;
+    } else {
+        argument_size = (u32)log_pack_arguments(message, args, arguments, sizeof(arguments));
+    }
+
+    u8 record_header[19];
+    f64 timestamp = platform_get_absolute_time();
+    record_header[0] = LOG_BINARY_RECORD_MESSAGE;
+    record_header[1] = (u8)channel;
+    record_header[2] = (u8)level;
+    kcopy_memory(record_header + 3, &timestamp, sizeof(f64));
+    kcopy_memory(record_header + 11, &id, sizeof(u32));
+    kcopy_memory(record_header + 15, &argument_size, sizeof(u32));
+    binary_append(record_header, sizeof(record_header));
+    binary_append(arguments, argument_size);
+
+    // Make sure errors make it to disk in the event of a crash.
+    if (level < LOG_LEVEL_WARN) {
+        binary_flush();
+    }
+}
+
+b8 logger_binary_mode_set(b8 enabled) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    if (!enabled) {
+        kmutex_lock(&state_ptr->write_mutex);
+        if (state_ptr->binary_mode) {
+            filesystem_writer_destroy(&state_ptr->binary_writer);
+            filesystem_close(&state_ptr->binary_file_handle);
+            state_ptr->binary_mode = false;
+        }
+        kmutex_unlock(&state_ptr->write_mutex);
+        return true;
+    }
+
+    if (logger_binary_mode_get()) {
+        return true;
+    }
+
+    // Opened before taking the lock, as a failure to open is logged.
+    file_handle binary_file_handle;
+    if (!filesystem_open("console.klog", FILE_MODE_WRITE, true, &binary_file_handle)) {
+        platform_console_write_error("ERROR: Unable to open console.klog for writing.", LOG_LEVEL_ERROR);
+        return false;
+    }
+
+    kmutex_lock(&state_ptr->write_mutex);
+    if (state_ptr->binary_mode) {
+        // Another thread got there first.
+        kmutex_unlock(&state_ptr->write_mutex);
+        filesystem_close(&binary_file_handle);
+        return true;
+    }
+    state_ptr->binary_file_handle = binary_file_handle;
+    filesystem_writer_create(&state_ptr->binary_file_handle, LOG_BINARY_BUFFER_SIZE, state_ptr->binary_buffer, &state_ptr->binary_writer);
+    state_ptr->format_count = 0;
+    kzero_memory(state_ptr->format_lookup, sizeof(state_ptr->format_lookup));
+
+    log_binary_header header;
+    header.magic = LOG_BINARY_MAGIC;
+    header.version = LOG_BINARY_VERSION;
+    binary_append(&header, sizeof(log_binary_header));
+
+    // Reserve id 0 for pre-formatted messages.
+    binary_register_format("%s");
+
+    state_ptr->binary_mode = true;
+    kmutex_unlock(&state_ptr->write_mutex);
+    return true;
+}
+
+b8 logger_binary_mode_get() {
+    return state_ptr && state_ptr->binary_mode;
+}
+
+void logger_flush() {
+    if (!state_ptr) {
+        return;
+    }
+    kmutex_lock(&state_ptr->write_mutex);
+    if (state_ptr->log_file_handle.is_valid && !filesystem_writer_flush(&state_ptr->log_writer)) {
+        platform_console_write_error("ERROR writing to console.log.", LOG_LEVEL_ERROR);
+    }
+    if (state_ptr->binary_mode) {
+        binary_flush();
+    }
+    kmutex_unlock(&state_ptr->write_mutex);
+}
+
+u64 log_format_packed(const char* format, const u8* arguments, u64 argument_size, char* out_message, u64 message_size) {
+    if (!format || !out_message || message_size == 0) {
+        return 0;
+    }
+
+    u64 out_length = 0;
+    u64 offset = 0;
+    const char* p = format;
+    log_format_spec spec;
+    const char* next;
+    while (out_length + 1 < message_size) {
+        const char* literal_start = p;
+        next = log_next_spec(p, &spec);
+        const char* literal_end = next ? spec.start : p + string_length(p);
+
+        // Copy literal text, collapsing "%%".
+        for (const char* c = literal_start; c < literal_end && out_length + 1 < message_size; ++c) {
+            if (c[0] == '%' && c[1] == '%') {
+                c++;
+            }
+            out_message[out_length++] = *c;
+        }
+        if (!next) {
+            break;
+        }
+
+        // Read the star arguments, then the value.
+        i32 stars[2] = {0, 0};
+        for (u8 i = 0; i < spec.star_count && i < 2; ++i) {
+            if (offset + sizeof(i32) <= argument_size) {
+                kcopy_memory(&stars[i], arguments + offset, sizeof(i32));
+                offset += sizeof(i32);
+            }
+        }
+
+        // Rebuild the specification with a length modifier which matches the stored size.
+        char spec_str[64];
+        u32 prefix_length = spec.prefix_length < 48 ? spec.prefix_length : 48;
+        kcopy_memory(spec_str, spec.start, prefix_length);
+        u32 spec_length = prefix_length;
+        if (spec.type == LOG_ARGUMENT_I64) {
+            spec_str[spec_length++] = 'l';
+            spec_str[spec_length++] = 'l';
+        }
+        spec_str[spec_length++] = spec.conversion;
+        spec_str[spec_length] = 0;
+
+        char* dest = out_message + out_length;
+        u64 remaining = message_size - out_length;
+        i32 written = 0;
+        switch (spec.type) {
+            case LOG_ARGUMENT_I32: {
+                i32 value = 0;
+                if (offset + sizeof(i32) <= argument_size) {
+                    kcopy_memory(&value, arguments + offset, sizeof(i32));
+                }
+                offset += sizeof(i32);
+                written = spec.star_count == 2 ? snprintf(dest, remaining, spec_str, stars[0], stars[1], value)
+                        : spec.star_count == 1 ? snprintf(dest, remaining, spec_str, stars[0], value)
+                                               : snprintf(dest, remaining, spec_str, value);
+            } break;
+            case LOG_ARGUMENT_I64: {
+                i64 value = 0;
+                if (offset + sizeof(i64) <= argument_size) {
+                    kcopy_memory(&value, arguments + offset, sizeof(i64));
+                }
+                offset += sizeof(i64);
+                written = spec.star_count == 2 ? snprintf(dest, remaining, spec_str, stars[0], stars[1], (long long)value)
+                        : spec.star_count == 1 ? snprintf(dest, remaining, spec_str, stars[0], (long long)value)
+                                               : snprintf(dest, remaining, spec_str, (long long)value);
+            } break;
+            case LOG_ARGUMENT_POINTER: {
+                i64 value = 0;
+                if (offset + sizeof(i64) <= argument_size) {
+                    kcopy_memory(&value, arguments + offset, sizeof(i64));
+                }
+                offset += sizeof(i64);
+                void* ptr = (void*)(u64)value;
+                written = spec.star_count == 2 ? snprintf(dest, remaining, spec_str, stars[0], stars[1], ptr)
+                        : spec.star_count == 1 ? snprintf(dest, remaining, spec_str, stars[0], ptr)
+                                               : snprintf(dest, remaining, spec_str, ptr);
+            } break;
+            case LOG_ARGUMENT_F64: {
+                f64 value = 0;
+                if (offset + sizeof(f64) <= argument_size) {
+                    kcopy_memory(&value, arguments + offset, sizeof(f64));
+                }
+                offset += sizeof(f64);
+                written = spec.star_count == 2 ? snprintf(dest, remaining, spec_str, stars[0], stars[1], value)
+                        : spec.star_count == 1 ? snprintf(dest, remaining, spec_str, stars[0], value)
+                                               : snprintf(dest, remaining, spec_str, value);
+            } break;
+            case LOG_ARGUMENT_STRING: {
+                u32 length = 0;
+                if (offset + sizeof(u32) <= argument_size) {
+                    kcopy_memory(&length, arguments + offset, sizeof(u32));
+                    offset += sizeof(u32);
+                }
+                if (offset + length > argument_size) {
+                    length = (u32)(argument_size - offset);
+                }
+                char value[LOG_BINARY_MAX_ARGUMENT_SIZE];
+                if (length >= sizeof(value)) {
+                    length = sizeof(value) - 1;
+                }
+                kcopy_memory(value, arguments + offset, length);
+                value[length] = 0;
+                offset += length;
+                written = spec.star_count == 2 ? snprintf(dest, remaining, spec_str, stars[0], stars[1], value)
+                        : spec.star_count == 1 ? snprintf(dest, remaining, spec_str, stars[0], value)
+                                               : snprintf(dest, remaining, spec_str, value);
+            } break;
+            case LOG_ARGUMENT_NONE:
+                break;
+        }
+
+        if (written > 0) {
+            out_length += (u64)written < remaining ? (u64)written : remaining - 1;
+        }
+        p = next;
+    }
+
+    out_message[out_length] = 0;
+    return out_length;
 }
@@ -13,6 +13,17 @@
 #define LOG_TRACE_ENABLED 0
 #endif
 
+/**
+ * @brief Whether the logger starts in deferred-format binary mode. In this mode
+ * log calls do not format their message; they only record the id of their format
+ * string and the raw bytes of their arguments into console.klog, which can be
+ * turned back into text offline with `tools decode_log`. Can also be toggled at
+ * runtime with logger_binary_mode_set().
+ */
+#ifndef LOG_BINARY_MODE_DEFAULT
+#define LOG_BINARY_MODE_DEFAULT 0
+#endif
+
 typedef enum log_level
 {
 	LOG_LEVEL_FATAL = 0,
@@ -23,10 +34,67 @@ typedef enum log_level
 	LOG_LEVEL_TRACE = 5,
 } log_level;
 
+/**
+ * @brief Named log channels. Each channel has a compile-time maximum level
+ * (LOG_CHANNEL_<NAME>_LEVEL) and a runtime threshold (see log_channel_level_set).
+ * Messages more verbose than the compile-time level are stripped entirely.
+ */
+typedef enum log_channel {
+	LOG_CHANNEL_GENERAL = 0,
+	LOG_CHANNEL_RENDERER = 1,
+	LOG_CHANNEL_VULKAN = 2,
+	LOG_CHANNEL_TEXTURE = 3,
+	LOG_CHANNEL_MATERIAL = 4,
+	LOG_CHANNEL_INPUT = 5,
+	LOG_CHANNEL_MEMORY = 6,
+
+	LOG_CHANNEL_MAX
+} log_channel;
+
+// The most verbose level compiled in for channels which do not override it.
+#if LOG_TRACE_ENABLED == 1
+#define LOG_CHANNEL_DEFAULT_LEVEL 5
+#elif LOG_DEBUG_ENABLED == 1
+#define LOG_CHANNEL_DEFAULT_LEVEL 4
+#else
+#define LOG_CHANNEL_DEFAULT_LEVEL 3
+#endif
+
+// Per-channel compile-time levels. Define any of these before including this header
+// (or on the command line) to strip a channel further, i.e. -DLOG_CHANNEL_VULKAN_LEVEL=2
+#ifndef LOG_CHANNEL_GENERAL_LEVEL
+#define LOG_CHANNEL_GENERAL_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_RENDERER_LEVEL
+#define LOG_CHANNEL_RENDERER_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_VULKAN_LEVEL
+#define LOG_CHANNEL_VULKAN_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_TEXTURE_LEVEL
+#define LOG_CHANNEL_TEXTURE_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_MATERIAL_LEVEL
+#define LOG_CHANNEL_MATERIAL_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_INPUT_LEVEL
+#define LOG_CHANNEL_INPUT_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+#ifndef LOG_CHANNEL_MEMORY_LEVEL
+#define LOG_CHANNEL_MEMORY_LEVEL LOG_CHANNEL_DEFAULT_LEVEL
+#endif
+
+/**
+ * @brief Runtime level thresholds, indexed by log_channel. Read directly by the
+ * logging macros so a disabled call costs one load and one branch. Use
+ * log_channel_level_set to change them.
+ */
+KAPI extern u8 log_channel_levels[LOG_CHANNEL_MAX];
+
 /**
  * @brief Initializes logging system. Call twice; once with state = 0 to get required memory size,
  * then a second time passing allocated memory to state.
- * 
+ *
  * @param memory_requirement A pointer to hold the required memory size of internal state.
  * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
  * @return b8 True on success; otherwise false.
@@ -36,15 +104,88 @@ void shutdown_logging(void * state);
 
 KAPI void log_output(log_level level, const char* message, ...);
 
-#define KFATAL(message, ...) log_output(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+/**
+ * @brief Logs a message to the given channel, caching the id of its format string in format_id.
+ * Used by the logging macros, which pass a per-call-site static slot so that
+ * binary mode never has to look the format string up again.
+ * NOTE: message must be a string literal (or otherwise outlive the logger).
+ *
+ * @param channel The channel to log to.
+ * @param level The log level.
+ * @param format_id A pointer to the cached format id for this call site. May be 0.
+ * @param message The format string.
+ */
+KAPI void log_output_channel(log_channel channel, log_level level, u32* format_id, const char* message, ...);
+
+/**
+ * @brief Sets the runtime threshold of a channel. Messages more verbose than level
+ * are skipped without evaluating their arguments. Cannot enable levels which were
+ * stripped at compile time.
+ *
+ * @param channel The channel to configure.
+ * @param level The most verbose level to output.
+ */
+KAPI void log_channel_level_set(log_channel channel, log_level level);
+
+/** @brief Gets the runtime threshold of a channel. */
+KAPI log_level log_channel_level_get(log_channel channel);
+
+/** @brief Gets the display name of a channel, i.e. "texture". */
+KAPI const char* log_channel_name(log_channel channel);
+
+/**
+ * @brief Enables or disables deferred-format binary logging at runtime.
+ *
+ * @param enabled True to write binary records to console.klog; false for plain text.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 logger_binary_mode_set(b8 enabled);
+
+/** @brief Indicates if the logger is currently in binary mode. */
+KAPI b8 logger_binary_mode_get();
+
+/**
+ * @brief Writes all buffered log output to disk. Errors are always written
+ * immediately; everything else is buffered until this is called, which the
+ * application does once per frame.
+ */
+KAPI void logger_flush();
+
+/**
+ * Logs to a channel by name (GENERAL, RENDERER, VULKAN, ...). The compile-time check is
+ * constant and folds away entirely; the runtime check is a single branch. Arguments are
+ * only evaluated if the message is actually output.
+ */
+#define KLOG_CHANNEL(channel, level, message, ...)                                                                \
+	{                                                                                                             \
+		if ((level) <= LOG_CHANNEL_##channel##_LEVEL && (level) <= log_channel_levels[LOG_CHANNEL_##channel]) { \
+			static u32 log_format_id = INVALID_ID;                                                                \
+			log_output_channel(LOG_CHANNEL_##channel, level, &log_format_id, message, ##__VA_ARGS__);           \
+		}                                                                                                         \
+	}
+
+// Logs a fatal message to the given channel. Fatal messages are never stripped.
+#define KFATAL_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+// Logs an error message to the given channel.
+#define KERROR_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+// Logs a warning message to the given channel.
+#define KWARN_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+// Logs an informational message to the given channel.
+#define KINFO_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+// Logs a debug message to the given channel.
+#define KDEBUG_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+// Logs a trace message to the given channel.
+#define KTRACE_CH(channel, message, ...) KLOG_CHANNEL(channel, LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+
+#define KFATAL(message, ...) KFATAL_CH(GENERAL, message, ##__VA_ARGS__)
 
 #ifndef KERROR
-#define KERROR(message, ...) log_output(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+#define KERROR(message, ...) KERROR_CH(GENERAL, message, ##__VA_ARGS__)
 #endif
 
 #if LOG_WARN_ENABLED == 1
 // Logs a warning message
-#define KWARN(message, ...) log_output(LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+#define KWARN(message, ...) KWARN_CH(GENERAL, message, ##__VA_ARGS__)
 #else
 // Disables warning logging if LOG_WARN_ENABLED is not 1
 #define KWARN(message, ...)
@@ -52,7 +193,7 @@ KAPI void log_output(log_level level, const char* message, ...);
 
 #if LOG_INFO_ENABLED == 1
 // Logs an informational message
-#define KINFO(message, ...) log_output(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define KINFO(message, ...) KINFO_CH(GENERAL, message, ##__VA_ARGS__)
 #else
 // Disables informational logging if LOG_INFO_ENABLED is not 1
 #define KINFO(message, ...)
@@ -60,7 +201,7 @@ KAPI void log_output(log_level level, const char* message, ...);
 
 #if LOG_DEBUG_ENABLED == 1
 // Logs a debug message
-#define KDEBUG(message, ...) log_output(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define KDEBUG(message, ...) KDEBUG_CH(GENERAL, message, ##__VA_ARGS__)
 #else
 // Disables debug logging if LOG_DEBUG_ENABLED is not 1
 #define KDEBUG(message, ...)
@@ -68,8 +209,46 @@ KAPI void log_output(log_level level, const char* message, ...);
 
 #if LOG_TRACE_ENABLED == 1
 // Logs a trace message
-#define KTRACE(message, ...) log_output(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#define KTRACE(message, ...) KTRACE_CH(GENERAL, message, ##__VA_ARGS__)
 #else
 // Disables trace logging if LOG_TRACE_ENABLED is not 1
 #define KTRACE(message, ...)
-#endif
\ No newline at end of file
+#endif
+
+/*
+ * Binary log format (console.klog)
+ *
+ * The file starts with a log_binary_header, followed by a stream of records.
+ * Each record starts with a single u8 log_binary_record_type:
+ *  - FORMAT:  u32 id, u32 length, then length bytes of the format string (no terminator).
+ *             Written the first time a format string is used.
+ *  - MESSAGE: u8 channel, u8 level, f64 timestamp, u32 format id, u32 argument size, then the
+ *             packed arguments, in format string order. Integers and pointers are
+ *             stored as i32/i64 values, floating-point values as f64 and strings
+ *             as a u32 length followed by their bytes.
+ * All values are stored in host byte order, without padding.
+ */
+#define LOG_BINARY_MAGIC 0x474F4C4B  // "KLOG"
+#define LOG_BINARY_VERSION 2
+
+typedef struct log_binary_header {
+	u32 magic;
+	u32 version;
+} log_binary_header;
+
+typedef enum log_binary_record_type {
+	LOG_BINARY_RECORD_FORMAT = 1,
+	LOG_BINARY_RECORD_MESSAGE = 2
+} log_binary_record_type;
+
+/**
+ * @brief Formats a message from a format string and the packed arguments of a MESSAGE record.
+ *
+ * @param format The format string the arguments were packed with.
+ * @param arguments The packed arguments.
+ * @param argument_size The size of the packed arguments in bytes.
+ * @param out_message The buffer to write the formatted message to.
+ * @param message_size The size of out_message in bytes.
+ * @return The length of the formatted message.
+ */
+KAPI u64 log_format_packed(const char* format, const u8* arguments, u64 argument_size, char* out_message, u64 message_size);
@@ -0,0 +1,192 @@
+#include "lz4.h"
+
+#include "core/kmemory.h"
+
+// Shortest match a sequence can hold.
+#define LZ4_MIN_MATCH 4
+// The format requires the last bytes of a block to be literals...
+#define LZ4_LAST_LITERALS 5
+// ...and the last match to start this far from its end.
+#define LZ4_MATCH_FIND_LIMIT 12
+// Furthest back a match can be.
+#define LZ4_MAX_OFFSET 65535
+// Size of the table of recent positions, by hash. Small enough to stay in L1.
+#define LZ4_HASH_BITS 12
+
+// Little endian, whatever the platform. Compiles to a single load where it can.
+KINLINE u32 read_u32(const u8* p) {
+    return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+KINLINE u32 hash_u32(u32 value) {
+    return (value * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+// Writes a length which did not fit in its 4 bits of the token, as a run of 255s and a remainder.
+static u8* write_length(u8* op, u64 length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (u8)length;
+    return op;
+}
+
+// Writes a sequence; literals, then a match unless match_length is 0. Returns 0 if it does not fit.
+static u8* write_sequence(u8* op, const u8* op_end, const u8* literals, u64 literal_length, u64 offset, u64 match_length) {
+    u64 needed = 1 + literal_length / 255 + 1 + literal_length + (match_length ? 2 + match_length / 255 + 1 : 0);
+    if (needed > (u64)(op_end - op)) {
+        return 0;
+    }
+
+    u8* token = op++;
+    *token = (u8)((literal_length < 15 ? literal_length : 15) << 4);
+    if (literal_length >= 15) {
+        op = write_length(op, literal_length - 15);
+    }
+    kcopy_memory(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length) {
+        *op++ = (u8)(offset & 0xFF);
+        *op++ = (u8)(offset >> 8);
+        u64 length = match_length - LZ4_MIN_MATCH;
+        *token |= (u8)(length < 15 ? length : 15);
+        if (length >= 15) {
+            op = write_length(op, length - 15);
+        }
+    }
+    return op;
+}
+
+u64 lz4_compress_bound(u64 size) {
+    return size + size / 255 + 16;
+}
+
+u64 lz4_compress(const void* source, u64 source_size, void* dest, u64 dest_capacity) {
+    if (!source || !dest || source_size > LZ4_MAX_INPUT_SIZE) {
+        return 0;
+    }
+    const u8* src = source;
+    u8* op = dest;
+    const u8* op_end = op + dest_capacity;
+    u64 anchor = 0;
+
+    // Too short for any match, so all literals.
+    if (source_size > LZ4_MATCH_FIND_LIMIT) {
+        // Where each hash was last seen. A stale or colliding position is caught by comparing bytes.
+        u32 table[1 << LZ4_HASH_BITS] = {};
+        u64 match_limit = source_size - LZ4_MATCH_FIND_LIMIT;
+        u64 match_end_limit = source_size - LZ4_LAST_LITERALS;
+
+        u64 ip = 1;
+        while (ip < match_limit) {
+            u32 sequence = read_u32(src + ip);
+            u32 hash = hash_u32(sequence);
+            u64 candidate = table[hash];
+            table[hash] = (u32)ip;
+            if (candidate >= ip || ip - candidate > LZ4_MAX_OFFSET || read_u32(src + candidate) != sequence) {
+                ip++;
+                continue;
+            }
+
+            // Take in any matching bytes before it, then as many after as allowed.
+            while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+                ip--;
+                candidate--;
+            }
+            u64 match_length = LZ4_MIN_MATCH;
+            while (ip + match_length < match_end_limit && src[candidate + match_length] == src[ip + match_length]) {
+                match_length++;
+            }
+
+            op = write_sequence(op, op_end, src + anchor, ip - anchor, ip - candidate, match_length);
+            if (!op) {
+                return 0;
+            }
+            ip += match_length;
+            anchor = ip;
+            // Helps find the next match when data repeats in short runs.
+            if (ip < match_limit) {
+                table[hash_u32(read_u32(src + ip - 2))] = (u32)(ip - 2);
+            }
+        }
+    }
+
+    op = write_sequence(op, op_end, src + anchor, source_size - anchor, 0, 0);
+    return op ? (u64)(op - (u8*)dest) : 0;
+}
+
+// Reads a length continued past its 4 bits of the token. False if the block ends first.
+KINLINE b8 read_length(const u8** ip, const u8* ip_end, u64* length) {
+    u8 byte;
+    do {
+        if (*ip >= ip_end) {
+            return false;
+        }
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+b8 lz4_decompress(const void* source, u64 source_size, void* dest, u64 dest_size) {
+    if (!source || !dest) {
+        return false;
+    }
+    const u8* ip = source;
+    const u8* ip_end = ip + source_size;
+    u8* op = dest;
+    u8* op_end = op + dest_size;
+
+    while (ip < ip_end) {
+        u8 token = *ip++;
+
+        u64 literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(&ip, ip_end, &literal_length)) {
+            return false;
+        }
+        if (literal_length > (u64)(ip_end - ip) || literal_length > (u64)(op_end - op)) {
+            return false;
+        }
+        kcopy_memory(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // The last sequence has no match.
+        if (ip == ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        u64 offset = (u64)ip[0] | ((u64)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (u64)(op - (u8*)dest)) {
+            return false;
+        }
+
+        u64 match_length = token & 15;
+        if (match_length == 15 && !read_length(&ip, ip_end, &match_length)) {
+            return false;
+        }
+        match_length += LZ4_MIN_MATCH;
+        if (match_length > (u64)(op_end - op)) {
+            return false;
+        }
+
+        const u8* match = op - offset;
+        if (offset >= match_length) {
+            kcopy_memory(op, match, match_length);
+            op += match_length;
+        } else {
+            // Overlapping; a repeating pattern, which has to be copied forward byte by byte.
+            for (u64 i = 0; i < match_length; ++i) {
+                *op++ = match[i];
+            }
+        }
+    }
+
+    return op == op_end;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "defines.h"
+
+// Largest input a single block can hold, as in the reference implementation.
+#define LZ4_MAX_INPUT_SIZE 0x7E000000
+
+/**
+ * LZ4 block compression. Blocks are interchangeable with the reference implementation's
+ * LZ4_compress_default / LZ4_decompress_safe, without the frame format around them.
+ * Fast to decompress (several GB/s) at a modest ratio, which suits assets read on load.
+ */
+
+/**
+ * @brief Gets the most a block of the given size can compress to, for sizing the output.
+ * Incompressible data comes out slightly larger than it went in.
+ *
+ * @param size The size of the input, in bytes.
+ * @return u64 The size of the output to allocate, in bytes.
+ */
+KAPI u64 lz4_compress_bound(u64 size);
+
+/**
+ * @brief Compresses a block.
+ *
+ * @param source The data to compress.
+ * @param source_size The size of the data, at most LZ4_MAX_INPUT_SIZE.
+ * @param dest Where to write the compressed block.
+ * @param dest_capacity The size of dest. lz4_compress_bound(source_size) always fits.
+ * @return u64 The size of the compressed block, or 0 if it does not fit in dest.
+ */
+KAPI u64 lz4_compress(const void* source, u64 source_size, void* dest, u64 dest_capacity);
+
+/**
+ * @brief Decompresses a block. Malformed blocks are rejected without reading or
+ * writing out of bounds.
+ *
+ * @param source The compressed block.
+ * @param source_size The size of the compressed block.
+ * @param dest Where to write the data.
+ * @param dest_size The size of the data, which must be known up front.
+ * @return b8 True if the block decompressed to exactly dest_size bytes; otherwise false.
+ */
+KAPI b8 lz4_decompress(const void* source, u64 source_size, void* dest, u64 dest_size);
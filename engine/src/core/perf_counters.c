@@ -0,0 +1,221 @@
+#include "perf_counters.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "platform/filesystem.h"
+#include "platform/katomic.h"
+
+// Size of the buffer CSV rows are written through.
+#define PERF_COUNTER_CSV_BUFFER_SIZE 16384
+
+// Counts added by a single thread with perf_counter_add_local. Only ever written by its own thread.
+typedef struct perf_counter_thread_slot {
+    u64 values[PERF_COUNTER_MAX];
+} perf_counter_thread_slot;
+
+typedef struct perf_counters_state {
+    u32 counter_count;
+    const char* names[PERF_COUNTER_MAX];
+    // Running totals added with perf_counter_add.
+    u64 totals[PERF_COUNTER_MAX];
+
+    u32 thread_count;
+    perf_counter_thread_slot threads[PERF_COUNTER_MAX_THREADS];
+
+    // Totals (shared and per thread) as of the last snapshot.
+    u64 previous[PERF_COUNTER_MAX];
+    // Total number of snapshots taken. The history ring index is snapshot_count % PERF_COUNTER_HISTORY.
+    u64 snapshot_count;
+    u64 history[PERF_COUNTER_HISTORY][PERF_COUNTER_MAX];
+
+    b8 capturing;
+    // Number of counters which have a column in the capture.
+    u32 capture_column_count;
+    file_handle capture_handle;
+    file_writer capture_writer;
+    u8 capture_buffer[PERF_COUNTER_CSV_BUFFER_SIZE];
+} perf_counters_state;
+
+static perf_counters_state* state_ptr;
+
+STATIC_ASSERT(PERF_COUNTER_MAX_THREADS >= JOB_SYSTEM_MAX_WORKERS + 1, "Perf counters must have room for every job system thread.");
+
+// The slot of the calling thread, claimed on its first local add.
+static KTHREAD_LOCAL perf_counter_thread_slot* thread_slot;
+
+b8 perf_counters_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(perf_counters_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(perf_counters_state));
+    return true;
+}
+
+void perf_counters_shutdown(void* state) {
+    perf_counters_capture_end();
+    state_ptr = 0;
+    thread_slot = 0;
+}
+
+perf_counter_id perf_counter_register(const char* name) {
+    if (!state_ptr || !name) {
+        return INVALID_ID;
+    }
+
+    for (u32 i = 0; i < state_ptr->counter_count; ++i) {
+        if (strings_equal(state_ptr->names[i], name)) {
+            return i;
+        }
+    }
+
+    if (state_ptr->counter_count >= PERF_COUNTER_MAX) {
+        KWARN("perf_counter_register - Out of counters, '%s' is not counted. Increase PERF_COUNTER_MAX.", name);
+        return INVALID_ID;
+    }
+
+    u32 id = state_ptr->counter_count;
+    state_ptr->names[id] = name;
+    state_ptr->counter_count++;
+    return id;
+}
+
+const char* perf_counter_name(perf_counter_id id) {
+    if (!state_ptr || id >= state_ptr->counter_count) {
+        return 0;
+    }
+    return state_ptr->names[id];
+}
+
+void perf_counter_add(perf_counter_id id, u64 value) {
+    if (!state_ptr || id >= PERF_COUNTER_MAX) {
+        return;
+    }
+    katomic_fetch_add_u64(&state_ptr->totals[id], value, KATOMIC_RELAXED);
+}
+
+static perf_counter_thread_slot* get_thread_slot() {
+    if (!thread_slot && state_ptr) {
+        u32 index = katomic_fetch_add_u32(&state_ptr->thread_count, 1, KATOMIC_RELAXED);
+        if (index >= PERF_COUNTER_MAX_THREADS) {
+            return 0;
+        }
+        thread_slot = &state_ptr->threads[index];
+    }
+    return thread_slot;
+}
+
+void perf_counter_add_local(perf_counter_id id, u64 value) {
+    if (id >= PERF_COUNTER_MAX) {
+        return;
+    }
+
+    perf_counter_thread_slot* slot = get_thread_slot();
+    if (!slot) {
+        // Out of thread slots; fall back to the shared total.
+        perf_counter_add(id, value);
+        return;
+    }
+    // Only this thread writes the slot; the store just needs to be whole when the snapshot reads it.
+    katomic_store_u64(&slot->values[id], slot->values[id] + value, KATOMIC_RELAXED);
+}
+
+static void write_capture_row(u64 frame_number, const u64* values) {
+    char line[32];
+    string_format(line, "%llu", frame_number);
+    filesystem_writer_write(&state_ptr->capture_writer, string_length(line), line);
+    for (u32 i = 0; i < state_ptr->capture_column_count; ++i) {
+        string_format(line, ",%llu", values[i]);
+        filesystem_writer_write(&state_ptr->capture_writer, string_length(line), line);
+    }
+    filesystem_writer_write(&state_ptr->capture_writer, 1, "\n");
+}
+
+void perf_counters_snapshot(u64 frame_number) {
+    if (!state_ptr) {
+        return;
+    }
+
+    u32 thread_count = katomic_load_u32(&state_ptr->thread_count, KATOMIC_RELAXED);
+    if (thread_count > PERF_COUNTER_MAX_THREADS) {
+        thread_count = PERF_COUNTER_MAX_THREADS;
+    }
+
+    u64* frame = state_ptr->history[state_ptr->snapshot_count % PERF_COUNTER_HISTORY];
+    for (u32 i = 0; i < state_ptr->counter_count; ++i) {
+        u64 total = katomic_load_u64(&state_ptr->totals[i], KATOMIC_RELAXED);
+        for (u32 t = 0; t < thread_count; ++t) {
+            total += katomic_load_u64(&state_ptr->threads[t].values[i], KATOMIC_RELAXED);
+        }
+        // Counters only ever grow, so the difference is what was added during the frame.
+        frame[i] = total - state_ptr->previous[i];
+        state_ptr->previous[i] = total;
+    }
+    for (u32 i = state_ptr->counter_count; i < PERF_COUNTER_MAX; ++i) {
+        frame[i] = 0;
+    }
+    state_ptr->snapshot_count++;
+
+    if (state_ptr->capturing) {
+        write_capture_row(frame_number, frame);
+    }
+}
+
+b8 perf_counter_get(perf_counter_id id, u32 frames_ago, u64* out_value) {
+    if (!state_ptr || id >= state_ptr->counter_count || !out_value) {
+        return false;
+    }
+    if (frames_ago >= PERF_COUNTER_HISTORY || frames_ago >= state_ptr->snapshot_count) {
+        return false;
+    }
+
+    u64 index = (state_ptr->snapshot_count - 1 - frames_ago) % PERF_COUNTER_HISTORY;
+    *out_value = state_ptr->history[index][id];
+    return true;
+}
+
+b8 perf_counters_capture_begin(const char* path) {
+    if (!state_ptr) {
+        return false;
+    }
+    if (state_ptr->capturing) {
+        perf_counters_capture_end();
+    }
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &state_ptr->capture_handle)) {
+        KERROR("perf_counters_capture_begin - Unable to open '%s' for writing.", path);
+        return false;
+    }
+    filesystem_writer_create(&state_ptr->capture_handle, PERF_COUNTER_CSV_BUFFER_SIZE, state_ptr->capture_buffer, &state_ptr->capture_writer);
+
+    // Columns are fixed for the whole capture, so counters registered later are left out.
+    state_ptr->capture_column_count = state_ptr->counter_count;
+    filesystem_writer_write(&state_ptr->capture_writer, 5, "frame");
+    for (u32 i = 0; i < state_ptr->capture_column_count; ++i) {
+        filesystem_writer_write(&state_ptr->capture_writer, 1, ",");
+        filesystem_writer_write(&state_ptr->capture_writer, string_length(state_ptr->names[i]), state_ptr->names[i]);
+    }
+    filesystem_writer_write(&state_ptr->capture_writer, 1, "\n");
+
+    state_ptr->capturing = true;
+    KINFO("Capturing %u performance counters to '%s'.", state_ptr->capture_column_count, path);
+    return true;
+}
+
+void perf_counters_capture_end() {
+    if (!state_ptr || !state_ptr->capturing) {
+        return;
+    }
+
+    filesystem_writer_destroy(&state_ptr->capture_writer);
+    filesystem_close(&state_ptr->capture_handle);
+    state_ptr->capturing = false;
+    KINFO("Performance counter capture ended.");
+}
+
+b8 perf_counters_capturing() {
+    return state_ptr ? state_ptr->capturing : false;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "defines.h"
+#include "systems/job_system.h"
+
+/**
+ * @brief Whether performance counters are compiled in. When 0, KPERF_COUNTER_ADD
+ * compiles to nothing.
+ */
+#ifndef KPERF_COUNTERS_ENABLED
+#define KPERF_COUNTERS_ENABLED 1
+#endif
+
+// Maximum number of distinct counters.
+#define PERF_COUNTER_MAX 128
+// Maximum number of threads which can use perf_counter_add_local; every job system thread, the main one included.
+#define PERF_COUNTER_MAX_THREADS (JOB_SYSTEM_MAX_WORKERS + 1)
+// Number of frames of counter values kept.
+#define PERF_COUNTER_HISTORY 256
+
+typedef u32 perf_counter_id;
+
+/**
+ * @brief Initializes the performance counter system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @return b8 True on success; otherwise false.
+ */
+b8 perf_counters_initialize(u64* memory_requirement, void* state);
+void perf_counters_shutdown(void* state);
+
+/**
+ * @brief Registers a named counter, or returns the existing one with that name.
+ * Called once per counter when a subsystem starts, which keeps the id in its state.
+ * NOTE: Not thread safe. Register from the main thread, before any other thread can
+ * add to the counter. name must be a string literal (or otherwise outlive the system).
+ *
+ * @param name The name of the counter, i.e. "draw calls".
+ * @return The id of the counter; INVALID_ID if the system is not running or full.
+ */
+KAPI perf_counter_id perf_counter_register(const char* name);
+
+/** @brief Gets the name of a counter; 0 if it does not exist. */
+KAPI const char* perf_counter_name(perf_counter_id id);
+
+/**
+ * @brief Adds to a counter with an atomic add. Safe to call from any thread.
+ *
+ * @param id The id of the counter.
+ * @param value The amount to add.
+ */
+KAPI void perf_counter_add(perf_counter_id id, u64 value);
+
+/**
+ * @brief Adds to the calling thread's own copy of a counter. Cheaper than
+ * perf_counter_add for counters bumped very often; copies are summed when the frame is snapshot.
+ *
+ * @param id The id of the counter.
+ * @param value The amount to add.
+ */
+KAPI void perf_counter_add_local(perf_counter_id id, u64 value);
+
+/**
+ * @brief Records the amount each counter grew by since the last snapshot as the
+ * values of a frame, and writes them out if a capture is running. Called by the
+ * application at the end of each frame.
+ *
+ * @param frame_number The number of the frame which ended.
+ */
+void perf_counters_snapshot(u64 frame_number);
+
+/**
+ * @brief Gets the value of a counter in a recent frame.
+ *
+ * @param id The id of the counter.
+ * @param frames_ago 0 for the last snapshot frame, 1 for the one before, and so on, up to PERF_COUNTER_HISTORY - 1.
+ * @param out_value A pointer to hold the value.
+ * @return True if the frame is still held; otherwise false.
+ */
+KAPI b8 perf_counter_get(perf_counter_id id, u32 frames_ago, u64* out_value);
+
+/**
+ * @brief Starts streaming each frame's counter values to a CSV file, one row per
+ * frame and one column per counter registered at this point.
+ *
+ * @param path The path of the CSV file.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 perf_counters_capture_begin(const char* path);
+
+/** @brief Stops a running CSV capture, if any. */
+KAPI void perf_counters_capture_end();
+
+/** @brief Indicates if a CSV capture is running. */
+KAPI b8 perf_counters_capturing();
+
+#if KPERF_COUNTERS_ENABLED == 1
+// Adds value to a counter registered with perf_counter_register. Safe from any thread.
+#define KPERF_COUNTER_ADD(id, value) perf_counter_add(id, value)
+// Like KPERF_COUNTER_ADD, but adds to the calling thread's own copy. For very hot counters.
+#define KPERF_COUNTER_ADD_LOCAL(id, value) perf_counter_add_local(id, value)
+#else
+#define KPERF_COUNTER_ADD(id, value)
+#define KPERF_COUNTER_ADD_LOCAL(id, value)
+#endif
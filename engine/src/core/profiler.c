@@ -0,0 +1,274 @@
+#include "profiler.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "platform/katomic.h"
+#include "platform/kthread.h"
+
+typedef struct profiler_zone {
+    const char* name;
+    f64 start;
+    // 0 while the zone is still open.
+    f64 end;
+    u32 depth;
+    u32 frame;
+} profiler_zone;
+
+// Stands in for a zone which was not recorded, so its end still pairs up.
+#define PROFILER_DROPPED_ZONE 0xFFFFFFFFFFFFFFFFULL
+
+// Zones recorded by a single thread. Only ever written by its own thread.
+typedef struct profiler_thread_buffer {
+    u32 thread_index;
+    // True for the thread which initialized the profiler.
+    b8 is_main_thread;
+    // Total number of zones begun. The zone ring index is count % PROFILER_MAX_ZONES.
+    u64 count;
+    profiler_zone zones[PROFILER_MAX_ZONES];
+
+    // Counts of the currently open zones, outermost first, or PROFILER_DROPPED_ZONE.
+    u32 depth;
+    u64 open_zones[PROFILER_MAX_DEPTH];
+} profiler_thread_buffer;
+
+typedef struct profiler_state {
+    u32 frame;
+    u64 main_thread_id;
+    u32 thread_count;
+    profiler_thread_buffer threads[PROFILER_MAX_THREADS];
+    // Zones timed on the GPU. Written by the renderer thread only.
+    profiler_thread_buffer gpu_track;
+} profiler_state;
+
+static profiler_state* state_ptr;
+
+STATIC_ASSERT(PROFILER_MAX_THREADS >= JOB_SYSTEM_MAX_WORKERS + 1, "The profiler must have room for every job system thread.");
+
+// The buffer of the calling thread, claimed on its first zone.
+static KTHREAD_LOCAL profiler_thread_buffer* thread_buffer;
+
+b8 profiler_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(profiler_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(profiler_state));
+    state_ptr->main_thread_id = kthread_current_id();
+    // Shown after the CPU threads.
+    state_ptr->gpu_track.thread_index = PROFILER_MAX_THREADS;
+    return true;
+}
+
+void profiler_shutdown(void* state) {
+    state_ptr = 0;
+    thread_buffer = 0;
+}
+
+static profiler_thread_buffer* get_thread_buffer() {
+    if (!thread_buffer && state_ptr) {
+        u32 index = katomic_fetch_add_u32(&state_ptr->thread_count, 1, KATOMIC_RELAXED);
+        if (index >= PROFILER_MAX_THREADS) {
+            return 0;
+        }
+        thread_buffer = &state_ptr->threads[index];
+        thread_buffer->thread_index = index;
+        thread_buffer->is_main_thread = kthread_current_id() == state_ptr->main_thread_id;
+    }
+    return thread_buffer;
+}
+
+void profiler_zone_begin(const char* name) {
+    profiler_thread_buffer* buffer = get_thread_buffer();
+    if (!buffer || buffer->depth >= PROFILER_MAX_DEPTH) {
+        return;
+    }
+
+    // Never overwrite a zone which is still open; drop the new one instead.
+    if (buffer->depth > 0 && buffer->count - buffer->open_zones[0] >= PROFILER_MAX_ZONES) {
+        buffer->open_zones[buffer->depth++] = PROFILER_DROPPED_ZONE;
+        return;
+    }
+
+    u32 index = (u32)(buffer->count % PROFILER_MAX_ZONES);
+    buffer->open_zones[buffer->depth++] = buffer->count;
+    buffer->count++;
+    profiler_zone* zone = &buffer->zones[index];
+    zone->name = name;
+    zone->end = 0;
+    zone->depth = buffer->depth;
+    zone->frame = state_ptr->frame;
+
+    // Taken last so the bookkeeping above is not part of the zone.
+    zone->start = platform_get_absolute_time();
+}
+
+void profiler_zone_end() {
+    f64 end = platform_get_absolute_time();
+    profiler_thread_buffer* buffer = thread_buffer;
+    if (!buffer || buffer->depth == 0) {
+        return;
+    }
+
+    buffer->depth--;
+    u64 zone = buffer->open_zones[buffer->depth];
+    if (zone != PROFILER_DROPPED_ZONE) {
+        buffer->zones[zone % PROFILER_MAX_ZONES].end = end;
+    }
+}
+
+void profiler_gpu_zone_record(const char* name, f64 start, f64 end, u32 depth) {
+    if (!state_ptr) {
+        return;
+    }
+
+    profiler_thread_buffer* buffer = &state_ptr->gpu_track;
+    profiler_zone* zone = &buffer->zones[buffer->count % PROFILER_MAX_ZONES];
+    buffer->count++;
+    zone->name = name;
+    zone->start = start;
+    zone->end = end;
+    zone->depth = depth;
+    // GPU results arrive a few frames late; this is the frame they were read back in.
+    zone->frame = state_ptr->frame;
+}
+
+void profiler_frame_mark() {
+    if (!state_ptr) {
+        return;
+    }
+
+    profiler_thread_buffer* buffer = thread_buffer;
+    if (buffer && buffer->depth > 0) {
+        KWARN("profiler_frame_mark - %u zone(s) left open, starting with '%s'. Check for a missing KPROFILE_ZONE_END.",
+              buffer->depth, buffer->zones[buffer->open_zones[0] % PROFILER_MAX_ZONES].name);
+        buffer->depth = 0;
+    }
+    state_ptr->frame++;
+}
+
+// Copies name into out as the body of a JSON string, truncating it to fit out_size.
+static void escape_name(const char* name, char* out, u32 out_size) {
+    static const char* hex = "0123456789abcdef";
+    u32 length = 0;
+    for (const char* c = name; *c; ++c) {
+        char escaped[6];
+        u32 escaped_length = 0;
+        if (*c == '"' || *c == '\\') {
+            escaped[escaped_length++] = '\\';
+            escaped[escaped_length++] = *c;
+        } else if ((u8)*c < 0x20) {
+            escaped[escaped_length++] = '\\';
+            escaped[escaped_length++] = 'u';
+            escaped[escaped_length++] = '0';
+            escaped[escaped_length++] = '0';
+            escaped[escaped_length++] = hex[(u8)*c >> 4];
+            escaped[escaped_length++] = hex[(u8)*c & 0xF];
+        } else {
+            escaped[escaped_length++] = *c;
+        }
+        // Stop at a whole escape sequence, never part of one.
+        if (length + escaped_length >= out_size) {
+            // Nor part of a UTF-8 character.
+            while (length > 0 && ((u8)out[length - 1] & 0xC0) == 0x80) {
+                length--;
+            }
+            if (length > 0 && (u8)out[length - 1] >= 0xC0) {
+                length--;
+            }
+            break;
+        }
+        kcopy_memory(out + length, escaped, escaped_length);
+        length += escaped_length;
+    }
+    out[length] = 0;
+}
+
+// Writes a formatted event, dropping it if it did not fit the line.
+static void write_event(file_writer* writer, char* line, u64 line_size, i32 length) {
+    if (length < 0 || (u64)length >= line_size) {
+        KWARN("profiler_export_chrome_trace - an event did not fit and was skipped.");
+        return;
+    }
+    filesystem_writer_write(writer, length, line);
+}
+
+// Writes the metadata and completed zones of a single track. Returns the number of zones written.
+static u64 export_track(file_writer* writer, profiler_thread_buffer* buffer, const char* track_name) {
+    // Zone names are escaped into at most this much, so the line always fits the rest of the event.
+    char name[128];
+    char line[512];
+    escape_name(track_name, name, sizeof(name));
+    i32 length = string_format_n(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                                 buffer->thread_index, name);
+    write_event(writer, line, sizeof(line), length);
+
+    // Walk the ring from the oldest zone still held.
+    u64 zone_count = 0;
+    u64 begin = buffer->count > PROFILER_MAX_ZONES ? buffer->count - PROFILER_MAX_ZONES : 0;
+    for (u64 i = begin; i < buffer->count; ++i) {
+        profiler_zone* zone = &buffer->zones[i % PROFILER_MAX_ZONES];
+        if (zone->end == 0) {
+            continue;
+        }
+        // Complete events, with times in microseconds.
+        escape_name(zone->name, name, sizeof(name));
+        length = string_format_n(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"depth\":%u}}",
+                                 name, buffer->thread_index, zone->start * 1000000.0, (zone->end - zone->start) * 1000000.0, zone->frame, zone->depth);
+        write_event(writer, line, sizeof(line), length);
+        zone_count++;
+    }
+    return zone_count;
+}
+
+b8 profiler_export_chrome_trace(const char* path) {
+    if (!state_ptr) {
+        KWARN("profiler_export_chrome_trace called before the profiler was initialized.");
+        return false;
+    }
+
+    file_handle handle;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &handle)) {
+        KERROR("profiler_export_chrome_trace - unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    file_writer writer;
+    filesystem_writer_create(&handle, 65536, 0, &writer);
+
+    // Every following event is written with a leading comma, so start with the process name.
+    filesystem_writer_write_line(&writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    const char* process_name = "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"engine\"}}";
+    filesystem_writer_write(&writer, string_length(process_name), process_name);
+
+    // Threads past the limit still bump the count when they fail to claim a buffer.
+    u32 thread_count = katomic_load_u32(&state_ptr->thread_count, KATOMIC_ACQUIRE);
+    if (thread_count > PROFILER_MAX_THREADS) {
+        thread_count = PROFILER_MAX_THREADS;
+    }
+
+    u64 zone_count = 0;
+    for (u32 t = 0; t < thread_count; ++t) {
+        profiler_thread_buffer* buffer = &state_ptr->threads[t];
+        char track_name[32];
+        if (buffer->is_main_thread) {
+            string_format_n(track_name, sizeof(track_name), "main");
+        } else {
+            string_format_n(track_name, sizeof(track_name), "worker %u", buffer->thread_index);
+        }
+        zone_count += export_track(&writer, buffer, track_name);
+    }
+    if (state_ptr->gpu_track.count > 0) {
+        zone_count += export_track(&writer, &state_ptr->gpu_track, "gpu");
+    }
+    filesystem_writer_write_line(&writer, "\n]}");
+
+    filesystem_writer_destroy(&writer);
+    filesystem_close(&handle);
+    KINFO("Exported %llu profiler zones over %u frame(s) to '%s'.", zone_count, state_ptr->frame, path);
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "defines.h"
+#include "systems/job_system.h"
+
+/**
+ * @brief Whether the profiler is compiled in. When 0, all KPROFILE_* macros
+ * compile to nothing. Enabled by default in debug builds.
+ */
+#ifndef KPROFILER_ENABLED
+#if defined(_DEBUG)
+#define KPROFILER_ENABLED 1
+#else
+#define KPROFILER_ENABLED 0
+#endif
+#endif
+
+// Maximum number of threads which can record zones; every job system thread, the main one included.
+#define PROFILER_MAX_THREADS (JOB_SYSTEM_MAX_WORKERS + 1)
+// Number of zones kept per thread. Older zones are overwritten once this is exceeded;
+// zones begun while that would overwrite one still open are dropped instead.
+#define PROFILER_MAX_ZONES 16384
+// Maximum nesting depth of zones on a single thread.
+#define PROFILER_MAX_DEPTH 64
+
+/**
+ * @brief Initializes the profiler. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @return b8 True on success; otherwise false.
+ */
+b8 profiler_initialize(u64* memory_requirement, void* state);
+void profiler_shutdown(void* state);
+
+/**
+ * @brief Opens a zone on the calling thread. Zones nest, and must be closed in
+ * reverse order with profiler_zone_end.
+ * NOTE: name must be a string literal (or otherwise outlive the profiler).
+ *
+ * @param name The name of the zone.
+ */
+KAPI void profiler_zone_begin(const char* name);
+
+/** @brief Closes the innermost open zone on the calling thread. */
+KAPI void profiler_zone_end();
+
+/**
+ * @brief Records a zone which was timed elsewhere, i.e. with GPU timestamp queries,
+ * onto the GPU track. Times must already be on the platform_get_absolute_time timeline.
+ * NOTE: name must be a string literal (or otherwise outlive the profiler).
+ *
+ * @param name The name of the zone.
+ * @param start The start time of the zone, in seconds.
+ * @param end The end time of the zone, in seconds.
+ * @param depth The nesting depth of the zone.
+ */
+KAPI void profiler_gpu_zone_record(const char* name, f64 start, f64 end, u32 depth);
+
+/**
+ * @brief Marks the end of a frame. Zones recorded afterwards belong to the next frame.
+ * Any zones still open on the calling thread are reported and discarded.
+ */
+KAPI void profiler_frame_mark();
+
+/**
+ * @brief Writes all recorded zones to a Chrome trace_event JSON file, which can be
+ * opened in Perfetto or chrome://tracing.
+ *
+ * @param path The path of the file to write.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 profiler_export_chrome_trace(const char* path);
+
+#if KPROFILER_ENABLED == 1
+// Opens a profiler zone with the given name.
+#define KPROFILE_ZONE_BEGIN(name) profiler_zone_begin(name)
+// Opens a profiler zone named after the current function.
+#define KPROFILE_FUNCTION_BEGIN() profiler_zone_begin(__FUNCTION__)
+// Closes the innermost profiler zone. Must be called on every path out of the zone.
+#define KPROFILE_ZONE_END() profiler_zone_end()
+// Marks the end of a frame.
+#define KPROFILE_FRAME_MARK() profiler_frame_mark()
+#else
+#define KPROFILE_ZONE_BEGIN(name)
+#define KPROFILE_FUNCTION_BEGIN()
+#define KPROFILE_ZONE_END()
+#define KPROFILE_FRAME_MARK()
+#endif
@@ -0,0 +1,137 @@
+#include "telemetry.h"
+
+#include "core/logger.h"
+#include "core/kstring.h"
+#include "core/frame_pacer.h"
+#include "core/perf_counters.h"
+#include "platform/platform.h"
+#include "platform/katomic.h"
+
+// Times telemetry_read retries before giving up on a page being written.
+#define TELEMETRY_READ_ATTEMPTS 64
+
+typedef struct telemetry_state {
+    shared_memory memory;
+    telemetry_page* page;
+    // Filled in first, so the page is only locked for a copy.
+    telemetry_page staging;
+} telemetry_state;
+
+static telemetry_state* state_ptr;
+
+static void copy_name(char* dest, const char* source) {
+    string_ncopy(dest, source ? source : "", TELEMETRY_NAME_LENGTH - 1);
+    dest[TELEMETRY_NAME_LENGTH - 1] = 0;
+}
+
+b8 telemetry_initialize(u64* memory_requirement, void* state, const char* application_name) {
+    *memory_requirement = sizeof(telemetry_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(telemetry_state));
+    if (!application_name) {
+        return true;
+    }
+
+    char name[256];
+    telemetry_shared_memory_name(application_name, name);
+    if (!platform_shared_memory_open(name, sizeof(telemetry_page), true, &state_ptr->memory)) {
+        // Not worth stopping the application over.
+        KWARN("Unable to create shared memory '%s'. Telemetry will not be published.", name);
+        return true;
+    }
+
+    state_ptr->page = state_ptr->memory.block;
+    state_ptr->staging.magic = TELEMETRY_MAGIC;
+    state_ptr->staging.version = TELEMETRY_VERSION;
+    state_ptr->staging.size = sizeof(telemetry_page);
+    for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        copy_name(state_ptr->staging.memory_tag_names[i], memory_tag_name(i));
+        string_trim(state_ptr->staging.memory_tag_names[i]);
+    }
+    kcopy_memory(state_ptr->page, &state_ptr->staging, sizeof(telemetry_page));
+
+    KINFO("Publishing telemetry to shared memory '%s'.", name);
+    return true;
+}
+
+void telemetry_shutdown(void* state) {
+    if (state_ptr && state_ptr->page) {
+        platform_shared_memory_close(&state_ptr->memory);
+    }
+    state_ptr = 0;
+}
+
+void telemetry_publish(u64 frame_number, const renderer_stats* renderer) {
+    if (!state_ptr || !state_ptr->page) {
+        return;
+    }
+
+    telemetry_page* staging = &state_ptr->staging;
+    staging->frame_number = frame_number;
+    staging->time = platform_get_absolute_time();
+    frame_stats_get(&staging->frame_stats);
+    staging->pacing_interval = frame_pacer_interval_get();
+    staging->memory_allocation_count = get_memory_alloc_count();
+    memory_system_stats_get(&staging->memory);
+    if (renderer) {
+        staging->renderer = *renderer;
+    }
+
+    staging->counter_count = 0;
+    for (u32 i = 0; i < TELEMETRY_MAX_COUNTERS; ++i) {
+        const char* name = perf_counter_name(i);
+        if (!name) {
+            break;
+        }
+        telemetry_counter* counter = &staging->counters[staging->counter_count++];
+        copy_name(counter->name, name);
+        counter->value = 0;
+        perf_counter_get(i, 0, &counter->value);
+    }
+
+    // Seqlock write. The sequence is only ever written here, so it can be read back plainly.
+    telemetry_page* page = state_ptr->page;
+    u32 sequence = page->sequence;
+    katomic_store_u32(&page->sequence, sequence + 1, KATOMIC_RELAXED);
+    // Keeps the data writes below from being seen before the odd sequence.
+    katomic_fence(KATOMIC_RELEASE);
+    // The header and sequence are left as they are.
+    u64 header_size = sizeof(u32) * 4;
+    kcopy_memory((u8*)page + header_size, (u8*)staging + header_size, sizeof(telemetry_page) - header_size);
+    katomic_store_u32(&page->sequence, sequence + 2, KATOMIC_RELEASE);
+}
+
+void telemetry_shared_memory_name(const char* application_name, char* out_name) {
+    string_format(out_name, "%.200s_telemetry", application_name);
+    // Keep to characters every platform accepts in a shared memory name.
+    for (char* c = out_name; *c; ++c) {
+        if (*c == ' ' || *c == '/' || *c == '\\') {
+            *c = '_';
+        }
+    }
+}
+
+b8 telemetry_read(const telemetry_page* page, telemetry_page* out_page) {
+    if (page->magic != TELEMETRY_MAGIC || page->version != TELEMETRY_VERSION || page->size != sizeof(telemetry_page)) {
+        return false;
+    }
+
+    for (u32 attempt = 0; attempt < TELEMETRY_READ_ATTEMPTS; ++attempt) {
+        u32 begin = katomic_load_u32(&page->sequence, KATOMIC_ACQUIRE);
+        if (begin & 1) {
+            // Being written.
+            continue;
+        }
+        kcopy_memory(out_page, page, sizeof(telemetry_page));
+        // Keeps the copy above from being moved past the check below.
+        katomic_fence(KATOMIC_ACQUIRE);
+        if (katomic_load_u32(&page->sequence, KATOMIC_RELAXED) == begin) {
+            return true;
+        }
+    }
+    return false;
+}
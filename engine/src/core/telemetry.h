@@ -0,0 +1,91 @@
+#pragma once
+
+#include "defines.h"
+#include "core/kmemory.h"
+#include "core/frame_stats.h"
+#include "renderer/renderer_types.inl"
+
+// Identifies a telemetry page. 'KTEL'.
+#define TELEMETRY_MAGIC 0x4C45544B
+// Bumped whenever the layout of telemetry_page changes.
+#define TELEMETRY_VERSION 1
+// Maximum number of performance counters published.
+#define TELEMETRY_MAX_COUNTERS 32
+// Maximum length of a published name, including the terminator.
+#define TELEMETRY_NAME_LENGTH 32
+
+typedef struct telemetry_counter {
+    char name[TELEMETRY_NAME_LENGTH];
+    // The counter's value in the last frame.
+    u64 value;
+} telemetry_counter;
+
+/**
+ * The page of live stats published to shared memory once per frame. Readers
+ * must copy it with telemetry_read, which retries while the page is being written.
+ */
+typedef struct telemetry_page {
+    // Written once, when the page is created.
+    u32 magic;
+    u32 version;
+    // sizeof(telemetry_page) in the engine which wrote it.
+    u32 size;
+    // Odd while the page is being written. Readers retry if it was odd or changed during their copy.
+    u32 sequence;
+
+    u64 frame_number;
+    // platform_get_absolute_time of the publish, in seconds.
+    f64 time;
+
+    frame_stats frame_stats;
+    // Interval frames are paced at, in seconds. 0 if unlimited.
+    f64 pacing_interval;
+
+    u64 memory_allocation_count;
+    memory_stats memory;
+    char memory_tag_names[MEMORY_TAG_MAX_TAGS][TELEMETRY_NAME_LENGTH];
+
+    renderer_stats renderer;
+
+    u32 counter_count;
+    telemetry_counter counters[TELEMETRY_MAX_COUNTERS];
+} telemetry_page;
+
+/**
+ * @brief Initializes telemetry. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param application_name The name of the application, which the shared memory is named after. 0 disables publishing.
+ * @return b8 True on success; otherwise false.
+ */
+b8 telemetry_initialize(u64* memory_requirement, void* state, const char* application_name);
+void telemetry_shutdown(void* state);
+
+/**
+ * @brief Publishes the current stats to the telemetry page. Called by the application
+ * once per frame, after performance counters have been snapshot.
+ *
+ * @param frame_number The number of the frame which ended.
+ * @param renderer The state of the renderer. Optional.
+ */
+void telemetry_publish(u64 frame_number, const renderer_stats* renderer);
+
+/**
+ * @brief Gets the name of the shared memory an application publishes telemetry to.
+ *
+ * @param application_name The name of the application.
+ * @param out_name A buffer to hold the name. Should be at least 256 characters.
+ */
+KAPI void telemetry_shared_memory_name(const char* application_name, char* out_name);
+
+/**
+ * @brief Copies a consistent snapshot of a telemetry page, which may be written to
+ * concurrently by another process.
+ *
+ * @param page A pointer to the shared page.
+ * @param out_page A pointer to hold the copy.
+ * @return True if a consistent copy of a page of this version was taken; otherwise false.
+ */
+KAPI b8 telemetry_read(const telemetry_page* page, telemetry_page* out_page);
@@ -51,6 +51,9 @@ STATIC_ASSERT(sizeof(f64) == 8, "f64 is not 8 bytes");
  */
 #define INVALID_ID 4294967295U
 
+// Timeout for blocking waits, i.e. on semaphores, which never expires.
+#define KWAIT_FOREVER 0xFFFFFFFFFFFFFFFFULL
+
 // Platform detection
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
 #define KPLATFORM_WINDOWS 1
@@ -116,3 +119,17 @@ STATIC_ASSERT(sizeof(f64) == 8, "f64 is not 8 bytes");
 #define KNOINLINE
 #endif
 
+// Thread-local storage
+#ifdef _MSC_VER
+#define KTHREAD_LOCAL __declspec(thread)
+#else
+#define KTHREAD_LOCAL _Thread_local
+#endif
+
+// Alignment of a type or member, in bytes.
+#ifdef _MSC_VER
+#define KALIGN(n) __declspec(align(n))
+#else
+#define KALIGN(n) __attribute__((aligned(n)))
+#endif
+
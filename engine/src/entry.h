@@ -15,7 +15,8 @@ extern b8 create_game(game* out_game);
 int main(void)
 {
 	//Request the game instance from the application
-	game game_inst;
+	// Zeroed, so optional function pointers the game does not set are null.
+	game game_inst = {};
 	if (!create_game(&game_inst))
 	{
 		KFATAL("Failed to create game instance.");
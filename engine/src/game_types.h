@@ -2,6 +2,8 @@
 
 #include "core/application.h"
 
+struct task_graph;
+
 /**
  * Represents the basic game state in a game.
  * Called for creation of the application.
@@ -19,6 +21,11 @@ typedef struct game {
 	//Function pointer to game's render function
 	b8 (*render)(struct game* game_inst, f32 delta_time);
 
+	// Optional. Adds the game's own tasks to the frame graph, between update and render.
+	// Tasks which declare their reads and writes can run in parallel with each other.
+	// The engine's tasks use the resources "input", "game" and "render packet".
+	b8 (*build_frame_graph)(struct game* game_inst, struct task_graph* graph, f32 delta_time);
+
 	//Function pointer to handle zesizes, if applicable
 	void (*on_resize)(struct game* game_inst, u32 width, u32 height);
 
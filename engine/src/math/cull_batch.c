@@ -0,0 +1,167 @@
+#include "cull_batch.h"
+
+#include "math/kmath.h"
+#include "platform/katomic.h"
+#include "systems/job_system.h"
+
+// Bounds per job when split across threads, unless there are too many for that. A multiple of 64.
+#define CULL_BATCH_JOB_SIZE 1024
+
+// Writes count bits for the indices from i, which must all fall in the same u64.
+KINLINE void write_bits(u64* mask, u32 i, u64 bits, u32 count) {
+    u64 field = ((1ULL << count) - 1) << (i % 64);
+    mask[i / 64] = (mask[i / 64] & ~field) | (bits << (i % 64));
+}
+
+// Index of the first multiple of 4 at or after begin, where the SIMD loops start, within end.
+KINLINE u32 simd_begin(u32 begin, u32 end) {
+    u32 aligned = (begin + 3) & ~3u;
+    return aligned < end ? aligned : end;
+}
+
+static u32 cull_spheres_scalar(const frustum* f, sphere_soa spheres, u32 begin, u32 end, u64* out_visible) {
+    u32 visible_count = 0;
+    for (u32 i = begin; i < end; ++i) {
+        sphere s = {{spheres.center.x[i], spheres.center.y[i], spheres.center.z[i]}, spheres.radius[i]};
+        b8 visible = frustum_intersects_sphere(f, s);
+        write_bits(out_visible, i, visible, 1);
+        visible_count += visible;
+    }
+    return visible_count;
+}
+
+static u32 cull_aabbs_scalar(const frustum* f, aabb_soa boxes, u32 begin, u32 end, u64* out_visible) {
+    u32 visible_count = 0;
+    for (u32 i = begin; i < end; ++i) {
+        aabb box = {
+            {boxes.min.x[i], boxes.min.y[i], boxes.min.z[i]},
+            {boxes.max.x[i], boxes.max.y[i], boxes.max.z[i]}};
+        b8 visible = frustum_intersects_aabb(f, box);
+        write_bits(out_visible, i, visible, 1);
+        visible_count += visible;
+    }
+    return visible_count;
+}
+
+u32 cull_batch_spheres(const frustum* f, sphere_soa spheres, u32 begin, u32 end, u64* out_visible) {
+#if KMATH_SIMD
+    u32 i = simd_begin(begin, end);
+    u32 visible_count = cull_spheres_scalar(f, spheres, begin, i, out_visible);
+
+    // Each plane in every lane, so each lane tests a sphere of its own.
+    f32x4 planes[6][4];
+    for (u32 p = 0; p < 6; ++p) {
+        for (u32 j = 0; j < 4; ++j) {
+            planes[p][j] = f32x4_splat(f->planes[p].elements[j]);
+        }
+    }
+    for (; i + 4 <= end; i += 4) {
+        f32x4 x = f32x4_loadu(spheres.center.x + i);
+        f32x4 y = f32x4_loadu(spheres.center.y + i);
+        f32x4 z = f32x4_loadu(spheres.center.z + i);
+        f32x4 radius = f32x4_loadu(spheres.radius + i);
+        // A sphere is culled when it is wholly behind any plane.
+        u32 culled = 0;
+        for (u32 p = 0; p < 6; ++p) {
+            f32x4 distance = f32x4_madd(z, planes[p][2], f32x4_madd(y, planes[p][1], f32x4_madd(x, planes[p][0], planes[p][3])));
+            culled |= f32x4_negative_mask(f32x4_add(distance, radius));
+        }
+        u32 visible = ~culled & 0xF;
+        write_bits(out_visible, i, visible, 4);
+        visible_count += (u32)__builtin_popcount(visible);
+    }
+    return visible_count + cull_spheres_scalar(f, spheres, i, end, out_visible);
+#else
+    return cull_spheres_scalar(f, spheres, begin, end, out_visible);
+#endif
+}
+
+u32 cull_batch_aabbs(const frustum* f, aabb_soa boxes, u32 begin, u32 end, u64* out_visible) {
+#if KMATH_SIMD
+    u32 i = simd_begin(begin, end);
+    u32 visible_count = cull_aabbs_scalar(f, boxes, begin, i, out_visible);
+
+    f32x4 planes[6][4];
+    // Which corner is furthest along each plane's normal, per axis; 0 for min, 1 for max.
+    u8 corner[6][3];
+    for (u32 p = 0; p < 6; ++p) {
+        for (u32 j = 0; j < 4; ++j) {
+            planes[p][j] = f32x4_splat(f->planes[p].elements[j]);
+        }
+        for (u32 j = 0; j < 3; ++j) {
+            corner[p][j] = f->planes[p].elements[j] >= 0.0f;
+        }
+    }
+    for (; i + 4 <= end; i += 4) {
+        f32x4 bounds[2][3] = {
+            {f32x4_loadu(boxes.min.x + i), f32x4_loadu(boxes.min.y + i), f32x4_loadu(boxes.min.z + i)},
+            {f32x4_loadu(boxes.max.x + i), f32x4_loadu(boxes.max.y + i), f32x4_loadu(boxes.max.z + i)}};
+        // A box is culled when its corner furthest along any plane's normal is behind it.
+        u32 culled = 0;
+        for (u32 p = 0; p < 6; ++p) {
+            f32x4 x = bounds[corner[p][0]][0];
+            f32x4 y = bounds[corner[p][1]][1];
+            f32x4 z = bounds[corner[p][2]][2];
+            f32x4 distance = f32x4_madd(z, planes[p][2], f32x4_madd(y, planes[p][1], f32x4_madd(x, planes[p][0], planes[p][3])));
+            culled |= f32x4_negative_mask(distance);
+        }
+        u32 visible = ~culled & 0xF;
+        write_bits(out_visible, i, visible, 4);
+        visible_count += (u32)__builtin_popcount(visible);
+    }
+    return visible_count + cull_aabbs_scalar(f, boxes, i, end, out_visible);
+#else
+    return cull_aabbs_scalar(f, boxes, begin, end, out_visible);
+#endif
+}
+
+/**
+ * Bounds per job for count in all. parallel_for grows the batches itself past
+ * JOB_SYSTEM_MAX_PARALLEL_BATCHES of them, to sizes which needn't be multiples of 64,
+ * so that is done here instead and rounded up, so no two jobs write the same u64 of the mask.
+ */
+static u32 job_size(u32 count) {
+    u32 size = (u32)(((u64)count + JOB_SYSTEM_MAX_PARALLEL_BATCHES - 1) / JOB_SYSTEM_MAX_PARALLEL_BATCHES);
+    if (size < CULL_BATCH_JOB_SIZE) {
+        size = CULL_BATCH_JOB_SIZE;
+    }
+    return (size + 63) & ~63u;
+}
+
+typedef struct cull_batch_params {
+    const frustum* f;
+    sphere_soa spheres;
+    aabb_soa boxes;
+    u64* out_visible;
+    volatile u32 visible_count;
+} cull_batch_params;
+
+static void cull_spheres_range(u32 begin, u32 end, void* params) {
+    cull_batch_params* p = params;
+    u32 visible_count = cull_batch_spheres(p->f, p->spheres, begin, end, p->out_visible);
+    katomic_fetch_add_u32(&p->visible_count, visible_count, KATOMIC_RELAXED);
+}
+
+static void cull_aabbs_range(u32 begin, u32 end, void* params) {
+    cull_batch_params* p = params;
+    u32 visible_count = cull_batch_aabbs(p->f, p->boxes, begin, end, p->out_visible);
+    katomic_fetch_add_u32(&p->visible_count, visible_count, KATOMIC_RELAXED);
+}
+
+u32 cull_batch_spheres_parallel(const frustum* f, sphere_soa spheres, u32 count, u64* out_visible) {
+    cull_batch_params params = {0};
+    params.f = f;
+    params.spheres = spheres;
+    params.out_visible = out_visible;
+    job_system_parallel_for(count, job_size(count), cull_spheres_range, &params, JOB_PRIORITY_HIGH);
+    return katomic_load_u32(&params.visible_count, KATOMIC_RELAXED);
+}
+
+u32 cull_batch_aabbs_parallel(const frustum* f, aabb_soa boxes, u32 count, u64* out_visible) {
+    cull_batch_params params = {0};
+    params.f = f;
+    params.boxes = boxes;
+    params.out_visible = out_visible;
+    job_system_parallel_for(count, job_size(count), cull_aabbs_range, &params, JOB_PRIORITY_HIGH);
+    return katomic_load_u32(&params.visible_count, KATOMIC_RELAXED);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.h"
+#include "math_types.h"
+
+/**
+ * Tests many bounds against a frustum at once, four at a time with SIMD, writing a bit
+ * per bound to a visibility mask; bit i of out_visible[i / 64] is set if bound i may be
+ * visible. As with transform_batch, each function works on the indices [begin, end), so
+ * the work can be split across jobs. Concurrent calls must not share a u64 of the mask,
+ * so ranges split between them should begin on multiples of 64.
+ */
+
+/**
+ * @brief Tests spheres against a frustum, as frustum_intersects_sphere does.
+ *
+ * @param f The frustum to test against.
+ * @param spheres The spheres to test.
+ * @param begin The first index to test.
+ * @param end One past the last index to test.
+ * @param out_visible The mask to write to, at least (end + 63) / 64 u64s. Only bits in the range are written.
+ * @return u32 The number of spheres in the range which may be visible.
+ */
+KAPI u32 cull_batch_spheres(const frustum* f, sphere_soa spheres, u32 begin, u32 end, u64* out_visible);
+
+/**
+ * @brief Tests boxes against a frustum, as frustum_intersects_aabb does.
+ *
+ * @param f The frustum to test against.
+ * @param boxes The boxes to test.
+ * @param begin The first index to test.
+ * @param end One past the last index to test.
+ * @param out_visible The mask to write to, at least (end + 63) / 64 u64s. Only bits in the range are written.
+ * @return u32 The number of boxes in the range which may be visible.
+ */
+KAPI u32 cull_batch_aabbs(const frustum* f, aabb_soa boxes, u32 begin, u32 end, u64* out_visible);
+
+/** @brief As cull_batch_spheres over [0, count), split across the job system's threads. */
+KAPI u32 cull_batch_spheres_parallel(const frustum* f, sphere_soa spheres, u32 count, u64* out_visible);
+
+/** @brief As cull_batch_aabbs over [0, count), split across the job system's threads. */
+KAPI u32 cull_batch_aabbs_parallel(const frustum* f, aabb_soa boxes, u32 count, u64* out_visible);
+
+/** @brief Indicates if bit i of a visibility mask is set. */
+KINLINE b8 cull_batch_visible(const u64* visible, u32 i) {
+    return (visible[i / 64] >> (i % 64)) & 1;
+}
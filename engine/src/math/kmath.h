@@ -29,6 +29,183 @@
 // Smallest positive number where 1.0 + FLOAT_EPSILON != 0
 #define K_FLOAT_EPSILON 1.192092896e-07f
 
+// ------------------------------------------
+// SIMD
+// ------------------------------------------
+
+/*
+ * vec4 and mat4 operations use SSE on x64 and NEON on ARM, through the f32x4 functions
+ * below. Building with KMATH_NO_SIMD selects the scalar path instead. The scalar versions
+ * of mat4's are always available as *_reference, which the SIMD path is checked against.
+ * Multiply-adds are fused on ARM, and on x64 where FMA is enabled (i.e. -mfma or
+ * /arch:AVX2), so results may differ from the scalar path in the last bits.
+ */
+#if defined(KMATH_NO_SIMD)
+#define KMATH_SIMD 0
+#elif defined(__SSE2__) || defined(_M_X64)
+#define KMATH_SIMD 1
+#define KMATH_SSE 1
+#include <emmintrin.h>
+#if defined(__FMA__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+// Shuffles need the compiler's vector extensions on ARM.
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) && (defined(__clang__) || __GNUC__ >= 12)
+#define KMATH_SIMD 1
+#define KMATH_NEON 1
+#include <arm_neon.h>
+#else
+#define KMATH_SIMD 0
+#endif
+
+#if KMATH_SSE
+typedef __m128 f32x4;
+
+// Loads from 16 byte aligned memory.
+KINLINE f32x4 f32x4_load(const f32* p) {
+    return _mm_load_ps(p);
+}
+
+// Stores to 16 byte aligned memory.
+KINLINE void f32x4_store(f32* p, f32x4 v) {
+    _mm_store_ps(p, v);
+}
+
+// Loads from memory of any alignment.
+KINLINE f32x4 f32x4_loadu(const f32* p) {
+    return _mm_loadu_ps(p);
+}
+
+// Stores to memory of any alignment.
+KINLINE void f32x4_storeu(f32* p, f32x4 v) {
+    _mm_storeu_ps(p, v);
+}
+
+KINLINE f32x4 f32x4_set(f32 x, f32 y, f32 z, f32 w) {
+    return _mm_setr_ps(x, y, z, w);
+}
+
+KINLINE f32x4 f32x4_splat(f32 value) {
+    return _mm_set1_ps(value);
+}
+
+KINLINE f32x4 f32x4_add(f32x4 a, f32x4 b) {
+    return _mm_add_ps(a, b);
+}
+
+KINLINE f32x4 f32x4_sub(f32x4 a, f32x4 b) {
+    return _mm_sub_ps(a, b);
+}
+
+KINLINE f32x4 f32x4_mul(f32x4 a, f32x4 b) {
+    return _mm_mul_ps(a, b);
+}
+
+KINLINE f32x4 f32x4_div(f32x4 a, f32x4 b) {
+    return _mm_div_ps(a, b);
+}
+
+// a * b + c.
+KINLINE f32x4 f32x4_madd(f32x4 a, f32x4 b, f32x4 c) {
+#if defined(__FMA__) || defined(__AVX2__)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// The sum of all four lanes, in every lane.
+KINLINE f32x4 f32x4_sum(f32x4 v) {
+    f32x4 pairs = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// A bit per lane, set where it is negative; lane 0 in bit 0.
+KINLINE u32 f32x4_negative_mask(f32x4 v) {
+    return (u32)_mm_movemask_ps(_mm_cmplt_ps(v, _mm_setzero_ps()));
+}
+
+// Lanes i0 and i1 of a, then i2 and i3 of b. Indices must be constants.
+#define f32x4_shuffle(a, b, i0, i1, i2, i3) _mm_shuffle_ps(a, b, _MM_SHUFFLE(i3, i2, i1, i0))
+#elif KMATH_NEON
+typedef float32x4_t f32x4;
+
+KINLINE f32x4 f32x4_load(const f32* p) {
+    return vld1q_f32(p);
+}
+
+KINLINE void f32x4_store(f32* p, f32x4 v) {
+    vst1q_f32(p, v);
+}
+
+// NEON loads and stores need no alignment.
+KINLINE f32x4 f32x4_loadu(const f32* p) {
+    return vld1q_f32(p);
+}
+
+KINLINE void f32x4_storeu(f32* p, f32x4 v) {
+    vst1q_f32(p, v);
+}
+
+KINLINE f32x4 f32x4_set(f32 x, f32 y, f32 z, f32 w) {
+    return (f32x4){x, y, z, w};
+}
+
+KINLINE f32x4 f32x4_splat(f32 value) {
+    return vdupq_n_f32(value);
+}
+
+KINLINE f32x4 f32x4_add(f32x4 a, f32x4 b) {
+    return vaddq_f32(a, b);
+}
+
+KINLINE f32x4 f32x4_sub(f32x4 a, f32x4 b) {
+    return vsubq_f32(a, b);
+}
+
+KINLINE f32x4 f32x4_mul(f32x4 a, f32x4 b) {
+    return vmulq_f32(a, b);
+}
+
+KINLINE f32x4 f32x4_div(f32x4 a, f32x4 b) {
+    return vdivq_f32(a, b);
+}
+
+// a * b + c. Fused, as on every AArch64 CPU.
+KINLINE f32x4 f32x4_madd(f32x4 a, f32x4 b, f32x4 c) {
+    return vfmaq_f32(c, a, b);
+}
+
+KINLINE f32x4 f32x4_sum(f32x4 v) {
+    return vdupq_n_f32(vaddvq_f32(v));
+}
+
+KINLINE u32 f32x4_negative_mask(f32x4 v) {
+    uint32x4_t negative = vcltq_f32(v, vdupq_n_f32(0.0f));
+    return vaddvq_u32(vandq_u32(negative, (uint32x4_t){1, 2, 4, 8}));
+}
+
+#define f32x4_shuffle(a, b, i0, i1, i2, i3) __builtin_shufflevector(a, b, i0, i1, (i2) + 4, (i3) + 4)
+#endif
+
+#if KMATH_SIMD
+// Lane i of v, in every lane.
+#define f32x4_lane(v, i) f32x4_shuffle(v, v, i, i, i, i)
+
+// Swaps the rows and columns of four vectors, i.e. turns the x, y, z and w of four
+// vectors into the four vectors.
+KINLINE void f32x4_transpose(f32x4 rows[4]) {
+    f32x4 low_01 = f32x4_shuffle(rows[0], rows[1], 0, 1, 0, 1);
+    f32x4 high_01 = f32x4_shuffle(rows[0], rows[1], 2, 3, 2, 3);
+    f32x4 low_23 = f32x4_shuffle(rows[2], rows[3], 0, 1, 0, 1);
+    f32x4 high_23 = f32x4_shuffle(rows[2], rows[3], 2, 3, 2, 3);
+    rows[0] = f32x4_shuffle(low_01, low_23, 0, 2, 0, 2);
+    rows[1] = f32x4_shuffle(low_01, low_23, 1, 3, 1, 3);
+    rows[2] = f32x4_shuffle(high_01, high_23, 0, 2, 0, 2);
+    rows[3] = f32x4_shuffle(high_01, high_23, 1, 3, 1, 3);
+}
+#endif
+
 // ------------------------------------------
 // General math functions
 // ------------------------------------------
@@ -598,11 +775,17 @@ KINLINE vec4 vec4_one() {
  * @return The resulting vector. 
  */
 KINLINE vec4 vec4_add(vec4 vector_0, vec4 vector_1) {
+#if KMATH_SIMD
+    vec4 result;
+    f32x4_store(result.elements, f32x4_add(f32x4_load(vector_0.elements), f32x4_load(vector_1.elements)));
+    return result;
+#else
     vec4 result;
-     for (u64 i = 0; i < 4; ++i) {
+    for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = vector_0.elements[i] + vector_1.elements[i];
     }
     return result;
+#endif
 }
 
 /**
@@ -613,11 +796,17 @@ KINLINE vec4 vec4_add(vec4 vector_0, vec4 vector_1) {
  * @return The resulting vector. 
  */
 KINLINE vec4 vec4_sub(vec4 vector_0, vec4 vector_1) {
+#if KMATH_SIMD
+    vec4 result;
+    f32x4_store(result.elements, f32x4_sub(f32x4_load(vector_0.elements), f32x4_load(vector_1.elements)));
+    return result;
+#else
     vec4 result;
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = vector_0.elements[i] - vector_1.elements[i];
     }
     return result;
+#endif
 }
 
 /**
@@ -628,11 +817,17 @@ KINLINE vec4 vec4_sub(vec4 vector_0, vec4 vector_1) {
  * @return The resulting vector. 
  */
 KINLINE vec4 vec4_mul(vec4 vector_0, vec4 vector_1) {
+#if KMATH_SIMD
+    vec4 result;
+    f32x4_store(result.elements, f32x4_mul(f32x4_load(vector_0.elements), f32x4_load(vector_1.elements)));
+    return result;
+#else
     vec4 result;
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = vector_0.elements[i] * vector_1.elements[i];
     }
     return result;
+#endif
 }
 
 /**
@@ -643,11 +838,17 @@ KINLINE vec4 vec4_mul(vec4 vector_0, vec4 vector_1) {
  * @return The resulting vector. 
  */
 KINLINE vec4 vec4_div(vec4 vector_0, vec4 vector_1) {
+#if KMATH_SIMD
+    vec4 result;
+    f32x4_store(result.elements, f32x4_div(f32x4_load(vector_0.elements), f32x4_load(vector_1.elements)));
+    return result;
+#else
     vec4 result;
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = vector_0.elements[i] / vector_1.elements[i];
     }
     return result;
+#endif
 }
 
 /**
@@ -728,14 +929,8 @@ KINLINE mat4 mat4_identity() {
     return out_matrix;
 }
 
-/**
- * @brief Returns the result of multiplying matrix_0 and matrix_1.
- * 
- * @param matrix_0 The first matrix to be multiplied.
- * @param matrix_1 The second matrix to be multiplied.
- * @return The result of the matrix multiplication.
- */
-KINLINE mat4 mat4_mul(mat4 matrix_0, mat4 matrix_1) {
+// The scalar reference for mat4_mul.
+KINLINE mat4 mat4_mul_reference(mat4 matrix_0, mat4 matrix_1) {
     mat4 out_matrix = mat4_identity();
 
     const f32* m1_ptr = matrix_0.data;
@@ -756,6 +951,35 @@ KINLINE mat4 mat4_mul(mat4 matrix_0, mat4 matrix_1) {
     return out_matrix;
 }
 
+/**
+ * @brief Returns the result of multiplying matrix_0 and matrix_1.
+ * 
+ * @param matrix_0 The first matrix to be multiplied.
+ * @param matrix_1 The second matrix to be multiplied.
+ * @return The result of the matrix multiplication.
+ */
+KINLINE mat4 mat4_mul(mat4 matrix_0, mat4 matrix_1) {
+#if KMATH_SIMD
+    mat4 out_matrix;
+    f32x4 rows[4];
+    for (u32 i = 0; i < 4; ++i) {
+        rows[i] = f32x4_load(matrix_1.data + i * 4);
+    }
+    // Each row of the result is the rows of matrix_1, weighted by that row of matrix_0.
+    for (u32 i = 0; i < 4; ++i) {
+        f32x4 row = f32x4_load(matrix_0.data + i * 4);
+        f32x4 result = f32x4_mul(f32x4_lane(row, 0), rows[0]);
+        result = f32x4_madd(f32x4_lane(row, 1), rows[1], result);
+        result = f32x4_madd(f32x4_lane(row, 2), rows[2], result);
+        result = f32x4_madd(f32x4_lane(row, 3), rows[3], result);
+        f32x4_store(out_matrix.data + i * 4, result);
+    }
+    return out_matrix;
+#else
+    return mat4_mul_reference(matrix_0, matrix_1);
+#endif
+}
+
 /**
  * @brief Creates and returns an orthographic projection matrix. Typically used to
  * render flat or 2D scenes.
@@ -846,13 +1070,8 @@ KINLINE mat4 mat4_look_at(vec3 position, vec3 target, vec3 up) {
     return out_matrix;
 }
 
-/**
- * @brief Returns a transposed copy of the provided matrix (rows->colums)
- * 
- * @param matrix The matrix to be transposed.
- * @return A transposed copy of of the provided matrix.
- */
-KINLINE mat4 mat4_transposed(mat4 matrix) {
+// The scalar reference for mat4_transposed.
+KINLINE mat4 mat4_transposed_reference(mat4 matrix) {
     mat4 out_matrix = mat4_identity();
     out_matrix.data[0] = matrix.data[0];
     out_matrix.data[1] = matrix.data[4];
@@ -874,12 +1093,35 @@ KINLINE mat4 mat4_transposed(mat4 matrix) {
 }
 
 /**
- * @brief Creates and returns an inverse of the provided matrix.
+ * @brief Returns a transposed copy of the provided matrix (rows->colums)
  * 
- * @param matrix The matrix to be inverted.
- * @return A inverted copy of the provided matrix. 
+ * @param matrix The matrix to be transposed.
+ * @return A transposed copy of of the provided matrix.
  */
-KINLINE mat4 mat4_inverse(mat4 matrix) {
+KINLINE mat4 mat4_transposed(mat4 matrix) {
+#if KMATH_SIMD
+    mat4 out_matrix;
+    f32x4 row0 = f32x4_load(matrix.data);
+    f32x4 row1 = f32x4_load(matrix.data + 4);
+    f32x4 row2 = f32x4_load(matrix.data + 8);
+    f32x4 row3 = f32x4_load(matrix.data + 12);
+    // Interleaves pairs of rows, then pairs of those.
+    f32x4 t0 = f32x4_shuffle(row0, row1, 0, 1, 0, 1);
+    f32x4 t1 = f32x4_shuffle(row0, row1, 2, 3, 2, 3);
+    f32x4 t2 = f32x4_shuffle(row2, row3, 0, 1, 0, 1);
+    f32x4 t3 = f32x4_shuffle(row2, row3, 2, 3, 2, 3);
+    f32x4_store(out_matrix.data, f32x4_shuffle(t0, t2, 0, 2, 0, 2));
+    f32x4_store(out_matrix.data + 4, f32x4_shuffle(t0, t2, 1, 3, 1, 3));
+    f32x4_store(out_matrix.data + 8, f32x4_shuffle(t1, t3, 0, 2, 0, 2));
+    f32x4_store(out_matrix.data + 12, f32x4_shuffle(t1, t3, 1, 3, 1, 3));
+    return out_matrix;
+#else
+    return mat4_transposed_reference(matrix);
+#endif
+}
+
+// The scalar reference for mat4_inverse.
+KINLINE mat4 mat4_inverse_reference(mat4 matrix) {
     const f32* m = matrix.data;
 
     f32 t0 = m[10] * m[15];
@@ -937,6 +1179,102 @@ KINLINE mat4 mat4_inverse(mat4 matrix) {
     return out_matrix;
 }
 
+/**
+ * @brief Creates and returns an inverse of the provided matrix.
+ * 
+ * @param matrix The matrix to be inverted.
+ * @return A inverted copy of the provided matrix. 
+ */
+KINLINE mat4 mat4_inverse(mat4 matrix) {
+#if KMATH_SIMD
+    // Inverts by 2x2 blocks, each held in one register as {x00, x01, x10, x11}:
+    // | A B |
+    // | C D |
+    f32x4 row0 = f32x4_load(matrix.data);
+    f32x4 row1 = f32x4_load(matrix.data + 4);
+    f32x4 row2 = f32x4_load(matrix.data + 8);
+    f32x4 row3 = f32x4_load(matrix.data + 12);
+    f32x4 a = f32x4_shuffle(row0, row1, 0, 1, 0, 1);
+    f32x4 b = f32x4_shuffle(row0, row1, 2, 3, 2, 3);
+    f32x4 c = f32x4_shuffle(row2, row3, 0, 1, 0, 1);
+    f32x4 d = f32x4_shuffle(row2, row3, 2, 3, 2, 3);
+
+    // The determinants of A, B, C and D, in that order.
+    f32x4 det_sub = f32x4_sub(
+        f32x4_mul(f32x4_shuffle(row0, row2, 0, 2, 0, 2), f32x4_shuffle(row1, row3, 1, 3, 1, 3)),
+        f32x4_mul(f32x4_shuffle(row0, row2, 1, 3, 1, 3), f32x4_shuffle(row1, row3, 0, 2, 0, 2)));
+    f32x4 det_a = f32x4_lane(det_sub, 0);
+    f32x4 det_b = f32x4_lane(det_sub, 1);
+    f32x4 det_c = f32x4_lane(det_sub, 2);
+    f32x4 det_d = f32x4_lane(det_sub, 3);
+
+    // adj(D) * C and adj(A) * B.
+    f32x4 d_c = f32x4_sub(f32x4_mul(f32x4_shuffle(d, d, 3, 3, 0, 0), c), f32x4_mul(f32x4_shuffle(d, d, 1, 1, 2, 2), f32x4_shuffle(c, c, 2, 3, 0, 1)));
+    f32x4 a_b = f32x4_sub(f32x4_mul(f32x4_shuffle(a, a, 3, 3, 0, 0), b), f32x4_mul(f32x4_shuffle(a, a, 1, 1, 2, 2), f32x4_shuffle(b, b, 2, 3, 0, 1)));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A) * B * adj(D) * C)
+    f32x4 det_m = f32x4_add(f32x4_mul(det_a, det_d), f32x4_mul(det_b, det_c));
+    det_m = f32x4_sub(det_m, f32x4_sum(f32x4_mul(a_b, f32x4_shuffle(d_c, d_c, 0, 2, 1, 3))));
+
+    // X = |D|A - B * (adj(D) * C)
+    f32x4 x = f32x4_sub(f32x4_mul(det_d, a), f32x4_add(f32x4_mul(b, f32x4_shuffle(d_c, d_c, 0, 3, 0, 3)), f32x4_mul(f32x4_shuffle(b, b, 1, 0, 3, 2), f32x4_shuffle(d_c, d_c, 2, 1, 2, 1))));
+    // W = |A|D - C * (adj(A) * B)
+    f32x4 w = f32x4_sub(f32x4_mul(det_a, d), f32x4_add(f32x4_mul(c, f32x4_shuffle(a_b, a_b, 0, 3, 0, 3)), f32x4_mul(f32x4_shuffle(c, c, 1, 0, 3, 2), f32x4_shuffle(a_b, a_b, 2, 1, 2, 1))));
+    // Y = |B|C - D * adj(adj(A) * B)
+    f32x4 y = f32x4_sub(f32x4_mul(det_b, c), f32x4_sub(f32x4_mul(d, f32x4_shuffle(a_b, a_b, 3, 0, 3, 0)), f32x4_mul(f32x4_shuffle(d, d, 1, 0, 3, 2), f32x4_shuffle(a_b, a_b, 2, 1, 2, 1))));
+    // Z = |C|B - A * adj(adj(D) * C)
+    f32x4 z = f32x4_sub(f32x4_mul(det_c, b), f32x4_sub(f32x4_mul(a, f32x4_shuffle(d_c, d_c, 3, 0, 3, 0)), f32x4_mul(f32x4_shuffle(a, a, 1, 0, 3, 2), f32x4_shuffle(d_c, d_c, 2, 1, 2, 1))));
+
+    // The inverse's blocks are the adjugates of those, over |M|.
+    f32x4 r_det_m = f32x4_div(f32x4_set(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+    x = f32x4_mul(x, r_det_m);
+    y = f32x4_mul(y, r_det_m);
+    z = f32x4_mul(z, r_det_m);
+    w = f32x4_mul(w, r_det_m);
+
+    mat4 out_matrix;
+    f32x4_store(out_matrix.data, f32x4_shuffle(x, y, 3, 1, 3, 1));
+    f32x4_store(out_matrix.data + 4, f32x4_shuffle(x, y, 2, 0, 2, 0));
+    f32x4_store(out_matrix.data + 8, f32x4_shuffle(z, w, 3, 1, 3, 1));
+    f32x4_store(out_matrix.data + 12, f32x4_shuffle(z, w, 2, 0, 2, 0));
+    return out_matrix;
+#else
+    return mat4_inverse_reference(matrix);
+#endif
+}
+
+// The scalar reference for mat4_transform_point.
+KINLINE vec3 mat4_transform_point_reference(mat4 matrix, vec3 point) {
+    const f32* m = matrix.data;
+    vec3 out_point;
+    out_point.x = point.x * m[0] + point.y * m[4] + point.z * m[8] + m[12];
+    out_point.y = point.x * m[1] + point.y * m[5] + point.z * m[9] + m[13];
+    out_point.z = point.x * m[2] + point.y * m[6] + point.z * m[10] + m[14];
+    return out_point;
+}
+
+/**
+ * @brief Transforms a point by the provided matrix, as for a model or view matrix;
+ * that is, with a w of 1, and no perspective divide.
+ *
+ * @param matrix The matrix to transform by.
+ * @param point The point to be transformed.
+ * @return The transformed point.
+ */
+KINLINE vec3 mat4_transform_point(mat4 matrix, vec3 point) {
+#if KMATH_SIMD
+    f32x4 result = f32x4_load(matrix.data + 12);
+    result = f32x4_madd(f32x4_splat(point.x), f32x4_load(matrix.data), result);
+    result = f32x4_madd(f32x4_splat(point.y), f32x4_load(matrix.data + 4), result);
+    result = f32x4_madd(f32x4_splat(point.z), f32x4_load(matrix.data + 8), result);
+    vec4 out_point;
+    f32x4_store(out_point.elements, result);
+    return (vec3){out_point.x, out_point.y, out_point.z};
+#else
+    return mat4_transform_point_reference(matrix, point);
+#endif
+}
+
 KINLINE mat4 mat4_translation(vec3 position) {
     mat4 out_matrix = mat4_identity();
     out_matrix.data[12] = position.x;
@@ -1293,4 +1631,70 @@ KINLINE f32 deg_to_rad(f32 degrees) {
  */
 KINLINE f32 rad_to_deg(f32 radians) {
     return radians * K_RAD2DEG_MULTIPLIER;
-}
\ No newline at end of file
+}
+
+// ------------------------------------------
+// Frustum
+// ------------------------------------------
+
+/**
+ * @brief Extracts the frustum a view-projection matrix sees, i.e. mat4_mul(view, projection).
+ * Planes come out in world space; passing a projection alone gives them in view space.
+ *
+ * The near plane is where mat4_perspective puts clip z at -w. Vulkan clips at 0 instead,
+ * which is nearer the camera, so objects there may be drawn when they could have been culled,
+ * but never the other way around.
+ *
+ * @param view_projection The view-projection matrix.
+ * @return The frustum, with normalized planes.
+ */
+KINLINE frustum frustum_from_matrix(mat4 view_projection) {
+    // Clip coordinates are a point times the matrix's columns, and a point is inside when
+    // -w <= x, y, z <= w, so each plane is the w column plus or minus another.
+    const f32* m = view_projection.data;
+    frustum out_frustum;
+    for (u32 i = 0; i < 6; ++i) {
+        u32 column = i / 2;
+        f32 sign = (i & 1) ? -1.0f : 1.0f;
+        vec4 plane = {
+            m[3] + sign * m[column],
+            m[7] + sign * m[4 + column],
+            m[11] + sign * m[8 + column],
+            m[15] + sign * m[12 + column]};
+        f32 length = ksqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        out_frustum.planes[i] = (vec4){plane.x / length, plane.y / length, plane.z / length, plane.w / length};
+    }
+    return out_frustum;
+}
+
+/**
+ * @brief Indicates if any part of a sphere may be within the frustum. Spheres just outside
+ * a corner may pass, as the test is against each plane on its own; no visible sphere fails.
+ */
+KINLINE b8 frustum_intersects_sphere(const frustum* f, sphere s) {
+    for (u32 i = 0; i < 6; ++i) {
+        vec4 plane = f->planes[i];
+        if (plane.x * s.center.x + plane.y * s.center.y + plane.z * s.center.z + plane.w < -s.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Indicates if any part of a box may be within the frustum. As with spheres, boxes
+ * just outside a corner may pass.
+ */
+KINLINE b8 frustum_intersects_aabb(const frustum* f, aabb box) {
+    for (u32 i = 0; i < 6; ++i) {
+        vec4 plane = f->planes[i];
+        // The corner furthest along the normal; if that is behind the plane, so is the rest.
+        f32 x = plane.x >= 0.0f ? box.max.x : box.min.x;
+        f32 y = plane.y >= 0.0f ? box.max.y : box.min.y;
+        f32 z = plane.z >= 0.0f ? box.max.z : box.min.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
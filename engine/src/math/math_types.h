@@ -33,9 +33,10 @@ typedef union vec3_u {
 	};
 } vec3;
 
+// 16 byte aligned, so it can be loaded into a SIMD register as is.
 typedef union vec4_u {
 	// An array of x, y, z, w
-	f32 elements[4];
+	KALIGN(16) f32 elements[4];
 	struct {
 		union {
 			// the first element
@@ -55,10 +56,63 @@ typedef union vec4_u {
 
 typedef vec4 quat;
 
+// Four rows of four, 16 byte aligned like vec4.
 typedef union mat4_u {
-    f32 data[16];
+    KALIGN(16) f32 data[16];
 } mat4;
 
+/**
+ * Many vec3s, as an array per component (structure of arrays), so that four of them
+ * can be loaded into SIMD registers at once. The arrays need no particular alignment.
+ */
+typedef struct vec3_soa {
+    f32* x;
+    f32* y;
+    f32* z;
+} vec3_soa;
+
+// Many quats, as an array per component. See vec3_soa.
+typedef struct quat_soa {
+    f32* x;
+    f32* y;
+    f32* z;
+    f32* w;
+} quat_soa;
+
+// An axis-aligned bounding box.
+typedef struct aabb {
+    vec3 min;
+    vec3 max;
+} aabb;
+
+// A bounding sphere.
+typedef struct sphere {
+    vec3 center;
+    f32 radius;
+} sphere;
+
+// Many aabbs, as an array per component. See vec3_soa.
+typedef struct aabb_soa {
+    vec3_soa min;
+    vec3_soa max;
+} aabb_soa;
+
+// Many spheres, as an array per component. See vec3_soa.
+typedef struct sphere_soa {
+    vec3_soa center;
+    f32* radius;
+} sphere_soa;
+
+/**
+ * The six planes bounding what a camera can see, facing inward. Each is held as its
+ * normal in xyz and its distance in w, so a point is in front of it when
+ * dot(normal, point) + w >= 0. Normals are unit length, so that is also the distance.
+ */
+typedef struct frustum {
+    // Left, right, bottom, top, near, far.
+    vec4 planes[6];
+} frustum;
+
 typedef struct vertex_3d {
     vec3 position;
 	vec2 texcoord;
@@ -0,0 +1,203 @@
+#include "transform_batch.h"
+
+#include "math/kmath.h"
+#include "systems/job_system.h"
+
+// Objects per job when split across threads. A multiple of 4, so only the last job has a scalar tail.
+#define TRANSFORM_BATCH_JOB_SIZE 1024
+
+static void compose_one(vec3_soa positions, quat_soa rotations, vec3_soa scales, u32 i, mat4* out_matrix) {
+    f32 x = rotations.x[i], y = rotations.y[i], z = rotations.z[i], w = rotations.w[i];
+    // Scaling by 2 / |q|^2 rather than normalizing first, which saves a square root.
+    f32 s = 2.0f / (x * x + y * y + z * z + w * w);
+    f32 xx = x * x * s, yy = y * y * s, zz = z * z * s;
+    f32 xy = x * y * s, xz = x * z * s, yz = y * z * s;
+    f32 xw = x * w * s, yw = y * w * s, zw = z * w * s;
+
+    f32* m = out_matrix->data;
+    m[0] = (1.0f - yy - zz) * scales.x[i];
+    m[1] = (xy - zw) * scales.x[i];
+    m[2] = (xz + yw) * scales.x[i];
+    m[3] = 0.0f;
+    m[4] = (xy + zw) * scales.y[i];
+    m[5] = (1.0f - xx - zz) * scales.y[i];
+    m[6] = (yz - xw) * scales.y[i];
+    m[7] = 0.0f;
+    m[8] = (xz - yw) * scales.z[i];
+    m[9] = (yz + xw) * scales.z[i];
+    m[10] = (1.0f - xx - yy) * scales.z[i];
+    m[11] = 0.0f;
+    m[12] = positions.x[i];
+    m[13] = positions.y[i];
+    m[14] = positions.z[i];
+    m[15] = 1.0f;
+}
+
+#if KMATH_SIMD
+// Writes one row of four matrices, given as each of its columns across the four.
+KINLINE void store_row(f32x4 columns[4], mat4* out_matrices, u32 row) {
+    f32x4_transpose(columns);
+    for (u32 i = 0; i < 4; ++i) {
+        f32x4_store(out_matrices[i].data + row * 4, columns[i]);
+    }
+}
+#endif
+
+void transform_batch_compose(vec3_soa positions, quat_soa rotations, vec3_soa scales, u32 begin, u32 end, mat4* out_matrices) {
+    u32 i = begin;
+#if KMATH_SIMD
+    f32x4 zero = f32x4_splat(0.0f);
+    f32x4 one = f32x4_splat(1.0f);
+    f32x4 two = f32x4_splat(2.0f);
+    // Four objects at a time, each in a lane of its own, as compose_one does them.
+    for (; i + 4 <= end; i += 4) {
+        f32x4 x = f32x4_loadu(rotations.x + i);
+        f32x4 y = f32x4_loadu(rotations.y + i);
+        f32x4 z = f32x4_loadu(rotations.z + i);
+        f32x4 w = f32x4_loadu(rotations.w + i);
+        f32x4 length_squared = f32x4_madd(w, w, f32x4_madd(z, z, f32x4_madd(y, y, f32x4_mul(x, x))));
+        f32x4 s = f32x4_div(two, length_squared);
+        f32x4 xs = f32x4_mul(x, s), ys = f32x4_mul(y, s), zs = f32x4_mul(z, s);
+        f32x4 xx = f32x4_mul(x, xs), yy = f32x4_mul(y, ys), zz = f32x4_mul(z, zs);
+        f32x4 xy = f32x4_mul(x, ys), xz = f32x4_mul(x, zs), yz = f32x4_mul(y, zs);
+        f32x4 xw = f32x4_mul(w, xs), yw = f32x4_mul(w, ys), zw = f32x4_mul(w, zs);
+
+        f32x4 scale = f32x4_loadu(scales.x + i);
+        f32x4 columns[4] = {
+            f32x4_mul(f32x4_sub(one, f32x4_add(yy, zz)), scale),
+            f32x4_mul(f32x4_sub(xy, zw), scale),
+            f32x4_mul(f32x4_add(xz, yw), scale),
+            zero};
+        store_row(columns, out_matrices + i, 0);
+
+        scale = f32x4_loadu(scales.y + i);
+        columns[0] = f32x4_mul(f32x4_add(xy, zw), scale);
+        columns[1] = f32x4_mul(f32x4_sub(one, f32x4_add(xx, zz)), scale);
+        columns[2] = f32x4_mul(f32x4_sub(yz, xw), scale);
+        columns[3] = zero;
+        store_row(columns, out_matrices + i, 1);
+
+        scale = f32x4_loadu(scales.z + i);
+        columns[0] = f32x4_mul(f32x4_sub(xz, yw), scale);
+        columns[1] = f32x4_mul(f32x4_add(yz, xw), scale);
+        columns[2] = f32x4_mul(f32x4_sub(one, f32x4_add(xx, yy)), scale);
+        columns[3] = zero;
+        store_row(columns, out_matrices + i, 2);
+
+        columns[0] = f32x4_loadu(positions.x + i);
+        columns[1] = f32x4_loadu(positions.y + i);
+        columns[2] = f32x4_loadu(positions.z + i);
+        columns[3] = one;
+        store_row(columns, out_matrices + i, 3);
+    }
+#endif
+    for (; i < end; ++i) {
+        compose_one(positions, rotations, scales, i, &out_matrices[i]);
+    }
+}
+
+void transform_batch_mul(const mat4* matrices, mat4 matrix, u32 begin, u32 end, mat4* out_matrices) {
+#if KMATH_SIMD
+    // As mat4_mul, with matrix's rows loaded once for the whole batch.
+    f32x4 rows[4];
+    for (u32 i = 0; i < 4; ++i) {
+        rows[i] = f32x4_load(matrix.data + i * 4);
+    }
+    for (u32 i = begin; i < end; ++i) {
+        const f32* in = matrices[i].data;
+        f32* out = out_matrices[i].data;
+        for (u32 j = 0; j < 4; ++j) {
+            f32x4 row = f32x4_load(in + j * 4);
+            f32x4 result = f32x4_mul(f32x4_lane(row, 0), rows[0]);
+            result = f32x4_madd(f32x4_lane(row, 1), rows[1], result);
+            result = f32x4_madd(f32x4_lane(row, 2), rows[2], result);
+            result = f32x4_madd(f32x4_lane(row, 3), rows[3], result);
+            f32x4_store(out + j * 4, result);
+        }
+    }
+#else
+    for (u32 i = begin; i < end; ++i) {
+        out_matrices[i] = mat4_mul_reference(matrices[i], matrix);
+    }
+#endif
+}
+
+void transform_batch_points(mat4 matrix, vec3_soa points, u32 begin, u32 end, vec3_soa out_points) {
+    const f32* m = matrix.data;
+    u32 i = begin;
+#if KMATH_SIMD
+    // Every element of the matrix in every lane, so each lane transforms a point of its own.
+    f32x4 splats[16];
+    for (u32 j = 0; j < 16; ++j) {
+        splats[j] = f32x4_splat(m[j]);
+    }
+    for (; i + 4 <= end; i += 4) {
+        f32x4 x = f32x4_loadu(points.x + i);
+        f32x4 y = f32x4_loadu(points.y + i);
+        f32x4 z = f32x4_loadu(points.z + i);
+        f32x4 out_x = f32x4_madd(z, splats[8], f32x4_madd(y, splats[4], f32x4_madd(x, splats[0], splats[12])));
+        f32x4 out_y = f32x4_madd(z, splats[9], f32x4_madd(y, splats[5], f32x4_madd(x, splats[1], splats[13])));
+        f32x4 out_z = f32x4_madd(z, splats[10], f32x4_madd(y, splats[6], f32x4_madd(x, splats[2], splats[14])));
+        f32x4_storeu(out_points.x + i, out_x);
+        f32x4_storeu(out_points.y + i, out_y);
+        f32x4_storeu(out_points.z + i, out_z);
+    }
+#endif
+    for (; i < end; ++i) {
+        f32 x = points.x[i], y = points.y[i], z = points.z[i];
+        out_points.x[i] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        out_points.y[i] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        out_points.z[i] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
+typedef struct transform_batch_params {
+    vec3_soa positions;
+    quat_soa rotations;
+    vec3_soa scales;
+    const mat4* matrices;
+    mat4 matrix;
+    mat4* out_matrices;
+    vec3_soa out_points;
+} transform_batch_params;
+
+static void compose_range(u32 begin, u32 end, void* params) {
+    transform_batch_params* p = params;
+    transform_batch_compose(p->positions, p->rotations, p->scales, begin, end, p->out_matrices);
+}
+
+static void mul_range(u32 begin, u32 end, void* params) {
+    transform_batch_params* p = params;
+    transform_batch_mul(p->matrices, p->matrix, begin, end, p->out_matrices);
+}
+
+static void points_range(u32 begin, u32 end, void* params) {
+    transform_batch_params* p = params;
+    transform_batch_points(p->matrix, p->positions, begin, end, p->out_points);
+}
+
+void transform_batch_compose_parallel(vec3_soa positions, quat_soa rotations, vec3_soa scales, u32 count, mat4* out_matrices) {
+    transform_batch_params params = {0};
+    params.positions = positions;
+    params.rotations = rotations;
+    params.scales = scales;
+    params.out_matrices = out_matrices;
+    job_system_parallel_for(count, TRANSFORM_BATCH_JOB_SIZE, compose_range, &params, JOB_PRIORITY_HIGH);
+}
+
+void transform_batch_mul_parallel(const mat4* matrices, mat4 matrix, u32 count, mat4* out_matrices) {
+    transform_batch_params params = {0};
+    params.matrices = matrices;
+    params.matrix = matrix;
+    params.out_matrices = out_matrices;
+    job_system_parallel_for(count, TRANSFORM_BATCH_JOB_SIZE, mul_range, &params, JOB_PRIORITY_HIGH);
+}
+
+void transform_batch_points_parallel(mat4 matrix, vec3_soa points, u32 count, vec3_soa out_points) {
+    transform_batch_params params = {0};
+    params.matrix = matrix;
+    // The points are read from positions, as they are for compose.
+    params.positions = points;
+    params.out_points = out_points;
+    job_system_parallel_for(count, TRANSFORM_BATCH_JOB_SIZE, points_range, &params, JOB_PRIORITY_HIGH);
+}
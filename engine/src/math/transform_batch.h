@@ -0,0 +1,59 @@
+#pragma once
+
+#include "defines.h"
+#include "math_types.h"
+
+/**
+ * Transforms many objects at once, i.e. every object in a scene each frame. Inputs are
+ * structures of arrays, so four objects fill a SIMD register; matrices stay as mat4s,
+ * as that is how they are handed to the renderer.
+ *
+ * Each function works on the indices [begin, end), so the work can be split across jobs
+ * by giving each a range of its own. The *_parallel versions do that through the job system.
+ */
+
+/**
+ * @brief Builds world matrices from positions, rotations and scales; the same as
+ * mat4_mul(mat4_mul(mat4_scale(scale), quat_to_mat4(rotation)), mat4_translation(position)).
+ * Rotations need not be normalized.
+ *
+ * @param positions The positions of the objects.
+ * @param rotations The rotations of the objects.
+ * @param scales The scales of the objects.
+ * @param begin The first index to build.
+ * @param end One past the last index to build.
+ * @param out_matrices The matrices to write to, indexed as the inputs are.
+ */
+KAPI void transform_batch_compose(vec3_soa positions, quat_soa rotations, vec3_soa scales, u32 begin, u32 end, mat4* out_matrices);
+
+/**
+ * @brief Multiplies matrices by the same matrix, i.e. world matrices by a view-projection.
+ * out_matrices[i] = mat4_mul(matrices[i], matrix). May be done in place.
+ *
+ * @param matrices The matrices to multiply.
+ * @param matrix The matrix to multiply each of them by.
+ * @param begin The first index to multiply.
+ * @param end One past the last index to multiply.
+ * @param out_matrices The matrices to write to. May be matrices.
+ */
+KAPI void transform_batch_mul(const mat4* matrices, mat4 matrix, u32 begin, u32 end, mat4* out_matrices);
+
+/**
+ * @brief Transforms points by the same matrix, as mat4_transform_point does. May be done in place.
+ *
+ * @param matrix The matrix to transform by.
+ * @param points The points to transform.
+ * @param begin The first index to transform.
+ * @param end One past the last index to transform.
+ * @param out_points The points to write to. May be points.
+ */
+KAPI void transform_batch_points(mat4 matrix, vec3_soa points, u32 begin, u32 end, vec3_soa out_points);
+
+/** @brief As transform_batch_compose over [0, count), split across the job system's threads. */
+KAPI void transform_batch_compose_parallel(vec3_soa positions, quat_soa rotations, vec3_soa scales, u32 count, mat4* out_matrices);
+
+/** @brief As transform_batch_mul over [0, count), split across the job system's threads. */
+KAPI void transform_batch_mul_parallel(const mat4* matrices, mat4 matrix, u32 count, mat4* out_matrices);
+
+/** @brief As transform_batch_points over [0, count), split across the job system's threads. */
+KAPI void transform_batch_points_parallel(mat4 matrix, vec3_soa points, u32 count, vec3_soa out_points);
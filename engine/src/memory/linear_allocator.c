@@ -30,16 +30,23 @@ void linear_allocator_destroy(linear_allocator* allocator){
 
 void* linear_allocator_allocate(linear_allocator* allocator, u64 size){
 	if (allocator && allocator->memory) {
-		if (allocator->allocated+size > allocator->total_size) {
+		// Aligned as far as the size allows, up to LINEAR_ALLOCATOR_MAX_ALIGNMENT; enough for any type it could hold.
+		u64 alignment = size & (~size + 1);
+		if (alignment == 0 || alignment > LINEAR_ALLOCATOR_MAX_ALIGNMENT) {
+			alignment = LINEAR_ALLOCATOR_MAX_ALIGNMENT;
+		}
+		u64 top = (u64)allocator->memory + allocator->allocated;
+		u64 offset = allocator->allocated + (((top + alignment - 1) & ~(alignment - 1)) - top);
+		if (offset+size > allocator->total_size) {
 			u64 remaining = allocator->total_size-allocator->allocated;
-			KERROR("linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size, remaining);
+			KERROR_CH(MEMORY, "linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size, remaining);
 			return 0;
 		}
-		void* block = allocator->memory + allocator->allocated;
-		allocator->allocated+=size;
+		void* block = allocator->memory + offset;
+		allocator->allocated = offset + size;
 		return block;
 	}
-	KERROR("linear_allocator_allocate - Provided allocator not initialized.");
+	KERROR_CH(MEMORY, "linear_allocator_allocate - Provided allocator not initialized.");
 	return 0;
 }
 void linear_allocator_free_all(linear_allocator* allocator){
@@ -47,5 +54,5 @@ void linear_allocator_free_all(linear_allocator* allocator){
 		allocator-> allocated = 0;
 		kzero_memory(allocator->memory, allocator->total_size);
 	}
-	KERROR("linear_allocator_free_all - Provided allocator not initialized.");
+	KERROR_CH(MEMORY, "linear_allocator_free_all - Provided allocator not initialized.");
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "defines.h"
 
+// Allocations are aligned to this many bytes at most, as SIMD types such as mat4 need.
+#define LINEAR_ALLOCATOR_MAX_ALIGNMENT 16
+
 typedef struct linear_allocator {
 	u64 total_size;
 	u64 allocated;
@@ -2,6 +2,7 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "memory/linear_allocator.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -10,13 +11,38 @@
 b8 filesystem_exists(const char* path) {
 #ifdef _MSC_VER
     struct _stat buffer;
-    return _stat(path, &buffer);
+    return _stat(path, &buffer) == 0;
 #else
     struct stat buffer;
     return stat(path, &buffer) == 0;
 #endif
 }
 
+b8 filesystem_delete(const char* path) {
+    return remove(path) == 0;
+}
+
+b8 filesystem_file_info(const char* path, u64* out_size, u64* out_modified_time) {
+#ifdef _MSC_VER
+    struct _stat64 buffer;
+    if (_stat64(path, &buffer) != 0) {
+        return false;
+    }
+#else
+    struct stat buffer;
+    if (stat(path, &buffer) != 0) {
+        return false;
+    }
+#endif
+    if (out_size) {
+        *out_size = (u64)buffer.st_size;
+    }
+    if (out_modified_time) {
+        *out_modified_time = (u64)buffer.st_mtime;
+    }
+    return true;
+}
+
 b8 filesystem_open(const char* path, file_modes mode, b8 binary, file_handle* out_handle) {
     out_handle->is_valid = false;
     out_handle->handle = 0;
@@ -119,4 +145,230 @@ b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* o
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+b8 filesystem_size(file_handle* handle, u64* out_size) {
+    if (handle->handle && out_size) {
+        FILE* file = (FILE*)handle->handle;
+#ifdef _MSC_VER
+        i64 position = _ftelli64(file);
+        _fseeki64(file, 0, SEEK_END);
+        i64 size = _ftelli64(file);
+        _fseeki64(file, position, SEEK_SET);
+#else
+        i64 position = ftell(file);
+        fseek(file, 0, SEEK_END);
+        i64 size = ftell(file);
+        fseek(file, position, SEEK_SET);
+#endif
+        if (position < 0 || size < 0) {
+            return false;
+        }
+        *out_size = (u64)size;
+        return true;
+    }
+    return false;
+}
+
+b8 filesystem_seek(file_handle* handle, u64 position) {
+    if (handle->handle) {
+#ifdef _MSC_VER
+        return _fseeki64((FILE*)handle->handle, (i64)position, SEEK_SET) == 0;
+#else
+        return fseeko((FILE*)handle->handle, (off_t)position, SEEK_SET) == 0;
+#endif
+    }
+    return false;
+}
+
+b8 filesystem_read_all_bytes_into(file_handle* handle, u64 buffer_size, void* out_data, u64* out_bytes_read) {
+    u64 size = 0;
+    if (!out_data || !out_bytes_read || !filesystem_size(handle, &size)) {
+        return false;
+    }
+    if (size > buffer_size) {
+        KERROR("filesystem_read_all_bytes_into - file of %llu bytes does not fit in %llu bytes.", size, buffer_size);
+        return false;
+    }
+
+    rewind((FILE*)handle->handle);
+    *out_bytes_read = fread(out_data, 1, size, (FILE*)handle->handle);
+    return *out_bytes_read == size;
+}
+
+b8 filesystem_read_all_bytes_linear(file_handle* handle, linear_allocator* allocator, u8** out_bytes, u64* out_bytes_read) {
+    u64 size = 0;
+    if (!allocator || !out_bytes || !out_bytes_read || !filesystem_size(handle, &size)) {
+        return false;
+    }
+
+    *out_bytes = linear_allocator_allocate(allocator, size);
+    if (!*out_bytes) {
+        return false;
+    }
+    return filesystem_read_all_bytes_into(handle, size, *out_bytes, out_bytes_read);
+}
+
+// Buffered writer
+
+b8 filesystem_writer_create(file_handle* handle, u64 buffer_size, void* memory, file_writer* out_writer) {
+    if (!handle || !handle->handle || buffer_size == 0 || !out_writer) {
+        return false;
+    }
+
+    out_writer->handle = handle;
+    out_writer->capacity = buffer_size;
+    out_writer->used = 0;
+    out_writer->owns_memory = memory == 0;
+    out_writer->buffer = memory ? memory : kallocate(buffer_size, MEMORY_TAG_FILE);
+    return true;
+}
+
+void filesystem_writer_destroy(file_writer* writer) {
+    if (writer && writer->buffer) {
+        filesystem_writer_flush(writer);
+        if (writer->owns_memory) {
+            kfree(writer->buffer, writer->capacity, MEMORY_TAG_FILE);
+        }
+        kzero_memory(writer, sizeof(file_writer));
+    }
+}
+
+// Hands the buffered bytes to the file, without flushing the file itself.
+static b8 writer_drain(file_writer* writer) {
+    if (writer->used == 0) {
+        return true;
+    }
+    if (!writer->handle->handle) {
+        return false;
+    }
+    u64 written = fwrite(writer->buffer, 1, writer->used, (FILE*)writer->handle->handle);
+    b8 result = written == writer->used;
+    writer->used = 0;
+    return result;
+}
+
+b8 filesystem_writer_write(file_writer* writer, u64 data_size, const void* data) {
+    if (!writer || !writer->buffer || (!data && data_size)) {
+        return false;
+    }
+
+    if (writer->used + data_size > writer->capacity) {
+        if (!writer_drain(writer)) {
+            return false;
+        }
+        // Too large to be worth buffering, write it straight through.
+        if (data_size >= writer->capacity) {
+            return writer->handle->handle && fwrite(data, 1, data_size, (FILE*)writer->handle->handle) == data_size;
+        }
+    }
+
+    kcopy_memory(writer->buffer + writer->used, data, data_size);
+    writer->used += data_size;
+    return true;
+}
+
+b8 filesystem_writer_write_line(file_writer* writer, const char* text) {
+    char newline = '\n';
+    return filesystem_writer_write(writer, strlen(text), text) && filesystem_writer_write(writer, 1, &newline);
+}
+
+b8 filesystem_writer_flush(file_writer* writer) {
+    if (!writer || !writer->buffer) {
+        return false;
+    }
+    b8 result = writer_drain(writer);
+    if (writer->handle->handle) {
+        fflush((FILE*)writer->handle->handle);
+    }
+    return result;
+}
+
+// Buffered reader
+
+b8 filesystem_reader_create(file_handle* handle, u64 buffer_size, void* memory, file_reader* out_reader) {
+    if (!handle || !handle->handle || buffer_size == 0 || !out_reader) {
+        return false;
+    }
+
+    out_reader->handle = handle;
+    out_reader->capacity = buffer_size;
+    out_reader->position = 0;
+    out_reader->length = 0;
+    out_reader->owns_memory = memory == 0;
+    out_reader->buffer = memory ? memory : kallocate(buffer_size, MEMORY_TAG_FILE);
+    return true;
+}
+
+void filesystem_reader_destroy(file_reader* reader) {
+    if (reader && reader->buffer) {
+        if (reader->owns_memory) {
+            kfree(reader->buffer, reader->capacity, MEMORY_TAG_FILE);
+        }
+        kzero_memory(reader, sizeof(file_reader));
+    }
+}
+
+// Refills the buffer once it has been consumed. False if there is nothing left to read.
+static b8 reader_fill(file_reader* reader) {
+    if (reader->position < reader->length) {
+        return true;
+    }
+    if (!reader->handle->handle) {
+        return false;
+    }
+    reader->position = 0;
+    reader->length = fread(reader->buffer, 1, reader->capacity, (FILE*)reader->handle->handle);
+    return reader->length > 0;
+}
+
+b8 filesystem_reader_read(file_reader* reader, u64 data_size, void* out_data, u64* out_bytes_read) {
+    if (!reader || !reader->buffer || !out_data || !out_bytes_read) {
+        return false;
+    }
+
+    u8* out = out_data;
+    u64 total = 0;
+    while (total < data_size) {
+        u64 available = reader->length - reader->position;
+        if (available == 0) {
+            // Large reads skip the buffer entirely.
+            u64 remaining = data_size - total;
+            if (remaining >= reader->capacity) {
+                total += fread(out + total, 1, remaining, (FILE*)reader->handle->handle);
+                break;
+            }
+            if (!reader_fill(reader)) {
+                break;
+            }
+            available = reader->length;
+        }
+
+        u64 count = available < data_size - total ? available : data_size - total;
+        kcopy_memory(out + total, reader->buffer + reader->position, count);
+        reader->position += count;
+        total += count;
+    }
+
+    *out_bytes_read = total;
+    return total == data_size;
+}
+
+b8 filesystem_reader_read_line(file_reader* reader, u64 max_length, char* line_buf, u64* out_line_length) {
+    if (!reader || !reader->buffer || !line_buf || !out_line_length || max_length == 0) {
+        return false;
+    }
+
+    u64 length = 0;
+    while (length + 1 < max_length && reader_fill(reader)) {
+        char c = (char)reader->buffer[reader->position++];
+        line_buf[length++] = c;
+        if (c == '\n') {
+            break;
+        }
+    }
+
+    line_buf[length] = 0;
+    *out_line_length = length;
+    return length > 0;
+}
@@ -2,6 +2,8 @@
 
 #include "defines.h"
 
+struct linear_allocator;
+
 // Holds a handle to a file
 typedef struct file_handle {
 	//Opaque handle to internal file handle
@@ -9,11 +11,70 @@ typedef struct file_handle {
 	b8 is_valid;
 } file_handle;
 
+/**
+ * A write-combining buffer on top of a file_handle. Writes are gathered in the
+ * buffer and only handed to the file when it fills up or is explicitly flushed,
+ * so many small writes turn into a few large ones.
+ */
+typedef struct file_writer {
+    file_handle* handle;
+    u8* buffer;
+    u64 capacity;
+    u64 used;
+    b8 owns_memory;
+} file_writer;
+
+/**
+ * A read-ahead buffer on top of a file_handle, for parsing files in small pieces
+ * (i.e. line by line) without a call into the file for each of them.
+ */
+typedef struct file_reader {
+    file_handle* handle;
+    u8* buffer;
+    u64 capacity;
+    // Read position within the buffer.
+    u64 position;
+    // Number of valid bytes in the buffer.
+    u64 length;
+    b8 owns_memory;
+} file_reader;
+
+/**
+ * @brief Called for each entry of a directory being listed.
+ *
+ * @param name The name of the entry, without the directory.
+ * @param is_directory True if the entry is a directory.
+ * @param user_data As passed to filesystem_list_directory.
+ * @return b8 True to continue listing; false to stop.
+ */
+typedef b8 (*pfn_directory_entry)(const char* name, b8 is_directory, void* user_data);
+
 typedef enum file_modes {
     FILE_MODE_READ = 0x1,
     FILE_MODE_WRITE = 0x2
 } file_modes;
 
+// How a mapped file will be read, so the OS can read ahead (or not) to suit.
+typedef enum file_access_hint {
+    FILE_ACCESS_HINT_NORMAL = 0,
+    // Read front to back once, i.e. a shader or image being decoded.
+    FILE_ACCESS_HINT_SEQUENTIAL = 1,
+    // Read in scattered pieces, i.e. an archive being looked up in.
+    FILE_ACCESS_HINT_RANDOM = 2,
+    // Read in full soon, so worth paging in right away.
+    FILE_ACCESS_HINT_WILL_NEED = 3
+} file_access_hint;
+
+/**
+ * A file mapped into memory. Its pages are read in as they are touched, straight from
+ * the OS page cache, which is shared with every other process mapping the file.
+ */
+typedef struct file_mapping {
+    // The contents of the file. Read only; writing to it crashes. 0 for an empty file.
+    const void* data;
+    u64 size;
+} file_mapping;
+
 /**
  * Checks if a file with the given path exists.
  * @param path The path of the file to be checked.
@@ -21,6 +82,32 @@ typedef enum file_modes {
  */
 KAPI b8 filesystem_exists(const char* path);
 
+/**
+ * Deletes a file. It must not be open.
+ * @param path The path of the file to be deleted.
+ * @returns True if deleted; otherwise false, i.e. if it does not exist.
+ */
+KAPI b8 filesystem_delete(const char* path);
+
+/**
+ * Renames a file, replacing any file already at the new path. Where the platform allows,
+ * which both supported ones do within a directory, the replacement is atomic, so other
+ * readers see either the old file or the new one, never a mix.
+ * @param old_path The current path of the file.
+ * @param new_path The path to move it to.
+ * @returns True if renamed; otherwise false.
+ */
+KAPI b8 filesystem_rename(const char* old_path, const char* new_path);
+
+/**
+ * Gets the size and last modification time of a file, without opening it.
+ * @param path The path of the file.
+ * @param out_size A pointer to hold the size in bytes. Optional.
+ * @param out_modified_time A pointer to hold the time it was last written, in seconds since the Unix epoch. Optional.
+ * @returns True if the file exists; otherwise false.
+ */
+KAPI b8 filesystem_file_info(const char* path, u64* out_size, u64* out_modified_time);
+
 /** 
  * Attempt to open file located at path.
  * @param path The path of the file to be opened.
@@ -84,4 +171,153 @@ KAPI b8 filesystem_read_all_bytes(file_handle* handle, u8** out_bytes, u64* out_
  * @param out_bytes_written A pointer to a number which will be populated with the number of bytes actually written to the file.
  * @returns True if successful; otherwise false.
  */
-KAPI b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
\ No newline at end of file
+KAPI b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
+
+/**
+ * Obtains the size of the file in bytes. The read/write position is preserved.
+ * @param handle A pointer to a file_handle structure.
+ * @param out_size A pointer to hold the file size.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_size(file_handle* handle, u64* out_size);
+
+/**
+ * Moves the read/write position of the file.
+ * @param handle A pointer to a file_handle structure.
+ * @param position The new position, in bytes from the start of the file.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_seek(file_handle* handle, u64 position);
+
+/**
+ * Reads the entire file into caller-provided memory. Fails without reading if
+ * the file does not fit. Use filesystem_size to find the required size.
+ * @param handle A pointer to a file_handle structure.
+ * @param buffer_size The size of out_data in bytes.
+ * @param out_data The memory to read into.
+ * @param out_bytes_read A pointer to a number which will be populated with the number of bytes actually read from the file.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_read_all_bytes_into(file_handle* handle, u64 buffer_size, void* out_data, u64* out_bytes_read);
+
+/**
+ * Reads the entire file into memory taken from the given linear allocator.
+ * The memory is released along with the rest of the allocator.
+ * @param handle A pointer to a file_handle structure.
+ * @param allocator The allocator to take the memory from.
+ * @param out_bytes A pointer to a byte array which will be populated by this method.
+ * @param out_bytes_read A pointer to a number which will be populated with the number of bytes actually read from the file.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_read_all_bytes_linear(file_handle* handle, struct linear_allocator* allocator, u8** out_bytes, u64* out_bytes_read);
+
+/**
+ * Maps an entire file into memory read only, without copying it. The mapping stays
+ * valid until unmapped; the file should not be changed while mapped.
+ * @param path The path of the file to be mapped.
+ * @param hint How the file will be read.
+ * @param out_mapping A pointer to the mapping to be filled in.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_map_readonly(const char* path, file_access_hint hint, file_mapping* out_mapping);
+
+/**
+ * Unmaps a file mapped with filesystem_map_readonly. Its data must no longer be used.
+ * @param mapping A pointer to the mapping.
+ */
+KAPI void filesystem_unmap(file_mapping* mapping);
+
+/**
+ * Lists the entries of a directory, not including "." and "..", in no particular order.
+ * Subdirectories are listed but not descended into.
+ * @param path The path of the directory.
+ * @param callback Called for each entry.
+ * @param user_data Passed to callback.
+ * @returns True if the directory could be listed; otherwise false.
+ */
+KAPI b8 filesystem_list_directory(const char* path, pfn_directory_entry callback, void* user_data);
+
+/**
+ * Creates a directory. Its parent must already exist.
+ * @param path The path of the directory.
+ * @returns True if the directory was created or already exists; otherwise false.
+ */
+KAPI b8 filesystem_create_directory(const char* path);
+
+/**
+ * Creates a buffered writer for the given handle. The handle must stay open for
+ * the lifetime of the writer.
+ * @param handle A pointer to an open file_handle structure.
+ * @param buffer_size The size of the write buffer in bytes.
+ * @param memory The memory to use as buffer, at least buffer_size bytes. Pass 0 to have one allocated.
+ * @param out_writer A pointer to the writer to be created.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_writer_create(file_handle* handle, u64 buffer_size, void* memory, file_writer* out_writer);
+
+/**
+ * Flushes any pending data and destroys the writer. Does not close its file.
+ * @param writer A pointer to the writer to be destroyed.
+ */
+KAPI void filesystem_writer_destroy(file_writer* writer);
+
+/**
+ * Appends data to the writer. Data larger than the buffer is written through directly.
+ * @param writer A pointer to the writer.
+ * @param data_size The size of the data in bytes.
+ * @param data The data to be written.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_writer_write(file_writer* writer, u64 data_size, const void* data);
+
+/**
+ * Appends text to the writer, followed by a '\n'.
+ * @param writer A pointer to the writer.
+ * @param text The text to be written.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_writer_write_line(file_writer* writer, const char* text);
+
+/**
+ * Writes all pending data to the file and flushes it.
+ * @param writer A pointer to the writer.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_writer_flush(file_writer* writer);
+
+/**
+ * Creates a buffered reader for the given handle. The handle must stay open for
+ * the lifetime of the reader, and should not be read from directly meanwhile.
+ * @param handle A pointer to an open file_handle structure.
+ * @param buffer_size The size of the read buffer in bytes.
+ * @param memory The memory to use as buffer, at least buffer_size bytes. Pass 0 to have one allocated.
+ * @param out_reader A pointer to the reader to be created.
+ * @returns True if successful; otherwise false.
+ */
+KAPI b8 filesystem_reader_create(file_handle* handle, u64 buffer_size, void* memory, file_reader* out_reader);
+
+/**
+ * Destroys the reader. Does not close its file.
+ * @param reader A pointer to the reader to be destroyed.
+ */
+KAPI void filesystem_reader_destroy(file_reader* reader);
+
+/**
+ * Reads up to data_size bytes into out_data.
+ * @param reader A pointer to the reader.
+ * @param data_size The number of bytes to read.
+ * @param out_data The memory to read into. Must be at least data_size bytes.
+ * @param out_bytes_read A pointer to a number which will be populated with the number of bytes actually read.
+ * @returns True if all data_size bytes were read; otherwise false.
+ */
+KAPI b8 filesystem_reader_read(file_reader* reader, u64 data_size, void* out_data, u64* out_bytes_read);
+
+/**
+ * Reads up to a newline or EOF, keeping the newline. Behaves like filesystem_read_line.
+ * @param reader A pointer to the reader.
+ * @param max_length The size of line_buf, including the terminator.
+ * @param line_buf The character array to read into.
+ * @param out_line_length A pointer to hold the line length read from the file.
+ * @returns True if a line was read; false at EOF or on error.
+ */
+KAPI b8 filesystem_reader_read_line(file_reader* reader, u64 max_length, char* line_buf, u64* out_line_length);
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Thin wrappers over the C11 atomic operations, with the same memory model. They
+ * work on plain integers (rather than _Atomic types), so atomic fields can live in
+ * ordinary structs; every access to such a field should then go through these.
+ */
+
+// Memory orders, as in C11.
+typedef enum katomic_order {
+    // No ordering; only the operation itself is atomic. For counters and statistics.
+    KATOMIC_RELAXED = __ATOMIC_RELAXED,
+    // Later reads and writes are not moved before this load.
+    KATOMIC_ACQUIRE = __ATOMIC_ACQUIRE,
+    // Earlier reads and writes are not moved after this store.
+    KATOMIC_RELEASE = __ATOMIC_RELEASE,
+    // Both of the above, for read-modify-write operations.
+    KATOMIC_ACQ_REL = __ATOMIC_ACQ_REL,
+    // Acquire/release, plus a single total order of all such operations.
+    KATOMIC_SEQ_CST = __ATOMIC_SEQ_CST
+} katomic_order;
+
+KINLINE u32 katomic_load_u32(const volatile u32* object, katomic_order order) {
+    return __atomic_load_n(object, order);
+}
+
+KINLINE void katomic_store_u32(volatile u32* object, u32 value, katomic_order order) {
+    __atomic_store_n(object, value, order);
+}
+
+// Returns the value from before the add.
+KINLINE u32 katomic_fetch_add_u32(volatile u32* object, u32 value, katomic_order order) {
+    return __atomic_fetch_add(object, value, order);
+}
+
+// Returns the value from before the subtraction.
+KINLINE u32 katomic_fetch_sub_u32(volatile u32* object, u32 value, katomic_order order) {
+    return __atomic_fetch_sub(object, value, order);
+}
+
+// Returns the value from before the exchange.
+KINLINE u32 katomic_exchange_u32(volatile u32* object, u32 value, katomic_order order) {
+    return __atomic_exchange_n(object, value, order);
+}
+
+/**
+ * Sets object to desired if it equals *expected. Otherwise, *expected is set to the
+ * current value. Returns true if object was set.
+ */
+KINLINE b8 katomic_compare_exchange_u32(volatile u32* object, u32* expected, u32 desired, katomic_order order) {
+    return __atomic_compare_exchange_n(object, expected, desired, false, order, __ATOMIC_RELAXED);
+}
+
+KINLINE u64 katomic_load_u64(const volatile u64* object, katomic_order order) {
+    return __atomic_load_n(object, order);
+}
+
+KINLINE void katomic_store_u64(volatile u64* object, u64 value, katomic_order order) {
+    __atomic_store_n(object, value, order);
+}
+
+// Returns the value from before the add.
+KINLINE u64 katomic_fetch_add_u64(volatile u64* object, u64 value, katomic_order order) {
+    return __atomic_fetch_add(object, value, order);
+}
+
+// Returns the value from before the subtraction.
+KINLINE u64 katomic_fetch_sub_u64(volatile u64* object, u64 value, katomic_order order) {
+    return __atomic_fetch_sub(object, value, order);
+}
+
+// Returns the value from before the exchange.
+KINLINE u64 katomic_exchange_u64(volatile u64* object, u64 value, katomic_order order) {
+    return __atomic_exchange_n(object, value, order);
+}
+
+// Returns the value from before the or. For sets of flags.
+KINLINE u64 katomic_fetch_or_u64(volatile u64* object, u64 value, katomic_order order) {
+    return __atomic_fetch_or(object, value, order);
+}
+
+/**
+ * Sets object to desired if it equals *expected. Otherwise, *expected is set to the
+ * current value. Returns true if object was set.
+ */
+KINLINE b8 katomic_compare_exchange_u64(volatile u64* object, u64* expected, u64 desired, katomic_order order) {
+    return __atomic_compare_exchange_n(object, expected, desired, false, order, __ATOMIC_RELAXED);
+}
+
+// Orders memory accesses around it without an atomic operation, i.e. for data guarded by a sequence number.
+KINLINE void katomic_fence(katomic_order order) {
+    __atomic_thread_fence(order);
+}
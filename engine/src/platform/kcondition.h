@@ -0,0 +1,41 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/kmutex.h"
+
+/**
+ * A condition variable, for threads to sleep until another thread changes some
+ * state guarded by a kmutex. Waits can wake spuriously, so always re-check the
+ * state in a loop.
+ */
+typedef struct kcondition {
+    // Opaque handle to the platform's condition variable.
+    void* internal_data;
+} kcondition;
+
+/**
+ * @brief Creates a condition variable.
+ *
+ * @param out_condition A pointer to hold the condition variable.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kcondition_create(kcondition* out_condition);
+
+/** @brief Destroys a condition variable. No thread may be waiting on it. */
+KAPI void kcondition_destroy(kcondition* condition);
+
+/**
+ * @brief Unlocks the mutex and sleeps until woken, then locks the mutex again.
+ *
+ * @param condition A pointer to the condition variable.
+ * @param mutex A pointer to a mutex locked by the calling thread.
+ * @param timeout_ms The longest to wait, in milliseconds. KWAIT_FOREVER waits forever.
+ * @return True if woken; false on timeout or error. The mutex is locked either way.
+ */
+KAPI b8 kcondition_wait(kcondition* condition, kmutex* mutex, u64 timeout_ms);
+
+/** @brief Wakes one thread waiting on the condition variable, if any. */
+KAPI void kcondition_signal(kcondition* condition);
+
+/** @brief Wakes every thread waiting on the condition variable. */
+KAPI void kcondition_broadcast(kcondition* condition);
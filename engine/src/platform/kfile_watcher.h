@@ -0,0 +1,50 @@
+#pragma once
+
+#include "defines.h"
+
+// Most directories a watcher can watch, its own included, where each must be watched on its own (Linux).
+#define KFILE_WATCHER_MAX_DIRECTORIES 256
+// Longest path a change can be reported for, relative to the watched directory.
+#define KFILE_WATCHER_MAX_PATH_LENGTH 256
+
+/**
+ * Watches a directory and everything under it for files being written, created or
+ * renamed into place, through inotify on Linux and ReadDirectoryChangesW on Windows.
+ * Changes are collected by the OS and picked up by polling, so nothing runs on other
+ * threads. Not thread safe; use from a single thread.
+ */
+typedef struct kfile_watcher {
+    // Opaque handle to the platform's watcher.
+    void* internal_data;
+} kfile_watcher;
+
+/**
+ * @brief Called for each file changed since the last poll.
+ *
+ * @param path The path of the file relative to the watched directory, with forward slashes.
+ * @param user_data As passed to kfile_watcher_poll.
+ */
+typedef void (*pfn_file_changed)(const char* path, void* user_data);
+
+/**
+ * @brief Starts watching a directory, subdirectories included.
+ *
+ * @param directory The path of the directory.
+ * @param out_watcher A pointer to hold the watcher.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kfile_watcher_create(const char* directory, kfile_watcher* out_watcher);
+
+/** @brief Stops watching, dropping any changes not yet polled. */
+KAPI void kfile_watcher_destroy(kfile_watcher* watcher);
+
+/**
+ * @brief Reports the files changed since the last poll. Never blocks. A file written
+ * several times may be reported more than once.
+ *
+ * @param watcher A pointer to the watcher.
+ * @param callback Called for each changed file.
+ * @param user_data Passed to callback.
+ * @return The number of changes reported.
+ */
+KAPI u32 kfile_watcher_poll(kfile_watcher* watcher, pfn_file_changed callback, void* user_data);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "defines.h"
+
+struct file_handle;
+
+/**
+ * A queue of asynchronous reads serviced by the kernel (io_uring on Linux). Not every
+ * platform or kernel has one; creation then fails, and callers should fall back to
+ * blocking reads on other threads. Not thread safe; use from a single thread.
+ */
+typedef struct kio_ring {
+    // Opaque handle to the platform's ring.
+    void* internal_data;
+} kio_ring;
+
+typedef struct kio_completion {
+    // As passed to kio_ring_read.
+    u64 user_data;
+    // Number of bytes read, or a negative platform error code.
+    i64 result;
+} kio_completion;
+
+/**
+ * @brief Creates a ring.
+ *
+ * @param entry_count The most reads which can be in flight at once.
+ * @param out_ring A pointer to hold the ring.
+ * @return True on success; false if the platform has no such queue, or it could not be created.
+ */
+KAPI b8 kio_ring_create(u32 entry_count, kio_ring* out_ring);
+
+/** @brief Destroys a ring. Reads still in flight are abandoned, so wait for them first. */
+KAPI void kio_ring_destroy(kio_ring* ring);
+
+/**
+ * @brief Queues a read, to be started by the next kio_ring_submit. The read may
+ * complete with fewer bytes than asked for.
+ *
+ * @param ring A pointer to the ring.
+ * @param file The file to read from. Must stay open until the read completes.
+ * @param offset Where in the file to start reading.
+ * @param size The number of bytes to read.
+ * @param buffer Where to read to. Must stay valid until the read completes.
+ * @param user_data Handed back in the read's completion.
+ * @return True if queued; false if the ring is full.
+ */
+KAPI b8 kio_ring_read(kio_ring* ring, struct file_handle* file, u64 offset, u64 size, void* buffer, u64 user_data);
+
+/** @brief Starts every queued read, and returns how many were started. */
+KAPI u32 kio_ring_submit(kio_ring* ring);
+
+/**
+ * @brief Takes completed reads off the ring.
+ *
+ * @param ring A pointer to the ring.
+ * @param out_completions An array to hold the completions.
+ * @param max_count The size of out_completions.
+ * @param wait Blocks until at least one read completes if true. Only wait with reads in flight.
+ * @return The number of completions taken.
+ */
+KAPI u32 kio_ring_complete(kio_ring* ring, kio_completion* out_completions, u32 max_count, b8 wait);
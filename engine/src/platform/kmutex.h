@@ -0,0 +1,36 @@
+#pragma once
+
+#include "defines.h"
+
+// A mutual exclusion lock. Not recursive.
+typedef struct kmutex {
+    // Opaque handle to the platform's lock.
+    void* internal_data;
+} kmutex;
+
+/**
+ * @brief Creates a mutex.
+ *
+ * @param out_mutex A pointer to hold the mutex.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kmutex_create(kmutex* out_mutex);
+
+/** @brief Destroys a mutex. It must not be locked. */
+KAPI void kmutex_destroy(kmutex* mutex);
+
+/**
+ * @brief Locks a mutex, blocking until it is available.
+ *
+ * @param mutex A pointer to the mutex.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kmutex_lock(kmutex* mutex);
+
+/**
+ * @brief Unlocks a mutex locked by the calling thread.
+ *
+ * @param mutex A pointer to the mutex.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kmutex_unlock(kmutex* mutex);
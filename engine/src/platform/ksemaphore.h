@@ -0,0 +1,39 @@
+#pragma once
+
+#include "defines.h"
+
+// A counting semaphore.
+typedef struct ksemaphore {
+    // Opaque handle to the platform's semaphore.
+    void* internal_data;
+} ksemaphore;
+
+/**
+ * @brief Creates a semaphore.
+ *
+ * @param out_semaphore A pointer to hold the semaphore.
+ * @param max_count The highest the count can go. Signals past it are lost.
+ * @param start_count The initial count.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 ksemaphore_create(ksemaphore* out_semaphore, u32 max_count, u32 start_count);
+
+/** @brief Destroys a semaphore. No thread may be waiting on it. */
+KAPI void ksemaphore_destroy(ksemaphore* semaphore);
+
+/**
+ * @brief Increments the count, waking a waiting thread if there is one.
+ *
+ * @param semaphore A pointer to the semaphore.
+ * @return True on success; false if the count was already at its max.
+ */
+KAPI b8 ksemaphore_signal(ksemaphore* semaphore);
+
+/**
+ * @brief Waits for the count to be above 0, then decrements it.
+ *
+ * @param semaphore A pointer to the semaphore.
+ * @param timeout_ms The longest to wait, in milliseconds. 0 only tries once; KWAIT_FOREVER waits forever.
+ * @return True if the count was decremented; false on timeout or error.
+ */
+KAPI b8 ksemaphore_wait(ksemaphore* semaphore, u64 timeout_ms);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "defines.h"
+
+// A thread of execution. Created and run by the platform layer.
+typedef struct kthread {
+    // Opaque handle to the platform's thread.
+    void* internal_data;
+    u64 thread_id;
+} kthread;
+
+/**
+ * @brief The function a thread runs.
+ *
+ * @param params The params passed to kthread_create.
+ * @return The exit code of the thread.
+ */
+typedef u32 (*pfn_thread_start)(void* params);
+
+/**
+ * @brief Creates and starts a thread.
+ *
+ * @param start_function_ptr The function the thread runs.
+ * @param params Passed to start_function_ptr. Must stay valid until the thread is done with it.
+ * @param auto_detach True to detach the thread immediately, in which case it cleans itself up
+ * and cannot be waited on; otherwise the thread must be waited on with kthread_wait.
+ * @param out_thread A pointer to hold the thread. Not touched if auto_detach is true and may be 0.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kthread_create(pfn_thread_start start_function_ptr, void* params, b8 auto_detach, kthread* out_thread);
+
+/**
+ * @brief Waits for a thread to exit and frees it.
+ *
+ * @param thread A pointer to the thread.
+ * @param out_exit_code A pointer to hold what the thread returned. Optional.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 kthread_wait(kthread* thread, u32* out_exit_code);
+
+/**
+ * @brief Detaches a thread, which then frees itself when it exits. It can no longer be waited on.
+ *
+ * @param thread A pointer to the thread.
+ */
+KAPI void kthread_detach(kthread* thread);
+
+/** @brief Gets the id of the calling thread. */
+KAPI u64 kthread_current_id();
+
+/**
+ * A key for a value held separately by each thread. For per-object thread
+ * storage; for a fixed variable, KTHREAD_LOCAL is simpler and faster.
+ */
+typedef struct ktls_key {
+    // Opaque handle to the platform's key.
+    u64 internal_data;
+} ktls_key;
+
+/**
+ * @brief Creates a thread local storage key. Every thread starts with a value of 0.
+ *
+ * @param out_key A pointer to hold the key.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 ktls_create(ktls_key* out_key);
+
+/** @brief Destroys a thread local storage key. Values are not freed. */
+KAPI void ktls_destroy(ktls_key* key);
+
+/** @brief Sets the calling thread's value for a key. */
+KAPI b8 ktls_set(ktls_key* key, void* value);
+
+/** @brief Gets the calling thread's value for a key. */
+KAPI void* ktls_get(ktls_key* key);
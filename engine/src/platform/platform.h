@@ -2,6 +2,16 @@
 
 #include "defines.h"
 
+// A block of memory which other processes can map by name.
+typedef struct shared_memory {
+	// Opaque handle to the platform's mapping.
+	void* handle;
+	void* block;
+	u64 size;
+	// True if this process created the block, rather than opening an existing one.
+	b8 owner;
+} shared_memory;
+
 b8 platform_system_startup(
     u64* memory_requirement,
     void* state,
@@ -25,6 +35,29 @@ void* platform_set_memory(void* dest, i32 value, u64 size);
 void platform_console_write(const char* message, u8 color);
 void platform_console_write_error(const char* message, u8 color);
 
-f64 platform_get_absolute_time();
-
-void platform_sleep(u64 ms);
\ No newline at end of file
+KAPI f64 platform_get_absolute_time();
+
+KAPI void platform_sleep(u64 ms);
+
+/** @brief Gets the number of logical processors, i.e. to size a pool of worker threads. */
+KAPI u32 platform_get_processor_count();
+
+/**
+ * @brief Creates a named block of memory shared between processes, or opens one
+ * created by another process. Created blocks are writable and start zeroed;
+ * opened blocks are read only.
+ *
+ * @param name The name of the block. Plain characters only, without slashes.
+ * @param size The size of the block in bytes. When opening, must not exceed the size it was created with.
+ * @param create True to create the block; false to open an existing one.
+ * @param out_memory A pointer to hold the mapped block.
+ * @return True on success; otherwise false.
+ */
+KAPI b8 platform_shared_memory_open(const char* name, u64 size, b8 create, shared_memory* out_memory);
+
+/**
+ * @brief Unmaps a shared block. Once every process has closed it, the block is destroyed.
+ *
+ * @param memory A pointer to the block to close.
+ */
+KAPI void platform_shared_memory_close(shared_memory* memory);
\ No newline at end of file
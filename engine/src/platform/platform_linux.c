@@ -0,0 +1,898 @@
+#include "platform/platform.h"
+#include "platform/kthread.h"
+#include "platform/kmutex.h"
+#include "platform/ksemaphore.h"
+#include "platform/kcondition.h"
+#include "platform/filesystem.h"
+#include "platform/kio_ring.h"
+#include "platform/kfile_watcher.h"
+#include "platform/katomic.h"
+
+// If not on linux, not include the code
+#if KPLATFORM_LINUX
+
+#include "core/logger.h"
+#include "core/kstring.h"
+#include "core/kmemory.h"
+
+#include "renderer/vulkan/vulkan_platform.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <time.h>
+#include <unistd.h>
+
+// TODO: Windowing (xcb) and input. Until then the platform runs headless, which is
+// enough for the tests and tools.
+typedef struct platform_state {
+    b8 headless;
+} platform_state;
+
+static platform_state* state_ptr;
+
+b8 platform_system_startup(
+    u64* memory_requirement,
+    void* state,
+    const char* application_name,
+    i32 x,
+    i32 y,
+    i32 width,
+    i32 height) {
+    *memory_requirement = sizeof(platform_state);
+    if (state == 0) {
+        return true;
+    }
+    state_ptr = state;
+    state_ptr->headless = true;
+    KWARN("Windowing is not implemented on Linux yet; '%s' runs without a window.", application_name);
+    return true;
+}
+
+void platform_system_shutdown(void* plat_state) {
+    state_ptr = 0;
+}
+
+b8 platform_pump_messages() {
+    return true;
+}
+
+void* platform_allocate(u64 size, b8 aligned) {
+    // aligned_alloc requires the size to be a multiple of the alignment.
+    return aligned ? aligned_alloc(16, (size + 15) & ~15ull) : malloc(size);
+}
+
+void platform_free(void* block, b8 aligned) {
+    free(block);
+}
+
+void* platform_zero_memory(void* block, u64 size) {
+    return memset(block, 0, size);
+}
+
+void* platform_copy_memory(void* dest, const void* source, u64 size) {
+    return memcpy(dest, source, size);
+}
+
+void* platform_set_memory(void* dest, i32 value, u64 size) {
+    return memset(dest, value, size);
+}
+
+void platform_console_write(const char* message, u8 color) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    printf("\033[%sm%s\033[0m", colour_strings[color], message);
+}
+
+void platform_console_write_error(const char* message, u8 color) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    fprintf(stderr, "\033[%sm%s\033[0m", colour_strings[color], message);
+}
+
+f64 platform_get_absolute_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 0.000000001;
+}
+
+void platform_sleep(u64 ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000 * 1000;
+    // Resume after signals for what is left.
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+    }
+}
+
+u32 platform_get_processor_count() {
+    return (u32)get_nprocs();
+}
+
+b8 platform_shared_memory_open(const char* name, u64 size, b8 create, shared_memory* out_memory) {
+    if (!name || size == 0 || !out_memory) {
+        return false;
+    }
+
+    // POSIX shared memory names start with a single slash.
+    char path[256];
+    string_format(path, "/%s", name);
+
+    i32 fd = create ? shm_open(path, O_CREAT | O_RDWR, 0600) : shm_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        return false;
+    }
+    // New segments are zero filled when extended.
+    if (create && ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(path);
+        return false;
+    }
+
+    void* block = mmap(0, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the segment alive on its own.
+    close(fd);
+    if (block == MAP_FAILED) {
+        if (create) {
+            shm_unlink(path);
+        }
+        return false;
+    }
+
+    // The owner keeps the name to unlink it when closing.
+    out_memory->handle = create ? string_duplicate(path) : 0;
+    out_memory->block = block;
+    out_memory->size = size;
+    out_memory->owner = create;
+    return true;
+}
+
+void platform_shared_memory_close(shared_memory* memory) {
+    if (memory->block) {
+        munmap(memory->block, memory->size);
+    }
+    if (memory->handle) {
+        // Unlike on Windows the name outlives every mapping unless removed. Readers still mapping it keep their view.
+        shm_unlink(memory->handle);
+        kfree(memory->handle, string_length(memory->handle) + 1, MEMORY_TAG_STRING);
+    }
+    memory->handle = 0;
+    memory->block = 0;
+    memory->size = 0;
+    memory->owner = false;
+}
+
+b8 filesystem_map_readonly(const char* path, file_access_hint hint, file_mapping* out_mapping) {
+    if (!path || !out_mapping) {
+        return false;
+    }
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+
+    i32 fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        // Nothing to map, and mmap refuses a zero length.
+        close(fd);
+        return true;
+    }
+
+    void* block = mmap(0, (u64)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file open on its own.
+    close(fd);
+    if (block == MAP_FAILED) {
+        KERROR("filesystem_map_readonly - Unable to map '%s': %s.", path, strerror(errno));
+        return false;
+    }
+
+    // Only a hint, so failure is harmless.
+    switch (hint) {
+        case FILE_ACCESS_HINT_SEQUENTIAL:
+            madvise(block, (u64)info.st_size, MADV_SEQUENTIAL);
+            break;
+        case FILE_ACCESS_HINT_RANDOM:
+            madvise(block, (u64)info.st_size, MADV_RANDOM);
+            break;
+        case FILE_ACCESS_HINT_WILL_NEED:
+            madvise(block, (u64)info.st_size, MADV_WILLNEED);
+            break;
+        default:
+            break;
+    }
+
+    out_mapping->data = block;
+    out_mapping->size = (u64)info.st_size;
+    return true;
+}
+
+void filesystem_unmap(file_mapping* mapping) {
+    if (mapping->data) {
+        munmap((void*)mapping->data, mapping->size);
+    }
+    mapping->data = 0;
+    mapping->size = 0;
+}
+
+b8 filesystem_list_directory(const char* path, pfn_directory_entry callback, void* user_data) {
+    if (!path || !callback) {
+        return false;
+    }
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return false;
+    }
+
+    char entry_path[4096];
+    struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        if (strings_equal(entry->d_name, ".") || strings_equal(entry->d_name, "..")) {
+            continue;
+        }
+        b8 is_directory = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+            // Not every filesystem fills in the type, and links are followed.
+            struct stat info;
+            string_format(entry_path, "%s/%s", path, entry->d_name);
+            is_directory = stat(entry_path, &info) == 0 && S_ISDIR(info.st_mode);
+        }
+        if (!callback(entry->d_name, is_directory, user_data)) {
+            break;
+        }
+    }
+
+    closedir(dir);
+    return true;
+}
+
+b8 filesystem_rename(const char* old_path, const char* new_path) {
+    if (!old_path || !new_path) {
+        return false;
+    }
+    // Replaces new_path atomically.
+    return rename(old_path, new_path) == 0;
+}
+
+b8 filesystem_create_directory(const char* path) {
+    if (!path) {
+        return false;
+    }
+    if (mkdir(path, 0755) == 0) {
+        return true;
+    }
+    struct stat info;
+    return errno == EEXIST && stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+// Converts a relative timeout to the absolute CLOCK_REALTIME deadline the pthread waits take.
+static struct timespec deadline_from_timeout(u64 timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+
+// Threads
+
+// pthreads start functions return a pointer, so the engine's start function is wrapped.
+typedef struct linux_thread_start {
+    pfn_thread_start function;
+    void* params;
+} linux_thread_start;
+
+static void* linux_thread_entry(void* arg) {
+    linux_thread_start start = *(linux_thread_start*)arg;
+    platform_free(arg, false);
+    u32 exit_code = start.function(start.params);
+    return (void*)(u64)exit_code;
+}
+
+b8 kthread_create(pfn_thread_start start_function_ptr, void* params, b8 auto_detach, kthread* out_thread) {
+    if (!start_function_ptr) {
+        return false;
+    }
+
+    // Freed by the thread once started.
+    linux_thread_start* start = platform_allocate(sizeof(linux_thread_start), false);
+    start->function = start_function_ptr;
+    start->params = params;
+
+    pthread_t thread;
+    i32 result = pthread_create(&thread, 0, linux_thread_entry, start);
+    if (result != 0) {
+        KERROR("kthread_create - pthread_create failed: %s", strerror(result));
+        platform_free(start, false);
+        return false;
+    }
+
+    if (auto_detach) {
+        pthread_detach(thread);
+        return true;
+    }
+    // pthread_t is an unsigned long on Linux, so it fits in the handle itself.
+    out_thread->internal_data = (void*)thread;
+    out_thread->thread_id = (u64)thread;
+    return true;
+}
+
+b8 kthread_wait(kthread* thread, u32* out_exit_code) {
+    if (!thread || !thread->internal_data) {
+        return false;
+    }
+
+    void* exit_value = 0;
+    i32 result = pthread_join((pthread_t)thread->internal_data, &exit_value);
+    thread->internal_data = 0;
+    thread->thread_id = 0;
+    if (result != 0) {
+        KERROR("kthread_wait - pthread_join failed: %s", strerror(result));
+        return false;
+    }
+    if (out_exit_code) {
+        *out_exit_code = (u32)(u64)exit_value;
+    }
+    return true;
+}
+
+void kthread_detach(kthread* thread) {
+    if (thread && thread->internal_data) {
+        pthread_detach((pthread_t)thread->internal_data);
+        thread->internal_data = 0;
+    }
+}
+
+u64 kthread_current_id() {
+    return (u64)pthread_self();
+}
+
+b8 ktls_create(ktls_key* out_key) {
+    pthread_key_t key;
+    i32 result = pthread_key_create(&key, 0);
+    if (result != 0) {
+        KERROR("ktls_create - pthread_key_create failed: %s", strerror(result));
+        return false;
+    }
+    out_key->internal_data = key;
+    return true;
+}
+
+void ktls_destroy(ktls_key* key) {
+    pthread_key_delete((pthread_key_t)key->internal_data);
+}
+
+b8 ktls_set(ktls_key* key, void* value) {
+    return pthread_setspecific((pthread_key_t)key->internal_data, value) == 0;
+}
+
+void* ktls_get(ktls_key* key) {
+    return pthread_getspecific((pthread_key_t)key->internal_data);
+}
+
+// Mutexes
+
+b8 kmutex_create(kmutex* out_mutex) {
+    pthread_mutex_t* mutex = platform_allocate(sizeof(pthread_mutex_t), false);
+    i32 result = pthread_mutex_init(mutex, 0);
+    if (result != 0) {
+        KERROR("kmutex_create - pthread_mutex_init failed: %s", strerror(result));
+        platform_free(mutex, false);
+        return false;
+    }
+    out_mutex->internal_data = mutex;
+    return true;
+}
+
+void kmutex_destroy(kmutex* mutex) {
+    if (mutex && mutex->internal_data) {
+        pthread_mutex_destroy(mutex->internal_data);
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+b8 kmutex_lock(kmutex* mutex) {
+    if (!mutex || !mutex->internal_data) {
+        return false;
+    }
+    return pthread_mutex_lock(mutex->internal_data) == 0;
+}
+
+b8 kmutex_unlock(kmutex* mutex) {
+    if (!mutex || !mutex->internal_data) {
+        return false;
+    }
+    return pthread_mutex_unlock(mutex->internal_data) == 0;
+}
+
+// Semaphores. POSIX semaphores have no maximum count, so it is kept alongside.
+
+typedef struct linux_semaphore {
+    sem_t handle;
+    u32 max_count;
+} linux_semaphore;
+
+b8 ksemaphore_create(ksemaphore* out_semaphore, u32 max_count, u32 start_count) {
+    linux_semaphore* semaphore = platform_allocate(sizeof(linux_semaphore), false);
+    if (sem_init(&semaphore->handle, 0, start_count) != 0) {
+        KERROR("ksemaphore_create - sem_init failed: %s", strerror(errno));
+        platform_free(semaphore, false);
+        return false;
+    }
+    semaphore->max_count = max_count;
+    out_semaphore->internal_data = semaphore;
+    return true;
+}
+
+void ksemaphore_destroy(ksemaphore* semaphore) {
+    if (semaphore && semaphore->internal_data) {
+        linux_semaphore* internal = semaphore->internal_data;
+        sem_destroy(&internal->handle);
+        platform_free(internal, false);
+        semaphore->internal_data = 0;
+    }
+}
+
+b8 ksemaphore_signal(ksemaphore* semaphore) {
+    if (!semaphore || !semaphore->internal_data) {
+        return false;
+    }
+    linux_semaphore* internal = semaphore->internal_data;
+    // Racy against concurrent signals, which can overshoot the max by their number. Good enough for a limit.
+    i32 count = 0;
+    sem_getvalue(&internal->handle, &count);
+    if ((u32)count >= internal->max_count) {
+        return false;
+    }
+    return sem_post(&internal->handle) == 0;
+}
+
+b8 ksemaphore_wait(ksemaphore* semaphore, u64 timeout_ms) {
+    if (!semaphore || !semaphore->internal_data) {
+        return false;
+    }
+    linux_semaphore* internal = semaphore->internal_data;
+
+    i32 result;
+    if (timeout_ms == KWAIT_FOREVER) {
+        do {
+            result = sem_wait(&internal->handle);
+        } while (result != 0 && errno == EINTR);
+    } else if (timeout_ms == 0) {
+        result = sem_trywait(&internal->handle);
+    } else {
+        struct timespec deadline = deadline_from_timeout(timeout_ms);
+        do {
+            result = sem_timedwait(&internal->handle, &deadline);
+        } while (result != 0 && errno == EINTR);
+    }
+    return result == 0;
+}
+
+// Condition variables
+
+b8 kcondition_create(kcondition* out_condition) {
+    pthread_cond_t* condition = platform_allocate(sizeof(pthread_cond_t), false);
+    i32 result = pthread_cond_init(condition, 0);
+    if (result != 0) {
+        KERROR("kcondition_create - pthread_cond_init failed: %s", strerror(result));
+        platform_free(condition, false);
+        return false;
+    }
+    out_condition->internal_data = condition;
+    return true;
+}
+
+void kcondition_destroy(kcondition* condition) {
+    if (condition && condition->internal_data) {
+        pthread_cond_destroy(condition->internal_data);
+        platform_free(condition->internal_data, false);
+        condition->internal_data = 0;
+    }
+}
+
+b8 kcondition_wait(kcondition* condition, kmutex* mutex, u64 timeout_ms) {
+    if (!condition || !condition->internal_data || !mutex || !mutex->internal_data) {
+        return false;
+    }
+    if (timeout_ms == KWAIT_FOREVER) {
+        return pthread_cond_wait(condition->internal_data, mutex->internal_data) == 0;
+    }
+    struct timespec deadline = deadline_from_timeout(timeout_ms);
+    return pthread_cond_timedwait(condition->internal_data, mutex->internal_data, &deadline) == 0;
+}
+
+void kcondition_signal(kcondition* condition) {
+    if (condition && condition->internal_data) {
+        pthread_cond_signal(condition->internal_data);
+    }
+}
+
+void kcondition_broadcast(kcondition* condition) {
+    if (condition && condition->internal_data) {
+        pthread_cond_broadcast(condition->internal_data);
+    }
+}
+
+// IO rings. io_uring through its system calls directly, as liburing is not a dependency.
+
+typedef struct linux_io_ring {
+    i32 fd;
+    u32 entry_count;
+    // Filled in but not yet handed to the kernel.
+    u32 queued;
+
+    // Submission queue. The kernel moves the head, this side the tail.
+    volatile u32* sq_head;
+    volatile u32* sq_tail;
+    u32 sq_mask;
+    u32* sq_array;
+    struct io_uring_sqe* sqes;
+
+    // Completion queue. This side moves the head, the kernel the tail.
+    volatile u32* cq_head;
+    volatile u32* cq_tail;
+    u32 cq_mask;
+    struct io_uring_cqe* cqes;
+
+    void* sq_ring;
+    u64 sq_ring_size;
+    // The same as sq_ring when the kernel maps both rings at once.
+    void* cq_ring;
+    u64 cq_ring_size;
+    u64 sqes_size;
+} linux_io_ring;
+
+static void io_ring_unmap(linux_io_ring* ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+}
+
+b8 kio_ring_create(u32 entry_count, kio_ring* out_ring) {
+    out_ring->internal_data = 0;
+
+    struct io_uring_params params;
+    kzero_memory(&params, sizeof(params));
+    i32 fd = (i32)syscall(__NR_io_uring_setup, entry_count, &params);
+    if (fd < 0) {
+        // Kernels before 5.1, or io_uring disabled (i.e. by seccomp in containers).
+        return false;
+    }
+
+    linux_io_ring* ring = platform_allocate(sizeof(linux_io_ring), false);
+    kzero_memory(ring, sizeof(linux_io_ring));
+    ring->fd = fd;
+    ring->entry_count = params.sq_entries;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    b8 single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map) {
+        ring->sq_ring_size = ring->cq_ring_size > ring->sq_ring_size ? ring->cq_ring_size : ring->sq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+    ring->sq_ring = mmap(0, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single_map ? ring->sq_ring : mmap(0, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        KWARN("kio_ring_create - Unable to map io_uring queues: %s", strerror(errno));
+        io_ring_unmap(ring);
+        close(fd);
+        platform_free(ring, false);
+        return false;
+    }
+
+    u8* sq = ring->sq_ring;
+    ring->sq_head = (u32*)(sq + params.sq_off.head);
+    ring->sq_tail = (u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (u32*)(sq + params.sq_off.array);
+    u8* cq = ring->cq_ring;
+    ring->cq_head = (u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    out_ring->internal_data = ring;
+    return true;
+}
+
+void kio_ring_destroy(kio_ring* ring) {
+    if (ring && ring->internal_data) {
+        linux_io_ring* internal = ring->internal_data;
+        io_ring_unmap(internal);
+        close(internal->fd);
+        platform_free(internal, false);
+        ring->internal_data = 0;
+    }
+}
+
+b8 kio_ring_read(kio_ring* ring, struct file_handle* file, u64 offset, u64 size, void* buffer, u64 user_data) {
+    if (!ring || !ring->internal_data || !file || !file->handle) {
+        return false;
+    }
+    linux_io_ring* internal = ring->internal_data;
+
+    u32 tail = *internal->sq_tail;
+    u32 head = katomic_load_u32(internal->sq_head, KATOMIC_ACQUIRE);
+    if (tail - head >= internal->entry_count) {
+        return false;
+    }
+
+    u32 index = tail & internal->sq_mask;
+    struct io_uring_sqe* sqe = &internal->sqes[index];
+    kzero_memory(sqe, sizeof(struct io_uring_sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fileno((FILE*)file->handle);
+    sqe->off = offset;
+    sqe->addr = (u64)buffer;
+    // A single read is limited to what fits in 32 bits; the rest comes back as a short read.
+    sqe->len = size > 0x7FFFF000 ? 0x7FFFF000 : (u32)size;
+    sqe->user_data = user_data;
+    internal->sq_array[index] = index;
+
+    // Publishes the entry before the kernel can see the new tail.
+    katomic_store_u32(internal->sq_tail, tail + 1, KATOMIC_RELEASE);
+    internal->queued++;
+    return true;
+}
+
+u32 kio_ring_submit(kio_ring* ring) {
+    if (!ring || !ring->internal_data) {
+        return 0;
+    }
+    linux_io_ring* internal = ring->internal_data;
+    if (internal->queued == 0) {
+        return 0;
+    }
+
+    i32 result;
+    do {
+        result = (i32)syscall(__NR_io_uring_enter, internal->fd, internal->queued, 0, 0, 0, 0);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+        KERROR("kio_ring_submit - io_uring_enter failed: %s", strerror(errno));
+        return 0;
+    }
+    internal->queued -= (u32)result;
+    return (u32)result;
+}
+
+u32 kio_ring_complete(kio_ring* ring, kio_completion* out_completions, u32 max_count, b8 wait) {
+    if (!ring || !ring->internal_data || max_count == 0) {
+        return 0;
+    }
+    linux_io_ring* internal = ring->internal_data;
+
+    u32 head = *internal->cq_head;
+    if (wait && head == katomic_load_u32(internal->cq_tail, KATOMIC_ACQUIRE)) {
+        i32 result;
+        do {
+            result = (i32)syscall(__NR_io_uring_enter, internal->fd, 0, 1, IORING_ENTER_GETEVENTS, 0, 0);
+        } while (result < 0 && errno == EINTR);
+    }
+
+    u32 tail = katomic_load_u32(internal->cq_tail, KATOMIC_ACQUIRE);
+    u32 count = 0;
+    while (head != tail && count < max_count) {
+        struct io_uring_cqe* cqe = &internal->cqes[head & internal->cq_mask];
+        out_completions[count].user_data = cqe->user_data;
+        out_completions[count].result = cqe->res;
+        count++;
+        head++;
+    }
+    // Hands the entries back to the kernel once they have been read.
+    katomic_store_u32(internal->cq_head, head, KATOMIC_RELEASE);
+    return count;
+}
+
+// File watching. inotify watches a single directory, so each one below the root gets its own.
+
+#define INOTIFY_WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR)
+
+typedef struct linux_watched_directory {
+    i32 wd;
+    // Relative to the watched directory; empty for the directory itself.
+    char path[KFILE_WATCHER_MAX_PATH_LENGTH];
+} linux_watched_directory;
+
+typedef struct linux_file_watcher {
+    i32 fd;
+    char root[KFILE_WATCHER_MAX_PATH_LENGTH];
+    u32 directory_count;
+    linux_watched_directory directories[KFILE_WATCHER_MAX_DIRECTORIES];
+} linux_file_watcher;
+
+typedef struct watch_directory_context {
+    linux_file_watcher* watcher;
+    const char* parent;
+} watch_directory_context;
+
+static void watch_directory(linux_file_watcher* watcher, const char* relative_path);
+
+// Joins a directory relative to the root with a name in it.
+static void join_relative_path(char* out_path, const char* directory, const char* name) {
+    if (directory[0]) {
+        snprintf(out_path, KFILE_WATCHER_MAX_PATH_LENGTH, "%s/%s", directory, name);
+    } else {
+        snprintf(out_path, KFILE_WATCHER_MAX_PATH_LENGTH, "%s", name);
+    }
+}
+
+static b8 watch_subdirectory(const char* name, b8 is_directory, void* user_data) {
+    if (is_directory) {
+        watch_directory_context* context = user_data;
+        char path[KFILE_WATCHER_MAX_PATH_LENGTH];
+        join_relative_path(path, context->parent, name);
+        watch_directory(context->watcher, path);
+    }
+    return true;
+}
+
+static void watch_directory(linux_file_watcher* watcher, const char* relative_path) {
+    if (watcher->directory_count == KFILE_WATCHER_MAX_DIRECTORIES) {
+        KWARN("kfile_watcher - Too many directories to watch; changes in '%s' will be missed.", relative_path);
+        return;
+    }
+    char full_path[KFILE_WATCHER_MAX_PATH_LENGTH * 2];
+    if (relative_path[0]) {
+        string_format(full_path, "%s/%s", watcher->root, relative_path);
+    } else {
+        string_format(full_path, "%s", watcher->root);
+    }
+
+    i32 wd = inotify_add_watch(watcher->fd, full_path, INOTIFY_WATCH_MASK);
+    if (wd < 0) {
+        KWARN("kfile_watcher - Unable to watch '%s': %s", full_path, strerror(errno));
+        return;
+    }
+    // Watching a directory twice (i.e. created while being listed) returns the same descriptor.
+    for (u32 i = 0; i < watcher->directory_count; ++i) {
+        if (watcher->directories[i].wd == wd) {
+            return;
+        }
+    }
+    linux_watched_directory* directory = &watcher->directories[watcher->directory_count++];
+    directory->wd = wd;
+    snprintf(directory->path, KFILE_WATCHER_MAX_PATH_LENGTH, "%s", relative_path);
+
+    watch_directory_context context = {watcher, directory->path};
+    filesystem_list_directory(full_path, watch_subdirectory, &context);
+}
+
+b8 kfile_watcher_create(const char* directory, kfile_watcher* out_watcher) {
+    out_watcher->internal_data = 0;
+    if (!directory || string_length(directory) >= KFILE_WATCHER_MAX_PATH_LENGTH) {
+        return false;
+    }
+
+    i32 fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        KERROR("kfile_watcher_create - inotify_init1 failed: %s", strerror(errno));
+        return false;
+    }
+
+    linux_file_watcher* watcher = platform_allocate(sizeof(linux_file_watcher), false);
+    kzero_memory(watcher, sizeof(linux_file_watcher));
+    watcher->fd = fd;
+    string_format(watcher->root, "%s", directory);
+    watch_directory(watcher, "");
+    if (watcher->directory_count == 0) {
+        close(fd);
+        platform_free(watcher, false);
+        return false;
+    }
+
+    out_watcher->internal_data = watcher;
+    return true;
+}
+
+void kfile_watcher_destroy(kfile_watcher* watcher) {
+    if (watcher && watcher->internal_data) {
+        linux_file_watcher* internal = watcher->internal_data;
+        // Closing the descriptor removes every watch on it.
+        close(internal->fd);
+        platform_free(internal, false);
+        watcher->internal_data = 0;
+    }
+}
+
+u32 kfile_watcher_poll(kfile_watcher* watcher, pfn_file_changed callback, void* user_data) {
+    if (!watcher || !watcher->internal_data || !callback) {
+        return 0;
+    }
+    linux_file_watcher* internal = watcher->internal_data;
+
+    u32 count = 0;
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t length = read(internal->fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN once there is nothing more to read.
+            break;
+        }
+
+        for (char* p = buffer; p < buffer + length;) {
+            struct inotify_event* event = (struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                KWARN("kfile_watcher_poll - Too many changes at once; some were dropped.");
+                continue;
+            }
+
+            u32 index = INVALID_ID;
+            for (u32 i = 0; i < internal->directory_count; ++i) {
+                if (internal->directories[i].wd == event->wd) {
+                    index = i;
+                    break;
+                }
+            }
+            if (index == INVALID_ID) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // The directory was deleted, so its watch is gone.
+                internal->directories[index] = internal->directories[--internal->directory_count];
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            char path[KFILE_WATCHER_MAX_PATH_LENGTH];
+            join_relative_path(path, internal->directories[index].path, event->name);
+            if (event->mask & IN_ISDIR) {
+                // New directories are watched too. Anything written to them before then is missed.
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    watch_directory(internal, path);
+                }
+            } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                // Files are reported once written, rather than when created empty.
+                callback(path, user_data);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void platform_get_required_extension_names(const char*** names_darray) {
+    // TODO: VK_KHR_xcb_surface, once there is a window to present to.
+}
+
+b8 platform_create_vulkan_surface(struct vulkan_context* context) {
+    KFATAL("Vulkan surfaces need a window, which is not implemented on Linux yet.");
+    return false;
+}
+
+#endif  // KPLATFORM_LINUX
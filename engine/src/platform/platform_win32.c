@@ -1,9 +1,18 @@
 #include "platform/platform.h"
+#include "platform/kthread.h"
+#include "platform/kmutex.h"
+#include "platform/ksemaphore.h"
+#include "platform/kcondition.h"
+#include "platform/filesystem.h"
+#include "platform/kio_ring.h"
+#include "platform/kfile_watcher.h"
 
 // If not on windows, not include the code
 #if KPLATFORM_WINDOWS
 
 #include "core/logger.h"
+#include "core/kstring.h"
+#include "core/kmemory.h"
 #include "core/input.h"
 #include "core/event.h"
 
@@ -18,6 +27,11 @@
 #include <vulkan/vulkan_win32.h>
 #include "renderer/vulkan/vulkan_types.inl"
 
+// Only declared by recent SDKs. Supported from Windows 10 1803 onwards.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 typedef struct platform_state {
 	HINSTANCE h_instance;
 	HWND hwnd;
@@ -26,6 +40,15 @@ typedef struct platform_state {
 
 static platform_state *state_ptr;
 
+// Sleep() is only as precise as the system timer, 15.6ms by default, so platform_sleep
+// waits on a high resolution waitable timer where the OS has them. Each thread has its
+// own, created on its first sleep; a shared one would have its due time reset by other
+// sleepers, and release only one of them. Worker threads' timers are closed by the OS
+// as the process exits.
+static KTHREAD_LOCAL HANDLE sleep_timer;
+// Set once creating the timer has failed, so it is not tried on every sleep.
+static KTHREAD_LOCAL b8 sleep_timer_unavailable;
+
 // Clock
 static f64 clock_frequency;
 static LARGE_INTEGER start_time;
@@ -143,6 +166,11 @@ void platform_system_shutdown(void *plat_state) {
         DestroyWindow(state_ptr->hwnd);
         state_ptr->hwnd = 0;
 	}
+    // The calling thread's; the only one still running by now.
+    if (sleep_timer) {
+        CloseHandle(sleep_timer);
+        sleep_timer = 0;
+    }
 }
 
 b8 platform_pump_messages() {
@@ -212,9 +240,516 @@ f64 platform_get_absolute_time() {
 }
 
 void platform_sleep(u64 ms) {
+	// Sleep(0) gives up the rest of the time slice, which is all a 0ms sleep is for.
+	if (ms > 0 && !sleep_timer && !sleep_timer_unavailable) {
+		sleep_timer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!sleep_timer) {
+			sleep_timer_unavailable = true;
+			KDEBUG("High resolution timers unavailable, platform_sleep falls back to Sleep().");
+		}
+	}
+	if (ms > 0 && sleep_timer) {
+		// Negative for a relative due time, in 100ns intervals.
+		LARGE_INTEGER due_time;
+		due_time.QuadPart = -(LONGLONG)(ms * 10000);
+		if (SetWaitableTimer(sleep_timer, &due_time, 0, 0, 0, FALSE)) {
+			WaitForSingleObject(sleep_timer, INFINITE);
+			return;
+		}
+	}
 	Sleep((DWORD)ms);
 }
 
+b8 platform_shared_memory_open(const char* name, u64 size, b8 create, shared_memory* out_memory) {
+	if (!name || size == 0 || !out_memory) {
+		return false;
+	}
+
+	// Local\ keeps the name within the user's session, which needs no extra privileges.
+	char mapping_name[256];
+	string_format(mapping_name, "Local\\%s", name);
+
+	HANDLE mapping;
+	if (create) {
+		// Backed by the page file, and zeroed by the OS.
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), mapping_name);
+	} else {
+		mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, mapping_name);
+	}
+	if (!mapping) {
+		return false;
+	}
+
+	void* block = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+	if (!block) {
+		CloseHandle(mapping);
+		return false;
+	}
+
+	out_memory->handle = mapping;
+	out_memory->block = block;
+	out_memory->size = size;
+	out_memory->owner = create;
+	return true;
+}
+
+void platform_shared_memory_close(shared_memory* memory) {
+	if (memory->block) {
+		UnmapViewOfFile(memory->block);
+	}
+	if (memory->handle) {
+		CloseHandle((HANDLE)memory->handle);
+	}
+	memory->handle = 0;
+	memory->block = 0;
+	memory->size = 0;
+	memory->owner = false;
+}
+
+b8 filesystem_map_readonly(const char* path, file_access_hint hint, file_mapping* out_mapping) {
+	if (!path || !out_mapping) {
+		return false;
+	}
+	out_mapping->data = 0;
+	out_mapping->size = 0;
+
+	// The cache manager reads ahead to suit these flags, the closest there is to madvise.
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (hint == FILE_ACCESS_HINT_SEQUENTIAL) {
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	} else if (hint == FILE_ACCESS_HINT_RANDOM) {
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+	}
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return false;
+	}
+	if (size.QuadPart == 0) {
+		// Nothing to map, and empty files cannot be.
+		CloseHandle(file);
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+	// The view keeps the mapping and file open on its own.
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+	if (!view) {
+		KERROR("filesystem_map_readonly - Unable to map '%s'. Error: %lu.", path, GetLastError());
+		return false;
+	}
+
+	if (hint == FILE_ACCESS_HINT_WILL_NEED) {
+		// Pages the whole file in up front. Only a hint, so failure is harmless.
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = view;
+		range.NumberOfBytes = (SIZE_T)size.QuadPart;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+
+	out_mapping->data = view;
+	out_mapping->size = (u64)size.QuadPart;
+	return true;
+}
+
+void filesystem_unmap(file_mapping* mapping) {
+	if (mapping->data) {
+		UnmapViewOfFile(mapping->data);
+	}
+	mapping->data = 0;
+	mapping->size = 0;
+}
+
+b8 filesystem_list_directory(const char* path, pfn_directory_entry callback, void* user_data) {
+	if (!path || !callback) {
+		return false;
+	}
+	char pattern[MAX_PATH];
+	string_format(pattern, "%s\\*", path);
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA(pattern, &data);
+	if (find == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	do {
+		if (strings_equal(data.cFileName, ".") || strings_equal(data.cFileName, "..")) {
+			continue;
+		}
+		b8 is_directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+		if (!callback(data.cFileName, is_directory, user_data)) {
+			break;
+		}
+	} while (FindNextFileA(find, &data));
+
+	FindClose(find);
+	return true;
+}
+
+b8 filesystem_rename(const char* old_path, const char* new_path) {
+	if (!old_path || !new_path) {
+		return false;
+	}
+	// Unlike rename(), replaces a file already at new_path. Fails if it is mapped.
+	return MoveFileExA(old_path, new_path, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+b8 filesystem_create_directory(const char* path) {
+	if (!path) {
+		return false;
+	}
+	if (CreateDirectoryA(path, 0)) {
+		return true;
+	}
+	if (GetLastError() != ERROR_ALREADY_EXISTS) {
+		return false;
+	}
+	DWORD attributes = GetFileAttributesA(path);
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+u32 platform_get_processor_count() {
+	SYSTEM_INFO sys_info;
+	GetSystemInfo(&sys_info);
+	return sys_info.dwNumberOfProcessors;
+}
+
+// Converts a timeout to what Win32 waits take. Anything too long for a DWORD waits forever.
+static DWORD win32_timeout(u64 timeout_ms) {
+	return timeout_ms >= INFINITE ? INFINITE : (DWORD)timeout_ms;
+}
+
+// Threads
+
+b8 kthread_create(pfn_thread_start start_function_ptr, void* params, b8 auto_detach, kthread* out_thread) {
+	if (!start_function_ptr) {
+		return false;
+	}
+
+	DWORD thread_id = 0;
+	// The x64 calling convention is the same for both signatures.
+	HANDLE handle = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)start_function_ptr, params, 0, &thread_id);
+	if (!handle) {
+		KERROR("kthread_create - CreateThread failed: %lu", GetLastError());
+		return false;
+	}
+
+	if (auto_detach) {
+		CloseHandle(handle);
+		return true;
+	}
+	out_thread->internal_data = handle;
+	out_thread->thread_id = thread_id;
+	return true;
+}
+
+b8 kthread_wait(kthread* thread, u32* out_exit_code) {
+	if (!thread || !thread->internal_data) {
+		return false;
+	}
+
+	b8 result = WaitForSingleObject(thread->internal_data, INFINITE) == WAIT_OBJECT_0;
+	if (result && out_exit_code) {
+		DWORD exit_code = 0;
+		GetExitCodeThread(thread->internal_data, &exit_code);
+		*out_exit_code = exit_code;
+	}
+	CloseHandle(thread->internal_data);
+	thread->internal_data = 0;
+	thread->thread_id = 0;
+	return result;
+}
+
+void kthread_detach(kthread* thread) {
+	if (thread && thread->internal_data) {
+		CloseHandle(thread->internal_data);
+		thread->internal_data = 0;
+	}
+}
+
+u64 kthread_current_id() {
+	return (u64)GetCurrentThreadId();
+}
+
+b8 ktls_create(ktls_key* out_key) {
+	DWORD index = TlsAlloc();
+	if (index == TLS_OUT_OF_INDEXES) {
+		KERROR("ktls_create - Out of thread local storage indices.");
+		return false;
+	}
+	out_key->internal_data = index;
+	return true;
+}
+
+void ktls_destroy(ktls_key* key) {
+	TlsFree((DWORD)key->internal_data);
+}
+
+b8 ktls_set(ktls_key* key, void* value) {
+	return TlsSetValue((DWORD)key->internal_data, value) != 0;
+}
+
+void* ktls_get(ktls_key* key) {
+	return TlsGetValue((DWORD)key->internal_data);
+}
+
+// Mutexes. Slim reader/writer locks, which unlike CRITICAL_SECTIONs also work with condition variables.
+
+b8 kmutex_create(kmutex* out_mutex) {
+	SRWLOCK* lock = platform_allocate(sizeof(SRWLOCK), false);
+	InitializeSRWLock(lock);
+	out_mutex->internal_data = lock;
+	return true;
+}
+
+void kmutex_destroy(kmutex* mutex) {
+	if (mutex && mutex->internal_data) {
+		platform_free(mutex->internal_data, false);
+		mutex->internal_data = 0;
+	}
+}
+
+b8 kmutex_lock(kmutex* mutex) {
+	if (!mutex || !mutex->internal_data) {
+		return false;
+	}
+	AcquireSRWLockExclusive(mutex->internal_data);
+	return true;
+}
+
+b8 kmutex_unlock(kmutex* mutex) {
+	if (!mutex || !mutex->internal_data) {
+		return false;
+	}
+	ReleaseSRWLockExclusive(mutex->internal_data);
+	return true;
+}
+
+// Semaphores
+
+b8 ksemaphore_create(ksemaphore* out_semaphore, u32 max_count, u32 start_count) {
+	HANDLE handle = CreateSemaphoreA(0, start_count, max_count, 0);
+	if (!handle) {
+		KERROR("ksemaphore_create - CreateSemaphore failed: %lu", GetLastError());
+		return false;
+	}
+	out_semaphore->internal_data = handle;
+	return true;
+}
+
+void ksemaphore_destroy(ksemaphore* semaphore) {
+	if (semaphore && semaphore->internal_data) {
+		CloseHandle(semaphore->internal_data);
+		semaphore->internal_data = 0;
+	}
+}
+
+b8 ksemaphore_signal(ksemaphore* semaphore) {
+	if (!semaphore || !semaphore->internal_data) {
+		return false;
+	}
+	return ReleaseSemaphore(semaphore->internal_data, 1, 0) != 0;
+}
+
+b8 ksemaphore_wait(ksemaphore* semaphore, u64 timeout_ms) {
+	if (!semaphore || !semaphore->internal_data) {
+		return false;
+	}
+	return WaitForSingleObject(semaphore->internal_data, win32_timeout(timeout_ms)) == WAIT_OBJECT_0;
+}
+
+// Condition variables
+
+b8 kcondition_create(kcondition* out_condition) {
+	CONDITION_VARIABLE* condition = platform_allocate(sizeof(CONDITION_VARIABLE), false);
+	InitializeConditionVariable(condition);
+	out_condition->internal_data = condition;
+	return true;
+}
+
+void kcondition_destroy(kcondition* condition) {
+	if (condition && condition->internal_data) {
+		platform_free(condition->internal_data, false);
+		condition->internal_data = 0;
+	}
+}
+
+b8 kcondition_wait(kcondition* condition, kmutex* mutex, u64 timeout_ms) {
+	if (!condition || !condition->internal_data || !mutex || !mutex->internal_data) {
+		return false;
+	}
+	return SleepConditionVariableSRW(condition->internal_data, mutex->internal_data, win32_timeout(timeout_ms), 0) != 0;
+}
+
+void kcondition_signal(kcondition* condition) {
+	if (condition && condition->internal_data) {
+		WakeConditionVariable(condition->internal_data);
+	}
+}
+
+void kcondition_broadcast(kcondition* condition) {
+	if (condition && condition->internal_data) {
+		WakeAllConditionVariable(condition->internal_data);
+	}
+}
+
+// IO rings
+// TODO: Overlapped reads through an IO completion port. Until then async reads use worker threads.
+
+b8 kio_ring_create(u32 entry_count, kio_ring* out_ring) {
+	out_ring->internal_data = 0;
+	return false;
+}
+
+void kio_ring_destroy(kio_ring* ring) {
+}
+
+b8 kio_ring_read(kio_ring* ring, struct file_handle* file, u64 offset, u64 size, void* buffer, u64 user_data) {
+	return false;
+}
+
+u32 kio_ring_submit(kio_ring* ring) {
+	return 0;
+}
+
+u32 kio_ring_complete(kio_ring* ring, kio_completion* out_completions, u32 max_count, b8 wait) {
+	return 0;
+}
+
+// File watching. One overlapped ReadDirectoryChangesW covers the whole tree, and is checked without waiting.
+
+typedef struct win32_file_watcher {
+	HANDLE directory;
+	char root[KFILE_WATCHER_MAX_PATH_LENGTH];
+	OVERLAPPED overlapped;
+	// Must be DWORD aligned. Changes made while it is full are dropped, and reported as 0 bytes.
+	DWORD buffer[16384];
+} win32_file_watcher;
+
+static b8 win32_watch_next(win32_file_watcher* watcher) {
+	return ReadDirectoryChangesW(
+		watcher->directory,
+		watcher->buffer,
+		sizeof(watcher->buffer),
+		TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+		0,
+		&watcher->overlapped,
+		0);
+}
+
+b8 kfile_watcher_create(const char* directory, kfile_watcher* out_watcher) {
+	out_watcher->internal_data = 0;
+	if (!directory || string_length(directory) >= KFILE_WATCHER_MAX_PATH_LENGTH) {
+		return false;
+	}
+
+	HANDLE handle = CreateFileA(
+		directory,
+		FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		0,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		0);
+	if (handle == INVALID_HANDLE_VALUE) {
+		KERROR("kfile_watcher_create - Unable to open '%s'.", directory);
+		return false;
+	}
+
+	win32_file_watcher* watcher = platform_allocate(sizeof(win32_file_watcher), false);
+	kzero_memory(watcher, sizeof(win32_file_watcher));
+	watcher->directory = handle;
+	string_format(watcher->root, "%s", directory);
+	watcher->overlapped.hEvent = CreateEventA(0, TRUE, FALSE, 0);
+	if (!watcher->overlapped.hEvent || !win32_watch_next(watcher)) {
+		KERROR("kfile_watcher_create - Unable to watch '%s'.", directory);
+		if (watcher->overlapped.hEvent) {
+			CloseHandle(watcher->overlapped.hEvent);
+		}
+		CloseHandle(handle);
+		platform_free(watcher, false);
+		return false;
+	}
+
+	out_watcher->internal_data = watcher;
+	return true;
+}
+
+void kfile_watcher_destroy(kfile_watcher* watcher) {
+	if (watcher && watcher->internal_data) {
+		win32_file_watcher* internal = watcher->internal_data;
+		// The buffer belongs to the OS until the read is cancelled.
+		CancelIoEx(internal->directory, &internal->overlapped);
+		DWORD bytes;
+		GetOverlappedResult(internal->directory, &internal->overlapped, &bytes, TRUE);
+		CloseHandle(internal->overlapped.hEvent);
+		CloseHandle(internal->directory);
+		platform_free(internal, false);
+		watcher->internal_data = 0;
+	}
+}
+
+u32 kfile_watcher_poll(kfile_watcher* watcher, pfn_file_changed callback, void* user_data) {
+	if (!watcher || !watcher->internal_data || !callback) {
+		return 0;
+	}
+	win32_file_watcher* internal = watcher->internal_data;
+
+	DWORD bytes = 0;
+	if (!GetOverlappedResult(internal->directory, &internal->overlapped, &bytes, FALSE)) {
+		// ERROR_IO_INCOMPLETE while nothing has changed.
+		return 0;
+	}
+
+	u32 count = 0;
+	if (bytes == 0) {
+		KWARN("kfile_watcher_poll - Too many changes at once; some were dropped.");
+	}
+	u8* p = (u8*)internal->buffer;
+	while (bytes > 0) {
+		FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)p;
+		if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+			char path[KFILE_WATCHER_MAX_PATH_LENGTH];
+			i32 length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, info->FileNameLength / sizeof(WCHAR), path, sizeof(path) - 1, 0, 0);
+			if (length > 0) {
+				path[length] = 0;
+				for (i32 i = 0; i < length; ++i) {
+					if (path[i] == '\\') {
+						path[i] = '/';
+					}
+				}
+				// Directories are reported too, so are told apart by looking. One already deleted again is skipped.
+				char full_path[KFILE_WATCHER_MAX_PATH_LENGTH * 2];
+				string_format(full_path, "%s\\%s", internal->root, path);
+				DWORD attributes = GetFileAttributesA(full_path);
+				if (attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+					callback(path, user_data);
+					count++;
+				}
+			}
+		}
+		if (info->NextEntryOffset == 0) {
+			break;
+		}
+		p += info->NextEntryOffset;
+	}
+
+	ResetEvent(internal->overlapped.hEvent);
+	if (!win32_watch_next(internal)) {
+		KERROR("kfile_watcher_poll - Unable to keep watching; no more changes will be reported.");
+	}
+	return count;
+}
+
 // Required extensions for Vulkan on Windows
 void platform_get_required_extension_names(const char*** extensions) {
 	darray_push(*extensions, &"VK_KHR_win32_surface");
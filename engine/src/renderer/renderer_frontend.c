@@ -4,6 +4,8 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "core/profiler.h"
+#include "core/perf_counters.h"
 
 #include "math/kmath.h"
 
@@ -23,6 +25,10 @@ typedef struct renderer_system_state {
     mat4 view;
     f32 near_clip;
     f32 far_clip;
+    u16 framebuffer_width;
+    u16 framebuffer_height;
+    u64 skipped_frames;
+    perf_counter_id culled_objects_counter;
 
     // TODO: temporary
     material* test_material;
@@ -49,7 +55,7 @@ b8 event_on_debug_event(u16 code, void* sender, void* listener_inst, event_conte
     // Acquire the new texture.
     state_ptr->test_material->diffuse_map.texture = texture_system_acquire(names[choice], true);
     if (!state_ptr->test_material->diffuse_map.texture) {
-        KWARN("event_on_debug_event no texture! using default");
+        KWARN_CH(RENDERER, "event_on_debug_event no texture! using default");
         state_ptr->test_material->diffuse_map.texture = texture_system_get_default_texture();
     }
 
@@ -78,12 +84,16 @@ b8 renderer_system_initialize(u64* memory_requirement, void* state, const char*
     state_ptr->backend.frame_number = 0;
 
     if (!state_ptr->backend.initialize(&state_ptr->backend, application_name)) {
-		KFATAL("Failed to initialize renderer backend, shutting down.");
+		KFATAL_CH(RENDERER, "Failed to initialize renderer backend, shutting down.");
 		return false;
 	}
 
     state_ptr->near_clip = 0.1f;
     state_ptr->far_clip = 1000.0f;
+    state_ptr->framebuffer_width = 1280;
+    state_ptr->framebuffer_height = 720;
+    state_ptr->skipped_frames = 0;
+    state_ptr->culled_objects_counter = perf_counter_register("culled objects");
     state_ptr->projection = mat4_perspective(deg_to_rad(45.0f), 1280 / 720.0f, state_ptr->near_clip, state_ptr->far_clip);
 
     state_ptr->view = mat4_translation((vec3){0, 0, -30.0f});
@@ -107,28 +117,36 @@ b8 renderer_begin_frame(f32 delta_time) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->backend.begin_frame(&state_ptr->backend, delta_time);
+    KPROFILE_ZONE_BEGIN("renderer_begin_frame");
+    b8 result = state_ptr->backend.begin_frame(&state_ptr->backend, delta_time);
+    KPROFILE_ZONE_END();
+    return result;
 }
 
 b8 renderer_end_frame(f32 delta_time) {
     if (!state_ptr) {
         return false;
     }
+    KPROFILE_ZONE_BEGIN("renderer_end_frame");
     b8 result = state_ptr->backend.end_frame(&state_ptr->backend, delta_time);
+    KPROFILE_ZONE_END();
     state_ptr->backend.frame_number++;
 	return result;
 }
 
 void renderer_on_resize(u16 width, u16 height) {
     if (state_ptr) {
+        state_ptr->framebuffer_width = width;
+        state_ptr->framebuffer_height = height;
         state_ptr->projection = mat4_perspective(deg_to_rad(45.0f), width / (f32)height, state_ptr->near_clip, state_ptr->far_clip);
         state_ptr->backend.resized(&state_ptr->backend, width, height);
 	} else {
-		KWARN("Renderer backend not initialized, cannot resize to %ix%i", width, height)
+		KWARN_CH(RENDERER, "Renderer backend not initialized, cannot resize to %ix%i", width, height)
 	}
 }
 
 b8 renderer_draw_frame(render_packet* packet) {
+    KPROFILE_FUNCTION_BEGIN();
 
 	if (renderer_begin_frame(packet->delta_time)) {
         state_ptr->backend.update_global_state(state_ptr->projection, state_ptr->view, vec3_zero(), vec4_one(), 0);
@@ -141,13 +159,19 @@ b8 renderer_draw_frame(render_packet* packet) {
         geometry_render_data data = {};
         data.model = model;
 
+        // Only what the camera can see reaches the backend.
+        frustum view_frustum = frustum_from_matrix(mat4_mul(state_ptr->view, state_ptr->projection));
+        //TODO: Temporary. The bounds of the test geometry, a 10x10 quad about the origin.
+        sphere bounds = {mat4_transform_point(model, vec3_zero()), 7.1f};
+        b8 visible = frustum_intersects_sphere(&view_frustum, bounds);
+
         //TODO: Temporary.
         // Create a default material if does not exist.
         if (!state_ptr->test_material) {
             // Automatic config
             state_ptr->test_material = material_system_acquire("test_material");
             if (!state_ptr->test_material) {
-                KWARN("Automatic material load failed, falling back to manual default material.");
+                KWARN_CH(RENDERER, "Automatic material load failed, falling back to manual default material.");
                 // Manual config
                 material_config config;
                 string_ncopy(config.name, "test_material", MATERIAL_NAME_MAX_LENGTH);
@@ -158,19 +182,38 @@ b8 renderer_draw_frame(render_packet* packet) {
             }
         }
         data.material = state_ptr->test_material;
-        state_ptr->backend.update_object(data);
+        if (visible) {
+            state_ptr->backend.update_object(data);
+        } else {
+            KPERF_COUNTER_ADD(state_ptr->culled_objects_counter, 1);
+        }
 
 		// ENd th frame
 		b8 result = renderer_end_frame(packet->delta_time);
 		if (!result) {
-			KFATAL("renderer_end_frame failed. Application shutting down.");
+			KFATAL_CH(RENDERER, "renderer_end_frame failed. Application shutting down.");
+			KPROFILE_ZONE_END();
 			return false;
 		}
+	} else if (state_ptr) {
+		state_ptr->skipped_frames++;
 	}
 
+	KPROFILE_ZONE_END();
 	return true;
 }
 
+b8 renderer_stats_get(renderer_stats* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return false;
+    }
+    out_stats->frame_number = state_ptr->backend.frame_number;
+    out_stats->skipped_frames = state_ptr->skipped_frames;
+    out_stats->framebuffer_width = state_ptr->framebuffer_width;
+    out_stats->framebuffer_height = state_ptr->framebuffer_height;
+    return true;
+}
+
 void renderer_set_view(mat4 view) {
     state_ptr->view = view;
 }
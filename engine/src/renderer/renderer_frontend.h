@@ -9,6 +9,14 @@ void renderer_on_resize(u16 width, u16 height);
 
 b8 renderer_draw_frame(render_packet* packet);
 
+/**
+ * @brief Gets a summary of the renderer's state.
+ *
+ * @param out_stats A pointer to hold the stats.
+ * @return True on success; false if the renderer is not initialized.
+ */
+b8 renderer_stats_get(renderer_stats* out_stats);
+
 //TODO: HACK: this should not be exposed outside the engine.
 KAPI void renderer_set_view(mat4 view);
 
@@ -53,6 +53,16 @@ typedef struct renderer_backend {
     void (*destroy_material)(struct material* material);
 } renderer_backend;
 
+// A summary of the renderer's state, i.e. for monitoring.
+typedef struct renderer_stats {
+	// Number of frames drawn.
+	u64 frame_number;
+	// Number of frames which could not begin, i.e. while the swapchain was being recreated.
+	u64 skipped_frames;
+	u16 framebuffer_width;
+	u16 framebuffer_height;
+} renderer_stats;
+
 typedef struct render_packet {
 	f32 delta_time;
 } render_packet;
\ No newline at end of file
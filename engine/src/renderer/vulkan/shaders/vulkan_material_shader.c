@@ -2,6 +2,7 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "core/perf_counters.h"
 #include "math/math_types.h"
 #include "math/kmath.h"
 
@@ -20,7 +21,7 @@ b8 vulkan_material_shader_create(vulkan_context* context, vulkan_material_shader
 
     for (u32 i = 0; i < MATERIAL_SHADER_STAGE_COUNT; ++i) {
         if (!create_shader_module(context, BUILTIN_SHADER_NAME_MATERIAL, stage_type_strs[i], stage_types[i], i, out_shader->stages)) {
-            KERROR("Unable to create %s shader module for '%s'.", stage_type_strs[i], BUILTIN_SHADER_NAME_MATERIAL);
+            KERROR_CH(VULKAN, "Unable to create %s shader module for '%s'.", stage_type_strs[i], BUILTIN_SHADER_NAME_MATERIAL);
             return false;
         }
     }
@@ -151,7 +152,7 @@ b8 vulkan_material_shader_create(vulkan_context* context, vulkan_material_shader
             scissor,
             false,
             &out_shader->pipeline)) {
-        KERROR("Failed to load graphics pipeline for object shader.");
+        KERROR_CH(VULKAN, "Failed to load graphics pipeline for object shader.");
         return false;
     }
 
@@ -163,7 +164,7 @@ b8 vulkan_material_shader_create(vulkan_context* context, vulkan_material_shader
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
             true,
             &out_shader->global_uniform_buffer)) {
-        KERROR("Vulkan buffer creation failed for object shader.");
+        KERROR_CH(VULKAN, "Vulkan buffer creation failed for object shader.");
         return false;
     }
 
@@ -187,7 +188,7 @@ b8 vulkan_material_shader_create(vulkan_context* context, vulkan_material_shader
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
             true,
             &out_shader->object_uniform_buffer)) {
-        KERROR("Material instance buffer creation failed for shader.");
+        KERROR_CH(VULKAN, "Material instance buffer creation failed for shader.");
         return false;
     }
 
@@ -256,6 +257,7 @@ void vulkan_material_shader_update_global_state(vulkan_context* context, struct
     descriptor_write.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(context->device.logical_device, 1, &descriptor_write, 0, 0);
+    KPERF_COUNTER_ADD(context->descriptor_writes_counter, 1);
 }
 
 void vulkan_material_shader_update_object(vulkan_context* context, struct vulkan_material_shader* shader, geometry_render_data data) {
@@ -323,7 +325,7 @@ void vulkan_material_shader_update_object(vulkan_context* context, struct vulkan
                 t = data.material->diffuse_map.texture;
                 break;
             default:
-                KFATAL("Unable to bind sampler to unknown use.");
+                KFATAL_CH(VULKAN, "Unable to bind sampler to unknown use.");
                 return;
         }
          
@@ -368,6 +370,7 @@ void vulkan_material_shader_update_object(vulkan_context* context, struct vulkan
 
     if (descriptor_count > 0) {
         vkUpdateDescriptorSets(context->device.logical_device, descriptor_count, descriptor_writes, 0, 0);
+        KPERF_COUNTER_ADD(context->descriptor_writes_counter, descriptor_count);
     }
 
     // Bind the descriptor set to be updated, or in case the shader changed.
@@ -399,7 +402,7 @@ b8 vulkan_material_shader_acquire_resources(vulkan_context* context, struct vulk
     alloc_info.pSetLayouts = layouts;
     VkResult result = vkAllocateDescriptorSets(context->device.logical_device, &alloc_info, object_state->descriptor_sets);
     if (result != VK_SUCCESS) {
-        KERROR("Error allocating descriptor sets in shader!");
+        KERROR_CH(VULKAN, "Error allocating descriptor sets in shader!");
         return false;
     }
 
@@ -413,7 +416,7 @@ void vulkan_material_shader_release_resources(vulkan_context* context, struct vu
     // Release object descriptor sets.
     VkResult result = vkFreeDescriptorSets(context->device.logical_device, shader->object_descriptor_pool, descriptor_set_count, instance_state->descriptor_sets);
     if (result != VK_SUCCESS) {
-        KERROR("Error freeing object shader descriptor sets!");
+        KERROR_CH(VULKAN, "Error freeing object shader descriptor sets!");
     }
 
     for (u32 i = 0; i < VULKAN_MATERIAL_SHADER_DESCRIPTOR_COUNT; ++i) {
@@ -8,6 +8,7 @@
 #include "renderer/vulkan/vulkan_command_buffer.h"
 #include "renderer/vulkan/vulkan_framebuffer.h"
 #include "renderer/vulkan/vulkan_fence.h"
+#include "renderer/vulkan/vulkan_timestamp.h"
 #include "renderer/vulkan/vulkan_utils.h"
 #include "vulkan_buffer.h"
 #include "vulkan_image.h"
@@ -15,6 +16,8 @@
 #include "core/logger.h"
 #include "core/kstring.h"
 #include "core/kmemory.h"
+#include "core/profiler.h"
+#include "core/perf_counters.h"
 #include "core/application.h"
 
 #include "containers/darray.h"
@@ -63,6 +66,12 @@ void upload_data_range(vulkan_context* context, VkCommandPool pool, VkFence fenc
 b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* application_name) {
     
     context.find_memory_index = find_memory_index;
+
+    context.draw_calls_counter = perf_counter_register("draw calls");
+    context.texture_uploads_counter = perf_counter_register("texture uploads");
+    context.texture_upload_bytes_counter = perf_counter_register("texture upload bytes");
+    context.buffer_maps_counter = perf_counter_register("buffer maps");
+    context.descriptor_writes_counter = perf_counter_register("descriptor writes");
     
     // TODO: Custom allocator
     context.allocator = 0;
@@ -91,10 +100,10 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 #if defined(_DEBUG)
     darray_push(required_extensions, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME); // Debugging extension
 
-    KDEBUG("Required extensions:");
+    KDEBUG_CH(VULKAN, "Required extensions:");
     u32 length = darray_length(required_extensions);
     for (u32 i = 0; i < length; i++) {
-        KDEBUG("%s", required_extensions[i]);
+        KDEBUG_CH(VULKAN, "%s", required_extensions[i]);
     }
 #endif
 
@@ -106,7 +115,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     u32 required_validation_layer_count = 0;
 
 #if defined(_DEBUG)
-    KINFO("Validation layers enabled. Enumerating...");
+    KINFO_CH(VULKAN, "Validation layers enabled. Enumerating...");
 
     // The list of validation layers required.
     required_validation_layer_names = darray_create(const char*);
@@ -121,33 +130,33 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
     // Verify all required layers are available.
     for (u32 i = 0; i < required_validation_layer_count; ++i) {
-        KINFO("Searching for layer: %s...", required_validation_layer_names[i]);
+        KINFO_CH(VULKAN, "Searching for layer: %s...", required_validation_layer_names[i]);
         b8 found = false;
         for (u32 j = 0; j < available_layer_count; ++j) {
             if (strings_equal(required_validation_layer_names[i], available_layers[j].layerName)) {
                 found = true;
-                KINFO("Found.");
+                KINFO_CH(VULKAN, "Found.");
                 break;
             }
         }
 
         if (!found) {
-            KFATAL("Required validation layer is missing: %s", required_validation_layer_names[i]);
+            KFATAL_CH(VULKAN, "Required validation layer is missing: %s", required_validation_layer_names[i]);
             return false;
         }
     }
-    KINFO("All required validation layers are present.");
+    KINFO_CH(VULKAN, "All required validation layers are present.");
 #endif
 
     create_info.enabledLayerCount = required_validation_layer_count;
     create_info.ppEnabledLayerNames = required_validation_layer_names;
 
     VK_CHECK(vkCreateInstance(&create_info, context.allocator, &context.instance));
-    KINFO("Vulkan instance created.");
+    KINFO_CH(VULKAN, "Vulkan instance created.");
 
     // Debugger
 #if defined(_DEBUG)
-    KDEBUG("Creating Vulkan debugger...");
+    KDEBUG_CH(VULKAN, "Creating Vulkan debugger...");
     u32 log_severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT |
                        VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
                        VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;  //|
@@ -162,20 +171,20 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
         (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(context.instance, "vkCreateDebugUtilsMessengerEXT");
     KASSERT_MSG(func, "Failed to create debug messenger!");
     VK_CHECK(func(context.instance, &debug_create_info, context.allocator, &context.debug_messenger));
-    KDEBUG("Vulkan debugger created.");
+    KDEBUG_CH(VULKAN, "Vulkan debugger created.");
 #endif
 
     // Surface creation
-    KDEBUG("Creating Vulkan surface...");
+    KDEBUG_CH(VULKAN, "Creating Vulkan surface...");
     if (!platform_create_vulkan_surface(&context)) {
-        KERROR("Failed to create Vulkan surface.");
+        KERROR_CH(VULKAN, "Failed to create Vulkan surface.");
         return false;
     }
-    KDEBUG("Vulkan surface created.");
+    KDEBUG_CH(VULKAN, "Vulkan surface created.");
 
     // Create Vulkan device
     if (!vulkan_device_create(&context)) {
-        KERROR("Failed to create Vulkan device.");
+        KERROR_CH(VULKAN, "Failed to create Vulkan device.");
         return false;
     }
 
@@ -212,6 +221,14 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
         vulkan_fence_create(&context, true, &context.in_flight_fences[i]);
     }
 
+    // GPU timestamp queries, one pool per frame in flight. Only used when profiling.
+    context.timestamp_pools = darray_reserve(vulkan_timestamp_pool, context.swapchain.max_frames_in_flight);
+    if (KPROFILER_ENABLED && vulkan_timestamp_supported(&context)) {
+        for (u8 i = 0; i < context.swapchain.max_frames_in_flight; ++i) {
+            vulkan_timestamp_pool_create(&context, &context.timestamp_pools[i]);
+        }
+    }
+
     context.images_in_flight = darray_reserve(vulkan_fence, context.swapchain.image_count);
     for (u32 i = 0; i < context.swapchain.image_count; ++i) {
         context.images_in_flight[i] = 0;
@@ -219,7 +236,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
         // Create builtin shaders
     if (!vulkan_material_shader_create(&context, &context.material_shader)) {
-        KERROR("Error loading built-in basic_lighting shader.");
+        KERROR_CH(VULKAN, "Error loading built-in basic_lighting shader.");
         return false;
     }
 
@@ -260,7 +277,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
     // TODO: end temp code
 
-    KINFO("Vulkan renderer initialized successfully.");
+    KINFO_CH(VULKAN, "Vulkan renderer initialized successfully.");
     return true;
 }
 
@@ -296,6 +313,12 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
     darray_destroy(context.in_flight_fences);
     context.in_flight_fences = 0;
 
+    for (u8 i = 0; i < context.swapchain.max_frames_in_flight; ++i) {
+        vulkan_timestamp_pool_destroy(&context, &context.timestamp_pools[i]);
+    }
+    darray_destroy(context.timestamp_pools);
+    context.timestamp_pools = 0;
+
     darray_destroy(context.images_in_flight);
     context.images_in_flight = 0;
 
@@ -321,34 +344,34 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
 
     vulkan_swapchain_destroy(&context, &context.swapchain);
 
-    KDEBUG("Destroying Vulkan device...");
+    KDEBUG_CH(VULKAN, "Destroying Vulkan device...");
     vulkan_device_destroy(&context);
 
-    KDEBUG("Destroying Vulkan surface...");
+    KDEBUG_CH(VULKAN, "Destroying Vulkan surface...");
     if (context.surface) {
         vkDestroySurfaceKHR(context.instance, context.surface, context.allocator);
         context.surface = 0;
     }
     
-    KDEBUG("Destroying Vulkan debugger...");
+    KDEBUG_CH(VULKAN, "Destroying Vulkan debugger...");
     if (context.debug_messenger) {
         PFN_vkDestroyDebugUtilsMessengerEXT func =
             (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(context.instance, "vkDestroyDebugUtilsMessengerEXT");
         func(context.instance, context.debug_messenger, context.allocator);
     }
 
-    KDEBUG("Destroying Vulkan instance...");
+    KDEBUG_CH(VULKAN, "Destroying Vulkan instance...");
     vkDestroyInstance(context.instance, context.allocator);
 }
 
 void vulkan_renderer_backend_on_resized(renderer_backend* backend, u16 width, u16 height) {
-    KINFO("Resizing Vulkan renderer to %dx%d...", width, height);
+    KINFO_CH(VULKAN, "Resizing Vulkan renderer to %dx%d...", width, height);
 
     cached_framebuffer_width = width;
     cached_framebuffer_height = height;
     context.framebuffer_size_generation++;
 
-    KINFO("Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
+    KINFO_CH(VULKAN, "Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
 }
 
 b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time) {
@@ -359,17 +382,17 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     if (context.recreating_swapchain) {
         VkResult result = vkDeviceWaitIdle(device->logical_device);
         if (!vulkan_result_is_success(result)) {
-            KERROR("Vulkan_renderer_backend_begin_frame VkDeviceWaitIdle (1) failed: '%s'", vulkan_result_string(result, true));
+            KERROR_CH(VULKAN, "Vulkan_renderer_backend_begin_frame VkDeviceWaitIdle (1) failed: '%s'", vulkan_result_string(result, true));
             return false;
         }
-        KINFO("Recreating swapchain, booting.");
+        KINFO_CH(VULKAN, "Recreating swapchain, booting.");
         return false;
     }
 
     if (context.framebuffer_size_generation != context.framebuffer_size_last_generation) {
         VkResult result = vkDeviceWaitIdle(device->logical_device);
         if (!vulkan_result_is_success(result)) {
-            KERROR("Vulkan_renderer_backend_begin_frame VkDeviceWaitIdle (2) failed: '%s'", vulkan_result_string(result, true));
+            KERROR_CH(VULKAN, "Vulkan_renderer_backend_begin_frame VkDeviceWaitIdle (2) failed: '%s'", vulkan_result_string(result, true));
             return false;
         }
 
@@ -379,28 +402,38 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
             return false;
         }
 
-        KINFO("Resized, booting.");
+        KINFO_CH(VULKAN, "Resized, booting.");
         return false;
     }
 
     // Wait for the execution of the current frame to complete. The fence being free will allow this one to move on.
-    if (!vulkan_fence_wait(
-            &context,
-            &context.in_flight_fences[context.current_frame],
-            UINT64_MAX)) {
-        KWARN("In-flight fence wait failed.");
+    KPROFILE_ZONE_BEGIN("vulkan in-flight fence wait");
+    b8 fence_signaled = vulkan_fence_wait(
+        &context,
+        &context.in_flight_fences[context.current_frame],
+        UINT64_MAX);
+    KPROFILE_ZONE_END();
+    if (!fence_signaled) {
+        KWARN_CH(VULKAN, "In-flight fence wait failed.");
         return false;
     }
 
+    // The last frame to use this pool is now complete, so its timings can be read without waiting.
+    vulkan_timestamp_pool* timestamp_pool = &context.timestamp_pools[context.current_frame];
+    vulkan_timestamp_pool_collect(&context, timestamp_pool);
+
     // Acquire the swapchain next image index
-    if (!vulkan_swapchain_acquire_next_image_index(
-            &context,
-            &context.swapchain,
-            UINT64_MAX,
-            context.image_available_semaphores[context.current_frame],
-            0,
-            &context.image_index)) {
-        KWARN("Failed to acquire next image.");
+    KPROFILE_ZONE_BEGIN("vulkan acquire image");
+    b8 acquired = vulkan_swapchain_acquire_next_image_index(
+        &context,
+        &context.swapchain,
+        UINT64_MAX,
+        context.image_available_semaphores[context.current_frame],
+        0,
+        &context.image_index);
+    KPROFILE_ZONE_END();
+    if (!acquired) {
+        KWARN_CH(VULKAN, "Failed to acquire next image.");
         return false;
     }
     //TODO: Modif non tuto
@@ -409,7 +442,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
                 &context,
                 context.images_in_flight[context.image_index],
                 UINT64_MAX)) {
-            KWARN("Image in-flight fence wait failed.");
+            KWARN_CH(VULKAN, "Image in-flight fence wait failed.");
             return false;
         }
     }
@@ -418,6 +451,9 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     vulkan_command_buffer_reset(command_buffer);
     vulkan_command_buffer_begin(command_buffer, false, false, false);
 
+    vulkan_timestamp_pool_reset(command_buffer, timestamp_pool);
+    vulkan_timestamp_zone_begin(command_buffer, timestamp_pool, "gpu frame");
+
     // Dynamic state
     VkViewport viewport;
     viewport.x = 0.0f;
@@ -439,6 +475,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     context.main_renderpass.w = (f32)context.framebuffer_width;
     context.main_renderpass.h = (f32)context.framebuffer_height;
 
+    vulkan_timestamp_zone_begin(command_buffer, timestamp_pool, "main renderpass");
     vulkan_renderpass_begin(
         command_buffer,
         &context.main_renderpass,
@@ -461,9 +498,14 @@ void vulkan_renderer_update_global_state(mat4 projection, mat4 view, vec3 view_p
 b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time) {
     vulkan_command_buffer* command_buffer = &context.graphics_command_buffers[context.image_index];
     
+    vulkan_timestamp_pool* timestamp_pool = &context.timestamp_pools[context.current_frame];
+
     // End render pass
     vulkan_renderpass_end(command_buffer, &context.main_renderpass);
+    vulkan_timestamp_zone_end(command_buffer, timestamp_pool);
 
+    // End of the gpu frame zone.
+    vulkan_timestamp_zone_end(command_buffer, timestamp_pool);
     vulkan_command_buffer_end(command_buffer);
 
     // Make sur the previous frame is not using this image
@@ -498,20 +540,25 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
     submit_info.pWaitDstStageMask = flags;
 
 
+    KPROFILE_ZONE_BEGIN("vulkan queue submit");
+    f64 submit_time = platform_get_absolute_time();
     VkResult result = vkQueueSubmit(
         context.device.graphics_queue,
         1,
         &submit_info,
         context.in_flight_fences[context.current_frame].handle);
+    KPROFILE_ZONE_END();
     if (result != VK_SUCCESS) {
-        KERROR("vkQueueSubmit failed: %s", vulkan_result_string(result, true));
+        KERROR_CH(VULKAN, "vkQueueSubmit failed: %s", vulkan_result_string(result, true));
         return false;
     }
 
     vulkan_command_buffer_update_submitted(command_buffer);
+    vulkan_timestamp_pool_submitted(timestamp_pool, submit_time);
     // End queue submission
 
     // Give the image back to the swapchain
+    KPROFILE_ZONE_BEGIN("vulkan present");
     vulkan_swapchain_present(
         &context,
         &context.swapchain,
@@ -519,6 +566,7 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
         context.device.present_queue,
         context.queue_complete_semaphores[context.current_frame],
         context.image_index);
+    KPROFILE_ZONE_END();
 
     return true;
 }
@@ -540,6 +588,7 @@ void vulkan_backend_update_object(geometry_render_data data) {
 
     // Issue the draw.
     vkCmdDrawIndexed(command_buffer->handle, 6, 1, 0, 0, 0);
+    KPERF_COUNTER_ADD(context.draw_calls_counter, 1);
     // TODO: end temporary test code
 }
 
@@ -551,16 +600,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL vk_debug_callback(
     switch (message_severity) {
         default:
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-            KERROR(callback_data->pMessage);
+            KERROR_CH(VULKAN, "%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-            KWARN(callback_data->pMessage);
+            KWARN_CH(VULKAN, "%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-            KINFO(callback_data->pMessage);
+            KINFO_CH(VULKAN, "%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-            KTRACE(callback_data->pMessage);
+            KTRACE_CH(VULKAN, "%s", callback_data->pMessage);
             break;
     }
     return VK_FALSE;
@@ -577,7 +626,7 @@ i32 find_memory_index(u32 type_filter, u32 property_flags) {
         }
     }
 
-    KWARN("Unable to find suitable memory type!");
+    KWARN_CH(VULKAN, "Unable to find suitable memory type!");
     return -1;
 }
 
@@ -604,7 +653,7 @@ void create_command_buffers(renderer_backend* backend) {
             &context.graphics_command_buffers[i]);
     }
 
-    KDEBUG("Vulkan command buffers created.");
+    KDEBUG_CH(VULKAN, "Vulkan command buffers created.");
 }
 
 void regenerate_framebuffers(renderer_backend* backend, vulkan_swapchain* swapchain, vulkan_renderpass *renderpass) {
@@ -627,13 +676,13 @@ void regenerate_framebuffers(renderer_backend* backend, vulkan_swapchain* swapch
 b8 recreate_swapchain(renderer_backend* backend) {
     // If already being recreated, do not try again.
     if (context.recreating_swapchain) {
-        KDEBUG("recreate_swapchain called when already recreating. Booting.");
+        KDEBUG_CH(VULKAN, "recreate_swapchain called when already recreating. Booting.");
         return false;
     }
 
     // Detect if the window is too small to be drawn to
     if (context.framebuffer_width == 0 || context.framebuffer_height == 0) {
-        KDEBUG("recreate_swapchain called when window is < 1 in a dimension. Booting.");
+        KDEBUG_CH(VULKAN, "recreate_swapchain called when window is < 1 in a dimension. Booting.");
         return false;
     }
 
@@ -709,7 +758,7 @@ b8 create_buffers(vulkan_context* context) {
             memory_property_flags,
             true,
             &context->object_vertex_buffer)) {
-        KERROR("Error creating vertex buffer.");
+        KERROR_CH(VULKAN, "Error creating vertex buffer.");
         return false;
     }
     context->geometry_vertex_offset = 0;
@@ -722,7 +771,7 @@ b8 create_buffers(vulkan_context* context) {
             memory_property_flags,
             true,
             &context->object_index_buffer)) {
-        KERROR("Error creating vertex buffer.");
+        KERROR_CH(VULKAN, "Error creating vertex buffer.");
         return false;
     }
     context->geometry_index_offset = 0;
@@ -747,6 +796,8 @@ void vulkan_renderer_create_texture(const u8* pixels,texture* texture) {
     vulkan_buffer_create(&context, image_size, usage, memory_prop_flags, true, &staging);
 
     vulkan_buffer_load_data(&context, &staging, 0, image_size, 0, pixels);
+    KPERF_COUNTER_ADD(context.texture_uploads_counter, 1);
+    KPERF_COUNTER_ADD(context.texture_upload_bytes_counter, image_size);
 
     // NOTE: Lots of assumptions here, different texture types will require
     // different options here.
@@ -816,7 +867,7 @@ void vulkan_renderer_create_texture(const u8* pixels,texture* texture) {
 
     VkResult result = vkCreateSampler(context.device.logical_device, &sampler_info, context.allocator, &data->sampler);
     if (!vulkan_result_is_success(result)) {
-        KERROR("Error creating texture sampler: %s", vulkan_result_string(result, true));
+        KERROR_CH(VULKAN, "Error creating texture sampler: %s", vulkan_result_string(result, true));
         return;
     }
 
@@ -842,15 +893,15 @@ void vulkan_renderer_destroy_texture(struct texture* texture) {
 b8 vulkan_renderer_create_material(struct material* material) {
     if (material) {
         if (!vulkan_material_shader_acquire_resources(&context, &context.material_shader, material)) {
-            KERROR("vulkan_renderer_create_material - Failed to acquire shader resources.");
+            KERROR_CH(VULKAN, "vulkan_renderer_create_material - Failed to acquire shader resources.");
             return false;
         }
 
-        KTRACE("Renderer: Material created.");
+        KTRACE_CH(VULKAN, "Renderer: Material created.");
         return true;
     }
 
-    KERROR("vulkan_renderer_create_material called with nullptr. Creation failed.");
+    KERROR_CH(VULKAN, "vulkan_renderer_create_material called with nullptr. Creation failed.");
     return false;
 }
 
@@ -859,9 +910,9 @@ void vulkan_renderer_destroy_material(struct material* material) {
         if (material->internal_id != INVALID_ID) {
             vulkan_material_shader_release_resources(&context, &context.material_shader, material);
         } else {
-            KWARN("vulkan_renderer_destroy_material called with internal_id=INVALID_ID. Nothing was done.");
+            KWARN_CH(VULKAN, "vulkan_renderer_destroy_material called with internal_id=INVALID_ID. Nothing was done.");
         }
     } else {
-        KWARN("vulkan_renderer_destroy_material called with nullptr. Nothing was done.");
+        KWARN_CH(VULKAN, "vulkan_renderer_destroy_material called with nullptr. Nothing was done.");
     }
 }
\ No newline at end of file
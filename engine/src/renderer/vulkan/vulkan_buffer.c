@@ -6,6 +6,7 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "core/perf_counters.h"
 
 b8 vulkan_buffer_create(
     vulkan_context* context,
@@ -31,7 +32,7 @@ b8 vulkan_buffer_create(
     vkGetBufferMemoryRequirements(context->device.logical_device, out_buffer->handle, &requirements);
     out_buffer->memory_index = context->find_memory_index(requirements.memoryTypeBits, out_buffer->memory_property_flags);
     if (out_buffer->memory_index == -1) {
-        KERROR("Unable to create vulkan buffer because the required memory type index was not found.");
+        KERROR_CH(VULKAN, "Unable to create vulkan buffer because the required memory type index was not found.");
         return false;
     }
 
@@ -40,7 +41,7 @@ b8 vulkan_buffer_create(
     allocate_info.allocationSize = requirements.size;
     allocate_info.memoryTypeIndex = (u32)out_buffer->memory_index;
 
-    KTRACE("Requesting %i bits of memory", requirements.size);
+    KTRACE_CH(VULKAN, "Requesting %i bits of memory", requirements.size);
 
     // Allocate the memory.
     VkResult result = vkAllocateMemory(
@@ -50,7 +51,7 @@ b8 vulkan_buffer_create(
         &out_buffer->memory);
 
     if (result != VK_SUCCESS) {
-        KERROR("Unable to create vulkan buffer because the required memory allocation failed. Error: %i", result);
+        KERROR_CH(VULKAN, "Unable to create vulkan buffer because the required memory allocation failed. Error: %i", result);
         return false;
     }
 
@@ -103,7 +104,7 @@ b8 vulkan_buffer_resize(
     VkDeviceMemory new_memory;
     VkResult result = vkAllocateMemory(context->device.logical_device, &allocate_info, context->allocator, &new_memory);
     if (result != VK_SUCCESS) {
-        KERROR("Unable to resize vulkan buffer because the required memory allocation failed. Error: %i", result);
+        KERROR_CH(VULKAN, "Unable to resize vulkan buffer because the required memory allocation failed. Error: %i", result);
         return false;
     }
 
@@ -141,6 +142,7 @@ void vulkan_buffer_bind(vulkan_context* context, vulkan_buffer* buffer, u64 offs
 void* vulkan_buffer_lock_memory(vulkan_context* context, vulkan_buffer* buffer, u64 offset, u64 size, u32 flags) {
     void* data;
     VK_CHECK(vkMapMemory(context->device.logical_device, buffer->memory, offset, size, flags, &data));
+    KPERF_COUNTER_ADD(context->buffer_maps_counter, 1);
     return data;
 }
 
@@ -151,6 +153,7 @@ void vulkan_buffer_unlock_memory(vulkan_context* context, vulkan_buffer* buffer)
 void vulkan_buffer_load_data(vulkan_context* context, vulkan_buffer* buffer, u64 offset, u64 size, u32 flags, const void* data) {
     void* data_ptr;
     VK_CHECK(vkMapMemory(context->device.logical_device, buffer->memory, offset, size, flags, &data_ptr));
+    KPERF_COUNTER_ADD(context->buffer_maps_counter, 1);
     kcopy_memory(data_ptr, data, size);
     vkUnmapMemory(context->device.logical_device, buffer->memory);
 }
@@ -37,7 +37,7 @@ b8 vulkan_device_create(vulkan_context* context) {
         return false;
     }
 
-    KINFO("Creating logical device.");
+    KINFO_CH(VULKAN, "Creating logical device.");
     // NOTE: Do not create additional queues for shared indices
     b8 present_shares_graphics_queue = context->device.graphics_queue_index == context->device.present_queue_index;
     b8 transfer_shares_graphics_queue = context->device.graphics_queue_index == context->device.transfer_queue_index;
@@ -101,7 +101,7 @@ b8 vulkan_device_create(vulkan_context* context) {
         context->allocator,
         &context->device.logical_device));
 
-    KINFO("Logical device created.");
+    KINFO_CH(VULKAN, "Logical device created.");
 
     // Get the queue handles
     vkGetDeviceQueue(
@@ -121,7 +121,7 @@ b8 vulkan_device_create(vulkan_context* context) {
         context->device.transfer_queue_index,
         0,
         &context->device.transfer_queue);
-    KINFO("Queue handles obtained.")
+    KINFO_CH(VULKAN, "Queue handles obtained.")
 
     // Create command pool
     VkCommandPoolCreateInfo command_pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
@@ -132,7 +132,7 @@ b8 vulkan_device_create(vulkan_context* context) {
         &command_pool_info,
         context->allocator,
         &context->device.graphics_command_pool));
-    KINFO("Graphic command pool created.");
+    KINFO_CH(VULKAN, "Graphic command pool created.");
 
     return true;
 }
@@ -144,19 +144,19 @@ void vulkan_device_destroy(vulkan_context* context) {
     context->device.present_queue = 0;
     context->device.transfer_queue = 0;
 
-    KINFO("Destroying command pool...");
+    KINFO_CH(VULKAN, "Destroying command pool...");
     vkDestroyCommandPool(
         context->device.logical_device,
         context->device.graphics_command_pool,
         context->allocator);
 
-    KINFO("Destroying logical device.");
+    KINFO_CH(VULKAN, "Destroying logical device.");
     if (context->device.logical_device) {
         vkDestroyDevice(context->device.logical_device, context->allocator);
         context->device.logical_device = 0;
     }
 
-    KINFO("Releasing physical device.");
+    KINFO_CH(VULKAN, "Releasing physical device.");
     context->device.physical_device = 0;
 
     if (context->device.swapchain_support.formats) {
@@ -250,7 +250,7 @@ b8 select_physical_device(vulkan_context* context) {
     u32 physical_device_count = 0;
     VK_CHECK(vkEnumeratePhysicalDevices(context->instance, &physical_device_count, 0));
     if (physical_device_count == 0) {
-        KFATAL("No devices which support Vulkan were found.");
+        KFATAL_CH(VULKAN, "No devices which support Vulkan were found.");
         return false;
     }
     const u32 max_device_count = 32;
@@ -290,35 +290,35 @@ b8 select_physical_device(vulkan_context* context) {
             &context->device.swapchain_support);
 
         if (result) {
-            KINFO("Selected device: '%s'.", properties.deviceName);
+            KINFO_CH(VULKAN, "Selected device: '%s'.", properties.deviceName);
             // GPU type, etc.
             switch (properties.deviceType) {
                 default:
                 case VK_PHYSICAL_DEVICE_TYPE_OTHER:
-                    KINFO("GPU type is Unknown.");
+                    KINFO_CH(VULKAN, "GPU type is Unknown.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
-                    KINFO("GPU type is Integrated.");
+                    KINFO_CH(VULKAN, "GPU type is Integrated.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
-                    KINFO("GPU type is Descrete.");
+                    KINFO_CH(VULKAN, "GPU type is Descrete.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
-                    KINFO("GPU type is Virtual.");
+                    KINFO_CH(VULKAN, "GPU type is Virtual.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_CPU:
-                    KINFO("GPU type is CPU.");
+                    KINFO_CH(VULKAN, "GPU type is CPU.");
                     break;
             }
 
-            KINFO(
+            KINFO_CH(VULKAN, 
                 "GPU Driver version: %d.%d.%d",
                 VK_VERSION_MAJOR(properties.driverVersion),
                 VK_VERSION_MINOR(properties.driverVersion),
                 VK_VERSION_PATCH(properties.driverVersion));
 
             // Vulkan API version.
-            KINFO(
+            KINFO_CH(VULKAN, 
                 "Vulkan API version: %d.%d.%d",
                 VK_VERSION_MAJOR(properties.apiVersion),
                 VK_VERSION_MINOR(properties.apiVersion),
@@ -328,9 +328,9 @@ b8 select_physical_device(vulkan_context* context) {
             for (u32 j = 0; j < memory.memoryHeapCount; ++j) {
                 f32 memory_size_gib = (((f32)memory.memoryHeaps[j].size) / 1024.0f / 1024.0f / 1024.0f);
                 if (memory.memoryHeaps[j].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
-                    KINFO("Local GPU memory: %.2f GiB", memory_size_gib);
+                    KINFO_CH(VULKAN, "Local GPU memory: %.2f GiB", memory_size_gib);
                 } else {
-                    KINFO("Shared System memory: %.2f GiB", memory_size_gib);
+                    KINFO_CH(VULKAN, "Shared System memory: %.2f GiB", memory_size_gib);
                 }
             }
 
@@ -350,11 +350,11 @@ b8 select_physical_device(vulkan_context* context) {
 
     // Ensure a device was selected
     if (!context->device.physical_device) {
-        KERROR("No physical devices were found which meet the requirements.");
+        KERROR_CH(VULKAN, "No physical devices were found which meet the requirements.");
         return false;
     }
 
-    KINFO("Physical device selected.");
+    KINFO_CH(VULKAN, "Physical device selected.");
     return true;
 }
 
@@ -375,7 +375,7 @@ b8 physical_device_meets_requirements(
     // Discrete GPU?
     if (requirements->discrete_gpu) {
         if (properties->deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-            KINFO("Device is not a discrete GPU, and one is required. Skipping.");
+            KINFO_CH(VULKAN, "Device is not a discrete GPU, and one is required. Skipping.");
             return false;
         }
     }
@@ -386,7 +386,7 @@ b8 physical_device_meets_requirements(
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families);
 
     // Look at each queue and see what queues it supports
-    KINFO("Graphics | Present | Compute | Transfer | Name");
+    KINFO_CH(VULKAN, "Graphics | Present | Compute | Transfer | Name");
     u8 min_transfer_score = 255;
     for (u32 i = 0; i < queue_family_count; ++i) {
         u8 current_transfer_score = 0;
@@ -422,7 +422,7 @@ b8 physical_device_meets_requirements(
     }
 
     // Print out some info about the device
-    KINFO("       %d |       %d |       %d |        %d | %s",
+    KINFO_CH(VULKAN, "       %d |       %d |       %d |        %d | %s",
           out_queue_info->graphics_family_index != -1,
           out_queue_info->present_family_index != -1,
           out_queue_info->compute_family_index != -1,
@@ -434,11 +434,11 @@ b8 physical_device_meets_requirements(
         (!requirements->present || (requirements->present && out_queue_info->present_family_index != -1)) &&
         (!requirements->compute || (requirements->compute && out_queue_info->compute_family_index != -1)) &&
         (!requirements->transfer || (requirements->transfer && out_queue_info->transfer_family_index != -1))) {
-        KINFO("Device meets queue requirements.");
-        KTRACE("Graphics Family Index: %i", out_queue_info->graphics_family_index);
-        KTRACE("Present Family Index:  %i", out_queue_info->present_family_index);
-        KTRACE("Transfer Family Index: %i", out_queue_info->transfer_family_index);
-        KTRACE("Compute Family Index:  %i", out_queue_info->compute_family_index);
+        KINFO_CH(VULKAN, "Device meets queue requirements.");
+        KTRACE_CH(VULKAN, "Graphics Family Index: %i", out_queue_info->graphics_family_index);
+        KTRACE_CH(VULKAN, "Present Family Index:  %i", out_queue_info->present_family_index);
+        KTRACE_CH(VULKAN, "Transfer Family Index: %i", out_queue_info->transfer_family_index);
+        KTRACE_CH(VULKAN, "Compute Family Index:  %i", out_queue_info->compute_family_index);
 
         // Query swapchain support.
         vulkan_device_query_swapchain_support(
@@ -453,7 +453,7 @@ b8 physical_device_meets_requirements(
             if (out_swapchain_support->present_modes) {
                 kfree(out_swapchain_support->present_modes, sizeof(VkPresentModeKHR) * out_swapchain_support->present_mode_count, MEMORY_TAG_RENDERER);
             }
-            KINFO("Required swapchain support not present, skipping device.");
+            KINFO_CH(VULKAN, "Required swapchain support not present, skipping device.");
             return false;
         }
 
@@ -485,7 +485,7 @@ b8 physical_device_meets_requirements(
                     }
 
                     if (!found) {
-                        KINFO("Required extension not found: '%s', skipping device.", requirements->device_extension_names[i]);
+                        KINFO_CH(VULKAN, "Required extension not found: '%s', skipping device.", requirements->device_extension_names[i]);
                         kfree(available_extensions, sizeof(VkExtensionProperties) * available_extension_count, MEMORY_TAG_RENDERER);
                         return false;
                     }
@@ -496,7 +496,7 @@ b8 physical_device_meets_requirements(
 
         // Sampler anisotropy
         if (requirements->sampler_anisotropy && !features->samplerAnisotropy) {
-            KINFO("Device does not support samplerAnisotropy, skipping.");
+            KINFO_CH(VULKAN, "Device does not support samplerAnisotropy, skipping.");
             return false;
         }
 
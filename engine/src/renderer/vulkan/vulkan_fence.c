@@ -29,7 +29,7 @@ void vulkan_fence_destroy(vulkan_context* context, vulkan_fence* fence) {
 
 b8 vulkan_fence_wait(vulkan_context* context, vulkan_fence* fence, u64 timeout_ns) {
 	if (fence->is_signaled) {
-		//KWARN("Fence is already signaled, no need to wait on it");
+		//KWARN_CH(VULKAN, "Fence is already signaled, no need to wait on it");
 		return true;
 	}
 
@@ -46,19 +46,19 @@ b8 vulkan_fence_wait(vulkan_context* context, vulkan_fence* fence, u64 timeout_n
 		fence->is_signaled = true;
 		return true;
 	case VK_TIMEOUT:
-		KWARN("vk_fence_wait - Timed out");
+		KWARN_CH(VULKAN, "vk_fence_wait - Timed out");
 		break;
 	case VK_ERROR_DEVICE_LOST:
-		KERROR("vk_fence_wait - VK_ERROR_DEVICE_LOST");
+		KERROR_CH(VULKAN, "vk_fence_wait - VK_ERROR_DEVICE_LOST");
 		break;
 	case VK_ERROR_OUT_OF_HOST_MEMORY:
-		KERROR("vk_fence_wait - VK_ERROR_OUT_OF_HOST_MEMORY");
+		KERROR_CH(VULKAN, "vk_fence_wait - VK_ERROR_OUT_OF_HOST_MEMORY");
 		break;
 	case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-		KERROR("vk_fence_wait - VK_ERROR_OUT_OF_DEVICE_MEMORY");
+		KERROR_CH(VULKAN, "vk_fence_wait - VK_ERROR_OUT_OF_DEVICE_MEMORY");
 		break;
 	default:
-		KERROR("vk_fence_wait - Unknown error");
+		KERROR_CH(VULKAN, "vk_fence_wait - Unknown error");
 		break;
 	}
 	return false;
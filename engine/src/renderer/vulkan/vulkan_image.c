@@ -44,7 +44,7 @@ void vulkan_image_create(
 
     i32 memory_type = context->find_memory_index(memory_requirements.memoryTypeBits, memory_flags);
     if (memory_type == -1) {
-        KERROR("Failed to find suitable memory type for image!");
+        KERROR_CH(VULKAN, "Failed to find suitable memory type for image!");
     }
 
     // Allocate memory
@@ -125,7 +125,7 @@ void vulkan_image_transition_layout(
         // The fragment stage.
         dest_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
     } else {
-        KFATAL("unsupported layout transition!");
+        KFATAL_CH(VULKAN, "unsupported layout transition!");
         return;
     }
 
@@ -157,11 +157,11 @@ b8 vulkan_graphics_pipeline_create(
         &out_pipeline->handle);
 
     if (vulkan_result_is_success(result)) {
-        KDEBUG("Graphics pipeline created!");
+        KDEBUG_CH(VULKAN, "Graphics pipeline created!");
         return true;
     }
 
-    KERROR("vkCreateGraphicsPipelines failed with %s.", vulkan_result_string(result, true));
+    KERROR_CH(VULKAN, "vkCreateGraphicsPipelines failed with %s.", vulkan_result_string(result, true));
     return false;
 }
 
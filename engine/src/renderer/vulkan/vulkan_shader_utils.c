@@ -4,7 +4,7 @@
 #include "core/logger.h"
 #include "core/kmemory.h"
 
-#include "platform/filesystem.h"
+#include "systems/vfs_system.h"
 
 b8 create_shader_module(
 	vulkan_context* context,
@@ -16,36 +16,31 @@ b8 create_shader_module(
 	
 	//Build file name
 	char file_name[512];
-	string_format(file_name, "assets/shaders/%s.%s.spv", name, type_str);
+	string_format(file_name, "shaders/%s.%s.spv", name, type_str);
 
 	kzero_memory(&shader_stages[stage_index].create_info, sizeof(VkShaderModuleCreateInfo));
 	shader_stages[stage_index].create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 
-	// Obtain file handle.
-    file_handle handle;
-    if (!filesystem_open(file_name, FILE_MODE_READ, true, &handle)) {
-        KERROR("Unable to read shader module: %s.", file_name);
+	// Map the file rather than reading it; the bytecode is only needed until the module is created.
+    file_mapping mapping;
+    if (!vfs_map(file_name, FILE_ACCESS_HINT_SEQUENTIAL, &mapping) || mapping.size == 0) {
+        KERROR_CH(VULKAN, "Unable to read shader module: %s.", file_name);
         return false;
     }
+    // Mappings and pack entries are page aligned, which satisfies the 4 byte alignment pCode needs.
+    shader_stages[stage_index].create_info.codeSize = mapping.size;
+    shader_stages[stage_index].create_info.pCode = (const u32*)mapping.data;
 
-    // Read the entire file as binary.
-    u64 size = 0;
-    u8* file_buffer = 0;
-    if (!filesystem_read_all_bytes(&handle, &file_buffer, &size)) {
-        KERROR("Unable to binary read shader module: %s.", file_name);
-        return false;
-    }
-    shader_stages[stage_index].create_info.codeSize = size;
-    shader_stages[stage_index].create_info.pCode = (u32*)file_buffer;
-
-    // Close the file.
-    filesystem_close(&handle);
-
-    VK_CHECK(vkCreateShaderModule(
+    VkResult result = vkCreateShaderModule(
         context->device.logical_device,
         &shader_stages[stage_index].create_info,
         context->allocator,
-        &shader_stages[stage_index].handle));
+        &shader_stages[stage_index].handle);
+
+    // Not kept past creation.
+    vfs_unmap(&mapping);
+    shader_stages[stage_index].create_info.pCode = 0;
+    VK_CHECK(result);
 
     // Shader stage info
     kzero_memory(&shader_stages[stage_index].shader_stage_create_info, sizeof(VkPipelineShaderStageCreateInfo));
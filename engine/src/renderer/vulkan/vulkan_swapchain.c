@@ -50,7 +50,7 @@ b8 vulkan_swapchain_acquire_next_image_index(
 		vulkan_swapchain_recreate(context, context->framebuffer_width, context->framebuffer_height, swapchain);
 		return false;
 	} else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-		KFATAL("Failed to acquire swapchain image!");
+		KFATAL_CH(VULKAN, "Failed to acquire swapchain image!");
 		return false;
 	}
 
@@ -80,7 +80,7 @@ void vulkan_swapchain_present(
         // Swapchain is out of date, suboptimal or a framebuffer resize has occurred. Trigger swapchain recreation.
         vulkan_swapchain_recreate(context, context->framebuffer_width, context->framebuffer_height, swapchain);
     } else if (result != VK_SUCCESS) {
-        KFATAL("Failed to present swap chain image!");
+        KFATAL_CH(VULKAN, "Failed to present swap chain image!");
     }
 
 	// Increment (and loop) the index
@@ -181,7 +181,7 @@ void create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* sw
 
         const char* result_str = vulkan_result_string(result, true);
 
-        KFATAL("Failed to create Vulkan swapchain with the error: '%s'.", result_str);
+        KFATAL_CH(VULKAN, "Failed to create Vulkan swapchain with the error: '%s'.", result_str);
 
     }
 
@@ -217,7 +217,7 @@ void create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* sw
 	// Depth ressources
 	if (!vulkan_device_detect_depth_format(&context->device)) {
 		context->device.depth_format = VK_FORMAT_UNDEFINED;
-		KFATAL("Failed to detect depth format!");
+		KFATAL_CH(VULKAN, "Failed to detect depth format!");
 	}
 
 	vulkan_image_create(
@@ -232,7 +232,7 @@ void create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* sw
 		true,
 		VK_IMAGE_ASPECT_DEPTH_BIT,
 		&swapchain->depth_attachment);
-	KINFO("Swapchain created successfully.");
+	KINFO_CH(VULKAN, "Swapchain created successfully.");
 }
 
 
@@ -0,0 +1,147 @@
+#include "vulkan_timestamp.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/profiler.h"
+
+b8 vulkan_timestamp_supported(vulkan_context* context) {
+    context->timestamp_period = 0;
+    context->timestamp_mask = 0;
+
+    if (!context->device.properties.limits.timestampComputeAndGraphics) {
+        KINFO_CH(VULKAN, "Device does not support timestamps on all graphics queues. GPU timings disabled.");
+        return false;
+    }
+
+    u32 queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(context->device.physical_device, &queue_family_count, 0);
+    VkQueueFamilyProperties queue_families[32];
+    queue_family_count = queue_family_count > 32 ? 32 : queue_family_count;
+    vkGetPhysicalDeviceQueueFamilyProperties(context->device.physical_device, &queue_family_count, queue_families);
+
+    u32 valid_bits = queue_families[context->device.graphics_queue_index].timestampValidBits;
+    if (valid_bits == 0) {
+        KINFO_CH(VULKAN, "Graphics queue does not write timestamps. GPU timings disabled.");
+        return false;
+    }
+
+    context->timestamp_period = context->device.properties.limits.timestampPeriod;
+    context->timestamp_mask = valid_bits >= 64 ? ~0ull : ((1ull << valid_bits) - 1);
+    KDEBUG_CH(VULKAN, "GPU timestamps enabled: %u valid bits, %.3f ns per tick.", valid_bits, context->timestamp_period);
+    return true;
+}
+
+void vulkan_timestamp_pool_create(vulkan_context* context, vulkan_timestamp_pool* pool) {
+    kzero_memory(pool, sizeof(vulkan_timestamp_pool));
+    pool->query_count = VULKAN_TIMESTAMP_MAX_ZONES * 2;
+
+    VkQueryPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_create_info.queryCount = pool->query_count;
+    VK_CHECK(vkCreateQueryPool(
+        context->device.logical_device,
+        &pool_create_info,
+        context->allocator,
+        &pool->handle));
+}
+
+void vulkan_timestamp_pool_destroy(vulkan_context* context, vulkan_timestamp_pool* pool) {
+    if (pool->handle) {
+        vkDestroyQueryPool(context->device.logical_device, pool->handle, context->allocator);
+    }
+    kzero_memory(pool, sizeof(vulkan_timestamp_pool));
+}
+
+void vulkan_timestamp_pool_reset(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool) {
+    if (!pool->handle) {
+        return;
+    }
+    vkCmdResetQueryPool(command_buffer->handle, pool->handle, 0, pool->query_count);
+    pool->zone_count = 0;
+    pool->depth = 0;
+    pool->pending = false;
+}
+
+void vulkan_timestamp_zone_begin(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool, const char* name) {
+    if (!pool->handle || pool->zone_count >= VULKAN_TIMESTAMP_MAX_ZONES) {
+        return;
+    }
+
+    u32 index = pool->zone_count++;
+    vulkan_timestamp_zone* zone = &pool->zones[index];
+    zone->name = name;
+    zone->begin_query = index * 2;
+    zone->end_query = index * 2 + 1;
+    zone->depth = pool->depth;
+    pool->open_zones[pool->depth++] = index;
+
+    // Written once all previously submitted work has reached the top of the pipe.
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool->handle, zone->begin_query);
+}
+
+void vulkan_timestamp_zone_end(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool) {
+    if (!pool->handle || pool->depth == 0) {
+        return;
+    }
+
+    vulkan_timestamp_zone* zone = &pool->zones[pool->open_zones[--pool->depth]];
+    // Written once all previous work has completed.
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool->handle, zone->end_query);
+}
+
+void vulkan_timestamp_pool_submitted(vulkan_timestamp_pool* pool, f64 submit_time) {
+    if (pool->handle && pool->zone_count > 0) {
+        pool->submit_time = submit_time;
+        pool->pending = true;
+    }
+}
+
+void vulkan_timestamp_pool_collect(vulkan_context* context, vulkan_timestamp_pool* pool) {
+    if (!pool->handle || !pool->pending) {
+        return;
+    }
+
+    // Each query is followed by its availability, so partially complete results can be told apart.
+    u64 results[VULKAN_TIMESTAMP_MAX_ZONES * 2][2];
+    u32 query_count = pool->zone_count * 2;
+    VkResult result = vkGetQueryPoolResults(
+        context->device.logical_device,
+        pool->handle,
+        0,
+        query_count,
+        sizeof(results),
+        results,
+        sizeof(results[0]),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    pool->pending = false;
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        KWARN_CH(VULKAN, "vkGetQueryPoolResults failed. GPU timings for this frame are dropped.");
+        return;
+    }
+    if (!results[pool->zones[0].begin_query][1]) {
+        // Collected after the frame's fence, so this should not happen. Drop the frame rather than wait.
+        return;
+    }
+
+    // The GPU clock has no relation to the CPU one. Anchor the first zone of the frame,
+    // which starts with the command buffer, to the time it was submitted. Durations and
+    // gaps within the frame are exact; the queue latency before it is not measured.
+    u64 base = results[pool->zones[0].begin_query][0] & context->timestamp_mask;
+    f64 seconds_per_tick = context->timestamp_period / 1000000000.0;
+
+    for (u32 i = 0; i < pool->zone_count; ++i) {
+        vulkan_timestamp_zone* zone = &pool->zones[i];
+        if (!results[zone->begin_query][1] || !results[zone->end_query][1]) {
+            // Not written, i.e. the zone was never ended.
+            continue;
+        }
+        // Masked again so a counter wrapping around within the frame still gives the right offset.
+        u64 begin = (results[zone->begin_query][0] - base) & context->timestamp_mask;
+        u64 end = (results[zone->end_query][0] - base) & context->timestamp_mask;
+        profiler_gpu_zone_record(
+            zone->name,
+            pool->submit_time + begin * seconds_per_tick,
+            pool->submit_time + end * seconds_per_tick,
+            zone->depth);
+    }
+}
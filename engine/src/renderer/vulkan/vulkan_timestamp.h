@@ -0,0 +1,45 @@
+#pragma once
+
+#include "vulkan_types.inl"
+
+/*
+ * GPU timestamp queries, handed to the profiler as its GPU track.
+ * NOTE: Not yet verified under a software driver such as lavapipe. The backend
+ * always creates a window surface, so it has no headless path to run on, and
+ * nothing builds it without the Vulkan SDK.
+ */
+
+/**
+ * Checks whether the graphics queue can write timestamps, and fills in the
+ * timestamp period and mask of the context. Must be called before creating pools.
+ */
+b8 vulkan_timestamp_supported(vulkan_context* context);
+
+void vulkan_timestamp_pool_create(vulkan_context* context, vulkan_timestamp_pool* pool);
+
+void vulkan_timestamp_pool_destroy(vulkan_context* context, vulkan_timestamp_pool* pool);
+
+/**
+ * Resets the pool for a new frame. Must be recorded outside of a render pass,
+ * before any zone of the frame.
+ */
+void vulkan_timestamp_pool_reset(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool);
+
+/**
+ * Records the start of a timed zone. Zones nest and must be ended in reverse order.
+ * NOTE: name must be a string literal (or otherwise outlive the profiler).
+ */
+void vulkan_timestamp_zone_begin(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool, const char* name);
+
+// Records the end of the innermost open zone.
+void vulkan_timestamp_zone_end(vulkan_command_buffer* command_buffer, vulkan_timestamp_pool* pool);
+
+// Marks the queries of the pool as submitted at the given CPU time.
+void vulkan_timestamp_pool_submitted(vulkan_timestamp_pool* pool, f64 submit_time);
+
+/**
+ * Reads the results of the pool, if its queries have completed, and hands them
+ * to the profiler. Never waits; call it after the fence of the frame which
+ * used the pool has been waited on.
+ */
+void vulkan_timestamp_pool_collect(vulkan_context* context, vulkan_timestamp_pool* pool);
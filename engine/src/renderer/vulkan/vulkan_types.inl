@@ -2,6 +2,7 @@
 
 #include "defines.h"
 #include "core/asserts.h"
+#include "core/perf_counters.h"
 #include "renderer/renderer_types.inl"
 
 #include <vulkan/vulkan.h>
@@ -115,6 +116,34 @@ typedef struct vulkan_fence {
 	b8 is_signaled;
 } vulkan_fence;
 
+// Maximum number of timed zones per frame. Each zone uses two queries.
+#define VULKAN_TIMESTAMP_MAX_ZONES 16
+
+typedef struct vulkan_timestamp_zone {
+	const char* name;
+	u32 begin_query;
+	u32 end_query;
+	u32 depth;
+} vulkan_timestamp_zone;
+
+// GPU timestamp queries for a single frame in flight.
+typedef struct vulkan_timestamp_pool {
+	// 0 if timestamps are not supported or disabled.
+	VkQueryPool handle;
+	u32 query_count;
+
+	u32 zone_count;
+	vulkan_timestamp_zone zones[VULKAN_TIMESTAMP_MAX_ZONES];
+	// Indices of the currently open zones.
+	u32 depth;
+	u32 open_zones[VULKAN_TIMESTAMP_MAX_ZONES];
+
+	// CPU time the queries were submitted at, used to place them on the CPU timeline.
+	f64 submit_time;
+	// True once the queries have been submitted and until their results are read.
+	b8 pending;
+} vulkan_timestamp_pool;
+
 typedef struct vulkan_shader_stage {
     VkShaderModuleCreateInfo create_info;
     VkShaderModule handle;
@@ -227,6 +256,13 @@ typedef struct vulkan_context {
     u32 in_flight_fence_count;
     vulkan_fence* in_flight_fences;
 
+    // darray, one per frame in flight
+    vulkan_timestamp_pool* timestamp_pools;
+    // Nanoseconds per timestamp tick.
+    f64 timestamp_period;
+    // Mask of the timestamp bits the graphics queue actually writes.
+    u64 timestamp_mask;
+
     // Holds pointers to fences which exist and are owned elsewhere.
     vulkan_fence** images_in_flight;
 
@@ -240,6 +276,13 @@ typedef struct vulkan_context {
 	u64 geometry_vertex_offset;
     u64 geometry_index_offset;
 
+    // Registered when the backend starts.
+    perf_counter_id draw_calls_counter;
+    perf_counter_id texture_uploads_counter;
+    perf_counter_id texture_upload_bytes_counter;
+    perf_counter_id buffer_maps_counter;
+    perf_counter_id descriptor_writes_counter;
+
     i32 (*find_memory_index)(u32 type_filter, u32 property_flags);
 
 } vulkan_context;
@@ -0,0 +1,136 @@
+#include "material_file.h"
+
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/logger.h"
+#include "math/kmath.h"
+
+static void set_defaults(material_config* config) {
+    kzero_memory(config, sizeof(material_config));
+    config->auto_release = true;
+    config->diffuse_colour = vec4_one();  // white
+}
+
+b8 material_file_parse_text(const char* text, u64 size, const char* path, material_config* out_config) {
+    if (!text || !out_config) {
+        return false;
+    }
+    set_defaults(out_config);
+
+    // Read each line of the file.
+    u64 position = 0;
+    char line_buf[512] = "";
+    u64 line_length = 0;
+    u32 line_number = 1;
+    while (position < size) {
+        // Copy out up to the newline, as much as fits, and skip past it.
+        line_length = 0;
+        while (position < size && text[position] != '\n') {
+            if (line_length < 511) {
+                line_buf[line_length++] = text[position];
+            }
+            position++;
+        }
+        position++;
+        line_buf[line_length] = 0;
+
+        // Trim the string.
+        char* trimmed = string_trim(line_buf);
+
+        // Get the trimmed length.
+        line_length = string_length(trimmed);
+
+        // Skip blank lines and comments.
+        if (line_length < 1 || trimmed[0] == '#') {
+            line_number++;
+            continue;
+        }
+
+        // Split into var/value
+        i32 equal_index = string_index_of(trimmed, '=');
+        if (equal_index == -1) {
+            KWARN_CH(MATERIAL, "Potential formatting issue found in file '%s': '=' token not found. Skipping line %ui.", path, line_number);
+            line_number++;
+            continue;
+        }
+
+        // Assume a max of 64 characters for the variable name.
+        char raw_var_name[64];
+        kzero_memory(raw_var_name, sizeof(char) * 64);
+        string_mid(raw_var_name, trimmed, 0, equal_index);
+        char* trimmed_var_name = string_trim(raw_var_name);
+
+        // Assume a max of 511-65 (446) for the max length of the value to account for the variable name and the '='.
+        char raw_value[446];
+        kzero_memory(raw_value, sizeof(char) * 446);
+        string_mid(raw_value, trimmed, equal_index + 1, -1);  // Read the rest of the line
+        char* trimmed_value = string_trim(raw_value);
+
+        // Process the variable.
+        if (strings_equali(trimmed_var_name, "version")) {
+            // TODO: version
+        } else if (strings_equali(trimmed_var_name, "name")) {
+            string_ncopy(out_config->name, trimmed_value, MATERIAL_NAME_MAX_LENGTH);
+        } else if (strings_equali(trimmed_var_name, "diffuse_map_name")) {
+            string_ncopy(out_config->diffuse_map_name, trimmed_value, TEXTURE_NAME_MAX_LENGTH);
+        } else if (strings_equali(trimmed_var_name, "diffuse_colour")) {
+            // Parse the colour
+            if (!string_to_vec4(trimmed_value, &out_config->diffuse_colour)) {
+                KWARN_CH(MATERIAL, "Error parsing diffuse_colour in file '%s'. Using default of white instead.", path);
+                out_config->diffuse_colour = vec4_one();  // white
+            }
+        }
+
+        // TODO: more fields.
+
+        // Clear the line buffer.
+        kzero_memory(line_buf, sizeof(char) * 512);
+        line_number++;
+    }
+
+    // Names filling their buffer are cut short rather than left unterminated.
+    out_config->name[MATERIAL_NAME_MAX_LENGTH - 1] = 0;
+    out_config->diffuse_map_name[TEXTURE_NAME_MAX_LENGTH - 1] = 0;
+    return true;
+}
+
+b8 material_file_parse_binary(const void* data, u64 size, const char* path, material_config* out_config) {
+    if (!data || !out_config) {
+        return false;
+    }
+    if (size != sizeof(material_binary)) {
+        KERROR_CH(MATERIAL, "Binary material '%s' is %llu bytes rather than %llu; it is truncated or from another build.", path, size, (u64)sizeof(material_binary));
+        return false;
+    }
+    const material_binary* binary = data;
+    if (binary->magic != MATERIAL_BINARY_MAGIC) {
+        KERROR_CH(MATERIAL, "'%s' is not a binary material.", path);
+        return false;
+    }
+    if (binary->version != MATERIAL_BINARY_VERSION) {
+        KERROR_CH(MATERIAL, "Binary material '%s' is version %u; expected %u. Compile it again.", path, binary->version, MATERIAL_BINARY_VERSION);
+        return false;
+    }
+
+    kcopy_memory(out_config->name, binary->name, MATERIAL_NAME_MAX_LENGTH);
+    out_config->name[MATERIAL_NAME_MAX_LENGTH - 1] = 0;
+    kcopy_memory(out_config->diffuse_map_name, binary->diffuse_map_name, TEXTURE_NAME_MAX_LENGTH);
+    out_config->diffuse_map_name[TEXTURE_NAME_MAX_LENGTH - 1] = 0;
+    out_config->diffuse_colour = vec4_create(binary->diffuse_colour[0], binary->diffuse_colour[1], binary->diffuse_colour[2], binary->diffuse_colour[3]);
+    out_config->auto_release = binary->auto_release;
+    return true;
+}
+
+void material_file_to_binary(const material_config* config, material_binary* out_binary) {
+    // Zeroed first, so padding and unused characters are the same every time.
+    kzero_memory(out_binary, sizeof(material_binary));
+    out_binary->magic = MATERIAL_BINARY_MAGIC;
+    out_binary->version = MATERIAL_BINARY_VERSION;
+    out_binary->diffuse_colour[0] = config->diffuse_colour.r;
+    out_binary->diffuse_colour[1] = config->diffuse_colour.g;
+    out_binary->diffuse_colour[2] = config->diffuse_colour.b;
+    out_binary->diffuse_colour[3] = config->diffuse_colour.a;
+    out_binary->auto_release = config->auto_release;
+    string_ncopy(out_binary->name, config->name, MATERIAL_NAME_MAX_LENGTH - 1);
+    string_ncopy(out_binary->diffuse_map_name, config->diffuse_map_name, TEXTURE_NAME_MAX_LENGTH - 1);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "defines.h"
+#include "resources/resource_types.h"
+
+// "KMTB", as read from the start of a binary material.
+#define MATERIAL_BINARY_MAGIC 0x42544D4B
+#define MATERIAL_BINARY_VERSION 1
+#define MATERIAL_TEXT_EXTENSION "kmt"
+#define MATERIAL_BINARY_EXTENSION "kmb"
+
+/**
+ * A binary material (.kmb), as compiled from a text one (.kmt) by "tools compile_material".
+ * The whole file is this struct, so it is read with a single mapping and no parsing.
+ * Strings are null terminated and zero padded. Stored little endian.
+ */
+typedef struct material_binary {
+    u32 magic;
+    u32 version;
+    // rgba. Plain floats, so the layout does not follow vec4's alignment.
+    f32 diffuse_colour[4];
+    b8 auto_release;
+    u8 reserved[3];
+    char name[MATERIAL_NAME_MAX_LENGTH];
+    char diffuse_map_name[TEXTURE_NAME_MAX_LENGTH];
+} material_binary;
+
+/**
+ * @brief Parses a text material; lines of "key=value", with # comments.
+ * Unknown keys are skipped, and missing ones keep their defaults.
+ *
+ * @param text The contents of the file. Need not be null terminated.
+ * @param size The size of the contents, in bytes.
+ * @param path The path of the file, for warnings.
+ * @param out_config A pointer to hold the material.
+ * @return b8 True if successful; otherwise false.
+ */
+KAPI b8 material_file_parse_text(const char* text, u64 size, const char* path, material_config* out_config);
+
+/**
+ * @brief Reads a binary material, checking it is whole and of this version.
+ *
+ * @param data The contents of the file.
+ * @param size The size of the contents, in bytes.
+ * @param path The path of the file, for warnings.
+ * @param out_config A pointer to hold the material.
+ * @return b8 True if successful; otherwise false.
+ */
+KAPI b8 material_file_parse_binary(const void* data, u64 size, const char* path, material_config* out_config);
+
+/**
+ * @brief Converts a material to its binary form, ready to be written out.
+ *
+ * @param config The material.
+ * @param out_binary A pointer to hold the binary form.
+ */
+KAPI void material_file_to_binary(const material_config* config, material_binary* out_binary);
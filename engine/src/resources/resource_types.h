@@ -33,4 +33,12 @@ typedef struct material {
     char name[MATERIAL_NAME_MAX_LENGTH];
     vec4 diffuse_colour;
     texture_map diffuse_map;
-} material;
\ No newline at end of file
+} material;
+
+// A material as authored, before anything it uses is loaded.
+typedef struct material_config {
+    char name[MATERIAL_NAME_MAX_LENGTH];
+    b8 auto_release;
+    vec4 diffuse_colour;
+    char diffuse_map_name[TEXTURE_NAME_MAX_LENGTH];
+} material_config;
\ No newline at end of file
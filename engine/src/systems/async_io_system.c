@@ -0,0 +1,368 @@
+#include "async_io_system.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/perf_counters.h"
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "platform/kio_ring.h"
+#include "platform/katomic.h"
+#include "systems/job_system.h"
+
+// Completions taken off the ring at a time.
+#define ASYNC_IO_COMPLETION_BATCH 32
+
+typedef enum async_read_slot_state {
+    ASYNC_READ_SLOT_FREE = 0,
+    ASYNC_READ_SLOT_READING,
+    ASYNC_READ_SLOT_COMPLETE,
+    ASYNC_READ_SLOT_FAILED
+} async_read_slot_state;
+
+typedef struct async_read_slot {
+    // An async_read_slot_state. Set by whichever thread finishes the read.
+    volatile u32 state;
+    // Whether the read is on the ring, rather than a worker.
+    b8 on_ring;
+    b8 owns_buffer;
+    char path[ASYNC_IO_MAX_PATH_LENGTH];
+    file_handle file;
+    u8* buffer;
+    u64 offset;
+    u64 size;
+    // Bytes read so far. Reads through the ring can come back short, and are continued.
+    u64 read;
+    pfn_async_read_complete callback;
+    void* user_data;
+} async_read_slot;
+
+typedef struct async_io_system_state {
+    b8 use_ring;
+    kio_ring ring;
+    // Reads on the ring which have not completed yet.
+    u32 ring_in_flight;
+    // Reads on the job system's workers.
+    job_counter jobs;
+    // Slots not free; skips the scan for finished reads when there are none.
+    u32 active_count;
+    // Where the search for a free slot starts.
+    u32 next_slot;
+    async_read_slot slots[ASYNC_IO_MAX_REQUESTS];
+
+    perf_counter_id bytes_read_counter;
+} async_io_system_state;
+
+static async_io_system_state* state_ptr;
+
+static void finish_read(async_read_slot* slot, b8 succeeded) {
+    filesystem_close(&slot->file);
+    if (succeeded) {
+        perf_counter_add_local(state_ptr->bytes_read_counter, slot->read);
+    }
+    // Publishes the buffer to whoever sees the new state.
+    katomic_store_u32(&slot->state, succeeded ? ASYNC_READ_SLOT_COMPLETE : ASYNC_READ_SLOT_FAILED, KATOMIC_RELEASE);
+}
+
+static void read_job(void* params) {
+    async_read_slot* slot = params;
+    u64 remaining = slot->size - slot->read;
+    u64 bytes_read = 0;
+    b8 succeeded = filesystem_seek(&slot->file, slot->offset + slot->read) &&
+                   filesystem_read(&slot->file, remaining, slot->buffer + slot->read, &bytes_read);
+    slot->read += bytes_read;
+    finish_read(slot, succeeded);
+}
+
+// Queues the rest of a read on the ring, or on a worker when the ring is full.
+static void continue_read(async_read_slot* slot, job_info* jobs, u32* job_count) {
+    u32 index = (u32)(slot - state_ptr->slots);
+    if (state_ptr->use_ring && kio_ring_read(&state_ptr->ring, &slot->file, slot->offset + slot->read, slot->size - slot->read, slot->buffer + slot->read, index)) {
+        slot->on_ring = true;
+        state_ptr->ring_in_flight++;
+        return;
+    }
+
+    slot->on_ring = false;
+    job_info* job = &jobs[(*job_count)++];
+    job->entry_point = read_job;
+    job->params = slot;
+    // Asset streaming; never more urgent than the frame.
+    job->priority = JOB_PRIORITY_LOW;
+}
+
+static void process_completions(b8 wait) {
+    if (!state_ptr->use_ring || state_ptr->ring_in_flight == 0) {
+        return;
+    }
+
+    kio_completion completions[ASYNC_IO_COMPLETION_BATCH];
+    job_info jobs[ASYNC_IO_COMPLETION_BATCH];
+    u32 job_count = 0;
+    u32 count = kio_ring_complete(&state_ptr->ring, completions, ASYNC_IO_COMPLETION_BATCH, wait);
+    for (u32 i = 0; i < count; ++i) {
+        async_read_slot* slot = &state_ptr->slots[completions[i].user_data];
+        state_ptr->ring_in_flight--;
+        if (completions[i].result < 0) {
+            KWARN("Async read of '%s' failed with error %lld.", slot->path, -completions[i].result);
+            finish_read(slot, false);
+        } else if (completions[i].result == 0) {
+            // The file got shorter since it was opened.
+            KWARN("Async read of '%s' ended after %llu of %llu bytes.", slot->path, slot->read, slot->size);
+            finish_read(slot, false);
+        } else {
+            slot->read += (u64)completions[i].result;
+            if (slot->read < slot->size) {
+                continue_read(slot, jobs, &job_count);
+            } else {
+                finish_read(slot, true);
+            }
+        }
+    }
+
+    kio_ring_submit(&state_ptr->ring);
+    job_system_submit(jobs, job_count, &state_ptr->jobs);
+}
+
+static void release_slot(async_read_slot* slot) {
+    if (slot->owns_buffer && slot->buffer) {
+        kfree(slot->buffer, slot->size, MEMORY_TAG_FILE);
+    }
+    kzero_memory(slot, sizeof(async_read_slot));
+    state_ptr->active_count--;
+}
+
+static void fill_result(async_read_slot* slot, async_read_result* out_result) {
+    out_result->path = slot->path;
+    out_result->offset = slot->offset;
+    out_result->data = slot->buffer;
+    out_result->size = slot->read;
+    out_result->succeeded = katomic_load_u32(&slot->state, KATOMIC_ACQUIRE) == ASYNC_READ_SLOT_COMPLETE;
+    out_result->user_data = slot->user_data;
+}
+
+b8 async_io_system_initialize(u64* memory_requirement, void* state, async_io_system_config config) {
+    *memory_requirement = sizeof(async_io_system_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(async_io_system_state));
+    state_ptr->bytes_read_counter = perf_counter_register("async bytes read");
+
+    if (!config.disable_kernel_queue && kio_ring_create(ASYNC_IO_MAX_REQUESTS, &state_ptr->ring)) {
+        state_ptr->use_ring = true;
+        KINFO("Async IO reads through the kernel's queue.");
+    } else {
+        KINFO("Async IO reads on job system workers.");
+    }
+    return true;
+}
+
+void async_io_system_shutdown(void* state) {
+    if (state_ptr) {
+        while (state_ptr->ring_in_flight > 0) {
+            process_completions(true);
+        }
+        job_system_wait(&state_ptr->jobs);
+
+        for (u32 i = 0; i < ASYNC_IO_MAX_REQUESTS; ++i) {
+            if (katomic_load_u32(&state_ptr->slots[i].state, KATOMIC_ACQUIRE) != ASYNC_READ_SLOT_FREE) {
+                release_slot(&state_ptr->slots[i]);
+            }
+        }
+        if (state_ptr->use_ring) {
+            kio_ring_destroy(&state_ptr->ring);
+        }
+    }
+    state_ptr = 0;
+}
+
+void async_io_system_update() {
+    if (!state_ptr || state_ptr->active_count == 0) {
+        return;
+    }
+
+    process_completions(false);
+
+    for (u32 i = 0; i < ASYNC_IO_MAX_REQUESTS; ++i) {
+        async_read_slot* slot = &state_ptr->slots[i];
+        if (!slot->callback) {
+            continue;
+        }
+        u32 slot_state = katomic_load_u32(&slot->state, KATOMIC_ACQUIRE);
+        if (slot_state == ASYNC_READ_SLOT_COMPLETE || slot_state == ASYNC_READ_SLOT_FAILED) {
+            async_read_result result;
+            fill_result(slot, &result);
+            slot->callback(&result);
+            release_slot(slot);
+        }
+    }
+}
+
+static async_read_slot* claim_slot() {
+    for (u32 i = 0; i < ASYNC_IO_MAX_REQUESTS; ++i) {
+        u32 index = (state_ptr->next_slot + i) % ASYNC_IO_MAX_REQUESTS;
+        if (katomic_load_u32(&state_ptr->slots[index].state, KATOMIC_RELAXED) == ASYNC_READ_SLOT_FREE) {
+            state_ptr->next_slot = index + 1;
+            state_ptr->active_count++;
+            return &state_ptr->slots[index];
+        }
+    }
+    return 0;
+}
+
+// Opens and sizes the file of a read. False if the read failed already.
+static b8 prepare_read(async_read_slot* slot, const async_read_request* request) {
+    if (!filesystem_open(slot->path, FILE_MODE_READ, true, &slot->file)) {
+        KWARN("Async read of '%s' failed: unable to open the file.", slot->path);
+        return false;
+    }
+
+    slot->offset = request->offset;
+    slot->size = request->size;
+    if (slot->size == 0) {
+        u64 file_size = 0;
+        if (!filesystem_size(&slot->file, &file_size) || file_size < slot->offset) {
+            KWARN("Async read of '%s' failed: offset %llu is past the end of the file.", slot->path, slot->offset);
+            filesystem_close(&slot->file);
+            return false;
+        }
+        slot->size = file_size - slot->offset;
+    }
+
+    slot->buffer = request->buffer;
+    if (!slot->buffer && slot->size > 0) {
+        slot->buffer = kallocate(slot->size, MEMORY_TAG_FILE);
+        slot->owns_buffer = true;
+    }
+    return true;
+}
+
+b8 async_io_submit(const async_read_request* requests, u32 count, async_read_handle* out_handles) {
+    if (!state_ptr) {
+        KERROR("async_io_submit - The async IO system is not initialized.");
+        for (u32 i = 0; out_handles && i < count; ++i) {
+            out_handles[i] = INVALID_ID;
+        }
+        return false;
+    }
+
+    b8 all_started = true;
+    job_info jobs[ASYNC_IO_MAX_REQUESTS];
+    u32 job_count = 0;
+    for (u32 i = 0; i < count; ++i) {
+        const async_read_request* request = &requests[i];
+        if (out_handles) {
+            out_handles[i] = INVALID_ID;
+        }
+
+        if (!request->path || string_length(request->path) >= ASYNC_IO_MAX_PATH_LENGTH) {
+            KERROR("async_io_submit - Path is missing or longer than ASYNC_IO_MAX_PATH_LENGTH.");
+            all_started = false;
+            continue;
+        }
+        async_read_slot* slot = claim_slot();
+        if (!slot) {
+            KWARN("async_io_submit - Too many reads in flight; '%s' was not started. Increase ASYNC_IO_MAX_REQUESTS.", request->path);
+            all_started = false;
+            continue;
+        }
+
+        string_ncopy(slot->path, request->path, ASYNC_IO_MAX_PATH_LENGTH);
+        slot->callback = request->callback;
+        slot->user_data = request->user_data;
+        slot->state = ASYNC_READ_SLOT_READING;
+        if (out_handles) {
+            out_handles[i] = (u32)(slot - state_ptr->slots);
+        }
+
+        // Failures here are still reported through the handle or callback, like any other.
+        if (!prepare_read(slot, request)) {
+            slot->state = ASYNC_READ_SLOT_FAILED;
+        } else if (slot->size == 0) {
+            finish_read(slot, true);
+        } else {
+            continue_read(slot, jobs, &job_count);
+        }
+    }
+
+    // The whole batch goes out at once.
+    if (state_ptr->use_ring) {
+        kio_ring_submit(&state_ptr->ring);
+    }
+    job_system_submit(jobs, job_count, &state_ptr->jobs);
+    return all_started;
+}
+
+static async_read_slot* get_slot(async_read_handle handle, const char* function) {
+    if (!state_ptr || handle >= ASYNC_IO_MAX_REQUESTS || katomic_load_u32(&state_ptr->slots[handle].state, KATOMIC_RELAXED) == ASYNC_READ_SLOT_FREE) {
+        KERROR("%s - Invalid handle %u.", function, handle);
+        return 0;
+    }
+    return &state_ptr->slots[handle];
+}
+
+async_read_status async_io_status(async_read_handle handle) {
+    async_read_slot* slot = get_slot(handle, "async_io_status");
+    if (!slot) {
+        return ASYNC_READ_FAILED;
+    }
+
+    process_completions(false);
+    switch (katomic_load_u32(&slot->state, KATOMIC_ACQUIRE)) {
+        case ASYNC_READ_SLOT_COMPLETE:
+            return ASYNC_READ_COMPLETE;
+        case ASYNC_READ_SLOT_FAILED:
+            return ASYNC_READ_FAILED;
+        default:
+            return ASYNC_READ_PENDING;
+    }
+}
+
+b8 async_io_result(async_read_handle handle, async_read_result* out_result) {
+    if (async_io_status(handle) == ASYNC_READ_PENDING) {
+        return false;
+    }
+    async_read_slot* slot = get_slot(handle, "async_io_result");
+    if (!slot || !out_result) {
+        return false;
+    }
+    fill_result(slot, out_result);
+    return true;
+}
+
+async_read_status async_io_wait(async_read_handle handle) {
+    async_read_slot* slot = get_slot(handle, "async_io_wait");
+    if (!slot) {
+        return ASYNC_READ_FAILED;
+    }
+
+    async_read_status status;
+    while ((status = async_io_status(handle)) == ASYNC_READ_PENDING) {
+        if (slot->on_ring) {
+            process_completions(true);
+        } else if (!job_system_help()) {
+            // Being read on a worker.
+            platform_sleep(0);
+        }
+    }
+    return status;
+}
+
+void async_io_release(async_read_handle handle) {
+    async_read_slot* slot = get_slot(handle, "async_io_release");
+    if (!slot) {
+        return;
+    }
+    if (katomic_load_u32(&slot->state, KATOMIC_ACQUIRE) == ASYNC_READ_SLOT_READING) {
+        KWARN("async_io_release - '%s' is still being read; wait for it first.", slot->path);
+        return;
+    }
+    release_slot(slot);
+}
+
+b8 async_io_uses_kernel_queue() {
+    return state_ptr ? state_ptr->use_ring : false;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "defines.h"
+
+// Most reads which can be in flight, or completed but not yet released, at once.
+#define ASYNC_IO_MAX_REQUESTS 256
+// Longest path a read can be made from, including the terminator.
+#define ASYNC_IO_MAX_PATH_LENGTH 256
+
+// Identifies a read. INVALID_ID when a read could not be submitted.
+typedef u32 async_read_handle;
+
+typedef enum async_read_status {
+    ASYNC_READ_PENDING = 0,
+    ASYNC_READ_COMPLETE = 1,
+    ASYNC_READ_FAILED = 2
+} async_read_status;
+
+typedef struct async_read_result {
+    // The path the read was made from.
+    const char* path;
+    // Where in the file the read started.
+    u64 offset;
+    // The bytes read. Valid until the read is released.
+    void* data;
+    // The number of bytes read.
+    u64 size;
+    b8 succeeded;
+    // As passed with the request.
+    void* user_data;
+} async_read_result;
+
+/**
+ * @brief Called on the main thread, from async_io_system_update, when a read finishes.
+ * The read is released once it returns, so anything kept must be copied out.
+ *
+ * @param result The outcome of the read.
+ */
+typedef void (*pfn_async_read_complete)(const async_read_result* result);
+
+typedef struct async_read_request {
+    // Copied on submit.
+    const char* path;
+    // Where in the file to start reading.
+    u64 offset;
+    // Number of bytes to read. 0 reads to the end of the file.
+    u64 size;
+    // Where to read to. 0 allocates a buffer, which is freed when the read is released.
+    void* buffer;
+    // Optional. Without one, poll the handle with async_io_status and release it when done.
+    pfn_async_read_complete callback;
+    void* user_data;
+} async_read_request;
+
+typedef struct async_io_system_config {
+    // Forces reads onto the job system's workers, even where the kernel could do them.
+    b8 disable_kernel_queue;
+} async_io_system_config;
+
+/**
+ * @brief Initializes the async IO system. Call twice; once with state = 0 to get required
+ * memory size, then a second time passing allocated memory to state. Reads go through
+ * io_uring where available, otherwise they are done on the job system's workers, which
+ * should be started first.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param config The configuration of the system.
+ * @return b8 True on success; otherwise false.
+ */
+b8 async_io_system_initialize(u64* memory_requirement, void* state, async_io_system_config config);
+
+/** @brief Waits for reads in flight, then releases every read without calling their callbacks. */
+void async_io_system_shutdown(void* state);
+
+/** @brief Collects finished reads and calls their callbacks. Called once a frame. */
+void async_io_system_update();
+
+/**
+ * @brief Starts reading files in the background. Files are opened (and sized) here,
+ * only the reads themselves are asynchronous.
+ * NOTE: Everything but the reads themselves happens on the main thread, as does this.
+ *
+ * @param requests An array of reads.
+ * @param count The number of reads.
+ * @param out_handles An array of count handles to hold one per read, INVALID_ID for reads which
+ * could not be started. Optional when every request has a callback.
+ * @return b8 True if every read was started; otherwise false.
+ */
+KAPI b8 async_io_submit(const async_read_request* requests, u32 count, async_read_handle* out_handles);
+
+/** @brief Gets the status of a read which has no callback. */
+KAPI async_read_status async_io_status(async_read_handle handle);
+
+/**
+ * @brief Gets the outcome of a finished read which has no callback.
+ *
+ * @param handle The handle of the read.
+ * @param out_result A pointer to hold the outcome.
+ * @return b8 True if the read has finished; otherwise false.
+ */
+KAPI b8 async_io_result(async_read_handle handle, async_read_result* out_result);
+
+/** @brief Blocks until a read finishes. Returns its status. */
+KAPI async_read_status async_io_wait(async_read_handle handle);
+
+/** @brief Releases a finished read which has no callback, freeing its buffer if allocated for it. */
+KAPI void async_io_release(async_read_handle handle);
+
+/** @brief Indicates if reads are done by the kernel rather than worker threads. */
+KAPI b8 async_io_uses_kernel_queue();
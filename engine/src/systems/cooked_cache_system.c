@@ -0,0 +1,186 @@
+#include "cooked_cache_system.h"
+
+#include "core/khash.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/logger.h"
+#include "containers/darray.h"
+#include "platform/kthread.h"
+#include "platform/platform.h"
+
+#include <stdlib.h>
+
+// Appended to the path of an entry being written, after something unique to the writer.
+#define COOKED_CACHE_TEMP_EXTENSION "tmp"
+
+typedef struct cooked_cache_system_state {
+    char cache_directory[COOKED_CACHE_MAX_PATH_LENGTH];
+    // False when the cache directory could not be created.
+    b8 enabled;
+} cooked_cache_system_state;
+
+static cooked_cache_system_state* state_ptr;
+
+static void cooked_file_path(const char* type, u64 key, char* out_path) {
+    string_format(out_path, "%s/%016llx.%s", state_ptr->cache_directory, key, type);
+}
+
+// Entries, and the temporary files they are written to, are named for their key in 16 hex digits.
+static b8 is_cache_file(const char* name) {
+    for (u32 i = 0; i < 16; ++i) {
+        char c = name[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return name[16] == '.';
+}
+
+// As "<key>.<type>.<writer>.tmp"; the writer tells one apart from an entry of type "tmp".
+static b8 is_temp_file(const char* name) {
+    u32 dots = 0;
+    const char* extension = 0;
+    for (const char* c = name; *c; ++c) {
+        if (*c == '.') {
+            dots++;
+            extension = c + 1;
+        }
+    }
+    return dots >= 3 && strings_equal(extension, COOKED_CACHE_TEMP_EXTENSION);
+}
+
+typedef struct cache_entry {
+    char name[64];
+    u64 size;
+    u64 modified_time;
+} cache_entry;
+
+typedef struct cache_scan {
+    cache_entry* entries;
+    u64 total_size;
+} cache_scan;
+
+static b8 scan_entry(const char* name, b8 is_directory, void* user_data) {
+    if (is_directory || !is_cache_file(name) || string_length(name) >= sizeof(((cache_entry*)0)->name)) {
+        return true;
+    }
+    char path[COOKED_CACHE_MAX_PATH_LENGTH + 64];
+    string_format(path, "%s/%s", state_ptr->cache_directory, name);
+    if (is_temp_file(name)) {
+        // Left by a store which never finished.
+        filesystem_delete(path);
+        return true;
+    }
+
+    cache_scan* scan = user_data;
+    cache_entry entry;
+    string_ncopy(entry.name, name, sizeof(entry.name));
+    if (filesystem_file_info(path, &entry.size, &entry.modified_time)) {
+        darray_push(scan->entries, entry);
+        scan->total_size += entry.size;
+    }
+    return true;
+}
+
+static int compare_oldest_first(const void* a, const void* b) {
+    u64 left = ((const cache_entry*)a)->modified_time;
+    u64 right = ((const cache_entry*)b)->modified_time;
+    return (left > right) - (left < right);
+}
+
+// Deletes leftover temporary files, then the oldest entries until the rest fit in max_size.
+static void trim_cache(u64 max_size) {
+    cache_scan scan = {0};
+    scan.entries = darray_create(cache_entry);
+    filesystem_list_directory(state_ptr->cache_directory, scan_entry, &scan);
+
+    u64 count = darray_length(scan.entries);
+    if (max_size > 0 && scan.total_size > max_size) {
+        qsort(scan.entries, count, sizeof(cache_entry), compare_oldest_first);
+        u32 evicted = 0;
+        for (u64 i = 0; i < count && scan.total_size > max_size; ++i) {
+            char path[COOKED_CACHE_MAX_PATH_LENGTH + 64];
+            string_format(path, "%s/%s", state_ptr->cache_directory, scan.entries[i].name);
+            if (filesystem_delete(path)) {
+                scan.total_size -= scan.entries[i].size;
+                evicted++;
+            }
+        }
+        KINFO("Cooked asset cache over %llu bytes; removed the %u oldest entries.", max_size, evicted);
+    }
+    darray_destroy(scan.entries);
+}
+
+b8 cooked_cache_system_initialize(u64* memory_requirement, void* state, cooked_cache_config config) {
+    *memory_requirement = sizeof(cooked_cache_system_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(cooked_cache_system_state));
+    string_ncopy(state_ptr->cache_directory, config.cache_directory ? config.cache_directory : "cache", COOKED_CACHE_MAX_PATH_LENGTH - 1);
+    state_ptr->enabled = filesystem_create_directory(state_ptr->cache_directory);
+    if (state_ptr->enabled) {
+        trim_cache(config.max_size);
+        KINFO("Cooked assets cached in '%s'.", state_ptr->cache_directory);
+    } else {
+        // Not fatal; every asset is just cooked on each load.
+        KWARN("Unable to create cooked asset cache '%s'. Assets will be converted on every load.", state_ptr->cache_directory);
+    }
+    return true;
+}
+
+void cooked_cache_system_shutdown(void* state) {
+    state_ptr = 0;
+}
+
+u64 cooked_cache_key(const void* source, u64 source_size, u32 cooker_version) {
+    return khash64(source, source_size, cooker_version);
+}
+
+b8 cooked_cache_map(const char* type, u64 key, file_mapping* out_mapping) {
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+    if (!state_ptr || !state_ptr->enabled || !type) {
+        return false;
+    }
+    char path[COOKED_CACHE_MAX_PATH_LENGTH + 32];
+    cooked_file_path(type, key, path);
+    // Cooked assets are uploaded or copied front to back, once.
+    return filesystem_map_readonly(path, FILE_ACCESS_HINT_SEQUENTIAL, out_mapping);
+}
+
+b8 cooked_cache_store(const char* type, u64 key, const void* header, u64 header_size, const void* data, u64 data_size) {
+    if (!state_ptr || !state_ptr->enabled || !type) {
+        return false;
+    }
+    char path[COOKED_CACHE_MAX_PATH_LENGTH + 32];
+    cooked_file_path(type, key, path);
+    // In the same directory, so the rename never crosses filesystems. The thread and time keep
+    // two writers of the same entry, in this process or another, from sharing a temporary file.
+    char temp_path[COOKED_CACHE_MAX_PATH_LENGTH + 96];
+    u64 writer = kthread_current_id() ^ (u64)(platform_get_absolute_time() * 1000000000.0);
+    string_format(temp_path, "%s.%016llx.%s", path, writer, COOKED_CACHE_TEMP_EXTENSION);
+
+    file_handle handle;
+    if (!filesystem_open(temp_path, FILE_MODE_WRITE, true, &handle)) {
+        KWARN("cooked_cache_store - Unable to open '%s' for writing.", temp_path);
+        return false;
+    }
+    u64 written = 0;
+    b8 result = (header_size == 0 || filesystem_write(&handle, header_size, header, &written)) &&
+                (data_size == 0 || filesystem_write(&handle, data_size, data, &written));
+    filesystem_close(&handle);
+    if (!result) {
+        KWARN("cooked_cache_store - Failed to write '%s'.", temp_path);
+    } else if (!filesystem_rename(temp_path, path)) {
+        // i.e. the entry is mapped on a platform which cannot replace it meanwhile.
+        KWARN("cooked_cache_store - Unable to move '%s' into place.", temp_path);
+        result = false;
+    }
+    if (!result) {
+        filesystem_delete(temp_path);
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/filesystem.h"
+
+// Longest path the cache directory can have, including the terminator.
+#define COOKED_CACHE_MAX_PATH_LENGTH 256
+
+typedef struct cooked_cache_config {
+    // Where cooked assets are kept, i.e. "cache". Created if missing.
+    const char* cache_directory;
+    // Most bytes kept on disk, checked at startup, or 0 for no limit.
+    u64 max_size;
+} cooked_cache_config;
+
+/**
+ * @brief Initializes the cooked asset cache, which keeps assets already converted to the
+ * form they are used in (i.e. decoded pixels), so later loads can map them instead of
+ * converting them again. Entries are keyed by a hash of the source file's bytes and the
+ * version of whatever cooked it, so an edited source or a changed cooker simply misses.
+ * Call twice; once with state = 0 to get required memory size, then a second time passing
+ * allocated memory to state. Nothing is cached until this is called, and a cache directory
+ * which cannot be created only disables the cache.
+ *
+ * Entries are never removed while running. At startup, files left by interrupted stores are
+ * deleted, then if the entries add up to more than max_size, the least recently stored are
+ * deleted until they fit.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param config The configuration of the system.
+ * @return b8 True on success; otherwise false.
+ */
+b8 cooked_cache_system_initialize(u64* memory_requirement, void* state, cooked_cache_config config);
+
+void cooked_cache_system_shutdown(void* state);
+
+/**
+ * @brief Gets the key a source is cached under.
+ *
+ * @param source The bytes of the source file, as read.
+ * @param source_size The size of the source file.
+ * @param cooker_version The version of the conversion. Change it whenever its output changes.
+ * @return u64 The key.
+ */
+KAPI u64 cooked_cache_key(const void* source, u64 source_size, u32 cooker_version);
+
+/**
+ * @brief Maps a cooked asset read only. Unmap it with filesystem_unmap. Entries only appear
+ * once completely written, but their contents are as stored, so should still be checked before use.
+ *
+ * @param type The kind of asset, used as the file extension, i.e. "ktex".
+ * @param key The key from cooked_cache_key.
+ * @param out_mapping A pointer to the mapping to be filled in.
+ * @return b8 True if the asset is cached; otherwise false.
+ */
+KAPI b8 cooked_cache_map(const char* type, u64 key, file_mapping* out_mapping);
+
+/**
+ * @brief Stores a cooked asset, as a header followed by its data, replacing any stored before.
+ * Written to a temporary file first, then renamed into place, so a store cut short by a crash,
+ * or racing another, never leaves a partial entry behind.
+ *
+ * @param type The kind of asset, used as the file extension, i.e. "ktex".
+ * @param key The key from cooked_cache_key.
+ * @param header The header to write first.
+ * @param header_size The size of the header, in bytes.
+ * @param data The data to write after it.
+ * @param data_size The size of the data, in bytes.
+ * @return b8 True if stored; otherwise false.
+ */
+KAPI b8 cooked_cache_store(const char* type, u64 key, const void* header, u64 header_size, const void* data, u64 data_size);
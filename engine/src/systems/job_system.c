@@ -0,0 +1,351 @@
+#include "job_system.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/profiler.h"
+#include "core/perf_counters.h"
+#include "platform/platform.h"
+#include "platform/kthread.h"
+#include "platform/ksemaphore.h"
+#include "platform/katomic.h"
+
+// Times an idle worker looks for work again before going to sleep.
+#define JOB_SYSTEM_IDLE_SPINS 64
+// Longest an idle worker sleeps before looking again, in case a wake up was missed.
+#define JOB_SYSTEM_IDLE_TIMEOUT_MS 10
+
+typedef struct job_entry {
+    pfn_job_start entry_point;
+    void* params;
+    job_counter* counter;
+} job_entry;
+
+/**
+ * A Chase-Lev work-stealing deque of fixed capacity. Its owning thread pushes and
+ * takes at the bottom without contention; other threads steal from the top.
+ */
+typedef struct job_deque {
+    // Next index to steal from. Only ever increases.
+    volatile u64 top;
+    // Kept on separate cache lines, as thieves hammer top while the owner works on bottom.
+    u8 padding0[56];
+    // Next index to push to.
+    volatile u64 bottom;
+    u8 padding1[56];
+    job_entry entries[JOB_SYSTEM_QUEUE_CAPACITY];
+} job_deque;
+
+typedef struct job_thread {
+    u32 index;
+    // Where the next steal starts looking, so thieves spread across victims.
+    u32 steal_start;
+    kthread thread;
+    job_deque queues[JOB_PRIORITY_COUNT];
+} job_thread;
+
+typedef struct job_system_state {
+    volatile u32 running;
+    // Including the main thread, which is index 0.
+    u32 thread_count;
+    // Signalled as jobs are submitted, to wake sleeping workers.
+    ksemaphore wake;
+    job_thread* threads;
+
+    perf_counter_id jobs_run_counter;
+    perf_counter_id jobs_stolen_counter;
+} job_system_state;
+
+static job_system_state* state_ptr;
+
+// The job thread of the calling thread. 0 for threads outside the job system.
+static KTHREAD_LOCAL job_thread* current_thread;
+
+static b8 deque_push(job_deque* deque, const job_entry* entry) {
+    u64 bottom = katomic_load_u64(&deque->bottom, KATOMIC_RELAXED);
+    u64 top = katomic_load_u64(&deque->top, KATOMIC_ACQUIRE);
+    if (bottom - top >= JOB_SYSTEM_QUEUE_CAPACITY) {
+        return false;
+    }
+
+    deque->entries[bottom % JOB_SYSTEM_QUEUE_CAPACITY] = *entry;
+    // Publishes the entry before the new bottom.
+    katomic_fence(KATOMIC_RELEASE);
+    katomic_store_u64(&deque->bottom, bottom + 1, KATOMIC_RELAXED);
+    return true;
+}
+
+static b8 deque_take(job_deque* deque, job_entry* out_entry) {
+    // Claim the bottom entry before checking whether a thief got to it first.
+    u64 bottom = katomic_load_u64(&deque->bottom, KATOMIC_RELAXED) - 1;
+    katomic_store_u64(&deque->bottom, bottom, KATOMIC_RELAXED);
+    katomic_fence(KATOMIC_SEQ_CST);
+    u64 top = katomic_load_u64(&deque->top, KATOMIC_RELAXED);
+
+    // Signed, as bottom is one below top when the deque is empty.
+    if ((i64)(bottom - top) < 0) {
+        katomic_store_u64(&deque->bottom, bottom + 1, KATOMIC_RELAXED);
+        return false;
+    }
+
+    *out_entry = deque->entries[bottom % JOB_SYSTEM_QUEUE_CAPACITY];
+    if (bottom != top) {
+        // More than one left, so no thief can reach this one.
+        return true;
+    }
+
+    // The last entry. Race the thieves for it.
+    b8 won = katomic_compare_exchange_u64(&deque->top, &top, top + 1, KATOMIC_SEQ_CST);
+    katomic_store_u64(&deque->bottom, bottom + 1, KATOMIC_RELAXED);
+    return won;
+}
+
+static b8 deque_steal(job_deque* deque, job_entry* out_entry) {
+    u64 top = katomic_load_u64(&deque->top, KATOMIC_ACQUIRE);
+    katomic_fence(KATOMIC_SEQ_CST);
+    u64 bottom = katomic_load_u64(&deque->bottom, KATOMIC_ACQUIRE);
+    if ((i64)(bottom - top) <= 0) {
+        return false;
+    }
+
+    // May be torn if the owner is overwriting the slot, but then the exchange fails and the copy is dropped.
+    *out_entry = deque->entries[top % JOB_SYSTEM_QUEUE_CAPACITY];
+    return katomic_compare_exchange_u64(&deque->top, &top, top + 1, KATOMIC_SEQ_CST);
+}
+
+static b8 find_job(job_thread* self, job_entry* out_entry) {
+    // Every queue of a priority, the thread's own first, before any of a lower one.
+    for (u32 priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+        if (deque_take(&self->queues[priority], out_entry)) {
+            return true;
+        }
+
+        u32 count = state_ptr->thread_count;
+        for (u32 i = 0; i < count; ++i) {
+            job_thread* victim = &state_ptr->threads[(self->steal_start + i) % count];
+            if (victim != self && deque_steal(&victim->queues[priority], out_entry)) {
+                self->steal_start = victim->index;
+                perf_counter_add_local(state_ptr->jobs_stolen_counter, 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void run_job(const job_entry* entry) {
+    KPROFILE_ZONE_BEGIN("job");
+    entry->entry_point(entry->params);
+    KPROFILE_ZONE_END();
+
+    if (state_ptr) {
+        perf_counter_add_local(state_ptr->jobs_run_counter, 1);
+    }
+    if (entry->counter) {
+        // Releases the job's writes to whoever sees the counter reach 0.
+        katomic_fetch_sub_u32(&entry->counter->remaining, 1, KATOMIC_RELEASE);
+    }
+}
+
+static u32 job_worker_run(void* params) {
+    job_thread* self = params;
+    current_thread = self;
+
+    u32 idle_spins = 0;
+    job_entry entry;
+    while (katomic_load_u32(&state_ptr->running, KATOMIC_ACQUIRE)) {
+        if (find_job(self, &entry)) {
+            run_job(&entry);
+            idle_spins = 0;
+        } else if (++idle_spins >= JOB_SYSTEM_IDLE_SPINS) {
+            // Nothing to do. Sleep until more work is submitted.
+            ksemaphore_wait(&state_ptr->wake, JOB_SYSTEM_IDLE_TIMEOUT_MS);
+            idle_spins = 0;
+        }
+    }
+
+    current_thread = 0;
+    return 0;
+}
+
+static u32 get_worker_count(job_system_config config) {
+    u32 count = config.worker_count;
+    if (count == 0) {
+        u32 processor_count = platform_get_processor_count();
+        count = processor_count > 1 ? processor_count - 1 : 1;
+    }
+    return count > JOB_SYSTEM_MAX_WORKERS ? JOB_SYSTEM_MAX_WORKERS : count;
+}
+
+b8 job_system_initialize(u64* memory_requirement, void* state, job_system_config config) {
+    u32 worker_count = get_worker_count(config);
+    u32 thread_count = worker_count + 1;
+    *memory_requirement = sizeof(job_system_state) + sizeof(job_thread) * thread_count;
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, *memory_requirement);
+    state_ptr->threads = (job_thread*)((u8*)state + sizeof(job_system_state));
+    state_ptr->thread_count = thread_count;
+    state_ptr->running = true;
+    for (u32 i = 0; i < thread_count; ++i) {
+        state_ptr->threads[i].index = i;
+        state_ptr->threads[i].steal_start = i + 1;
+    }
+    state_ptr->jobs_run_counter = perf_counter_register("jobs run");
+    state_ptr->jobs_stolen_counter = perf_counter_register("jobs stolen");
+
+    if (!ksemaphore_create(&state_ptr->wake, 0x7FFFFFFF, 0)) {
+        KERROR("Failed to create job system semaphore.");
+        return false;
+    }
+
+    current_thread = &state_ptr->threads[0];
+    for (u32 i = 1; i < thread_count; ++i) {
+        if (!kthread_create(job_worker_run, &state_ptr->threads[i], false, &state_ptr->threads[i].thread)) {
+            KFATAL("Failed to start job worker thread %u.", i);
+            // Run with the workers started so far.
+            state_ptr->thread_count = i;
+            break;
+        }
+    }
+
+    KINFO("Job system started with %u worker threads.", state_ptr->thread_count - 1);
+    return true;
+}
+
+void job_system_shutdown(void* state) {
+    if (state_ptr) {
+        katomic_store_u32(&state_ptr->running, false, KATOMIC_RELEASE);
+        for (u32 i = 1; i < state_ptr->thread_count; ++i) {
+            ksemaphore_signal(&state_ptr->wake);
+        }
+        for (u32 i = 1; i < state_ptr->thread_count; ++i) {
+            kthread_wait(&state_ptr->threads[i].thread, 0);
+        }
+        ksemaphore_destroy(&state_ptr->wake);
+    }
+    current_thread = 0;
+    state_ptr = 0;
+}
+
+void job_system_submit(const job_info* jobs, u32 count, job_counter* counter) {
+    if (count == 0) {
+        return;
+    }
+    if (counter) {
+        katomic_fetch_add_u32(&counter->remaining, count, KATOMIC_RELAXED);
+    }
+
+    job_thread* self = current_thread;
+    if (!state_ptr || !self) {
+        if (state_ptr) {
+            KWARN("job_system_submit - Called from a thread outside the job system; running jobs immediately.");
+        }
+        for (u32 i = 0; i < count; ++i) {
+            job_entry entry = {jobs[i].entry_point, jobs[i].params, counter};
+            run_job(&entry);
+        }
+        return;
+    }
+
+    for (u32 i = 0; i < count; ++i) {
+        job_entry entry = {jobs[i].entry_point, jobs[i].params, counter};
+        job_priority priority = jobs[i].priority < JOB_PRIORITY_COUNT ? jobs[i].priority : JOB_PRIORITY_NORMAL;
+        if (!deque_push(&self->queues[priority], &entry)) {
+            // Queue full. Running it here also slows down whatever is flooding it.
+            run_job(&entry);
+        }
+    }
+
+    // Wake no more workers than there are jobs.
+    u32 wake_count = state_ptr->thread_count - 1;
+    wake_count = count < wake_count ? count : wake_count;
+    for (u32 i = 0; i < wake_count; ++i) {
+        ksemaphore_signal(&state_ptr->wake);
+    }
+}
+
+b8 job_counter_done(const job_counter* counter) {
+    return katomic_load_u32(&counter->remaining, KATOMIC_ACQUIRE) == 0;
+}
+
+void job_system_wait(job_counter* counter) {
+    if (job_counter_done(counter)) {
+        return;
+    }
+
+    KPROFILE_ZONE_BEGIN("job wait");
+    job_thread* self = current_thread;
+    job_entry entry;
+    while (!job_counter_done(counter)) {
+        if (state_ptr && self && find_job(self, &entry)) {
+            run_job(&entry);
+        } else {
+            // The rest are running elsewhere.
+            platform_sleep(0);
+        }
+    }
+    KPROFILE_ZONE_END();
+}
+
+b8 job_system_help() {
+    job_thread* self = current_thread;
+    job_entry entry;
+    if (state_ptr && self && find_job(self, &entry)) {
+        run_job(&entry);
+        return true;
+    }
+    return false;
+}
+
+u32 job_system_worker_count() {
+    return state_ptr ? state_ptr->thread_count - 1 : 0;
+}
+
+typedef struct parallel_for_batch {
+    pfn_parallel_for function;
+    void* params;
+    u32 begin;
+    u32 end;
+} parallel_for_batch;
+
+static void parallel_for_job(void* params) {
+    parallel_for_batch* batch = params;
+    batch->function(batch->begin, batch->end, batch->params);
+}
+
+void job_system_parallel_for(u32 count, u32 batch_size, pfn_parallel_for function, void* params, job_priority priority) {
+    if (count == 0 || !function) {
+        return;
+    }
+
+    u32 thread_count = state_ptr ? state_ptr->thread_count : 1;
+    if (batch_size == 0) {
+        batch_size = (count + thread_count - 1) / thread_count;
+    }
+    // Grow the batches if there would be too many to track.
+    u32 batch_count = (count + batch_size - 1) / batch_size;
+    if (batch_count > JOB_SYSTEM_MAX_PARALLEL_BATCHES) {
+        batch_size = (count + JOB_SYSTEM_MAX_PARALLEL_BATCHES - 1) / JOB_SYSTEM_MAX_PARALLEL_BATCHES;
+        batch_count = (count + batch_size - 1) / batch_size;
+    }
+
+    parallel_for_batch batches[JOB_SYSTEM_MAX_PARALLEL_BATCHES];
+    job_info jobs[JOB_SYSTEM_MAX_PARALLEL_BATCHES];
+    for (u32 i = 0; i < batch_count; ++i) {
+        batches[i].function = function;
+        batches[i].params = params;
+        batches[i].begin = i * batch_size;
+        batches[i].end = batches[i].begin + batch_size < count ? batches[i].begin + batch_size : count;
+        jobs[i].entry_point = parallel_for_job;
+        jobs[i].params = &batches[i];
+        jobs[i].priority = priority;
+    }
+
+    // The calling thread works through the batches too while it waits.
+    job_counter counter = {0};
+    job_system_submit(jobs, batch_count, &counter);
+    job_system_wait(&counter);
+}
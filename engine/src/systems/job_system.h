@@ -0,0 +1,117 @@
+#pragma once
+
+#include "defines.h"
+
+// Maximum number of worker threads, regardless of the number of cores.
+#define JOB_SYSTEM_MAX_WORKERS 32
+// Number of jobs each thread can have queued per priority. Jobs submitted past it run immediately instead.
+#define JOB_SYSTEM_QUEUE_CAPACITY 1024
+// Most jobs a single parallel_for is split into.
+#define JOB_SYSTEM_MAX_PARALLEL_BATCHES 256
+
+typedef enum job_priority {
+    // Needed this frame, i.e. culling and simulation.
+    JOB_PRIORITY_HIGH = 0,
+    JOB_PRIORITY_NORMAL = 1,
+    // Background work, i.e. asset loading. Only run when nothing more urgent is queued.
+    JOB_PRIORITY_LOW = 2,
+    JOB_PRIORITY_COUNT
+} job_priority;
+
+/**
+ * @brief The function a job runs.
+ *
+ * @param params The params the job was submitted with.
+ */
+typedef void (*pfn_job_start)(void* params);
+
+typedef struct job_info {
+    pfn_job_start entry_point;
+    // Passed to entry_point. Must stay valid until the job has run.
+    void* params;
+    job_priority priority;
+} job_info;
+
+/**
+ * Tracks a batch of jobs so it can be waited on. Zero it before the first submit; it
+ * can be reused once the batch is done.
+ */
+typedef struct job_counter {
+    // Number of submitted jobs which have not finished yet.
+    volatile u32 remaining;
+} job_counter;
+
+typedef struct job_system_config {
+    // Number of worker threads. 0 uses one per core, less the main thread's.
+    u8 worker_count;
+} job_system_config;
+
+/**
+ * @brief Initializes the job system and starts its worker threads. Call twice; once with
+ * state = 0 to get required memory size, then a second time passing allocated memory to state.
+ * The thread which initializes the job system becomes its main thread.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param config The configuration of the job system.
+ * @return b8 True on success; otherwise false.
+ */
+b8 job_system_initialize(u64* memory_requirement, void* state, job_system_config config);
+
+/** @brief Stops the worker threads once they finish their current job. Queued jobs are dropped. */
+void job_system_shutdown(void* state);
+
+/**
+ * @brief Queues jobs to run on any thread. Jobs are queued on the calling thread and
+ * taken from there by idle workers.
+ * NOTE: Only the main thread and jobs themselves may submit.
+ *
+ * @param jobs An array of jobs.
+ * @param count The number of jobs.
+ * @param counter Counts the jobs until they finish, to wait on them. Optional.
+ */
+KAPI void job_system_submit(const job_info* jobs, u32 count, job_counter* counter);
+
+/**
+ * @brief Waits for every job submitted with a counter to finish. Runs queued jobs
+ * on the calling thread while waiting, so jobs may wait on jobs of their own.
+ *
+ * @param counter A pointer to the counter.
+ */
+KAPI void job_system_wait(job_counter* counter);
+
+/**
+ * @brief Runs one queued job on the calling thread, if there is one. For threads
+ * waiting on something other than a counter.
+ *
+ * @return b8 True if a job was run; otherwise false.
+ */
+KAPI b8 job_system_help();
+
+/** @brief Indicates if every job submitted with a counter has finished. */
+KAPI b8 job_counter_done(const job_counter* counter);
+
+/** @brief Gets the number of worker threads, not counting the main thread. */
+KAPI u32 job_system_worker_count();
+
+/**
+ * @brief The function parallel_for runs on each range of indices.
+ *
+ * @param begin The first index of the range.
+ * @param end One past the last index of the range.
+ * @param params The params passed to job_system_parallel_for.
+ */
+typedef void (*pfn_parallel_for)(u32 begin, u32 end, void* params);
+
+/**
+ * @brief Runs a function over the indices [0, count) in batches spread across all
+ * threads, including the calling one, and waits for them to finish.
+ *
+ * @param count The number of indices.
+ * @param batch_size The number of indices per job. 0 splits the work evenly across threads. Grown
+ * where it would take more than JOB_SYSTEM_MAX_PARALLEL_BATCHES jobs.
+ * @param function The function to run on each batch.
+ * @param params Passed to function.
+ * @param priority The priority of the jobs.
+ */
+KAPI void job_system_parallel_for(u32 count, u32 batch_size, pfn_parallel_for function, void* params, job_priority priority);
@@ -1,14 +1,17 @@
 #include "material_system.h"
 
+#include "core/event.h"
 #include "core/logger.h"
 #include "core/kstring.h"
+#include "core/kstring_builder.h"
 #include "containers/hashtable.h"
 #include "math/kmath.h"
 #include "renderer/renderer_frontend.h"
+#include "resources/material_file.h"
 #include "systems/texture_system.h"
 
 // TODO: temp: resource system
-#include "platform/filesystem.h"
+#include "systems/vfs_system.h"
 // end temp
 
 typedef struct material_system_state {
@@ -35,10 +38,11 @@ b8 create_default_material(material_system_state* state);
 b8 load_material(material_config config, material* m);
 void destroy_material(material* m);
 b8 load_configuration_file(const char* path, material_config* out_config);
+b8 material_system_on_asset_changed(u16 code, void* sender, void* listener_inst, event_context context);
 
 b8 material_system_initialize(u64* memory_requirement, void* state, material_system_config config) {
     if (config.max_material_count == 0) {
-        KFATAL("material_system_initialize - config.max_material_count must be > 0.");
+        KFATAL_CH(MATERIAL, "material_system_initialize - config.max_material_count must be > 0.");
         return false;
     }
 
@@ -62,8 +66,8 @@ b8 material_system_initialize(u64* memory_requirement, void* state, material_sys
     // Hashtable block is after array.
     void* hashtable_block = array_block + array_requirement;
 
-    // Create a hashtable for material lookups.
-    hashtable_create(sizeof(material_reference), config.max_material_count, hashtable_block, false, &state_ptr->registered_material_table);
+    // Create a hashtable for material lookups. Names ignore case, as the default material's does.
+    hashtable_create_ignore_case(sizeof(material_reference), config.max_material_count, hashtable_block, false, &state_ptr->registered_material_table);
 
     // Fill the hashtable with invalid references to use as a default.
     material_reference invalid_ref;
@@ -81,16 +85,21 @@ b8 material_system_initialize(u64* memory_requirement, void* state, material_sys
     }
 
     if (!create_default_material(state_ptr)) {
-        KFATAL("Failed to create default material. Application cannot continue.");
+        KFATAL_CH(MATERIAL, "Failed to create default material. Application cannot continue.");
         return false;
     }
 
+    // Only fired while the vfs watches for changes.
+    event_register(EVENT_CODE_ASSET_CHANGED, state_ptr, material_system_on_asset_changed);
+
     return true;
 }
 
 void material_system_shutdown(void* state) {
     material_system_state* s = (material_system_state*)state;
     if (s) {
+        event_unregister(EVENT_CODE_ASSET_CHANGED, s, material_system_on_asset_changed);
+
         // Invalidate all materials in the array.
         u32 count = s->config.max_material_count;
         for (u32 i = 0; i < count; ++i) {
@@ -110,17 +119,25 @@ material* material_system_acquire(const char* name) {
     // Load the given material configuration from disk.
     material_config config;
 
-    // Load file from disk
-    // TODO: Should be able to be located anywhere.
-    char* format_str = "assets/materials/%s.%s";
-    char full_file_path[512];
-
-    // TODO: try different extensions
-    string_format(full_file_path, format_str, name, "kmt");
-    if (!load_configuration_file(full_file_path, &config)) {
-        KERROR("Failed to load material file: '%s'. Null pointer will be returned.", full_file_path);
+    // Load file through the virtual filesystem.
+    char path_buffer[VFS_MAX_PATH_LENGTH];
+    kstring_builder full_file_path;
+    string_builder_create_from_buffer(path_buffer, sizeof(path_buffer), 0, &full_file_path);
+    string_builder_appendf(&full_file_path, "materials/%s.", name);
+    u64 extension_start = full_file_path.length;
+
+    // Compiled materials are preferred, falling back to the text they are compiled from.
+    string_builder_append(&full_file_path, MATERIAL_BINARY_EXTENSION);
+    if (!vfs_exists(full_file_path.data)) {
+        string_builder_truncate(&full_file_path, extension_start);
+        string_builder_append(&full_file_path, MATERIAL_TEXT_EXTENSION);
+    }
+    if (!load_configuration_file(full_file_path.data, &config)) {
+        KERROR_CH(MATERIAL, "Failed to load material file: '%s'. Null pointer will be returned.", full_file_path.data);
+        string_builder_destroy(&full_file_path);
         return 0;
     }
+    string_builder_destroy(&full_file_path);
 
     // Now acquire from loaded config.
     return material_system_acquire_from_config(config);
@@ -154,13 +171,13 @@ material* material_system_acquire_from_config(material_config config) {
 
             // Make sure an empty slot was actually found.
             if (!m || ref.handle == INVALID_ID) {
-                KFATAL("material_system_acquire - Material system cannot hold anymore materials. Adjust configuration to allow more.");
+                KFATAL_CH(MATERIAL, "material_system_acquire - Material system cannot hold anymore materials. Adjust configuration to allow more.");
                 return 0;
             }
 
             // Create new material.
             if (!load_material(config, m)) {
-                KERROR("Failed to load material '%s'.", config.name);
+                KERROR_CH(MATERIAL, "Failed to load material '%s'.", config.name);
                 return 0;
             }
 
@@ -172,9 +189,9 @@ material* material_system_acquire_from_config(material_config config) {
 
             // Also use the handle as the material id.
             m->id = ref.handle;
-            KTRACE("Material '%s' does not yet exist. Created, and ref_count is now %i.", config.name, ref.reference_count);
+            KTRACE_CH(MATERIAL, "Material '%s' does not yet exist. Created, and ref_count is now %i.", config.name, ref.reference_count);
         } else {
-            KTRACE("Material '%s' already exists, ref_count increased to %i.", config.name, ref.reference_count);
+            KTRACE_CH(MATERIAL, "Material '%s' already exists, ref_count increased to %i.", config.name, ref.reference_count);
         }
 
         // Update the entry.
@@ -183,7 +200,7 @@ material* material_system_acquire_from_config(material_config config) {
     }
 
     // NOTE: This would only happen in the event something went wrong with the state.
-    KERROR("material_system_acquire_from_config failed to acquire material '%s'. Null pointer will be returned.", config.name);
+    KERROR_CH(MATERIAL, "material_system_acquire_from_config failed to acquire material '%s'. Null pointer will be returned.", config.name);
     return 0;
 }
 
@@ -195,7 +212,7 @@ void material_system_release(const char* name) {
     material_reference ref;
     if (state_ptr && hashtable_get(&state_ptr->registered_material_table, name, &ref)) {
         if (ref.reference_count == 0) {
-            KWARN("Tried to release non-existent material: '%s'", name);
+            KWARN_CH(MATERIAL, "Tried to release non-existent material: '%s'", name);
             return;
         }
         ref.reference_count--;
@@ -208,15 +225,15 @@ void material_system_release(const char* name) {
             // Reset the reference.
             ref.handle = INVALID_ID;
             ref.auto_release = false;
-            KTRACE("Released material '%s'., Material unloaded because reference count=0 and auto_release=true.", name);
+            KTRACE_CH(MATERIAL, "Released material '%s'., Material unloaded because reference count=0 and auto_release=true.", name);
         } else {
-            KTRACE("Released material '%s', now has a reference count of '%i' (auto_release=%s).", name, ref.reference_count, ref.auto_release ? "true" : "false");
+            KTRACE_CH(MATERIAL, "Released material '%s', now has a reference count of '%i' (auto_release=%s).", name, ref.reference_count, ref.auto_release ? "true" : "false");
         }
 
         // Update the entry.
         hashtable_set(&state_ptr->registered_material_table, name, &ref);
     } else {
-        KERROR("material_system_release failed to release material '%s'.", name);
+        KERROR_CH(MATERIAL, "material_system_release failed to release material '%s'.", name);
     }
 }
 
@@ -234,7 +251,7 @@ b8 load_material(material_config config, material* m) {
         m->diffuse_map.use = TEXTURE_USE_MAP_DIFFUSE;
         m->diffuse_map.texture = texture_system_acquire(config.diffuse_map_name, true);
         if (!m->diffuse_map.texture) {
-            KWARN("Unable to load texture '%s' for material '%s', using default.", config.diffuse_map_name, m->name);
+            KWARN_CH(MATERIAL, "Unable to load texture '%s' for material '%s', using default.", config.diffuse_map_name, m->name);
             m->diffuse_map.texture = texture_system_get_default_texture();
         }
     } else {
@@ -247,7 +264,7 @@ b8 load_material(material_config config, material* m) {
 
     // Send it off to the renderer to acquire resources.
     if (!renderer_create_material(m)) {
-        KERROR("Failed to acquire renderer resources for material '%s'.", m->name);
+        KERROR_CH(MATERIAL, "Failed to acquire renderer resources for material '%s'.", m->name);
         return false;
     }
 
@@ -255,7 +272,7 @@ b8 load_material(material_config config, material* m) {
 }
 
 void destroy_material(material* m) {
-    KTRACE("Destroying material '%s'...", m->name);
+    KTRACE_CH(MATERIAL, "Destroying material '%s'...", m->name);
 
     // Release texture references.
     if (m->diffuse_map.texture) {
@@ -282,7 +299,7 @@ b8 create_default_material(material_system_state* state) {
     state->default_material.diffuse_map.texture = texture_system_get_default_texture();
 
     if (!renderer_create_material(&state->default_material)) {
-        KFATAL("Failed to acquire renderer resources for default texture. Application cannot continue.");
+        KFATAL_CH(MATERIAL, "Failed to acquire renderer resources for default texture. Application cannot continue.");
         return false;
     }
 
@@ -290,73 +307,79 @@ b8 create_default_material(material_system_state* state) {
 }
 
 b8 load_configuration_file(const char* path, material_config* out_config) {
-    file_handle f;
-    if (!filesystem_open(path, FILE_MODE_READ, false, &f)) {
-        KERROR("load_configuration_file - unable to open material file for reading: '%s'.", path);
+    file_mapping file;
+    if (!vfs_map(path, FILE_ACCESS_HINT_SEQUENTIAL, &file)) {
+        KERROR_CH(MATERIAL, "load_configuration_file - unable to open material file for reading: '%s'.", path);
         return false;
     }
 
-    // Read each line of the file.
-    char line_buf[512] = "";
-    char* p = &line_buf[0];
-    u64 line_length = 0;
-    u32 line_number = 1;
-    while (filesystem_read_line(&f, 511, &p, &line_length)) {
-        // Trim the string.
-        char* trimmed = string_trim(line_buf);
-
-        // Get the trimmed length.
-        line_length = string_length(trimmed);
-
-        // Skip blank lines and comments.
-        if (line_length < 1 || trimmed[0] == '#') {
-            line_number++;
-            continue;
-        }
-
-        // Split into var/value
-        i32 equal_index = string_index_of(trimmed, '=');
-        if (equal_index == -1) {
-            KWARN("Potential formatting issue found in file '%s': '=' token not found. Skipping line %ui.", path, line_number);
-            line_number++;
-            continue;
-        }
+    // Binary materials are used as mapped; text ones are parsed line by line.
+    u64 length = string_length(path);
+    u64 extension_length = string_length(MATERIAL_BINARY_EXTENSION);
+    b8 binary = length > extension_length && strings_equal(path + length - extension_length, MATERIAL_BINARY_EXTENSION);
+    b8 result = binary ? material_file_parse_binary(file.data, file.size, path, out_config)
+                       : material_file_parse_text(file.data, file.size, path, out_config);
 
-        // Assume a max of 64 characters for the variable name.
-        char raw_var_name[64];
-        kzero_memory(raw_var_name, sizeof(char) * 64);
-        string_mid(raw_var_name, trimmed, 0, equal_index);
-        char* trimmed_var_name = string_trim(raw_var_name);
-
-        // Assume a max of 511-65 (446) for the max length of the value to account for the variable name and the '='.
-        char raw_value[446];
-        kzero_memory(raw_value, sizeof(char) * 446);
-        string_mid(raw_value, trimmed, equal_index + 1, -1);  // Read the rest of the line
-        char* trimmed_value = string_trim(raw_value);
-
-        // Process the variable.
-        if (strings_equali(trimmed_var_name, "version")) {
-            // TODO: version
-        } else if (strings_equali(trimmed_var_name, "name")) {
-            string_ncopy(out_config->name, trimmed_value, MATERIAL_NAME_MAX_LENGTH);
-        } else if (strings_equali(trimmed_var_name, "diffuse_map_name")) {
-            string_ncopy(out_config->diffuse_map_name, trimmed_value, TEXTURE_NAME_MAX_LENGTH);
-        } else if (strings_equali(trimmed_var_name, "diffuse_colour")) {
-            // Parse the colour
-            if (!string_to_vec4(trimmed_value, &out_config->diffuse_colour)) {
-                KWARN("Error parsing diffuse_colour in file '%s'. Using default of white instead.", path);
-                out_config->diffuse_colour = vec4_one();  // white
-            }
-        }
+    vfs_unmap(&file);
+    return result;
+}
 
-        // TODO: more fields.
+b8 material_system_on_asset_changed(u16 code, void* sender, void* listener_inst, event_context context) {
+    const char* path = (const char*)context.data.u64[0];
+    const char* prefix = "materials/";
+    // Either form; whichever was saved is read.
+    const char* extension = "." MATERIAL_TEXT_EXTENSION;
+    const char* binary_extension = "." MATERIAL_BINARY_EXTENSION;
+    u64 prefix_length = string_length(prefix);
+    u64 extension_length = string_length(extension);
+    u64 length = string_length(path);
+    if (length <= prefix_length + extension_length ||
+        (!strings_equal(path + length - extension_length, extension) && !strings_equal(path + length - extension_length, binary_extension))) {
+        return false;
+    }
+    char directory[16];
+    string_ncopy(directory, path, prefix_length);
+    directory[prefix_length] = 0;
+    if (!strings_equal(directory, prefix)) {
+        return false;
+    }
 
-        // Clear the line buffer.
-        kzero_memory(line_buf, sizeof(char) * 512);
-        line_number++;
+    material_config config;
+    if (!load_configuration_file(path, &config)) {
+        KERROR_CH(MATERIAL, "Failed to reload material file '%s'. The previous version will be kept.", path);
+        return true;
     }
+    material_reference ref;
+    if (!hashtable_get(&state_ptr->registered_material_table, config.name, &ref) || ref.handle == INVALID_ID) {
+        // Not in use, so it will be read as it is now when it is.
+        return true;
+    }
+    material* m = &state_ptr->registered_materials[ref.handle];
 
-    filesystem_close(&f);
+    // Updated in place rather than destroyed, so anything holding the material keeps a valid pointer.
+    m->diffuse_colour = config.diffuse_colour;
+    const char* old_map_name = m->diffuse_map.texture ? m->diffuse_map.texture->name : "";
+    if (!strings_equal(old_map_name, config.diffuse_map_name)) {
+        // Acquired before the old one is released, so a texture shared by both is not unloaded in between.
+        texture* old_texture = m->diffuse_map.texture;
+        if (string_length(config.diffuse_map_name) > 0) {
+            m->diffuse_map.use = TEXTURE_USE_MAP_DIFFUSE;
+            m->diffuse_map.texture = texture_system_acquire(config.diffuse_map_name, true);
+            if (!m->diffuse_map.texture) {
+                KWARN_CH(MATERIAL, "Unable to load texture '%s' for material '%s', using default.", config.diffuse_map_name, m->name);
+                m->diffuse_map.texture = texture_system_get_default_texture();
+            }
+        } else {
+            m->diffuse_map.use = TEXTURE_USE_UNKNOWN;
+            m->diffuse_map.texture = 0;
+        }
+        if (old_texture) {
+            texture_system_release(old_texture->name);
+        }
+    }
 
+    // Has the renderer rewrite the material's uniforms and descriptors.
+    m->generation++;
+    KINFO_CH(MATERIAL, "Reloaded material '%s'.", m->name);
     return true;
-}
\ No newline at end of file
+}
@@ -0,0 +1,345 @@
+#include "task_graph.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/profiler.h"
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "platform/katomic.h"
+#include "systems/job_system.h"
+
+// Index of the lowest set bit. The mask must not be 0.
+KINLINE u32 lowest_bit(u64 mask) {
+    return (u32)__builtin_ctzll(mask);
+}
+
+KINLINE u32 bit_count(u64 mask) {
+    return (u32)__builtin_popcountll(mask);
+}
+
+static b8 same_resource(const char* a, const char* b) {
+    return a == b || strings_equal(a, b);
+}
+
+static b8 valid_task(task_graph* graph, task_id id, const char* function) {
+    if (id >= graph->task_count) {
+        if (id != INVALID_ID) {
+            KERROR("%s - Invalid task id %u.", function, id);
+            graph->invalid = true;
+        }
+        // Otherwise the graph was already marked invalid when the task failed to be added.
+        return false;
+    }
+    return true;
+}
+
+static void add_access(task_graph* graph, task_id id, const char* resource, b8 write, const char* function) {
+    if (!valid_task(graph, id, function) || !resource) {
+        return;
+    }
+
+    task* t = &graph->tasks[id];
+    for (u32 i = 0; i < t->access_count; ++i) {
+        if (same_resource(t->accesses[i].resource, resource)) {
+            t->accesses[i].write |= write;
+            return;
+        }
+    }
+
+    if (t->access_count >= TASK_GRAPH_MAX_ACCESSES) {
+        KERROR("%s - Task '%s' uses too many resources. Increase TASK_GRAPH_MAX_ACCESSES.", function, t->name);
+        graph->invalid = true;
+        return;
+    }
+    t->accesses[t->access_count].resource = resource;
+    t->accesses[t->access_count].write = write;
+    t->access_count++;
+}
+
+void task_graph_reset(task_graph* graph) {
+    graph->task_count = 0;
+    graph->invalid = false;
+}
+
+task_id task_graph_add(task_graph* graph, const char* name, pfn_task_run run, void* params, task_flags flags) {
+    if (graph->task_count >= TASK_GRAPH_MAX_TASKS) {
+        KERROR("task_graph_add - Graph is full; '%s' was not added.", name);
+        graph->invalid = true;
+        return INVALID_ID;
+    }
+
+    task_id id = graph->task_count++;
+    task* t = &graph->tasks[id];
+    kzero_memory(t, sizeof(task));
+    t->name = name;
+    t->run = run;
+    t->params = params;
+    t->flags = flags;
+    t->graph = graph;
+    t->id = id;
+    return id;
+}
+
+void task_graph_reads(task_graph* graph, task_id id, const char* resource) {
+    add_access(graph, id, resource, false, "task_graph_reads");
+}
+
+void task_graph_writes(task_graph* graph, task_id id, const char* resource) {
+    add_access(graph, id, resource, true, "task_graph_writes");
+}
+
+void task_graph_depends_on(task_graph* graph, task_id id, task_id dependency) {
+    if (!valid_task(graph, id, "task_graph_depends_on") || !valid_task(graph, dependency, "task_graph_depends_on")) {
+        return;
+    }
+    if (dependency >= id) {
+        // Keeps the graph acyclic, and the task order a valid order to run them in.
+        KERROR("task_graph_depends_on - '%s' must be added before '%s', which depends on it.", graph->tasks[dependency].name, graph->tasks[id].name);
+        graph->invalid = true;
+        return;
+    }
+    graph->tasks[id].dependencies |= 1ULL << dependency;
+}
+
+// Adds the dependencies of a task on those added before it which use the same resources.
+static void resolve_accesses(task_graph* graph, task_id id) {
+    task* t = &graph->tasks[id];
+    for (u32 a = 0; a < t->access_count; ++a) {
+        const task_access* access = &t->accesses[a];
+        // Walk back to the previous writer, picking up readers on the way if this one writes.
+        for (u32 j = id; j-- > 0;) {
+            const task_access* other = 0;
+            for (u32 b = 0; b < graph->tasks[j].access_count; ++b) {
+                if (same_resource(graph->tasks[j].accesses[b].resource, access->resource)) {
+                    other = &graph->tasks[j].accesses[b];
+                    break;
+                }
+            }
+            if (!other) {
+                continue;
+            }
+            if (other->write || access->write) {
+                t->dependencies |= 1ULL << j;
+            }
+            if (other->write) {
+                break;
+            }
+        }
+    }
+}
+
+static void task_ready(task_graph* graph, task_id id);
+
+static void run_task(task_graph* graph, task_id id) {
+    task* t = &graph->tasks[id];
+    t->start_time = platform_get_absolute_time() - graph->execute_start_time;
+
+    // Skipped if anything it depends on did not succeed. Those all finished before this became ready.
+    b8 skip = false;
+    for (u64 mask = t->dependencies; mask; mask &= mask - 1) {
+        if (!graph->tasks[lowest_bit(mask)].succeeded) {
+            skip = true;
+            break;
+        }
+    }
+
+    if (skip) {
+        t->succeeded = false;
+    } else {
+        KPROFILE_ZONE_BEGIN(t->name);
+        t->succeeded = t->run(t->params);
+        KPROFILE_ZONE_END();
+        if (!t->succeeded) {
+            KERROR("Task '%s' failed. Tasks which depend on it will be skipped.", t->name);
+        }
+    }
+    t->end_time = platform_get_absolute_time() - graph->execute_start_time;
+
+    for (u64 mask = graph->dependents[id]; mask; mask &= mask - 1) {
+        u32 dependent = lowest_bit(mask);
+        // The last dependency to finish makes it ready, and releases everything before it.
+        if (katomic_fetch_sub_u32(&graph->pending[dependent], 1, KATOMIC_ACQ_REL) == 1) {
+            task_ready(graph, dependent);
+        }
+    }
+    katomic_fetch_sub_u32(&graph->remaining, 1, KATOMIC_RELEASE);
+}
+
+static void task_job(void* params) {
+    task* t = params;
+    run_task(t->graph, t->id);
+}
+
+static void task_ready(task_graph* graph, task_id id) {
+    task* t = &graph->tasks[id];
+    if (t->flags & TASK_FLAG_MAIN_THREAD) {
+        // Picked up by the thread executing the graph.
+        katomic_fetch_or_u64(&graph->main_ready, 1ULL << id, KATOMIC_RELEASE);
+        return;
+    }
+
+    job_info job;
+    job.entry_point = task_job;
+    job.params = t;
+    job.priority = JOB_PRIORITY_HIGH;
+    job_system_submit(&job, 1, 0);
+}
+
+b8 task_graph_execute(task_graph* graph) {
+    if (graph->invalid) {
+        KERROR("task_graph_execute - The graph is invalid and will not be run. See earlier errors.");
+        return false;
+    }
+    if (graph->task_count == 0) {
+        return true;
+    }
+
+    KPROFILE_ZONE_BEGIN("task graph");
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        graph->dependents[i] = 0;
+    }
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        resolve_accesses(graph, i);
+        for (u64 mask = graph->tasks[i].dependencies; mask; mask &= mask - 1) {
+            graph->dependents[lowest_bit(mask)] |= 1ULL << i;
+        }
+        graph->pending[i] = bit_count(graph->tasks[i].dependencies);
+        graph->tasks[i].succeeded = false;
+    }
+    graph->main_ready = 0;
+    graph->remaining = graph->task_count;
+    graph->execute_start_time = platform_get_absolute_time();
+    // Publishes the state above to the workers, before any task is submitted.
+    katomic_fence(KATOMIC_RELEASE);
+
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        if (graph->tasks[i].dependencies == 0) {
+            task_ready(graph, i);
+        }
+    }
+
+    while (katomic_load_u32(&graph->remaining, KATOMIC_ACQUIRE) > 0) {
+        u64 ready = katomic_exchange_u64(&graph->main_ready, 0, KATOMIC_ACQUIRE);
+        if (ready) {
+            for (; ready; ready &= ready - 1) {
+                run_task(graph, lowest_bit(ready));
+            }
+        } else if (!job_system_help()) {
+            // The rest are running elsewhere.
+            platform_sleep(0);
+        }
+    }
+
+    graph->execute_time = platform_get_absolute_time() - graph->execute_start_time;
+    KPROFILE_ZONE_END();
+
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        if (!graph->tasks[i].succeeded) {
+            return false;
+        }
+    }
+    return true;
+}
+
+f64 task_graph_critical_path(const task_graph* graph, task_id* out_tasks, u32* out_count) {
+    *out_count = 0;
+    if (graph->task_count == 0) {
+        return 0;
+    }
+
+    // Tasks only depend on those added before them, so one pass in order is enough.
+    f64 path_time[TASK_GRAPH_MAX_TASKS];
+    task_id previous[TASK_GRAPH_MAX_TASKS];
+    task_id last = 0;
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        const task* t = &graph->tasks[i];
+        f64 longest = 0;
+        previous[i] = INVALID_ID;
+        for (u64 mask = t->dependencies; mask; mask &= mask - 1) {
+            u32 dependency = lowest_bit(mask);
+            if (previous[i] == INVALID_ID || path_time[dependency] > longest) {
+                longest = path_time[dependency];
+                previous[i] = dependency;
+            }
+        }
+        path_time[i] = longest + (t->end_time - t->start_time);
+        if (path_time[i] > path_time[last]) {
+            last = i;
+        }
+    }
+
+    // Walked back from the end, so fill the output from the back too.
+    u32 count = 0;
+    for (task_id i = last; i != INVALID_ID; i = previous[i]) {
+        count++;
+    }
+    *out_count = count;
+    if (out_tasks) {
+        u32 index = count;
+        for (task_id i = last; i != INVALID_ID; i = previous[i]) {
+            out_tasks[--index] = i;
+        }
+    }
+    return path_time[last];
+}
+
+b8 task_graph_dump(const task_graph* graph, const char* path) {
+    task_id critical[TASK_GRAPH_MAX_TASKS];
+    u32 critical_count = 0;
+    f64 critical_time = task_graph_critical_path(graph, critical, &critical_count);
+    u64 on_path = 0;
+    for (u32 i = 0; i < critical_count; ++i) {
+        on_path |= 1ULL << critical[i];
+    }
+
+    file_handle handle;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &handle)) {
+        KERROR("task_graph_dump - Unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    char line[512];
+    filesystem_write_line(&handle, "digraph task_graph {");
+    filesystem_write_line(&handle, "    rankdir=LR;");
+    filesystem_write_line(&handle, "    node [shape=box, style=\"rounded,filled\", fillcolor=white, fontname=\"sans-serif\"];");
+    string_format(line, "    label=\"%u tasks in %.3f ms. Critical path %.3f ms. Red: critical path, blue: main thread, dashed: failed or skipped.\";",
+                  graph->task_count, graph->execute_time * 1000.0, critical_time * 1000.0);
+    filesystem_write_line(&handle, line);
+
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        const task* t = &graph->tasks[i];
+        b8 critical_task = (on_path & (1ULL << i)) != 0;
+        string_format(line, "    t%u [label=\"%.128s\\n%.3f ms (starts %.3f ms)\"%s%s%s];",
+                      i, t->name, (t->end_time - t->start_time) * 1000.0, t->start_time * 1000.0,
+                      critical_task ? ", color=red, penwidth=2" : "",
+                      (t->flags & TASK_FLAG_MAIN_THREAD) ? ", fillcolor=lightblue" : "",
+                      t->succeeded ? "" : ", style=\"rounded,filled,dashed\"");
+        filesystem_write_line(&handle, line);
+    }
+
+    for (u32 i = 0; i < graph->task_count; ++i) {
+        for (u64 mask = graph->tasks[i].dependencies; mask; mask &= mask - 1) {
+            u32 dependency = lowest_bit(mask);
+            b8 critical_edge = false;
+            for (u32 c = 1; c < critical_count; ++c) {
+                if (critical[c - 1] == dependency && critical[c] == i) {
+                    critical_edge = true;
+                }
+            }
+            string_format(line, "    t%u -> t%u%s;", dependency, i, critical_edge ? " [color=red, penwidth=2]" : "");
+            filesystem_write_line(&handle, line);
+        }
+    }
+    filesystem_write_line(&handle, "}");
+    filesystem_close(&handle);
+
+    // The path in the log too, as it is most of what the dump is for.
+    char* cursor = line;
+    line[0] = 0;
+    for (u32 i = 0; i < critical_count && cursor - line < 400; ++i) {
+        cursor += string_format(cursor, "%s%.48s", i > 0 ? " -> " : "", graph->tasks[critical[i]].name);
+    }
+    KINFO("Task graph written to '%s'. Critical path (%.3f ms of %.3f ms): %s", path, critical_time * 1000.0, graph->execute_time * 1000.0, line);
+    return true;
+}
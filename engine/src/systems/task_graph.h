@@ -0,0 +1,133 @@
+#pragma once
+
+#include "defines.h"
+
+// Most tasks a graph can hold. Tasks are tracked in 64 bit masks, so it cannot be raised past 64.
+#define TASK_GRAPH_MAX_TASKS 64
+// Most resources a single task can read or write.
+#define TASK_GRAPH_MAX_ACCESSES 8
+
+typedef u32 task_id;
+
+/**
+ * @brief The function a task runs.
+ *
+ * @param params The params the task was added with.
+ * @return b8 True on success. On failure, tasks which depend on it are skipped.
+ */
+typedef b8 (*pfn_task_run)(void* params);
+
+typedef enum task_flags {
+    TASK_FLAG_NONE = 0x0,
+    // Runs on the thread executing the graph, i.e. for the window and renderer backend.
+    TASK_FLAG_MAIN_THREAD = 0x1
+} task_flags;
+
+typedef struct task_access {
+    // Compared by pointer first, then by content.
+    const char* resource;
+    b8 write;
+} task_access;
+
+typedef struct task {
+    // Shown in the profiler and dumps. Must be a literal, or live as long as the graph.
+    const char* name;
+    pfn_task_run run;
+    void* params;
+    task_flags flags;
+
+    u32 access_count;
+    task_access accesses[TASK_GRAPH_MAX_ACCESSES];
+
+    // A bit per task this one runs after. Those from its accesses are added on execution.
+    u64 dependencies;
+
+    // Filled in by task_graph_execute.
+    struct task_graph* graph;
+    task_id id;
+    // False if the task failed, or was skipped as a task it depends on did.
+    b8 succeeded;
+    // Times relative to the start of the execution, in seconds.
+    f64 start_time;
+    f64 end_time;
+} task;
+
+/**
+ * A set of tasks and their dependencies, run across the job system. Dependencies come from
+ * the resources each task reads and writes, in the order tasks are added: a reader waits
+ * on the previous writer of a resource, a writer on the previous writer and every reader since.
+ * Tasks with nothing between them run in parallel. Rebuilt each frame with task_graph_reset.
+ */
+typedef struct task_graph {
+    u32 task_count;
+    task tasks[TASK_GRAPH_MAX_TASKS];
+    // Set when a task could not be added, so execute can report it.
+    b8 invalid;
+
+    // Execution state.
+    // A bit per task which runs after each task.
+    u64 dependents[TASK_GRAPH_MAX_TASKS];
+    // Number of dependencies each task is still waiting on.
+    volatile u32 pending[TASK_GRAPH_MAX_TASKS];
+    // Main thread tasks ready to run, as a bit each.
+    volatile u64 main_ready;
+    // Number of tasks which have not finished yet.
+    volatile u32 remaining;
+    f64 execute_start_time;
+    // How long the whole execution took, in seconds.
+    f64 execute_time;
+} task_graph;
+
+/** @brief Removes every task from the graph. */
+KAPI void task_graph_reset(task_graph* graph);
+
+/**
+ * @brief Adds a task to the graph.
+ *
+ * @param graph A pointer to the graph.
+ * @param name The name of the task. Must be a literal, or live as long as the graph.
+ * @param run The function the task runs.
+ * @param params Passed to run. Must stay valid until the graph has been executed.
+ * @param flags Flags for the task.
+ * @return The id of the task, or INVALID_ID if the graph is full.
+ */
+KAPI task_id task_graph_add(task_graph* graph, const char* name, pfn_task_run run, void* params, task_flags flags);
+
+/** @brief Declares that a task reads a resource, so it runs after the last task added before it which writes it. */
+KAPI void task_graph_reads(task_graph* graph, task_id id, const char* resource);
+
+/** @brief Declares that a task writes a resource, so it runs after every task added before it which uses it. */
+KAPI void task_graph_writes(task_graph* graph, task_id id, const char* resource);
+
+/** @brief Makes a task run after another added before it, for orderings no resource describes. */
+KAPI void task_graph_depends_on(task_graph* graph, task_id id, task_id dependency);
+
+/**
+ * @brief Runs every task and waits for them to finish. The calling thread runs the main
+ * thread tasks, and helps with the others while it waits. It must belong to the job system.
+ *
+ * @param graph A pointer to the graph.
+ * @return b8 True if every task succeeded; otherwise false.
+ */
+KAPI b8 task_graph_execute(task_graph* graph);
+
+/**
+ * @brief Gets the critical path of the last execution; the chain of dependent tasks
+ * which took the longest, and so bounds how fast the graph can run.
+ *
+ * @param graph A pointer to the executed graph.
+ * @param out_tasks An array of at least TASK_GRAPH_MAX_TASKS to hold the path, first task first. Optional.
+ * @param out_count A pointer to hold the number of tasks on the path.
+ * @return f64 The time spent in tasks on the path, in seconds.
+ */
+KAPI f64 task_graph_critical_path(const task_graph* graph, task_id* out_tasks, u32* out_count);
+
+/**
+ * @brief Writes the last execution as a Graphviz dot file, with each task's time and
+ * the critical path highlighted. Render it with i.e. "dot -Tsvg frame_graph.dot".
+ *
+ * @param graph A pointer to the executed graph.
+ * @param path The path of the file to write.
+ * @return b8 True on success; otherwise false.
+ */
+KAPI b8 task_graph_dump(const task_graph* graph, const char* path);
@@ -1,9 +1,15 @@
 #include "texture_system.h"
 
+#include "core/event.h"
 #include "core/logger.h"
 #include "core/kstring.h"
+#include "core/kstring_builder.h"
 #include "core/kmemory.h"
+#include "core/profiler.h"
 #include "containers/hashtable.h"
+#include "systems/async_io_system.h"
+#include "systems/cooked_cache_system.h"
+#include "systems/vfs_system.h"
 
 #include "renderer/renderer_frontend.h"
 
@@ -11,6 +17,28 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "vendor/stb_image.h"
 
+// The cooked cache's file extension for textures.
+#define COOKED_TEXTURE_TYPE "ktex"
+// "KTEX", as read from the start of a cooked texture.
+#define COOKED_TEXTURE_MAGIC 0x5845544B
+// Bump whenever decoding changes (i.e. flipping or channel count), so textures are cooked again.
+#define TEXTURE_COOKER_VERSION 1
+
+// A cooked texture; this header, followed by its pixels, ready to upload.
+typedef struct cooked_texture_header {
+    u32 magic;
+    u32 version;
+    u32 width;
+    u32 height;
+    u8 channel_count;
+    b8 has_transparency;
+    u16 reserved;
+    // Always 1 for now, as the renderer only uploads the full size level.
+    u32 mip_count;
+    // The size of the pixels, in bytes.
+    u64 pixel_size;
+} cooked_texture_header;
+
 typedef struct texture_system_state {
     texture_system_config config;
     texture default_texture;
@@ -33,11 +61,13 @@ static texture_system_state* state_ptr = 0;
 b8 create_default_textures(texture_system_state* state);
 void destroy_default_textures(texture_system_state* state);
 b8 load_texture(const char* texture_name, texture* t);
+b8 stream_texture(const char* texture_name, u32 handle);
 void destroy_texture(texture* t);
+b8 texture_system_on_asset_changed(u16 code, void* sender, void* listener_inst, event_context context);
 
 b8 texture_system_initialize(u64* memory_requirement, void* state, texture_system_config config) {
     if (config.max_texture_count == 0) {
-        KFATAL("texture_system_initialize - config.max_texture_count must be > 0.");
+        KFATAL_CH(TEXTURE, "texture_system_initialize - config.max_texture_count must be > 0.");
         return false;
     }
 
@@ -47,7 +77,7 @@ b8 texture_system_initialize(u64* memory_requirement, void* state, texture_syste
     u64 hashtable_requirement = sizeof(texture_reference) * config.max_texture_count;
     *memory_requirement = struct_requirement + array_requirement + hashtable_requirement;
 
-    KTRACE("Asking for %i bits of memory", *memory_requirement)
+    KTRACE_CH(TEXTURE, "Asking for %i bits of memory", *memory_requirement)
 
     if (!state) {
         return true;
@@ -63,8 +93,8 @@ b8 texture_system_initialize(u64* memory_requirement, void* state, texture_syste
     // Hashtable block is after array.
     void* hashtable_block = array_block + array_requirement;
 
-    // Create a hashtable for texture lookups.
-    hashtable_create(sizeof(texture_reference), config.max_texture_count, hashtable_block, false, &state_ptr->registered_texture_table);
+    // Create a hashtable for texture lookups. Names ignore case, as the default texture's does.
+    hashtable_create_ignore_case(sizeof(texture_reference), config.max_texture_count, hashtable_block, false, &state_ptr->registered_texture_table);
 
     // Fill the hashtable with invalid references to use as a default.
     texture_reference invalid_ref;
@@ -83,11 +113,16 @@ b8 texture_system_initialize(u64* memory_requirement, void* state, texture_syste
     // Create default textures for use in the system.
     create_default_textures(state_ptr);
 
+    // Only fired while the vfs watches for changes.
+    event_register(EVENT_CODE_ASSET_CHANGED, state_ptr, texture_system_on_asset_changed);
+
     return true;
 }
 
 void texture_system_shutdown(void* state) {
     if (state_ptr) {
+        event_unregister(EVENT_CODE_ASSET_CHANGED, state_ptr, texture_system_on_asset_changed);
+
         // Destroy all loaded textures.
         for (u32 i = 0; i < state_ptr->config.max_texture_count; ++i) {
             texture* t = &state_ptr->registered_textures[i];
@@ -103,9 +138,11 @@ void texture_system_shutdown(void* state) {
 }
 
 texture* texture_system_acquire(const char* name, b8 auto_release) {
+    KPROFILE_FUNCTION_BEGIN();
     // Return default texture, but warn about it since this should be returned via get_default_texture();
     if (strings_equali(name, DEFAULT_TEXTURE_NAME)) {
-        KWARN("texture_system_acquire called for default texture. Use texture_system_get_default_texture for texture 'default'.");
+        KWARN_CH(TEXTURE, "texture_system_acquire called for default texture. Use texture_system_get_default_texture for texture 'default'.");
+        KPROFILE_ZONE_END();
         return &state_ptr->default_texture;
     }
 
@@ -131,30 +168,47 @@ texture* texture_system_acquire(const char* name, b8 auto_release) {
 
             // Make sure an empty slot was actually found.
             if (!t || ref.handle == INVALID_ID) {
-                KFATAL("texture_system_acquire - Texture system cannot hold anymore textures. Adjust configuration to allow more.");
+                KFATAL_CH(TEXTURE, "texture_system_acquire - Texture system cannot hold anymore textures. Adjust configuration to allow more.");
+                KPROFILE_ZONE_END();
                 return 0;
             }
 
             // Create new texture.
-            if (!load_texture(name, t)) {
-                KERROR("Failed to load texture '%s'.", name);
+            if (state_ptr->config.stream_textures) {
+                // Claims the slot. Until its file is read and uploaded, the invalid generation
+                // has the renderer draw the default texture in its place.
+                kzero_memory(t, sizeof(texture));
+                string_ncopy(t->name, name, TEXTURE_NAME_MAX_LENGTH);
+                t->generation = INVALID_ID;
+                t->id = ref.handle;
+                if (!stream_texture(name, ref.handle)) {
+                    KERROR_CH(TEXTURE, "Failed to start loading texture '%s'.", name);
+                    t->id = INVALID_ID;
+                    KPROFILE_ZONE_END();
+                    return 0;
+                }
+            } else if (!load_texture(name, t)) {
+                KERROR_CH(TEXTURE, "Failed to load texture '%s'.", name);
+                KPROFILE_ZONE_END();
                 return 0;
             }
 
             // Also use the handle as the texture id.
             t->id = ref.handle;
-            KTRACE("Texture '%s' does not yet exist. Created, and ref_count is now %i.", name, ref.reference_count);
+            KTRACE_CH(TEXTURE, "Texture '%s' does not yet exist. Created, and ref_count is now %i.", name, ref.reference_count);
         } else {
-            KTRACE("Texture '%s' already exists, ref_count increased to %i.", name, ref.reference_count);
+            KTRACE_CH(TEXTURE, "Texture '%s' already exists, ref_count increased to %i.", name, ref.reference_count);
         }
 
         // Update the entry.
         hashtable_set(&state_ptr->registered_texture_table, name, &ref);
+        KPROFILE_ZONE_END();
         return &state_ptr->registered_textures[ref.handle];
     }
 
     // NOTE: This would only happen in the event something went wrong with the state.
-    KERROR("texture_system_acquire failed to acquire texture '%s'. Null pointer will be returned.", name);
+    KERROR_CH(TEXTURE, "texture_system_acquire failed to acquire texture '%s'. Null pointer will be returned.", name);
+    KPROFILE_ZONE_END();
     return 0;
 }
 
@@ -166,7 +220,7 @@ void texture_system_release(const char* name) {
     texture_reference ref;
     if (state_ptr && hashtable_get(&state_ptr->registered_texture_table, name, &ref)) {
         if (ref.reference_count == 0) {
-            KWARN("Tried to release non-existent texture: '%s'", name);
+            KWARN_CH(TEXTURE, "Tried to release non-existent texture: '%s'", name);
             return;
         }
 
@@ -185,15 +239,15 @@ void texture_system_release(const char* name) {
             // Reset the reference.
             ref.handle = INVALID_ID;
             ref.auto_release = false;
-            KTRACE("Released texture '%s'., Texture unloaded because reference count=0 and auto_release=true.", name_copy);
+            KTRACE_CH(TEXTURE, "Released texture '%s'., Texture unloaded because reference count=0 and auto_release=true.", name_copy);
         } else {
-            KTRACE("Released texture '%s', now has a reference count of '%i' (auto_release=%s).", name_copy, ref.reference_count, ref.auto_release ? "true" : "false");
+            KTRACE_CH(TEXTURE, "Released texture '%s', now has a reference count of '%i' (auto_release=%s).", name_copy, ref.reference_count, ref.auto_release ? "true" : "false");
         }
 
         // Update the entry.
         hashtable_set(&state_ptr->registered_texture_table, name_copy, &ref);
     } else {
-        KERROR("texture_system_release failed to release texture '%s'.", name);
+        KERROR_CH(TEXTURE, "texture_system_release failed to release texture '%s'.", name);
     }
 }
 
@@ -202,14 +256,14 @@ texture* texture_system_get_default_texture() {
         return &state_ptr->default_texture;
     }
 
-    KERROR("texture_system_get_default_texture called before texture system initialization! Null pointer returned.");
+    KERROR_CH(TEXTURE, "texture_system_get_default_texture called before texture system initialization! Null pointer returned.");
     return 0;
 }
 
 b8 create_default_textures(texture_system_state* state) {
     // NOTE: Create default texture, a 256x256 blue/white checkerboard pattern.
     // This is done in code to eliminate asset dependencies.
-    KTRACE("Creating default texture...");
+    KTRACE_CH(TEXTURE, "Creating default texture...");
     const u32 tex_dimension = 256;
     const u32 channels = 4;
     const u32 pixel_count = tex_dimension * tex_dimension;
@@ -254,33 +308,100 @@ void destroy_default_textures(texture_system_state* state) {
     }
 }
 
-b8 load_texture(const char* texture_name, texture* t) {
-    // TODO: Should be able to be located anywhere.
-    char* format_str = "assets/textures/%s.%s";
-    const i32 required_channel_count = 4;
-    stbi_set_flip_vertically_on_load(true);
-    char full_file_path[512];
-
+// The texture's path within the virtual filesystem.
+// Starts out_path in buffer, which holds any path the vfs accepts, and appends the texture's path to it.
+static void texture_file_path(const char* texture_name, char buffer[VFS_MAX_PATH_LENGTH], kstring_builder* out_path) {
+    string_builder_create_from_buffer(buffer, VFS_MAX_PATH_LENGTH, 0, out_path);
     // TODO: try different extensions
-    string_format(full_file_path, format_str, texture_name, "png");
+    string_builder_appendf(out_path, "textures/%s.%s", texture_name, "png");
+}
+
+// Uploads decoded pixels in place of t, bumping its generation.
+static void upload_texture(const char* texture_name, texture* t, const u8* pixels, u32 width, u32 height, u8 channel_count, b8 has_transparency) {
+    u32 current_generation = t->generation;
+    t->generation = INVALID_ID;
 
     // Use a temporary texture to load into.
     texture temp_texture;
+    kzero_memory(&temp_texture, sizeof(texture));
+    temp_texture.width = width;
+    temp_texture.height = height;
+    temp_texture.channel_count = channel_count;
+    // Take a copy of the name.
+    string_ncopy(temp_texture.name, texture_name, TEXTURE_NAME_MAX_LENGTH);
+    temp_texture.generation = INVALID_ID;
+    temp_texture.has_transparency = has_transparency;
 
-    u8* data = stbi_load(
-        full_file_path,
-        (i32*)&temp_texture.width,
-        (i32*)&temp_texture.height,
-        (i32*)&temp_texture.channel_count,
-        required_channel_count);
+    // Acquire internal texture resources and upload to GPU.
+    renderer_create_texture(pixels, &temp_texture);
 
-    temp_texture.channel_count = required_channel_count;
+    // Take a copy of the old texture.
+    texture old = *t;
 
-    if (data) {
-        u32 current_generation = t->generation;
-        t->generation = INVALID_ID;
+    // Assign the temp texture to the pointer.
+    *t = temp_texture;
+
+    // Destroy the old texture.
+    renderer_destroy_texture(&old);
+
+    if (current_generation == INVALID_ID) {
+        t->generation = 0;
+    } else {
+        t->generation = current_generation + 1;
+    }
+}
+
+// Uploads a cooked texture, if it is intact. Otherwise false, and it is cooked again.
+static b8 create_texture_from_cooked(const char* texture_name, texture* t, const file_mapping* cooked) {
+    if (cooked->size < sizeof(cooked_texture_header)) {
+        return false;
+    }
+    const cooked_texture_header* header = cooked->data;
+    u64 pixel_size = (u64)header->width * header->height * header->channel_count;
+    if (header->magic != COOKED_TEXTURE_MAGIC || header->version != TEXTURE_COOKER_VERSION || header->channel_count != 4 ||
+        header->pixel_size != pixel_size || cooked->size != sizeof(cooked_texture_header) + pixel_size) {
+        return false;
+    }
+    // Uploaded straight from the mapping; nothing is decoded or copied on this side.
+    upload_texture(texture_name, t, (const u8*)(header + 1), header->width, header->height, header->channel_count, header->has_transparency);
+    return true;
+}
+
+// Decodes a texture file (or maps it cooked, if it has been before) and uploads it in place of t.
+static b8 create_texture_from_file(const char* texture_name, texture* t, const void* file_data, u64 file_size, const char* full_file_path) {
+    // Hashing is much cheaper than decoding, so the cache is checked every time.
+    u64 key = cooked_cache_key(file_data, file_size, TEXTURE_COOKER_VERSION);
+    file_mapping cooked;
+    if (cooked_cache_map(COOKED_TEXTURE_TYPE, key, &cooked)) {
+        KPROFILE_ZONE_BEGIN("cooked texture upload");
+        b8 uploaded = create_texture_from_cooked(texture_name, t, &cooked);
+        KPROFILE_ZONE_END();
+        filesystem_unmap(&cooked);
+        if (uploaded) {
+            return true;
+        }
+        KWARN_CH(TEXTURE, "Cooked copy of '%s' is invalid; decoding it again.", full_file_path);
+    }
+
+    const i32 required_channel_count = 4;
+    stbi_set_flip_vertically_on_load(true);
+
+    i32 width;
+    i32 height;
+    i32 channel_count;
+
+    KPROFILE_ZONE_BEGIN("stbi_load");
+    u8* data = stbi_load_from_memory(
+        file_data,
+        (i32)file_size,
+        &width,
+        &height,
+        &channel_count,
+        required_channel_count);
+    KPROFILE_ZONE_END();
 
-        u64 total_size = temp_texture.width * temp_texture.height * required_channel_count;
+    if (data) {
+        u64 total_size = (u64)width * height * required_channel_count;
         // Check for transparency
         b32 has_transparency = false;
         for (u64 i = 0; i < total_size; i += required_channel_count) {
@@ -292,41 +413,34 @@ b8 load_texture(const char* texture_name, texture* t) {
         }
 
         if (stbi_failure_reason()) {
-            KWARN("load_texture() failed to load file '%s': %s", full_file_path, stbi_failure_reason());
+            KWARN_CH(TEXTURE, "load_texture() failed to load file '%s': %s", full_file_path, stbi_failure_reason());
             // Clear the error so the next load doesn't fail.
             stbi__err(0, 0);
+            stbi_image_free(data);
             return false;
         }
 
-        // Take a copy of the name.
-        string_ncopy(temp_texture.name, texture_name, TEXTURE_NAME_MAX_LENGTH);
-        temp_texture.generation = INVALID_ID;
-        temp_texture.has_transparency = has_transparency;
-
-        // Acquire internal texture resources and upload to GPU.
-        renderer_create_texture(data, &temp_texture);
-
-        // Take a copy of the old texture.
-        texture old = *t;
-
-        // Assign the temp texture to the pointer.
-        *t = temp_texture;
-
-        // Destroy the old texture.
-        renderer_destroy_texture(&old);
-
-        if (current_generation == INVALID_ID) {
-            t->generation = 0;
-        } else {
-            t->generation = current_generation + 1;
-        }
+        upload_texture(texture_name, t, data, (u32)width, (u32)height, required_channel_count, has_transparency);
+
+        // Cooked for next time. Failing to is not an error; it is just decoded again.
+        cooked_texture_header header;
+        kzero_memory(&header, sizeof(header));
+        header.magic = COOKED_TEXTURE_MAGIC;
+        header.version = TEXTURE_COOKER_VERSION;
+        header.width = (u32)width;
+        header.height = (u32)height;
+        header.channel_count = required_channel_count;
+        header.has_transparency = has_transparency;
+        header.mip_count = 1;
+        header.pixel_size = total_size;
+        cooked_cache_store(COOKED_TEXTURE_TYPE, key, &header, sizeof(header), data, total_size);
 
         // Clean up data.
         stbi_image_free(data);
         return true;
     } else {
         if (stbi_failure_reason()) {
-            KWARN("load_texture() failed to load file '%s': %s", full_file_path, stbi_failure_reason());
+            KWARN_CH(TEXTURE, "load_texture() failed to load file '%s': %s", full_file_path, stbi_failure_reason());
             // Clear the error so the next load doesn't fail.
             stbi__err(0, 0);
         }
@@ -334,6 +448,108 @@ b8 load_texture(const char* texture_name, texture* t) {
     }
 }
 
+b8 load_texture(const char* texture_name, texture* t) {
+    KPROFILE_FUNCTION_BEGIN();
+    char path_buffer[VFS_MAX_PATH_LENGTH];
+    kstring_builder full_file_path;
+    texture_file_path(texture_name, path_buffer, &full_file_path);
+
+    // Decoded straight from the page cache, rather than through stdio's buffers.
+    file_mapping mapping;
+    if (!vfs_map(full_file_path.data, FILE_ACCESS_HINT_SEQUENTIAL, &mapping)) {
+        KWARN_CH(TEXTURE, "load_texture() failed to open file '%s'.", full_file_path.data);
+        string_builder_destroy(&full_file_path);
+        KPROFILE_ZONE_END();
+        return false;
+    }
+
+    b8 result = create_texture_from_file(texture_name, t, mapping.data, mapping.size, full_file_path.data);
+    vfs_unmap(&mapping);
+    string_builder_destroy(&full_file_path);
+    KPROFILE_ZONE_END();
+    return result;
+}
+
+// Creates texture handle from its file once read, which is expected to be at expected_path.
+static void create_texture_from_read(const async_read_result* result, u32 handle, texture* t, const char* expected_path) {
+    // The texture may have been released (and its slot reused) while its file was read.
+    vfs_location expected;
+    if (t->id != handle || t->generation != INVALID_ID || !vfs_locate(expected_path, &expected) ||
+        !strings_equal(expected.file_path, result->path) || expected.offset != result->offset) {
+        KTRACE_CH(TEXTURE, "Dropping read of '%s'; its texture is gone or already loaded.", result->path);
+        return;
+    }
+    if (!result->succeeded) {
+        KERROR_CH(TEXTURE, "Failed to read texture file '%s'. The default texture will be used.", expected_path);
+        return;
+    }
+
+    const void* file_data = result->data;
+    u64 file_size = result->size;
+    void* decompressed = 0;
+    if (expected.compressed) {
+        decompressed = kallocate(expected.uncompressed_size, MEMORY_TAG_TEXTURE);
+        if (!vfs_decompress(result->data, result->size, decompressed, expected.uncompressed_size)) {
+            KERROR_CH(TEXTURE, "Texture file '%s' is corrupt. The default texture will be used.", expected_path);
+            kfree(decompressed, expected.uncompressed_size, MEMORY_TAG_TEXTURE);
+            return;
+        }
+        file_data = decompressed;
+        file_size = expected.uncompressed_size;
+    }
+
+    KPROFILE_ZONE_BEGIN("texture upload");
+    // A copy, as the texture (name included) is replaced on success.
+    char name[TEXTURE_NAME_MAX_LENGTH];
+    string_ncopy(name, t->name, TEXTURE_NAME_MAX_LENGTH);
+    if (create_texture_from_file(name, t, file_data, file_size, expected_path)) {
+        t->id = handle;
+    } else {
+        KERROR_CH(TEXTURE, "Failed to load texture '%s'. The default texture will be used.", name);
+    }
+    KPROFILE_ZONE_END();
+
+    if (decompressed) {
+        kfree(decompressed, expected.uncompressed_size, MEMORY_TAG_TEXTURE);
+    }
+}
+
+static void on_texture_read(const async_read_result* result) {
+    if (!state_ptr) {
+        return;
+    }
+    u32 handle = (u32)(u64)result->user_data;
+    texture* t = &state_ptr->registered_textures[handle];
+
+    char path_buffer[VFS_MAX_PATH_LENGTH];
+    kstring_builder expected_path;
+    texture_file_path(t->name, path_buffer, &expected_path);
+    create_texture_from_read(result, handle, t, expected_path.data);
+    string_builder_destroy(&expected_path);
+}
+
+b8 stream_texture(const char* texture_name, u32 handle) {
+    char path_buffer[VFS_MAX_PATH_LENGTH];
+    kstring_builder full_file_path;
+    texture_file_path(texture_name, path_buffer, &full_file_path);
+    // Read from within the pack where the texture is packed.
+    vfs_location location;
+    if (!vfs_locate(full_file_path.data, &location)) {
+        KWARN_CH(TEXTURE, "stream_texture() failed to find file '%s'.", full_file_path.data);
+        string_builder_destroy(&full_file_path);
+        return false;
+    }
+    string_builder_destroy(&full_file_path);
+
+    async_read_request request = {};
+    request.path = location.file_path;
+    request.offset = location.offset;
+    request.size = location.size;
+    request.callback = on_texture_read;
+    request.user_data = (void*)(u64)handle;
+    return async_io_submit(&request, 1, 0);
+}
+
 void destroy_texture(texture* t) {
     // Clean up backend resources.
     renderer_destroy_texture(t);
@@ -342,4 +558,50 @@ void destroy_texture(texture* t) {
     kzero_memory(t, sizeof(texture));
     t->id = INVALID_ID;
     t->generation = INVALID_ID;
-}
\ No newline at end of file
+}
+
+b8 texture_system_on_asset_changed(u16 code, void* sender, void* listener_inst, event_context context) {
+    const char* path = (const char*)context.data.u64[0];
+    // The reverse of texture_file_path.
+    const char* prefix = "textures/";
+    const char* extension = ".png";
+    u64 prefix_length = string_length(prefix);
+    u64 extension_length = string_length(extension);
+    u64 length = string_length(path);
+    if (length <= prefix_length + extension_length || length - prefix_length - extension_length >= TEXTURE_NAME_MAX_LENGTH ||
+        !strings_equal(path + length - extension_length, extension)) {
+        return false;
+    }
+    char directory[16];
+    string_ncopy(directory, path, prefix_length);
+    directory[prefix_length] = 0;
+    if (!strings_equal(directory, prefix)) {
+        return false;
+    }
+    char name[TEXTURE_NAME_MAX_LENGTH];
+    u64 name_length = length - prefix_length - extension_length;
+    string_ncopy(name, path + prefix_length, name_length);
+    name[name_length] = 0;
+
+    texture_reference ref;
+    if (!hashtable_get(&state_ptr->registered_texture_table, name, &ref) || ref.handle == INVALID_ID) {
+        // Not in use, so it will be read as it is now when it is.
+        return true;
+    }
+    texture* t = &state_ptr->registered_textures[ref.handle];
+    if (t->generation == INVALID_ID) {
+        // Still streaming in, and its file may have been read before it changed.
+        KWARN_CH(TEXTURE, "Texture '%s' changed while loading and may be out of date.", name);
+        return true;
+    }
+
+    // Replaced in place, so the bumped generation has materials using it rewrite their descriptors.
+    // Blocks the frame, which is fine for an edit.
+    if (load_texture(name, t)) {
+        KINFO_CH(TEXTURE, "Reloaded texture '%s'.", name);
+    } else {
+        KERROR_CH(TEXTURE, "Failed to reload texture '%s'. The previous version will be kept.", name);
+    }
+    t->id = ref.handle;
+    return true;
+}
@@ -4,6 +4,9 @@
 
 typedef struct texture_system_config {
     u32 max_texture_count;
+    // Reads texture files through the async IO system, which must be running. Textures
+    // are drawn as the default texture until their file arrives.
+    b8 stream_textures;
 } texture_system_config;
 
 #define DEFAULT_TEXTURE_NAME "default"
@@ -0,0 +1,492 @@
+#include "vfs_system.h"
+
+#include "core/event.h"
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/lz4.h"
+#include "core/profiler.h"
+#include "platform/katomic.h"
+#include "platform/kfile_watcher.h"
+#include "systems/job_system.h"
+
+// Most distinct files reported by one update. Editors often write a file several times
+// when saving, so each is only reported once per update.
+#define VFS_MAX_CHANGES_PER_UPDATE 64
+
+typedef struct vfs_changes {
+    u32 count;
+    char paths[VFS_MAX_CHANGES_PER_UPDATE][KFILE_WATCHER_MAX_PATH_LENGTH];
+} vfs_changes;
+
+typedef struct vfs_system_state {
+    char asset_directory[VFS_MAX_PATH_LENGTH];
+    char pack_path[VFS_MAX_PATH_LENGTH];
+    b8 prefer_loose_files;
+
+    // The whole pack, mapped once. Empty without one.
+    file_mapping pack;
+    const asset_pack_entry* entries;
+    u32 entry_count;
+    const char* string_table;
+
+    // Memory compressed files were decompressed into by vfs_map, freed when unmapped.
+    file_mapping decompressed[VFS_MAX_DECOMPRESSED_MAPPINGS];
+
+    // Only created when watching for changes.
+    kfile_watcher watcher;
+    // Files changed since the last update.
+    vfs_changes changes;
+} vfs_system_state;
+
+typedef struct decompress_params {
+    const u8* stored;
+    const u32* chunk_sizes;
+    // Where each chunk starts within stored.
+    const u64* chunk_offsets;
+    u8* out_data;
+    u64 size;
+    volatile u32 failed;
+} decompress_params;
+
+static vfs_system_state* state_ptr;
+
+// Checks that a pack's header, directory and entries are all within it, so lookups need not.
+static b8 validate_pack(const file_mapping* pack, const char* path) {
+    if (pack->size < sizeof(asset_pack_header)) {
+        KWARN("'%s' is too small to be a pack.", path);
+        return false;
+    }
+    const asset_pack_header* header = pack->data;
+    if (header->magic != ASSET_PACK_MAGIC) {
+        KWARN("'%s' is not a pack.", path);
+        return false;
+    }
+    if (header->version != ASSET_PACK_VERSION) {
+        KWARN("'%s' is pack version %u, expected %u. Rebuild it with 'tools pack'.", path, header->version, ASSET_PACK_VERSION);
+        return false;
+    }
+
+    u64 directory_end = sizeof(asset_pack_header) + (u64)header->entry_count * sizeof(asset_pack_entry) + header->string_table_size;
+    if (directory_end > pack->size) {
+        KWARN("'%s' is truncated; its directory runs past its end.", path);
+        return false;
+    }
+    const asset_pack_entry* entries = (const asset_pack_entry*)(header + 1);
+    const char* string_table = (const char*)(entries + header->entry_count);
+    if (header->entry_count > 0 && (header->string_table_size == 0 || string_table[header->string_table_size - 1] != 0)) {
+        KWARN("'%s' has a malformed string table.", path);
+        return false;
+    }
+
+    for (u32 i = 0; i < header->entry_count; ++i) {
+        const asset_pack_entry* entry = &entries[i];
+        if (entry->path_offset >= header->string_table_size || entry->offset > pack->size || entry->stored_size > pack->size - entry->offset) {
+            KWARN("'%s' has an entry outside of it (entry %u).", path, i);
+            return false;
+        }
+        // The chunks themselves are checked as they are decompressed.
+        u64 chunk_count = (entry->size + ASSET_PACK_CHUNK_SIZE - 1) / ASSET_PACK_CHUNK_SIZE;
+        b8 compressed = (entry->flags & ASSET_PACK_ENTRY_FLAG_LZ4) != 0;
+        if (compressed ? entry->stored_size < chunk_count * sizeof(u32) : entry->stored_size != entry->size) {
+            KWARN("'%s' has an entry of the wrong size (entry %u).", path, i);
+            return false;
+        }
+        if (i > 0 && entries[i - 1].hash > entry->hash) {
+            KWARN("'%s' has an unsorted directory (entry %u).", path, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds a file in the pack. Binary search on the hash, then the paths of any entries sharing it.
+static const asset_pack_entry* find_entry(const char* path) {
+    if (!state_ptr || !state_ptr->entries) {
+        return 0;
+    }
+    u64 hash = vfs_hash_path(path);
+    u32 low = 0;
+    u32 high = state_ptr->entry_count;
+    while (low < high) {
+        u32 middle = low + (high - low) / 2;
+        if (state_ptr->entries[middle].hash < hash) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    for (u32 i = low; i < state_ptr->entry_count && state_ptr->entries[i].hash == hash; ++i) {
+        if (strings_equal(state_ptr->string_table + state_ptr->entries[i].path_offset, path)) {
+            return &state_ptr->entries[i];
+        }
+    }
+    return 0;
+}
+
+static void loose_file_path(const char* path, char* out_path) {
+    string_format(out_path, "%s/%s", state_ptr->asset_directory, path);
+}
+
+// Finds the file in the pack, unless it should come from a loose file. Sets loose_path either way.
+static const asset_pack_entry* resolve(const char* path, char* loose_path, b8* out_loose) {
+    loose_file_path(path, loose_path);
+    if (state_ptr->prefer_loose_files && filesystem_exists(loose_path)) {
+        *out_loose = true;
+        return 0;
+    }
+    const asset_pack_entry* entry = find_entry(path);
+    *out_loose = !entry && filesystem_exists(loose_path);
+    return entry;
+}
+
+static void decompress_chunks(u32 begin, u32 end, void* params) {
+    decompress_params* p = params;
+    for (u32 i = begin; i < end; ++i) {
+        u64 chunk_start = (u64)i * ASSET_PACK_CHUNK_SIZE;
+        u64 chunk_size = p->size - chunk_start < ASSET_PACK_CHUNK_SIZE ? p->size - chunk_start : ASSET_PACK_CHUNK_SIZE;
+        const u8* stored = p->stored + p->chunk_offsets[i];
+        b8 ok;
+        if (p->chunk_sizes[i] == chunk_size) {
+            // Did not shrink, so stored as is.
+            kcopy_memory(p->out_data + chunk_start, stored, chunk_size);
+            ok = true;
+        } else {
+            ok = lz4_decompress(stored, p->chunk_sizes[i], p->out_data + chunk_start, chunk_size);
+        }
+        if (!ok) {
+            katomic_store_u32(&p->failed, 1, KATOMIC_RELAXED);
+            return;
+        }
+    }
+}
+
+// Decompresses a compressed entry into memory of its own, tracked until unmapped.
+static b8 map_decompressed(const asset_pack_entry* entry, const char* path, file_mapping* out_mapping) {
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+    u32 index = INVALID_ID;
+    for (u32 i = 0; i < VFS_MAX_DECOMPRESSED_MAPPINGS; ++i) {
+        if (!state_ptr->decompressed[i].data) {
+            index = i;
+            break;
+        }
+    }
+    if (index == INVALID_ID) {
+        KERROR("vfs_map - Too many compressed files mapped at once to map '%s'. Unmap some first.", path);
+        return false;
+    }
+    if (entry->size == 0) {
+        return true;
+    }
+
+    void* data = kallocate(entry->size, MEMORY_TAG_FILE);
+    if (!vfs_decompress((const u8*)state_ptr->pack.data + entry->offset, entry->stored_size, data, entry->size)) {
+        KERROR("vfs_map - '%s' is corrupt in the pack.", path);
+        kfree(data, entry->size, MEMORY_TAG_FILE);
+        return false;
+    }
+    state_ptr->decompressed[index].data = data;
+    state_ptr->decompressed[index].size = entry->size;
+    out_mapping->data = data;
+    out_mapping->size = entry->size;
+    return true;
+}
+
+b8 vfs_system_initialize(u64* memory_requirement, void* state, vfs_system_config config) {
+    *memory_requirement = sizeof(vfs_system_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, sizeof(vfs_system_state));
+    string_ncopy(state_ptr->asset_directory, config.asset_directory ? config.asset_directory : ".", VFS_MAX_PATH_LENGTH - 1);
+    state_ptr->prefer_loose_files = config.prefer_loose_files;
+
+    if (config.watch_for_changes) {
+        if (kfile_watcher_create(state_ptr->asset_directory, &state_ptr->watcher)) {
+            KINFO("Watching '%s' for changes.", state_ptr->asset_directory);
+        } else {
+            // Not fatal; assets just are not reloaded.
+            KWARN("Unable to watch '%s' for changes. Assets will not be reloaded when edited.", state_ptr->asset_directory);
+        }
+    }
+
+    if (!config.pack_path) {
+        KINFO("Virtual filesystem reading loose files from '%s'.", state_ptr->asset_directory);
+        return true;
+    }
+    string_ncopy(state_ptr->pack_path, config.pack_path, VFS_MAX_PATH_LENGTH - 1);
+    // Lookups land all over the directory, and entries are only read when used.
+    if (!filesystem_map_readonly(state_ptr->pack_path, FILE_ACCESS_HINT_RANDOM, &state_ptr->pack)) {
+        KINFO("No pack at '%s'. Virtual filesystem reading loose files from '%s'.", state_ptr->pack_path, state_ptr->asset_directory);
+        return true;
+    }
+    if (!validate_pack(&state_ptr->pack, state_ptr->pack_path)) {
+        KWARN("Ignoring pack '%s'. Virtual filesystem reading loose files from '%s'.", state_ptr->pack_path, state_ptr->asset_directory);
+        filesystem_unmap(&state_ptr->pack);
+        return true;
+    }
+
+    const asset_pack_header* header = state_ptr->pack.data;
+    state_ptr->entry_count = header->entry_count;
+    state_ptr->entries = (const asset_pack_entry*)(header + 1);
+    state_ptr->string_table = (const char*)(state_ptr->entries + header->entry_count);
+    KINFO("Virtual filesystem reading %u files from pack '%s'%s.", state_ptr->entry_count, state_ptr->pack_path,
+          state_ptr->prefer_loose_files ? ", with loose files taking precedence" : "");
+    return true;
+}
+
+void vfs_system_shutdown(void* state) {
+    if (state_ptr) {
+        kfile_watcher_destroy(&state_ptr->watcher);
+        for (u32 i = 0; i < VFS_MAX_DECOMPRESSED_MAPPINGS; ++i) {
+            if (state_ptr->decompressed[i].data) {
+                KWARN("vfs_system_shutdown - A decompressed file of %llu bytes was never unmapped.", state_ptr->decompressed[i].size);
+                kfree((void*)state_ptr->decompressed[i].data, state_ptr->decompressed[i].size, MEMORY_TAG_FILE);
+            }
+        }
+        filesystem_unmap(&state_ptr->pack);
+        state_ptr->entries = 0;
+        state_ptr->entry_count = 0;
+        state_ptr->string_table = 0;
+    }
+    state_ptr = 0;
+}
+
+static void fire_asset_changed(const char* path) {
+    event_context context;
+    context.data.u64[0] = (u64)path;
+    event_fire(EVENT_CODE_ASSET_CHANGED, 0, context);
+}
+
+static void on_file_changed(const char* path, void* user_data) {
+    vfs_changes* changes = user_data;
+    for (u32 i = 0; i < changes->count; ++i) {
+        if (strings_equal(changes->paths[i], path)) {
+            return;
+        }
+    }
+    if (changes->count == VFS_MAX_CHANGES_PER_UPDATE) {
+        // Reported without checking for repeats; reloading twice is only wasteful.
+        fire_asset_changed(path);
+        return;
+    }
+    string_ncopy(changes->paths[changes->count++], path, KFILE_WATCHER_MAX_PATH_LENGTH - 1);
+}
+
+void vfs_system_update() {
+    if (!state_ptr || !state_ptr->watcher.internal_data) {
+        return;
+    }
+    vfs_changes* changes = &state_ptr->changes;
+    changes->count = 0;
+    if (kfile_watcher_poll(&state_ptr->watcher, on_file_changed, changes) == 0) {
+        return;
+    }
+
+    for (u32 i = 0; i < changes->count; ++i) {
+        const char* path = changes->paths[i];
+        if (!state_ptr->prefer_loose_files && find_entry(path)) {
+            // The pack is read before loose files, so an edit is not seen until it is rebuilt.
+            KDEBUG("'%s' changed, but is read from the pack.", path);
+            continue;
+        }
+        KDEBUG("'%s' changed.", path);
+        fire_asset_changed(path);
+    }
+}
+
+u64 vfs_hash_path(const char* path) {
+    // FNV-1a.
+    u64 hash = 0xcbf29ce484222325ULL;
+    for (const u8* c = (const u8*)path; *c; ++c) {
+        hash ^= *c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+b8 vfs_exists(const char* path) {
+    if (!state_ptr || !path) {
+        return false;
+    }
+    char loose_path[VFS_MAX_PATH_LENGTH * 2];
+    b8 loose = false;
+    return resolve(path, loose_path, &loose) || loose;
+}
+
+b8 vfs_size(const char* path, u64* out_size) {
+    if (!state_ptr || !path || !out_size) {
+        return false;
+    }
+    char loose_path[VFS_MAX_PATH_LENGTH * 2];
+    b8 loose = false;
+    const asset_pack_entry* entry = resolve(path, loose_path, &loose);
+    if (entry) {
+        *out_size = entry->size;
+        return true;
+    }
+    file_handle file;
+    if (!loose || !filesystem_open(loose_path, FILE_MODE_READ, true, &file)) {
+        return false;
+    }
+    b8 result = filesystem_size(&file, out_size);
+    filesystem_close(&file);
+    return result;
+}
+
+b8 vfs_read(const char* path, u64 buffer_size, void* out_data, u64* out_bytes_read) {
+    if (!state_ptr || !path || !out_data || !out_bytes_read) {
+        return false;
+    }
+    *out_bytes_read = 0;
+    char loose_path[VFS_MAX_PATH_LENGTH * 2];
+    b8 loose = false;
+    const asset_pack_entry* entry = resolve(path, loose_path, &loose);
+    if (entry) {
+        if (entry->size > buffer_size) {
+            KERROR("vfs_read - '%s' is %llu bytes, which does not fit in %llu.", path, entry->size, buffer_size);
+            return false;
+        }
+        const u8* stored = (const u8*)state_ptr->pack.data + entry->offset;
+        if (entry->flags & ASSET_PACK_ENTRY_FLAG_LZ4) {
+            if (!vfs_decompress(stored, entry->stored_size, out_data, entry->size)) {
+                KERROR("vfs_read - '%s' is corrupt in the pack.", path);
+                return false;
+            }
+        } else {
+            kcopy_memory(out_data, stored, entry->size);
+        }
+        *out_bytes_read = entry->size;
+        return true;
+    }
+
+    file_handle file;
+    if (!loose || !filesystem_open(loose_path, FILE_MODE_READ, true, &file)) {
+        return false;
+    }
+    b8 result = filesystem_read_all_bytes_into(&file, buffer_size, out_data, out_bytes_read);
+    filesystem_close(&file);
+    return result;
+}
+
+b8 vfs_decompress(const void* stored, u64 stored_size, void* out_data, u64 size) {
+    if (!stored || !out_data) {
+        return size == 0;
+    }
+    u64 chunk_count = (size + ASSET_PACK_CHUNK_SIZE - 1) / ASSET_PACK_CHUNK_SIZE;
+    u64 table_size = chunk_count * sizeof(u32);
+    if (stored_size < table_size || chunk_count > 0xFFFFFFFF) {
+        return false;
+    }
+
+    // Find where each chunk starts, and that they all lie within what was stored.
+    decompress_params params = {};
+    params.stored = stored;
+    params.chunk_sizes = stored;
+    params.out_data = out_data;
+    params.size = size;
+    u64* chunk_offsets = kallocate(sizeof(u64) * chunk_count, MEMORY_TAG_FILE);
+    u64 offset = table_size;
+    for (u64 i = 0; i < chunk_count; ++i) {
+        chunk_offsets[i] = offset;
+        offset += params.chunk_sizes[i];
+    }
+    params.chunk_offsets = chunk_offsets;
+    b8 result = offset <= stored_size;
+
+    if (result) {
+        KPROFILE_ZONE_BEGIN("vfs decompress");
+        if (chunk_count == 1) {
+            // Not worth handing to another thread.
+            decompress_chunks(0, 1, &params);
+        } else {
+            job_system_parallel_for((u32)chunk_count, 1, decompress_chunks, &params, JOB_PRIORITY_NORMAL);
+        }
+        KPROFILE_ZONE_END();
+        result = katomic_load_u32(&params.failed, KATOMIC_RELAXED) == 0;
+    }
+
+    kfree(chunk_offsets, sizeof(u64) * chunk_count, MEMORY_TAG_FILE);
+    return result;
+}
+
+b8 vfs_map(const char* path, file_access_hint hint, file_mapping* out_mapping) {
+    if (!state_ptr || !path || !out_mapping) {
+        return false;
+    }
+    char loose_path[VFS_MAX_PATH_LENGTH * 2];
+    b8 loose = false;
+    const asset_pack_entry* entry = resolve(path, loose_path, &loose);
+    if (entry && (entry->flags & ASSET_PACK_ENTRY_FLAG_LZ4)) {
+        return map_decompressed(entry, path, out_mapping);
+    }
+    if (entry) {
+        // Empty entries map to nothing, as empty files do.
+        out_mapping->data = entry->size ? (const u8*)state_ptr->pack.data + entry->offset : 0;
+        out_mapping->size = entry->size;
+        return true;
+    }
+    if (!loose) {
+        out_mapping->data = 0;
+        out_mapping->size = 0;
+        return false;
+    }
+    return filesystem_map_readonly(loose_path, hint, out_mapping);
+}
+
+void vfs_unmap(file_mapping* mapping) {
+    const u8* pack_start = state_ptr ? state_ptr->pack.data : 0;
+    const u8* data = mapping->data;
+    if (pack_start && data >= pack_start && data < pack_start + state_ptr->pack.size) {
+        // Part of the pack, which stays mapped.
+        mapping->data = 0;
+        mapping->size = 0;
+        return;
+    }
+    for (u32 i = 0; state_ptr && data && i < VFS_MAX_DECOMPRESSED_MAPPINGS; ++i) {
+        if (state_ptr->decompressed[i].data == data) {
+            kfree((void*)data, state_ptr->decompressed[i].size, MEMORY_TAG_FILE);
+            state_ptr->decompressed[i].data = 0;
+            state_ptr->decompressed[i].size = 0;
+            mapping->data = 0;
+            mapping->size = 0;
+            return;
+        }
+    }
+    filesystem_unmap(mapping);
+}
+
+b8 vfs_locate(const char* path, vfs_location* out_location) {
+    if (!state_ptr || !path || !out_location) {
+        return false;
+    }
+    char loose_path[VFS_MAX_PATH_LENGTH * 2];
+    b8 loose = false;
+    const asset_pack_entry* entry = resolve(path, loose_path, &loose);
+    if (entry) {
+        if (entry->stored_size == 0) {
+            // A size of 0 would read the rest of the pack.
+            return false;
+        }
+        string_ncopy(out_location->file_path, state_ptr->pack_path, VFS_MAX_PATH_LENGTH - 1);
+        out_location->file_path[VFS_MAX_PATH_LENGTH - 1] = 0;
+        out_location->offset = entry->offset;
+        out_location->size = entry->stored_size;
+        out_location->compressed = (entry->flags & ASSET_PACK_ENTRY_FLAG_LZ4) != 0;
+        out_location->uncompressed_size = entry->size;
+        return true;
+    }
+    if (!loose || string_length(loose_path) >= VFS_MAX_PATH_LENGTH) {
+        return false;
+    }
+    string_ncopy(out_location->file_path, loose_path, VFS_MAX_PATH_LENGTH - 1);
+    out_location->file_path[VFS_MAX_PATH_LENGTH - 1] = 0;
+    out_location->offset = 0;
+    out_location->size = 0;
+    out_location->compressed = false;
+    out_location->uncompressed_size = 0;
+    return true;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/filesystem.h"
+
+// "KPAK", as read from the start of a pack.
+#define ASSET_PACK_MAGIC 0x4B41504B
+#define ASSET_PACK_VERSION 2
+// Every entry's data starts on this boundary, so it can be used in place (i.e. as
+// SPIR-V, which must be 4 byte aligned) and never shares a page with another entry.
+#define ASSET_PACK_ALIGNMENT 4096
+// Compressed entries are split into chunks of this much data, compressed on their own,
+// so one large entry can be decompressed across every thread.
+#define ASSET_PACK_CHUNK_SIZE (256 * 1024)
+// Longest path a file can be located through, including the terminator.
+#define VFS_MAX_PATH_LENGTH 256
+// Most compressed files which can be mapped at once, as each is decompressed into memory of its own.
+#define VFS_MAX_DECOMPRESSED_MAPPINGS 64
+
+/**
+ * A pack starts with this header, followed by entry_count asset_pack_entry sorted by
+ * hash (then by path), then the string table holding their paths. Entry data follows,
+ * each aligned to ASSET_PACK_ALIGNMENT. Written by "tools pack".
+ */
+typedef struct asset_pack_header {
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    // Size of the string table, in bytes.
+    u32 string_table_size;
+} asset_pack_header;
+
+typedef enum asset_pack_entry_flags {
+    ASSET_PACK_ENTRY_FLAG_NONE = 0x0,
+    /**
+     * Stored LZ4 compressed, as a u32 per chunk of ASSET_PACK_CHUNK_SIZE bytes holding
+     * its compressed size, then the chunks one after another. A chunk which would not
+     * shrink is stored as is, and so has a compressed size equal to its size.
+     */
+    ASSET_PACK_ENTRY_FLAG_LZ4 = 0x1
+} asset_pack_entry_flags;
+
+typedef struct asset_pack_entry {
+    // vfs_hash_path of the path.
+    u64 hash;
+    // Where the data starts, from the start of the pack.
+    u64 offset;
+    // The size of the file.
+    u64 size;
+    // The number of bytes stored in the pack. The same as size unless compressed.
+    u64 stored_size;
+    // Where the path starts, from the start of the string table. Null terminated.
+    u32 path_offset;
+    // asset_pack_entry_flags.
+    u32 flags;
+} asset_pack_entry;
+
+typedef struct vfs_system_config {
+    // Where loose files are read from, i.e. "assets".
+    const char* asset_directory;
+    // The pack to read from. Optional; without one, only loose files are read.
+    const char* pack_path;
+    // Looks for loose files before the pack, so edited assets are picked up
+    // without rebuilding it. Meant for development.
+    b8 prefer_loose_files;
+    // Watches the asset directory, firing EVENT_CODE_ASSET_CHANGED from vfs_system_update
+    // for each file written, so it can be reloaded. Meant for development.
+    b8 watch_for_changes;
+} vfs_system_config;
+
+// Where a file's bytes can be read from, for reads the vfs does not do itself.
+typedef struct vfs_location {
+    // The path of the file holding them; the pack, or a loose file.
+    char file_path[VFS_MAX_PATH_LENGTH];
+    // Where they start in that file.
+    u64 offset;
+    // The number of bytes to read. 0 for a loose file, which is read to its end.
+    u64 size;
+    // If set, the bytes read must be passed through vfs_decompress.
+    b8 compressed;
+    // The size of the file once decompressed.
+    u64 uncompressed_size;
+} vfs_location;
+
+/**
+ * @brief Initializes the virtual filesystem, which serves assets by path relative to
+ * the asset directory (i.e. "textures/paving.png"), from a single mapped pack where
+ * there is one, otherwise from loose files. Call twice; once with state = 0 to get
+ * required memory size, then a second time passing allocated memory to state.
+ * A missing or invalid pack is not an error; loose files are used instead.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param config The configuration of the system.
+ * @return b8 True on success; otherwise false.
+ */
+b8 vfs_system_initialize(u64* memory_requirement, void* state, vfs_system_config config);
+
+/** @brief Unmaps the pack. Nothing mapped from it may be used afterward. */
+void vfs_system_shutdown(void* state);
+
+/**
+ * @brief Fires EVENT_CODE_ASSET_CHANGED once for each file written since the last
+ * update, if watching for changes. Never blocks. Call once per frame, from the main thread.
+ */
+void vfs_system_update();
+
+/**
+ * @brief Hashes a path as the pack's directory does. Case sensitive; paths use forward slashes.
+ *
+ * @param path The path to hash.
+ * @return u64 The hash.
+ */
+KAPI u64 vfs_hash_path(const char* path);
+
+/** @brief Indicates if a file exists, in the pack or loose. */
+KAPI b8 vfs_exists(const char* path);
+
+/**
+ * @brief Gets the size of a file, as it will be read.
+ *
+ * @param path The path of the file, relative to the asset directory.
+ * @param out_size A pointer to hold the size, in bytes.
+ * @return b8 True if the file exists; otherwise false.
+ */
+KAPI b8 vfs_size(const char* path, u64* out_size);
+
+/**
+ * @brief Reads a whole file into caller-provided memory, i.e. a staging buffer. Compressed
+ * files are decompressed straight into it, in parallel on the job system's threads.
+ * Use vfs_size to find the required size.
+ *
+ * @param path The path of the file, relative to the asset directory.
+ * @param buffer_size The size of out_data in bytes.
+ * @param out_data The memory to read into.
+ * @param out_bytes_read A pointer to hold the number of bytes read.
+ * @return b8 True if successful; otherwise false, including if the file does not fit.
+ */
+KAPI b8 vfs_read(const char* path, u64 buffer_size, void* out_data, u64* out_bytes_read);
+
+/**
+ * @brief Maps a file read only. Files in the pack are already mapped, so this is a
+ * directory lookup with no calls into the OS. Compressed files are decompressed into
+ * memory held until they are unmapped, at most VFS_MAX_DECOMPRESSED_MAPPINGS at a time.
+ *
+ * @param path The path of the file, relative to the asset directory.
+ * @param hint How the file will be read. Only used for loose files.
+ * @param out_mapping A pointer to the mapping to be filled in.
+ * @return b8 True if successful; otherwise false.
+ */
+KAPI b8 vfs_map(const char* path, file_access_hint hint, file_mapping* out_mapping);
+
+/** @brief Unmaps a file mapped with vfs_map. Its data must no longer be used. */
+KAPI void vfs_unmap(file_mapping* mapping);
+
+/**
+ * @brief Decompresses a compressed file's bytes, read from where vfs_locate found them.
+ * Its chunks are decompressed in parallel on the job system's threads.
+ *
+ * @param stored The bytes read.
+ * @param stored_size The number of bytes read.
+ * @param out_data The memory to decompress into, at least size bytes.
+ * @param size The size of the file once decompressed.
+ * @return b8 True if successful; false if the bytes are malformed.
+ */
+KAPI b8 vfs_decompress(const void* stored, u64 stored_size, void* out_data, u64 size);
+
+/**
+ * @brief Finds where a file's bytes are, so they can be read elsewhere, i.e. by the async IO system.
+ *
+ * @param path The path of the file, relative to the asset directory.
+ * @param out_location A pointer to hold the location.
+ * @return b8 True if the file exists; otherwise false. Also false for empty files in the pack, which have nothing to read.
+ */
+KAPI b8 vfs_locate(const char* path, vfs_location* out_location);
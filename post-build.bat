@@ -17,4 +17,14 @@ echo "Copying assets..."
 echo xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
 xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
 
+REM Only once the tools have been built.
+if exist "%cd%\bin\tools.exe" (
+    echo "Compiling materials..."
+    bin\tools.exe compile_material bin/assets/materials
+    IF ERRORLEVEL 1 (echo Error compiling materials && exit)
+    echo "Packing assets..."
+    bin\tools.exe pack bin/assets bin/assets.kpak
+    IF ERRORLEVEL 1 (echo Error packing assets && exit)
+)
+
 echo "Done."
\ No newline at end of file
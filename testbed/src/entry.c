@@ -13,6 +13,9 @@ b8 create_game(game* out_game)
 	out_game->app_config.width = 1200;
 	out_game->app_config.height = 600;
 	out_game->app_config.name = "Testbed";
+	out_game->app_config.frame_pacing = FRAME_PACING_ADAPTIVE;
+	out_game->app_config.target_fps = 60;
+	out_game->app_config.publish_telemetry = true;
 	out_game->update = game_update;
 	out_game->render = game_render;
 	out_game->on_resize = game_on_resize;
@@ -318,6 +318,32 @@ u8 hashtable_should_set_get_and_update_ptr_successfully() {
     return true;
 }
 
+u8 hashtable_should_only_ignore_case_when_asked() {
+    hashtable table;
+    u64 memory[64];
+    u64 value = 23;
+    u64 other_value = 0;
+
+    // Case-sensitive by default.
+    hashtable_create(sizeof(u64), 64, memory, false, &table);
+    expect_to_be_false(table.ignore_case);
+    hashtable_set(&table, "Paving", &value);
+    hashtable_get(&table, "paving", &other_value);
+    expect_should_be(0, other_value);
+    hashtable_get(&table, "Paving", &other_value);
+    expect_should_be(value, other_value);
+    hashtable_destroy(&table);
+
+    hashtable_create_ignore_case(sizeof(u64), 64, memory, false, &table);
+    expect_to_be_true(table.ignore_case);
+    hashtable_set(&table, "Paving", &value);
+    other_value = 0;
+    hashtable_get(&table, "PAVING", &other_value);
+    expect_should_be(value, other_value);
+    hashtable_destroy(&table);
+    return true;
+}
+
 void hashtable_register_tests() {
     test_manager_register_test(hashtable_should_create_and_destroy, "Hashtable should create and destroy");
     test_manager_register_test(hashtable_should_set_and_get_successfully, "Hashtable should set and get");
@@ -328,4 +354,5 @@ void hashtable_register_tests() {
     test_manager_register_test(hashtable_try_call_non_ptr_on_ptr_table, "Hashtable try calling non-pointer functions on pointer type table.");
     test_manager_register_test(hashtable_try_call_ptr_on_non_ptr_table, "Hashtable try calling pointer functions on non-pointer type table.");
     test_manager_register_test(hashtable_should_set_get_and_update_ptr_successfully, "Hashtable Should get pointer, update, and get again successfully.");
+    test_manager_register_test(hashtable_should_only_ignore_case_when_asked, "Hashtable should only ignore case when created to.");
 }
\ No newline at end of file
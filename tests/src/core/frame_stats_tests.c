@@ -0,0 +1,84 @@
+#include "frame_stats_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/frame_stats.h>
+#include <core/kmemory.h>
+
+u8 frame_stats_should_be_empty_before_first_frame() {
+    test_system system;
+    test_system_start(&system, frame_stats_initialize, frame_stats_shutdown, MEMORY_TAG_APPLICATION);
+
+    frame_stats stats;
+    expect_to_be_true(frame_stats_get(&stats));
+    expect_should_be(0, stats.frame_count);
+    expect_should_be(0, stats.sample_count);
+    expect_should_be(0, stats.hitch_count);
+
+    test_system_stop(&system);
+
+    // Not initialized.
+    expect_to_be_false(frame_stats_get(&stats));
+    return true;
+}
+
+u8 frame_stats_should_compute_percentiles() {
+    test_system system;
+    test_system_start(&system, frame_stats_initialize, frame_stats_shutdown, MEMORY_TAG_APPLICATION);
+
+    // Frames of 1..100 ms, recorded out of order.
+    for (u32 i = 0; i < 100; ++i) {
+        u32 ms = ((i * 37) % 100) + 1;
+        frame_stats_record(0.001, 0.002, ms / 1000.0);
+    }
+
+    frame_stats stats;
+    expect_to_be_true(frame_stats_get(&stats));
+    expect_should_be(100, stats.frame_count);
+    expect_should_be(100, stats.sample_count);
+    expect_float_to_be(1.0f, (f32)(stats.frame.min * 1000.0));
+    expect_float_to_be(100.0f, (f32)(stats.frame.max * 1000.0));
+    expect_float_to_be(50.5f, (f32)(stats.frame.mean * 1000.0));
+    expect_float_to_be(50.0f, (f32)(stats.frame.p50 * 1000.0));
+    expect_float_to_be(95.0f, (f32)(stats.frame.p95 * 1000.0));
+    expect_float_to_be(99.0f, (f32)(stats.frame.p99 * 1000.0));
+    expect_float_to_be(1.0f, (f32)(stats.update.p99 * 1000.0));
+    expect_float_to_be(2.0f, (f32)(stats.render.mean * 1000.0));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 frame_stats_should_count_hitches_in_window() {
+    test_system system;
+    test_system_start(&system, frame_stats_initialize, frame_stats_shutdown, MEMORY_TAG_APPLICATION);
+
+    // Old hitches fall out of the window.
+    for (u32 i = 0; i < 10; ++i) {
+        frame_stats_record(0, 0, 0.5);
+    }
+    for (u32 i = 0; i < FRAME_STATS_WINDOW_SIZE; ++i) {
+        // A 50ms stutter every 100 frames of 16ms.
+        frame_stats_record(0, 0, (i % 100) == 99 ? 0.05 : 0.016);
+    }
+
+    frame_stats stats;
+    expect_to_be_true(frame_stats_get(&stats));
+    expect_should_be(FRAME_STATS_WINDOW_SIZE + 10, stats.frame_count);
+    expect_should_be(FRAME_STATS_WINDOW_SIZE, stats.sample_count);
+    expect_should_be(5, stats.hitch_count);
+    expect_float_to_be(16.0f, (f32)(stats.frame.p50 * 1000.0));
+    expect_float_to_be(50.0f, (f32)(stats.frame.max * 1000.0));
+
+    test_system_stop(&system);
+    return true;
+}
+
+void frame_stats_register_tests() {
+    test_manager_register_test(frame_stats_should_be_empty_before_first_frame, "Frame stats are empty before the first frame");
+    test_manager_register_test(frame_stats_should_compute_percentiles, "Frame stats compute min, mean and percentiles");
+    test_manager_register_test(frame_stats_should_count_hitches_in_window, "Frame stats count hitches within the window");
+}
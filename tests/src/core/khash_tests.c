@@ -0,0 +1,26 @@
+#include "khash_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/khash.h>
+
+u8 khash_should_match_reference() {
+    // From the reference implementation, covering the short path, the tail and the 32 byte rounds.
+    expect_should_be(0xEF46DB3751D8E999ULL, khash64("", 0, 0));
+    expect_should_be(0x44BC2CF5AD770999ULL, khash64("abc", 3, 0));
+
+    u8 data[1000];
+    for (u32 i = 0; i < sizeof(data); ++i) {
+        data[i] = (u8)(i * 31 + 7);
+    }
+    expect_should_be(0x5D71D9FC4B676D9FULL, khash64(data, 37, 0));
+    expect_should_be(0x99594F4828043D35ULL, khash64(data, sizeof(data), 0));
+    expect_should_be(0x31DB8080BC8EB541ULL, khash64(data, sizeof(data), 1));
+    return true;
+}
+
+void khash_register_tests() {
+    test_manager_register_test(khash_should_match_reference, "khash64 matches the reference XXH64");
+}
@@ -0,0 +1,80 @@
+#include "kstring_builder_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/kstring.h>
+#include <core/kstring_builder.h>
+#include <memory/linear_allocator.h>
+
+u8 kstring_builder_should_grow_out_of_its_buffer() {
+    char buffer[8];
+    kstring_builder builder;
+    string_builder_create_from_buffer(buffer, sizeof(buffer), 0, &builder);
+    string_builder_append(&builder, "abc");
+    string_builder_append_char(&builder, '-');
+    b8 in_buffer = builder.data == buffer;
+    expect_to_be_true(in_buffer);
+    expect_to_be_false(builder.owns_data);
+
+    // Too long for the buffer, so formatted a second time once grown.
+    expect_to_be_true(string_builder_appendf(&builder, "%d/%s", 12345, "textures"));
+    in_buffer = builder.data == buffer;
+    expect_to_be_false(in_buffer);
+    expect_to_be_true(builder.owns_data);
+    expect_to_be_true(strings_equal(builder.data, "abc-12345/textures"));
+    expect_should_be(18, builder.length);
+
+    string_builder_truncate(&builder, 3);
+    string_builder_append_n(&builder, ".pngxyz", 4);
+    expect_to_be_true(strings_equal(builder.data, "abc.png"));
+
+    string_builder_clear(&builder);
+    expect_should_be(0, builder.length);
+    expect_to_be_true(strings_equal(builder.data, ""));
+    string_builder_destroy(&builder);
+    expect_should_be(0, builder.data);
+    return true;
+}
+
+u8 kstring_builder_should_extend_in_its_allocator() {
+    linear_allocator allocator;
+    linear_allocator_create(64, 0, &allocator);
+
+    kstring_builder builder;
+    string_builder_create(8, &allocator, &builder);
+    expect_should_be(8, allocator.allocated);
+    for (u32 i = 0; i < 10; ++i) {
+        string_builder_append_char(&builder, (char)('0' + i));
+    }
+    // The latest allocation, so grown where it is rather than copied.
+    b8 in_place = builder.data == allocator.memory;
+    expect_to_be_true(in_place);
+    expect_should_be(builder.capacity, allocator.allocated);
+    expect_to_be_true(strings_equal(builder.data, "0123456789"));
+
+    // Something else allocated after it, so it has to move.
+    u64 before = allocator.allocated;
+    linear_allocator_allocate(&allocator, 4);
+    string_builder_append(&builder, "abcdefghij");
+    b8 moved = builder.data >= (char*)allocator.memory + before + 4;
+    expect_to_be_true(moved);
+    expect_to_be_false(builder.owns_data);
+    expect_to_be_true(strings_equal(builder.data, "0123456789abcdefghij"));
+
+    // Once the allocator runs out, the heap takes over.
+    string_builder_append(&builder, "0123456789012345678901234567890123456789");
+    expect_to_be_true(builder.owns_data);
+    expect_should_be(60, builder.length);
+    expect_to_be_true(strings_equal(builder.data + 50, "0123456789"));
+
+    string_builder_destroy(&builder);
+    linear_allocator_destroy(&allocator);
+    return true;
+}
+
+void kstring_builder_register_tests() {
+    test_manager_register_test(kstring_builder_should_grow_out_of_its_buffer, "String builder grows out of its buffer");
+    test_manager_register_test(kstring_builder_should_extend_in_its_allocator, "String builder extends in its allocator");
+}
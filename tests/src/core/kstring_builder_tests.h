@@ -0,0 +1,3 @@
+#pragma once
+
+void kstring_builder_register_tests();
\ No newline at end of file
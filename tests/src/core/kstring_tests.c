@@ -0,0 +1,431 @@
+#include "kstring_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/kstring.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+
+// What the parsers are measured against.
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _MSC_VER
+#include <strings.h>
+#endif
+
+#define ROUND_TRIP_COUNT 50000
+#define BENCHMARK_COUNT 100000
+
+static u32 next_random(u64* state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (u32)(*state >> 32);
+}
+
+u8 kstring_should_round_trip_floats() {
+    u64 seed = 42;
+    char text[64];
+    u32 f32_mismatches = 0;
+    u32 f64_mismatches = 0;
+    for (u32 i = 0; i < ROUND_TRIP_COUNT; ++i) {
+        // Any finite bit pattern, subnormals included.
+        union {
+            f32 f;
+            u32 u;
+        } expected32, parsed32;
+        do {
+            expected32.u = next_random(&seed);
+        } while ((expected32.u & 0x7F800000) == 0x7F800000);
+        string_format(text, "%.9g", expected32.f);
+        parsed32.u = 0;
+        if (!string_to_f32(text, &parsed32.f) || parsed32.u != expected32.u) {
+            f32_mismatches++;
+        }
+
+        union {
+            f64 f;
+            u64 u;
+        } expected64, parsed64;
+        do {
+            expected64.u = ((u64)next_random(&seed) << 32) | next_random(&seed);
+        } while ((expected64.u & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL);
+        string_format(text, "%.17g", expected64.f);
+        parsed64.u = 0;
+        if (!string_to_f64(text, &parsed64.f) || parsed64.u != expected64.u) {
+            f64_mismatches++;
+        }
+
+        // Short, hand written numbers, as found in files; these take the fast path.
+        string_format(text, "%d.%03d", (i32)(next_random(&seed) % 2000) - 1000, next_random(&seed) % 1000);
+        parsed32.u = 0;
+        expected32.f = strtof(text, 0);
+        if (!string_to_f32(text, &parsed32.f) || parsed32.u != expected32.u) {
+            f32_mismatches++;
+        }
+    }
+    expect_should_be(0, f32_mismatches);
+    expect_should_be(0, f64_mismatches);
+
+    f32 f = 0;
+    expect_to_be_true(string_to_f32("  -0.5", &f));
+    expect_float_to_be(-0.5f, f);
+    // Stops at the end of the number, as sscanf did.
+    expect_to_be_true(string_to_f32("1.5abc", &f));
+    expect_float_to_be(1.5f, f);
+    expect_to_be_true(string_to_f32("2e3", &f));
+    expect_float_to_be(2000.0f, f);
+    expect_to_be_true(string_to_f32("7e", &f));
+    expect_float_to_be(7.0f, f);
+    expect_to_be_false(string_to_f32("", &f));
+    expect_to_be_false(string_to_f32(".", &f));
+    expect_to_be_false(string_to_f32("abc", &f));
+    // Ties between two f32s, which rounding through f64 alone would get wrong.
+    union {
+        f32 f;
+        u32 u;
+    } tie, reference;
+    expect_to_be_true(string_to_f32("1.00000005960464477539062499", &tie.f));
+    reference.f = strtof("1.00000005960464477539062499", 0);
+    expect_should_be(reference.u, tie.u);
+    expect_to_be_true(string_to_f32("16777217", &tie.f));
+    expect_float_to_be(16777216.0f, tie.f);
+    // Too large to shift into the mantissa, so it must fall back rather than wrap.
+    union {
+        f64 f;
+        u64 u;
+    } large, large_reference;
+    expect_to_be_true(string_to_f64("18447e37", &large.f));
+    large_reference.f = strtod("18447e37", 0);
+    expect_should_be(large_reference.u, large.u);
+    b8 is_expected = large.f == 1.8447e41;
+    expect_to_be_true(is_expected);
+
+    vec4 v;
+    expect_to_be_true(string_to_vec4("1 0.5\t0.25  -2", &v));
+    expect_float_to_be(1.0f, v.x);
+    expect_float_to_be(0.5f, v.y);
+    expect_float_to_be(0.25f, v.z);
+    expect_float_to_be(-2.0f, v.w);
+    expect_to_be_false(string_to_vec4("1 2 3", &v));
+    vec2 v2;
+    expect_to_be_true(string_to_vec2("3 4", &v2));
+    expect_float_to_be(4.0f, v2.y);
+    return true;
+}
+
+u8 kstring_should_parse_integers_in_range() {
+    i8 i8_value;
+    expect_to_be_true(string_to_i8("-128", &i8_value));
+    i64 value = i8_value;
+    expect_should_be(-128, value);
+    expect_to_be_false(string_to_i8("128", &i8_value));
+
+    u8 u8_value;
+    expect_to_be_true(string_to_u8("255", &u8_value));
+    expect_should_be(255, u8_value);
+    expect_to_be_false(string_to_u8("256", &u8_value));
+
+    i32 i32_value;
+    expect_to_be_true(string_to_i32(" 0x7fffffff", &i32_value));
+    expect_should_be(2147483647, i32_value);
+    expect_to_be_true(string_to_i32("-2147483648", &i32_value));
+    value = i32_value;
+    expect_should_be(-2147483648LL, value);
+    expect_to_be_false(string_to_i32("2147483648", &i32_value));
+    expect_to_be_false(string_to_i32("x", &i32_value));
+
+    u32 u32_value;
+    expect_to_be_false(string_to_u32("-1", &u32_value));
+    expect_to_be_true(string_to_u32("+42 apples", &u32_value));
+    expect_should_be(42, u32_value);
+
+    i64 i64_value;
+    expect_to_be_true(string_to_i64("-9223372036854775808", &i64_value));
+    b8 is_min = i64_value == (-9223372036854775807LL - 1);
+    expect_to_be_true(is_min);
+    expect_to_be_false(string_to_i64("9223372036854775808", &i64_value));
+
+    u64 u64_value;
+    expect_to_be_true(string_to_u64("18446744073709551615", &u64_value));
+    b8 is_max = u64_value == 0xFFFFFFFFFFFFFFFFULL;
+    expect_to_be_true(is_max);
+    expect_to_be_false(string_to_u64("18446744073709551616", &u64_value));
+    expect_to_be_false(string_to_u64("0x10000000000000000", &u64_value));
+    return true;
+}
+
+u8 kstring_format_n_should_stay_in_bounds() {
+    char buffer[8];
+    kset_memory(buffer, 'x', sizeof(buffer));
+    i32 length = string_format_n(buffer, 6, "%s-%d", "abc", 1234);
+    // The whole length is returned, but only what fits is written, terminated.
+    expect_should_be(8, length);
+    expect_to_be_true(strings_equal(buffer, "abc-1"));
+    expect_should_be('x', buffer[6]);
+
+    length = string_format_n(buffer, sizeof(buffer), "%u", 7);
+    expect_should_be(1, length);
+    expect_to_be_true(strings_equal(buffer, "7"));
+    expect_should_be(-1, string_format_n(buffer, 0, "%u", 7));
+    return true;
+}
+
+// The definition strings_equali is held to; lowers ASCII letters only.
+static char reference_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c | 0x20) : c;
+}
+
+static b8 reference_equali(const char* a, const char* b) {
+    while (*a && reference_lower(*a) == reference_lower(*b)) {
+        a++;
+        b++;
+    }
+    return reference_lower(*a) == reference_lower(*b);
+}
+
+// Fills in a random name, mostly letters, of up to max_length characters.
+static void random_name(u64* seed, char* out, u32 max_length) {
+    static const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_/.@[`{\xc1\xe1";
+    u32 length = next_random(seed) % (max_length + 1);
+    for (u32 i = 0; i < length; ++i) {
+        out[i] = characters[next_random(seed) % (sizeof(characters) - 1)];
+    }
+    out[length] = 0;
+}
+
+u8 kstring_should_compare_and_hash_like_reference() {
+    // Three pages, so strings can be placed to end right before a page boundary.
+    u64 page_size = 4096;
+    char* memory = kallocate(page_size * 4, MEMORY_TAG_STRING);
+    char* pages = (char*)(((u64)memory + page_size - 1) & ~(page_size - 1));
+
+    u64 seed = 1234;
+    u32 mismatches = 0;
+    char name[128];
+    for (u32 i = 0; i < ROUND_TRIP_COUNT; ++i) {
+        random_name(&seed, name, 80);
+        u64 length = strlen(name);
+        // Alternately at any offset, or so its terminator is the last byte of the first page.
+        char* a = (i & 1) ? pages + page_size - 1 - length : pages + (next_random(&seed) % 64);
+        kcopy_memory(a, name, length + 1);
+
+        // Half the time, the same name with its case changed, or a letter changed.
+        char* b = pages + page_size * 2 - 1 - length + (next_random(&seed) % 2) * 7;
+        kcopy_memory(b, name, length + 1);
+        u32 change = next_random(&seed) % 4;
+        if (length && change == 1) {
+            b[next_random(&seed) % length] ^= 0x20;
+        } else if (length && change == 2) {
+            b[next_random(&seed) % length] = '#';
+        } else if (change == 3) {
+            random_name(&seed, b, 80);
+        }
+
+        if (string_length(a) != length || string_length(b) != strlen(b)) {
+            mismatches++;
+        }
+        if (strings_equal(a, b) != (strcmp(a, b) == 0)) {
+            mismatches++;
+        }
+        b8 equali = reference_equali(a, b);
+        if (strings_equali(a, b) != equali) {
+            mismatches++;
+        }
+        if (equali && string_hashi(a) != string_hashi(b)) {
+            mismatches++;
+        }
+        if (strcmp(a, b) == 0 && string_hash(a) != string_hash(b)) {
+            mismatches++;
+        }
+    }
+    expect_should_be(0, mismatches);
+    kfree(memory, page_size * 4, MEMORY_TAG_STRING);
+
+    // Fixed, so every backend is held to the same hashes.
+    b8 known = string_hashi("") == 0x96ebbe173ff72a30ULL;
+    expect_to_be_true(known);
+    known = string_hashi("test1") == 0x74c609f806fb21d6ULL;
+    expect_to_be_true(known);
+    known = string_hashi("TEXTURES/Paving.png") == 0x2737b0f7301a0b87ULL;
+    expect_to_be_true(known);
+    known = string_hashi("0123456789abcdef") == 0xb005aee5a3412eb0ULL;
+    expect_to_be_true(known);
+    known = string_hashi("0123456789ABCDEF0123456789abcdefX") == 0x2591ac619cf41c56ULL;
+    expect_to_be_true(known);
+    b8 differs = string_hashi("test1") != string_hashi("test2");
+    expect_to_be_true(differs);
+    known = string_hash("TEXTURES/Paving.png") == 0x79601ac26c25b72fULL;
+    expect_to_be_true(known);
+    known = string_hash("0123456789ABCDEF0123456789abcdefX") == 0x885ed1a2e7610a1eULL;
+    expect_to_be_true(known);
+    // Case matters to string_hash alone, and lowercase strings hash the same either way.
+    differs = string_hash("Paving") != string_hash("paving");
+    expect_to_be_true(differs);
+    b8 same = string_hash("textures/paving.png") == string_hashi("TEXTURES/Paving.png");
+    expect_to_be_true(same);
+    return true;
+}
+
+// The hash the hashtable used before string_hash.
+static u64 byte_hash(const char* name) {
+    u64 hash = 0;
+    for (const unsigned char* us = (const unsigned char*)name; *us; us++) {
+        hash = hash * 97 + *us;
+    }
+    return hash;
+}
+
+static b8 libc_equali(const char* a, const char* b) {
+#if defined(_MSC_VER)
+    return _strcmpi(a, b) == 0;
+#else
+    return strcasecmp(a, b) == 0;
+#endif
+}
+
+// The previous string_format; formatted into a large buffer, then copied out.
+static i32 bounced_format(char* dest, const char* format, ...) {
+    char buffer[32000];
+    va_list args;
+    va_start(args, format);
+    i32 written = vsnprintf(buffer, 32000, format, args);
+    va_end(args);
+    buffer[written] = 0;
+    kcopy_memory(dest, buffer, written + 1);
+    return written;
+}
+
+u8 kstring_benchmark_against_libc() {
+    // Colours as they appear in material files.
+    char(*lines)[48] = kallocate(sizeof(char[48]) * BENCHMARK_COUNT, MEMORY_TAG_STRING);
+    u64 seed = 7;
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        string_format(lines[i], "%.3f %.3f %.3f %.3f", (next_random(&seed) % 1000) / 1000.0f, (next_random(&seed) % 1000) / 1000.0f,
+                      (next_random(&seed) % 1000) / 1000.0f, 1.0f);
+    }
+
+    // Sums are checked so neither loop can be optimized away, and both must agree.
+    f64 start = platform_get_absolute_time();
+    f32 sum = 0;
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        vec4 v;
+        sscanf(lines[i], "%f %f %f %f", &v.x, &v.y, &v.z, &v.w);
+        sum += v.x + v.y + v.z + v.w;
+    }
+    f64 sscanf_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    f32 fast_sum = 0;
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        vec4 v;
+        string_to_vec4(lines[i], &v);
+        fast_sum += v.x + v.y + v.z + v.w;
+    }
+    f64 parse_time = platform_get_absolute_time() - start;
+    b8 same_sum = sum == fast_sum;
+    expect_to_be_true(same_sum);
+
+    start = platform_get_absolute_time();
+    i32 i32_sum = 0;
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        i32_sum += (i32)strtol(lines[i] + 2, 0, 10);
+    }
+    f64 strtol_time = platform_get_absolute_time() - start;
+    start = platform_get_absolute_time();
+    i32 fast_i32_sum = 0;
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        i32 value;
+        string_to_i32(lines[i] + 2, &value);
+        fast_i32_sum += value;
+    }
+    f64 int_time = platform_get_absolute_time() - start;
+    expect_should_be(i32_sum, fast_i32_sum);
+
+    char out[128];
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        bounced_format(out, "textures/%s.%s", lines[i], "png");
+    }
+    f64 bounced_time = platform_get_absolute_time() - start;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        string_format_n(out, sizeof(out), "textures/%s.%s", lines[i], "png");
+    }
+    f64 format_time = platform_get_absolute_time() - start;
+
+    // Names as resources are acquired by; compared against a copy with its case changed.
+    char(*names)[64] = kallocate(sizeof(char[64]) * 1024, MEMORY_TAG_STRING);
+    char(*upper)[64] = kallocate(sizeof(char[64]) * 1024, MEMORY_TAG_STRING);
+    for (u32 i = 0; i < 1024; ++i) {
+        string_format(names[i], "materials/%s_%u", (i & 1) ? "paving_stones_diffuse" : "wall", i);
+        for (u32 c = 0; c <= 63; ++c) {
+            upper[i][c] = (names[i][c] >= 'a' && names[i][c] <= 'z') ? (char)(names[i][c] - 0x20) : names[i][c];
+        }
+    }
+    u64 lengths = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        lengths += strlen(names[i & 1023]);
+    }
+    f64 strlen_time = platform_get_absolute_time() - start;
+    u64 fast_lengths = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        fast_lengths += string_length(names[i & 1023]);
+    }
+    f64 length_time = platform_get_absolute_time() - start;
+    expect_should_be(lengths, fast_lengths);
+
+    u32 matches = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        matches += libc_equali(names[i & 1023], upper[i & 1023]);
+    }
+    f64 libc_equali_time = platform_get_absolute_time() - start;
+    u32 fast_matches = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        fast_matches += strings_equali(names[i & 1023], upper[i & 1023]);
+    }
+    f64 equali_time = platform_get_absolute_time() - start;
+    expect_should_be(matches, fast_matches);
+
+    u64 hashes = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        hashes ^= byte_hash(names[i & 1023]);
+    }
+    f64 byte_hash_time = platform_get_absolute_time() - start;
+    u64 fast_hashes = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < BENCHMARK_COUNT; ++i) {
+        fast_hashes ^= string_hash(names[i & 1023]);
+    }
+    f64 hash_time = platform_get_absolute_time() - start;
+    // Only so neither loop is optimized away.
+    b8 hashed = hashes != fast_hashes;
+    expect_to_be_true(hashed);
+    kfree(names, sizeof(char[64]) * 1024, MEMORY_TAG_STRING);
+    kfree(upper, sizeof(char[64]) * 1024, MEMORY_TAG_STRING);
+
+    KINFO("%u vec4s: sscanf %.3f ms, string_to_vec4 %.3f ms (%.1fx).", BENCHMARK_COUNT, sscanf_time * 1000.0, parse_time * 1000.0, sscanf_time / parse_time);
+    KINFO("%u integers: strtol %.3f ms, string_to_i32 %.3f ms (%.1fx).", BENCHMARK_COUNT, strtol_time * 1000.0, int_time * 1000.0, strtol_time / int_time);
+    KINFO("%u paths: bounced through 32 KB %.3f ms, string_format_n %.3f ms (%.1fx).", BENCHMARK_COUNT, bounced_time * 1000.0, format_time * 1000.0, bounced_time / format_time);
+    KINFO("%u names: strlen %.3f ms, string_length %.3f ms (%.1fx).", BENCHMARK_COUNT, strlen_time * 1000.0, length_time * 1000.0, strlen_time / length_time);
+    KINFO("%u names: strcasecmp %.3f ms, strings_equali %.3f ms (%.1fx).", BENCHMARK_COUNT, libc_equali_time * 1000.0, equali_time * 1000.0, libc_equali_time / equali_time);
+    KINFO("%u names: byte hash %.3f ms, string_hash %.3f ms (%.1fx).", BENCHMARK_COUNT, byte_hash_time * 1000.0, hash_time * 1000.0, byte_hash_time / hash_time);
+
+    kfree(lines, sizeof(char[48]) * BENCHMARK_COUNT, MEMORY_TAG_STRING);
+    return true;
+}
+
+void kstring_register_tests() {
+    test_manager_register_test(kstring_should_round_trip_floats, "kstring float parsing round trips");
+    test_manager_register_test(kstring_should_parse_integers_in_range, "kstring integer parsing checks range");
+    test_manager_register_test(kstring_format_n_should_stay_in_bounds, "kstring string_format_n stays in bounds");
+    test_manager_register_test(kstring_should_compare_and_hash_like_reference, "kstring compares and hashes like the reference");
+    test_manager_register_test(kstring_benchmark_against_libc, "kstring parsers and formatting against libc");
+}
@@ -0,0 +1,119 @@
+#include "lz4_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/lz4.h>
+#include <core/kmemory.h>
+
+#define TEST_DATA_SIZE 200000
+
+// Text-like data, with repeats near and far, and runs which overlap their match.
+static void fill_compressible(u8* data, u64 size) {
+    static const char* words[] = {"texture", "material", "shader", "vertex", " ", "\n", "aaaaaaaaaaaaaaaaaaaaaaaa"};
+    u64 i = 0;
+    u32 seed = 7;
+    while (i < size) {
+        seed = seed * 1103515245 + 12345;
+        const char* word = words[(seed >> 16) % 7];
+        for (const char* c = word; *c && i < size; ++c) {
+            data[i++] = (u8)*c;
+        }
+    }
+}
+
+static void fill_random(u8* data, u64 size) {
+    u32 seed = 12345;
+    for (u64 i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (u8)(seed >> 16);
+    }
+}
+
+static u32 count_differences(const u8* a, const u8* b, u64 size) {
+    u32 differences = 0;
+    for (u64 i = 0; i < size; ++i) {
+        differences += a[i] != b[i];
+    }
+    return differences;
+}
+
+u8 lz4_should_round_trip() {
+    u8* data = kallocate(TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    u64 capacity = lz4_compress_bound(TEST_DATA_SIZE);
+    u8* compressed = kallocate(capacity, MEMORY_TAG_ARRAY);
+    u8* decompressed = kallocate(TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+
+    // Compressible data shrinks, random data grows no further than the bound.
+    for (u32 pass = 0; pass < 2; ++pass) {
+        if (pass == 0) {
+            fill_compressible(data, TEST_DATA_SIZE);
+        } else {
+            fill_random(data, TEST_DATA_SIZE);
+        }
+        u64 compressed_size = lz4_compress(data, TEST_DATA_SIZE, compressed, capacity);
+        expect_should_not_be(0, compressed_size);
+        b8 shrank = compressed_size < TEST_DATA_SIZE / 2;
+        b8 should_shrink = pass == 0;
+        expect_should_be(should_shrink, shrank);
+
+        kzero_memory(decompressed, TEST_DATA_SIZE);
+        expect_to_be_true(lz4_decompress(compressed, compressed_size, decompressed, TEST_DATA_SIZE));
+        expect_should_be(0, count_differences(data, decompressed, TEST_DATA_SIZE));
+    }
+
+    // Sizes around where matches are allowed to start.
+    for (u64 size = 0; size < 40; ++size) {
+        fill_compressible(data, size);
+        u64 compressed_size = lz4_compress(data, size, compressed, capacity);
+        expect_should_not_be(0, compressed_size);
+        expect_to_be_true(lz4_decompress(compressed, compressed_size, decompressed, size));
+        expect_should_be(0, count_differences(data, decompressed, size));
+    }
+
+    // Too little room to compress into.
+    fill_random(data, TEST_DATA_SIZE);
+    expect_should_be(0, lz4_compress(data, TEST_DATA_SIZE, compressed, TEST_DATA_SIZE / 2));
+
+    kfree(data, TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    kfree(compressed, capacity, MEMORY_TAG_ARRAY);
+    kfree(decompressed, TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+u8 lz4_should_reject_malformed_blocks() {
+    u8* data = kallocate(TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    u64 capacity = lz4_compress_bound(TEST_DATA_SIZE);
+    u8* compressed = kallocate(capacity, MEMORY_TAG_ARRAY);
+    u8* decompressed = kallocate(TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+
+    fill_compressible(data, TEST_DATA_SIZE);
+    u64 compressed_size = lz4_compress(data, TEST_DATA_SIZE, compressed, capacity);
+
+    // Cut short, or the wrong size.
+    expect_to_be_false(lz4_decompress(compressed, compressed_size - 1, decompressed, TEST_DATA_SIZE));
+    expect_to_be_false(lz4_decompress(compressed, compressed_size, decompressed, TEST_DATA_SIZE - 1));
+    expect_to_be_false(lz4_decompress(compressed, compressed_size / 2, decompressed, TEST_DATA_SIZE));
+
+    // A match reaching back before the start of the output.
+    u8 bad_offset[] = {0x14, 'a', 0xFF, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+    expect_to_be_false(lz4_decompress(bad_offset, sizeof(bad_offset), decompressed, 20));
+    // A match with an offset of 0.
+    u8 zero_offset[] = {0x14, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+    expect_to_be_false(lz4_decompress(zero_offset, sizeof(zero_offset), decompressed, 20));
+    // The same with a valid offset decompresses, overlapping its match.
+    u8 valid[] = {0x14, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+    expect_to_be_true(lz4_decompress(valid, sizeof(valid), decompressed, 14));
+    expect_should_be('a', decompressed[13]);
+
+    kfree(data, TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    kfree(compressed, capacity, MEMORY_TAG_ARRAY);
+    kfree(decompressed, TEST_DATA_SIZE, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+void lz4_register_tests() {
+    test_manager_register_test(lz4_should_round_trip, "LZ4 round trips data");
+    test_manager_register_test(lz4_should_reject_malformed_blocks, "LZ4 rejects malformed blocks");
+}
@@ -0,0 +1,121 @@
+#include "perf_counters_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/perf_counters.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <platform/filesystem.h>
+
+#define TEST_CSV_PATH "perf_counters_test.tmp"
+
+u8 perf_counters_should_register_by_name() {
+    // Not initialized.
+    expect_should_be(INVALID_ID, perf_counter_register("draw calls"));
+
+    test_system system;
+    test_system_start(&system, perf_counters_initialize, perf_counters_shutdown, MEMORY_TAG_APPLICATION);
+
+    perf_counter_id draws = perf_counter_register("draw calls");
+    perf_counter_id maps = perf_counter_register("buffer maps");
+    expect_should_be(0, draws);
+    expect_should_be(1, maps);
+    expect_should_be(draws, perf_counter_register("draw calls"));
+    expect_to_be_true(strings_equal("buffer maps", perf_counter_name(maps)));
+    expect_should_be(0, perf_counter_name(2));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 perf_counters_should_snapshot_per_frame_values() {
+    test_system system;
+    test_system_start(&system, perf_counters_initialize, perf_counters_shutdown, MEMORY_TAG_APPLICATION);
+
+    perf_counter_id draws = perf_counter_register("draw calls");
+    perf_counter_id writes = perf_counter_register("descriptor writes");
+
+    u64 value = 0;
+    // Nothing snapshot yet.
+    expect_to_be_false(perf_counter_get(draws, 0, &value));
+
+    perf_counter_add(draws, 3);
+    perf_counter_add_local(writes, 2);
+    perf_counter_add_local(writes, 5);
+    perf_counters_snapshot(0);
+
+    perf_counter_add(draws, 10);
+    perf_counters_snapshot(1);
+
+    // Both the shared and the thread's own counts make up a frame.
+    expect_to_be_true(perf_counter_get(draws, 0, &value));
+    expect_should_be(10, value);
+    expect_to_be_true(perf_counter_get(writes, 0, &value));
+    expect_should_be(0, value);
+    expect_to_be_true(perf_counter_get(draws, 1, &value));
+    expect_should_be(3, value);
+    expect_to_be_true(perf_counter_get(writes, 1, &value));
+    expect_should_be(7, value);
+    expect_to_be_false(perf_counter_get(draws, 2, &value));
+
+    // Older frames fall out of the history.
+    for (u32 i = 0; i < PERF_COUNTER_HISTORY; ++i) {
+        perf_counter_add(draws, i);
+        perf_counters_snapshot(2 + i);
+    }
+    expect_to_be_true(perf_counter_get(draws, 0, &value));
+    expect_should_be(PERF_COUNTER_HISTORY - 1, value);
+    expect_to_be_true(perf_counter_get(draws, PERF_COUNTER_HISTORY - 1, &value));
+    expect_should_be(0, value);
+    expect_to_be_false(perf_counter_get(draws, PERF_COUNTER_HISTORY, &value));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 perf_counters_should_capture_csv() {
+    test_system system;
+    test_system_start(&system, perf_counters_initialize, perf_counters_shutdown, MEMORY_TAG_APPLICATION);
+
+    perf_counter_id draws = perf_counter_register("draw calls");
+    perf_counter_id maps = perf_counter_register("buffer maps");
+
+    expect_to_be_true(perf_counters_capture_begin(TEST_CSV_PATH));
+    expect_to_be_true(perf_counters_capturing());
+    // Registered after the capture started, so it has no column.
+    perf_counter_id late = perf_counter_register("late");
+
+    perf_counter_add(draws, 4);
+    perf_counter_add(late, 1);
+    perf_counters_snapshot(7);
+    perf_counter_add(maps, 2);
+    perf_counters_snapshot(8);
+    perf_counters_capture_end();
+    expect_to_be_false(perf_counters_capturing());
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_CSV_PATH, FILE_MODE_READ, false, &handle));
+    char line[64];
+    char* p = &line[0];
+    u64 length = 0;
+    expect_to_be_true(filesystem_read_line(&handle, sizeof(line), &p, &length));
+    expect_to_be_true(strings_equal(line, "frame,draw calls,buffer maps\n"));
+    expect_to_be_true(filesystem_read_line(&handle, sizeof(line), &p, &length));
+    expect_to_be_true(strings_equal(line, "7,4,0\n"));
+    expect_to_be_true(filesystem_read_line(&handle, sizeof(line), &p, &length));
+    expect_to_be_true(strings_equal(line, "8,0,2\n"));
+    filesystem_close(&handle);
+    filesystem_delete(TEST_CSV_PATH);
+
+    test_system_stop(&system);
+    return true;
+}
+
+void perf_counters_register_tests() {
+    test_manager_register_test(perf_counters_should_register_by_name, "Perf counters register once by name");
+    test_manager_register_test(perf_counters_should_snapshot_per_frame_values, "Perf counters snapshot per frame values");
+    test_manager_register_test(perf_counters_should_capture_csv, "Perf counters capture to CSV");
+}
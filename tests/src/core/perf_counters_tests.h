@@ -0,0 +1,3 @@
+#pragma once
+
+void perf_counters_register_tests();
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "profiler_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/profiler.h>
+#include <core/kmemory.h>
+#include <platform/filesystem.h>
+
+#include <string.h>
+
+#define TEST_TRACE_PATH "profiler_test.tmp"
+
+static b8 contains(const char* trace, const char* text) {
+    return strstr(trace, text) != 0;
+}
+
+// Exports the trace and reads it back as a string. Returns 0 on failure.
+static char* export_trace(u64* out_size) {
+    if (!profiler_export_chrome_trace(TEST_TRACE_PATH)) {
+        return 0;
+    }
+    file_handle handle;
+    if (!filesystem_open(TEST_TRACE_PATH, FILE_MODE_READ, true, &handle)) {
+        return 0;
+    }
+    u8* bytes = 0;
+    u64 size = 0;
+    b8 result = filesystem_read_all_bytes(&handle, &bytes, &size);
+    filesystem_close(&handle);
+    filesystem_delete(TEST_TRACE_PATH);
+    if (!result) {
+        return 0;
+    }
+
+    char* trace = kallocate(size + 1, MEMORY_TAG_STRING);
+    kcopy_memory(trace, bytes, size);
+    kfree(bytes, size, MEMORY_TAG_STRING);
+    *out_size = size + 1;
+    return trace;
+}
+
+u8 profiler_should_export_escaped_zones() {
+    test_system system;
+    test_system_start(&system, profiler_initialize, profiler_shutdown, MEMORY_TAG_APPLICATION);
+
+    profiler_zone_begin("say \"hi\" \\ bye");
+    profiler_zone_begin("new\nline");
+    profiler_zone_end();
+    profiler_zone_end();
+    // Still open when exported, so left out.
+    profiler_zone_begin("unfinished");
+    profiler_frame_mark();
+
+    u64 size = 0;
+    char* trace = export_trace(&size);
+    b8 exported = trace != 0;
+    expect_to_be_true(exported);
+
+    b8 starts_with_header = strncmp(trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39) == 0;
+    expect_to_be_true(starts_with_header);
+    expect_to_be_true(contains(trace, "\"name\":\"say \\\"hi\\\" \\\\ bye\",\"ph\":\"X\""));
+    expect_to_be_true(contains(trace, "\"name\":\"new\\u000aline\",\"ph\":\"X\""));
+    expect_to_be_false(contains(trace, "unfinished"));
+    // The thread which initialized the profiler is the main one.
+    expect_to_be_true(contains(trace, "\"args\":{\"name\":\"main\"}"));
+    expect_to_be_true(contains(trace, "\n]}"));
+
+    kfree(trace, size, MEMORY_TAG_STRING);
+    test_system_stop(&system);
+    return true;
+}
+
+u8 profiler_should_not_overwrite_open_zones() {
+    test_system system;
+    test_system_start(&system, profiler_initialize, profiler_shutdown, MEMORY_TAG_APPLICATION);
+
+    // Enough inner zones to wrap the ring while the outer one is still open.
+    profiler_zone_begin("outer");
+    for (u32 i = 0; i < PROFILER_MAX_ZONES + 10; ++i) {
+        profiler_zone_begin("inner");
+        profiler_zone_end();
+    }
+    profiler_zone_end();
+    profiler_frame_mark();
+
+    u64 size = 0;
+    char* trace = export_trace(&size);
+    b8 exported = trace != 0;
+    expect_to_be_true(exported);
+    expect_to_be_true(contains(trace, "\"name\":\"outer\",\"ph\":\"X\""));
+
+    kfree(trace, size, MEMORY_TAG_STRING);
+    test_system_stop(&system);
+    return true;
+}
+
+void profiler_register_tests() {
+    test_manager_register_test(profiler_should_export_escaped_zones, "Profiler should export escaped zones as JSON");
+    test_manager_register_test(profiler_should_not_overwrite_open_zones, "Profiler should not overwrite open zones");
+}
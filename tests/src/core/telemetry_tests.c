@@ -0,0 +1,62 @@
+#include "telemetry_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/telemetry.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+
+static telemetry_page* create_page() {
+    telemetry_page* page = kallocate(sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+    page->magic = TELEMETRY_MAGIC;
+    page->version = TELEMETRY_VERSION;
+    page->size = sizeof(telemetry_page);
+    page->sequence = 4;
+    page->frame_number = 42;
+    return page;
+}
+
+u8 telemetry_read_should_copy_consistent_page() {
+    telemetry_page* page = create_page();
+    telemetry_page* copy = kallocate(sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+
+    expect_to_be_true(telemetry_read(page, copy));
+    expect_should_be(42, copy->frame_number);
+    expect_should_be(4, copy->sequence);
+
+    // Pages of another version are rejected.
+    page->version = TELEMETRY_VERSION + 1;
+    expect_to_be_false(telemetry_read(page, copy));
+
+    kfree(copy, sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+    kfree(page, sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 telemetry_read_should_fail_while_page_is_written() {
+    telemetry_page* page = create_page();
+    telemetry_page* copy = kallocate(sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+
+    // An odd sequence means the writer is part way through.
+    page->sequence = 5;
+    expect_to_be_false(telemetry_read(page, copy));
+
+    kfree(copy, sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+    kfree(page, sizeof(telemetry_page), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 telemetry_should_name_shared_memory_after_application() {
+    char name[256];
+    telemetry_shared_memory_name("My Game/1", name);
+    expect_to_be_true(strings_equal("My_Game_1_telemetry", name));
+    return true;
+}
+
+void telemetry_register_tests() {
+    test_manager_register_test(telemetry_read_should_copy_consistent_page, "Telemetry read copies a consistent page");
+    test_manager_register_test(telemetry_read_should_fail_while_page_is_written, "Telemetry read fails while the page is written");
+    test_manager_register_test(telemetry_should_name_shared_memory_after_application, "Telemetry shared memory is named after the application");
+}
@@ -2,6 +2,25 @@
 
 #include "memory/linear_allocator_tests.h"
 #include "containers/hashtable_tests.h"
+#include "platform/filesystem_tests.h"
+#include "platform/threading_tests.h"
+#include "core/frame_stats_tests.h"
+#include "core/perf_counters_tests.h"
+#include "core/profiler_tests.h"
+#include "core/telemetry_tests.h"
+#include "core/lz4_tests.h"
+#include "core/khash_tests.h"
+#include "core/kstring_tests.h"
+#include "core/kstring_builder_tests.h"
+#include "math/kmath_tests.h"
+#include "math/transform_batch_tests.h"
+#include "math/cull_batch_tests.h"
+#include "resources/material_file_tests.h"
+#include "systems/job_system_tests.h"
+#include "systems/task_graph_tests.h"
+#include "systems/async_io_system_tests.h"
+#include "systems/vfs_system_tests.h"
+#include "systems/cooked_cache_system_tests.h"
 
 #include <core/logger.h>
 
@@ -14,6 +33,32 @@ int main() {
 
     hashtable_register_tests();
 
+    filesystem_register_tests();
+
+    threading_register_tests();
+
+    frame_stats_register_tests();
+
+    perf_counters_register_tests();
+    profiler_register_tests();
+
+    telemetry_register_tests();
+    lz4_register_tests();
+    khash_register_tests();
+    kstring_register_tests();
+    kstring_builder_register_tests();
+    kmath_register_tests();
+    transform_batch_register_tests();
+    cull_batch_register_tests();
+
+    material_file_register_tests();
+
+    job_system_register_tests();
+    task_graph_register_tests();
+    async_io_system_register_tests();
+    vfs_system_register_tests();
+    cooked_cache_system_register_tests();
+
 
     KDEBUG("Starting tests...");
 
@@ -0,0 +1,157 @@
+#include "cull_batch_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <math/kmath.h>
+#include <math/cull_batch.h>
+#include <core/kmemory.h>
+#include <systems/job_system.h>
+
+// Not a multiple of 4, so the scalar tail is covered too.
+#define BOUND_COUNT 10003
+#define MASK_WORDS ((BOUND_COUNT + 63) / 64)
+// Enough that parallel_for would need more than its maximum number of batches of the usual size.
+#define LARGE_BOUND_COUNT (JOB_SYSTEM_MAX_PARALLEL_BATCHES * 1024 + 12345)
+
+// Looking down -z from z = 30, as the renderer's test camera does.
+static frustum test_frustum() {
+    mat4 view = mat4_inverse(mat4_translation((vec3){0, 0, 30.0f}));
+    mat4 projection = mat4_perspective(deg_to_rad(45.0f), 1280 / 720.0f, 0.1f, 1000.0f);
+    return frustum_from_matrix(mat4_mul(view, projection));
+}
+
+u8 frustum_should_contain_what_the_camera_sees() {
+    frustum f = test_frustum();
+
+    // In front of the camera, behind it, and past the far plane.
+    expect_to_be_true(frustum_intersects_sphere(&f, (sphere){{0, 0, 0}, 1.0f}));
+    expect_should_be(false, frustum_intersects_sphere(&f, (sphere){{0, 0, 40.0f}, 1.0f}));
+    expect_should_be(false, frustum_intersects_sphere(&f, (sphere){{0, 0, -1100.0f}, 1.0f}));
+    // Off to the sides; 45 degrees vertically leaves about 12.4 either side of the centre at 30 away.
+    expect_should_be(false, frustum_intersects_sphere(&f, (sphere){{0, 14.0f, 0}, 1.0f}));
+    expect_should_be(false, frustum_intersects_sphere(&f, (sphere){{-25.0f, 0, 0}, 1.0f}));
+    expect_to_be_true(frustum_intersects_sphere(&f, (sphere){{0, 12.0f, 0}, 1.0f}));
+    // Straddling an edge.
+    expect_to_be_true(frustum_intersects_sphere(&f, (sphere){{0, 14.0f, 0}, 2.0f}));
+
+    expect_to_be_true(frustum_intersects_aabb(&f, (aabb){{-1, -1, -1}, {1, 1, 1}}));
+    expect_should_be(false, frustum_intersects_aabb(&f, (aabb){{-1, -1, 31.0f}, {1, 1, 33.0f}}));
+    expect_should_be(false, frustum_intersects_aabb(&f, (aabb){{-1, 13.0f, -1}, {1, 15.0f, 1}}));
+    expect_to_be_true(frustum_intersects_aabb(&f, (aabb){{-1, 12.0f, -1}, {1, 15.0f, 1}}));
+    // Around the camera.
+    expect_to_be_true(frustum_intersects_aabb(&f, (aabb){{-100, -100, -100}, {100, 100, 100}}));
+    return true;
+}
+
+u8 cull_batch_should_match_one_at_a_time() {
+    f32* memory = kallocate(sizeof(f32) * BOUND_COUNT * 10, MEMORY_TAG_ARRAY);
+    sphere_soa spheres = {{memory, memory + BOUND_COUNT, memory + BOUND_COUNT * 2}, memory + BOUND_COUNT * 3};
+    aabb_soa boxes = {
+        {memory + BOUND_COUNT * 4, memory + BOUND_COUNT * 5, memory + BOUND_COUNT * 6},
+        {memory + BOUND_COUNT * 7, memory + BOUND_COUNT * 8, memory + BOUND_COUNT * 9}};
+    for (u32 i = 0; i < BOUND_COUNT; ++i) {
+        // Spread well past the frustum on every side, so both outcomes are common.
+        spheres.center.x[i] = fkrandom_in_range(-200.0f, 200.0f);
+        spheres.center.y[i] = fkrandom_in_range(-200.0f, 200.0f);
+        spheres.center.z[i] = fkrandom_in_range(-300.0f, 100.0f);
+        spheres.radius[i] = fkrandom_in_range(0.0f, 20.0f);
+        boxes.min.x[i] = spheres.center.x[i] - spheres.radius[i];
+        boxes.min.y[i] = spheres.center.y[i] - fkrandom_in_range(0.0f, 20.0f);
+        boxes.min.z[i] = spheres.center.z[i] - fkrandom_in_range(0.0f, 20.0f);
+        boxes.max.x[i] = spheres.center.x[i] + spheres.radius[i];
+        boxes.max.y[i] = spheres.center.y[i] + fkrandom_in_range(0.0f, 20.0f);
+        boxes.max.z[i] = spheres.center.z[i] + fkrandom_in_range(0.0f, 20.0f);
+    }
+    frustum f = test_frustum();
+    u64 sphere_mask[MASK_WORDS] = {0};
+    u64 aabb_mask[MASK_WORDS] = {0};
+    u64 parallel_mask[MASK_WORDS] = {0};
+
+    // Split into uneven ranges, as jobs may be, with bits set already to be cleared.
+    kset_memory(sphere_mask, 0xFF, sizeof(sphere_mask));
+    u32 sphere_count = cull_batch_spheres(&f, spheres, 0, 3, sphere_mask);
+    sphere_count += cull_batch_spheres(&f, spheres, 3, 70, sphere_mask);
+    sphere_count += cull_batch_spheres(&f, spheres, 70, BOUND_COUNT, sphere_mask);
+    u32 aabb_count = cull_batch_aabbs(&f, boxes, 0, BOUND_COUNT, aabb_mask);
+
+    u32 sphere_mismatches = 0;
+    u32 aabb_mismatches = 0;
+    u32 expected_sphere_count = 0;
+    u32 expected_aabb_count = 0;
+    for (u32 i = 0; i < BOUND_COUNT; ++i) {
+        sphere s = {{spheres.center.x[i], spheres.center.y[i], spheres.center.z[i]}, spheres.radius[i]};
+        aabb box = {{boxes.min.x[i], boxes.min.y[i], boxes.min.z[i]}, {boxes.max.x[i], boxes.max.y[i], boxes.max.z[i]}};
+        b8 sphere_visible = frustum_intersects_sphere(&f, s);
+        b8 aabb_visible = frustum_intersects_aabb(&f, box);
+        sphere_mismatches += cull_batch_visible(sphere_mask, i) != sphere_visible;
+        aabb_mismatches += cull_batch_visible(aabb_mask, i) != aabb_visible;
+        expected_sphere_count += sphere_visible;
+        expected_aabb_count += aabb_visible;
+    }
+    expect_should_be(0, sphere_mismatches);
+    expect_should_be(0, aabb_mismatches);
+    expect_should_be(expected_sphere_count, sphere_count);
+    expect_should_be(expected_aabb_count, aabb_count);
+    // Both outcomes were tested.
+    b8 some_culled = sphere_count > BOUND_COUNT / 10 && sphere_count < BOUND_COUNT - BOUND_COUNT / 10;
+    expect_to_be_true(some_culled);
+    // Bits past the end are left alone.
+    u64 past_end = sphere_mask[MASK_WORDS - 1] >> (BOUND_COUNT % 64);
+    expect_should_be(~0ULL >> (BOUND_COUNT % 64), past_end);
+
+    u32 parallel_count = cull_batch_aabbs_parallel(&f, boxes, BOUND_COUNT, parallel_mask);
+    expect_should_be(aabb_count, parallel_count);
+    u32 parallel_mismatches = 0;
+    for (u32 i = 0; i < MASK_WORDS; ++i) {
+        parallel_mismatches += parallel_mask[i] != aabb_mask[i];
+    }
+    expect_should_be(0, parallel_mismatches);
+    parallel_count = cull_batch_spheres_parallel(&f, spheres, BOUND_COUNT, parallel_mask);
+    expect_should_be(sphere_count, parallel_count);
+
+    kfree(memory, sizeof(f32) * BOUND_COUNT * 10, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+u8 cull_batch_parallel_should_match_past_the_batch_limit() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    u32 mask_words = (LARGE_BOUND_COUNT + 63) / 64;
+    f32* memory = kallocate(sizeof(f32) * LARGE_BOUND_COUNT * 4, MEMORY_TAG_ARRAY);
+    u64* mask = kallocate(sizeof(u64) * mask_words, MEMORY_TAG_ARRAY);
+    u64* parallel_mask = kallocate(sizeof(u64) * mask_words, MEMORY_TAG_ARRAY);
+    sphere_soa spheres = {{memory, memory + LARGE_BOUND_COUNT, memory + LARGE_BOUND_COUNT * 2}, memory + LARGE_BOUND_COUNT * 3};
+    for (u32 i = 0; i < LARGE_BOUND_COUNT; ++i) {
+        spheres.center.x[i] = fkrandom_in_range(-200.0f, 200.0f);
+        spheres.center.y[i] = fkrandom_in_range(-200.0f, 200.0f);
+        spheres.center.z[i] = fkrandom_in_range(-300.0f, 100.0f);
+        spheres.radius[i] = fkrandom_in_range(0.0f, 20.0f);
+    }
+    frustum f = test_frustum();
+
+    u32 count = cull_batch_spheres(&f, spheres, 0, LARGE_BOUND_COUNT, mask);
+    u32 parallel_count = cull_batch_spheres_parallel(&f, spheres, LARGE_BOUND_COUNT, parallel_mask);
+    expect_should_be(count, parallel_count);
+    // Jobs sharing a u64 of the mask would lose each other's bits.
+    u32 mismatches = 0;
+    for (u32 i = 0; i < mask_words; ++i) {
+        mismatches += parallel_mask[i] != mask[i];
+    }
+    expect_should_be(0, mismatches);
+
+    kfree(parallel_mask, sizeof(u64) * mask_words, MEMORY_TAG_ARRAY);
+    kfree(mask, sizeof(u64) * mask_words, MEMORY_TAG_ARRAY);
+    kfree(memory, sizeof(f32) * LARGE_BOUND_COUNT * 4, MEMORY_TAG_ARRAY);
+    test_system_stop(&system);
+    return true;
+}
+
+void cull_batch_register_tests() {
+    test_manager_register_test(frustum_should_contain_what_the_camera_sees, "Frustum contains what the camera sees");
+    test_manager_register_test(cull_batch_should_match_one_at_a_time, "Cull batches match culling one at a time");
+    test_manager_register_test(cull_batch_parallel_should_match_past_the_batch_limit, "Cull batches split across jobs match past the batch limit");
+}
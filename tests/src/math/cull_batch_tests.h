@@ -0,0 +1,3 @@
+#pragma once
+
+void cull_batch_register_tests();
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "kmath_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <math/kmath.h>
+#include <containers/darray.h>
+#include <memory/linear_allocator.h>
+#include <platform/platform.h>
+
+#define MATRIX_COUNT 10000
+
+// Relative to the magnitude of the values, where that is over 1.
+static b8 close_enough(f32 a, f32 b, f32 magnitude) {
+    return kabs(a - b) <= 1e-4f * (magnitude > 1.0f ? magnitude : 1.0f);
+}
+
+// Relative to the largest element, as rounding errors are for any matrix product.
+static u32 mat4_mismatches(mat4 a, mat4 b) {
+    f32 magnitude = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        magnitude = kabs(a.data[i]) > magnitude ? kabs(a.data[i]) : magnitude;
+        magnitude = kabs(b.data[i]) > magnitude ? kabs(b.data[i]) : magnitude;
+    }
+    u32 mismatches = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        mismatches += !close_enough(a.data[i], b.data[i], magnitude);
+    }
+    return mismatches;
+}
+
+// How far m times its inverse is from the identity, summed over every element.
+static f32 inverse_error(mat4 m, mat4 inverse) {
+    mat4 identity = mat4_mul_reference(m, inverse);
+    f32 error = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        error += kabs(identity.data[i] - ((i % 5) == 0 ? 1.0f : 0.0f));
+    }
+    return error;
+}
+
+// Rotation, scale and translation, as model and view matrices are made of.
+static mat4 random_transform() {
+    mat4 rotation = mat4_euler_xyz(fkrandom_in_range(-K_PI, K_PI), fkrandom_in_range(-K_PI, K_PI), fkrandom_in_range(-K_PI, K_PI));
+    mat4 scale = mat4_scale((vec3){fkrandom_in_range(0.5f, 4.0f), fkrandom_in_range(0.5f, 4.0f), fkrandom_in_range(0.5f, 4.0f)});
+    mat4 translation = mat4_translation((vec3){fkrandom_in_range(-100.0f, 100.0f), fkrandom_in_range(-100.0f, 100.0f), fkrandom_in_range(-100.0f, 100.0f)});
+    return mat4_mul_reference(mat4_mul_reference(scale, rotation), translation);
+}
+
+u8 kmath_simd_should_match_reference() {
+    u32 mul_mismatches = 0;
+    u32 transpose_mismatches = 0;
+    u32 inverse_mismatches = 0;
+    u32 identity_mismatches = 0;
+    u32 point_mismatches = 0;
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        mat4 a = random_transform();
+        mat4 b = random_transform();
+        if (i & 1) {
+            // Projections too, as view-projection matrices are inverted to unproject.
+            b = mat4_mul_reference(b, mat4_perspective(fkrandom_in_range(0.5f, 2.0f), fkrandom_in_range(0.5f, 2.0f), 0.1f, 1000.0f));
+        }
+
+        mul_mismatches += mat4_mismatches(mat4_mul(a, b), mat4_mul_reference(a, b));
+        for (u32 j = 0; j < 16; ++j) {
+            transpose_mismatches += mat4_transposed(b).data[j] != mat4_transposed_reference(b).data[j];
+        }
+        // A far plane at 1000 leaves projections poorly conditioned, so the two inverses can
+        // differ by more than rounding while being as good as each other. Both stay within
+        // around 0.025 of the identity, so check that instead.
+        inverse_mismatches += inverse_error(b, mat4_inverse(b)) > 0.05f;
+        // Transforms alone stay within around 5e-5.
+        identity_mismatches += inverse_error(a, mat4_inverse(a)) > 1e-3f;
+
+        vec3 point = {fkrandom_in_range(-10.0f, 10.0f), fkrandom_in_range(-10.0f, 10.0f), fkrandom_in_range(-10.0f, 10.0f)};
+        vec3 transformed = mat4_transform_point(a, point);
+        vec3 expected = mat4_transform_point_reference(a, point);
+        f32 magnitude = kabs(expected.x) + kabs(expected.y) + kabs(expected.z);
+        point_mismatches += !close_enough(transformed.x, expected.x, magnitude) + !close_enough(transformed.y, expected.y, magnitude) +
+                            !close_enough(transformed.z, expected.z, magnitude);
+    }
+    expect_should_be(0, mul_mismatches);
+    expect_should_be(0, transpose_mismatches);
+    expect_should_be(0, inverse_mismatches);
+    expect_should_be(0, identity_mismatches);
+    expect_should_be(0, point_mismatches);
+
+    // A translation moves the point, and its inverse moves it back.
+    mat4 translation = mat4_translation((vec3){1.0f, 2.0f, 3.0f});
+    vec3 moved = mat4_transform_point(translation, (vec3){1.0f, 1.0f, 1.0f});
+    expect_float_to_be(2.0f, moved.x);
+    expect_float_to_be(3.0f, moved.y);
+    expect_float_to_be(4.0f, moved.z);
+    moved = mat4_transform_point(mat4_inverse(translation), moved);
+    expect_float_to_be(1.0f, moved.x);
+    expect_float_to_be(1.0f, moved.z);
+
+    vec4 sum = vec4_add(vec4_create(1.0f, 2.0f, 3.0f, 4.0f), vec4_create(0.5f, 0.5f, 0.5f, 0.5f));
+    expect_float_to_be(4.5f, sum.w);
+    vec4 quotient = vec4_div(vec4_create(1.0f, 2.0f, 3.0f, 4.0f), vec4_create(2.0f, 2.0f, 2.0f, 2.0f));
+    expect_float_to_be(1.5f, quotient.z);
+    return true;
+}
+
+u8 kmath_types_should_be_aligned() {
+    u64 alignment = _Alignof(mat4);
+    expect_should_be(16, alignment);
+    alignment = _Alignof(vec4);
+    expect_should_be(16, alignment);
+
+    // Where they are allocated from must keep them aligned too.
+    linear_allocator allocator;
+    linear_allocator_create(1024, 0, &allocator);
+    linear_allocator_allocate(&allocator, 3);
+    mat4* matrix = linear_allocator_allocate(&allocator, sizeof(mat4));
+    u64 misalignment = (u64)matrix & 15;
+    expect_should_be(0, misalignment);
+    linear_allocator_destroy(&allocator);
+
+    mat4* matrices = darray_create(mat4);
+    misalignment = (u64)matrices & 15;
+    expect_should_be(0, misalignment);
+    darray_destroy(matrices);
+    return true;
+}
+
+u8 kmath_simd_benchmark_against_reference() {
+    mat4* matrices = kallocate(sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        matrices[i] = random_transform();
+    }
+
+    // Independent inputs, each result added to a checksum so neither loop can be optimized away.
+    f64 reference_sum = 0;
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        mat4 result = mat4_inverse_reference(mat4_mul_reference(matrices[i], matrices[(i + 1) % MATRIX_COUNT]));
+        reference_sum += result.data[0] + result.data[5] + result.data[10] + result.data[15];
+    }
+    f64 reference_time = platform_get_absolute_time() - start;
+
+    f64 simd_sum = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        mat4 result = mat4_inverse(mat4_mul(matrices[i], matrices[(i + 1) % MATRIX_COUNT]));
+        simd_sum += result.data[0] + result.data[5] + result.data[10] + result.data[15];
+    }
+    f64 simd_time = platform_get_absolute_time() - start;
+
+    f64 reference_point_sum = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        vec3 point = mat4_transform_point_reference(matrices[i], (vec3){(f32)(i % 16), 2.0f, 3.0f});
+        reference_point_sum += point.x + point.y + point.z;
+    }
+    f64 reference_point_time = platform_get_absolute_time() - start;
+
+    f64 simd_point_sum = 0;
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < MATRIX_COUNT; ++i) {
+        vec3 point = mat4_transform_point(matrices[i], (vec3){(f32)(i % 16), 2.0f, 3.0f});
+        simd_point_sum += point.x + point.y + point.z;
+    }
+    f64 simd_point_time = platform_get_absolute_time() - start;
+
+    // The results are compared one by one elsewhere; the sums only need to agree to within
+    // the rounding error of that many terms.
+    expect_to_be_true(close_enough((f32)simd_sum, (f32)reference_sum, MATRIX_COUNT));
+    expect_to_be_true(close_enough((f32)simd_point_sum, (f32)reference_point_sum, MATRIX_COUNT));
+
+    KINFO("%u mat4 multiply + inverse: scalar %.3f ms, SIMD %.3f ms (%.1fx).", MATRIX_COUNT, reference_time * 1000.0, simd_time * 1000.0, reference_time / simd_time);
+    KINFO("%u point transforms: scalar %.3f ms, SIMD %.3f ms (%.1fx).", MATRIX_COUNT, reference_point_time * 1000.0, simd_point_time * 1000.0, reference_point_time / simd_point_time);
+
+    kfree(matrices, sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+void kmath_register_tests() {
+    test_manager_register_test(kmath_simd_should_match_reference, "kmath SIMD matches the scalar reference");
+    test_manager_register_test(kmath_types_should_be_aligned, "kmath types are 16 byte aligned");
+    test_manager_register_test(kmath_simd_benchmark_against_reference, "kmath SIMD against the scalar reference");
+}
@@ -0,0 +1,219 @@
+#include "transform_batch_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <math/kmath.h>
+#include <math/transform_batch.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+#include <systems/job_system.h>
+
+// Not a multiple of 4, so the scalar tail is covered too.
+#define OBJECT_COUNT 10003
+#define BENCHMARK_RUNS 5
+
+// Positions, rotations and scales, then points and their transforms; 16 arrays of floats in one block.
+typedef struct test_objects {
+    f32* memory;
+    vec3_soa positions;
+    quat_soa rotations;
+    vec3_soa scales;
+    vec3_soa points;
+    vec3_soa out_points;
+} test_objects;
+
+static void create_objects(u32 count, test_objects* out_objects) {
+    f32* memory = kallocate(sizeof(f32) * count * 16, MEMORY_TAG_ARRAY);
+    f32* arrays[16];
+    for (u32 i = 0; i < 16; ++i) {
+        arrays[i] = memory + i * count;
+    }
+    out_objects->memory = memory;
+    out_objects->positions = (vec3_soa){arrays[0], arrays[1], arrays[2]};
+    out_objects->rotations = (quat_soa){arrays[3], arrays[4], arrays[5], arrays[6]};
+    out_objects->scales = (vec3_soa){arrays[7], arrays[8], arrays[9]};
+    out_objects->points = (vec3_soa){arrays[10], arrays[11], arrays[12]};
+    out_objects->out_points = (vec3_soa){arrays[13], arrays[14], arrays[15]};
+
+    for (u32 i = 0; i < count; ++i) {
+        out_objects->positions.x[i] = fkrandom_in_range(-100.0f, 100.0f);
+        out_objects->positions.y[i] = fkrandom_in_range(-100.0f, 100.0f);
+        out_objects->positions.z[i] = fkrandom_in_range(-100.0f, 100.0f);
+        // Not normalized, as the batch must handle.
+        quat rotation = quat_from_axis_angle(vec3_normalized((vec3){fkrandom_in_range(-1.0f, 1.0f), fkrandom_in_range(-1.0f, 1.0f), 1.0f}), fkrandom_in_range(-K_PI, K_PI), false);
+        f32 length = fkrandom_in_range(0.5f, 2.0f);
+        out_objects->rotations.x[i] = rotation.x * length;
+        out_objects->rotations.y[i] = rotation.y * length;
+        out_objects->rotations.z[i] = rotation.z * length;
+        out_objects->rotations.w[i] = rotation.w * length;
+        out_objects->scales.x[i] = fkrandom_in_range(0.5f, 4.0f);
+        out_objects->scales.y[i] = fkrandom_in_range(0.5f, 4.0f);
+        out_objects->scales.z[i] = fkrandom_in_range(0.5f, 4.0f);
+        out_objects->points.x[i] = fkrandom_in_range(-10.0f, 10.0f);
+        out_objects->points.y[i] = fkrandom_in_range(-10.0f, 10.0f);
+        out_objects->points.z[i] = fkrandom_in_range(-10.0f, 10.0f);
+    }
+}
+
+static void destroy_objects(u32 count, test_objects* objects) {
+    kfree(objects->memory, sizeof(f32) * count * 16, MEMORY_TAG_ARRAY);
+}
+
+// Built one object at a time, as before there was a batch.
+static mat4 compose_reference(const test_objects* objects, u32 i) {
+    quat rotation = {objects->rotations.x[i], objects->rotations.y[i], objects->rotations.z[i], objects->rotations.w[i]};
+    mat4 scale = mat4_scale((vec3){objects->scales.x[i], objects->scales.y[i], objects->scales.z[i]});
+    mat4 translation = mat4_translation((vec3){objects->positions.x[i], objects->positions.y[i], objects->positions.z[i]});
+    return mat4_mul_reference(mat4_mul_reference(scale, quat_to_mat4(rotation)), translation);
+}
+
+// Relative to the magnitude of the values, where that is over 1.
+static b8 close_enough(f32 a, f32 b) {
+    f32 magnitude = kabs(b) > 1.0f ? kabs(b) : 1.0f;
+    return kabs(a - b) <= 1e-4f * magnitude;
+}
+
+static u32 mat4_mismatches(mat4 a, mat4 b) {
+    u32 mismatches = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        mismatches += !close_enough(a.data[i], b.data[i]);
+    }
+    return mismatches;
+}
+
+static mat4 view_projection() {
+    mat4 view = mat4_inverse(mat4_look_at((vec3){0.0f, 50.0f, 200.0f}, vec3_zero(), vec3_up()));
+    return mat4_mul(view, mat4_perspective(deg_to_rad(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+}
+
+u8 transform_batch_should_match_per_object() {
+    test_objects objects;
+    create_objects(OBJECT_COUNT, &objects);
+    mat4* world = kallocate(sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    mat4* world_view_projection = kallocate(sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    mat4 matrix = view_projection();
+
+    // Split into uneven ranges, as jobs may be.
+    transform_batch_compose(objects.positions, objects.rotations, objects.scales, 0, 5, world);
+    transform_batch_compose(objects.positions, objects.rotations, objects.scales, 5, OBJECT_COUNT, world);
+    transform_batch_mul(world, matrix, 0, OBJECT_COUNT, world_view_projection);
+    transform_batch_points(world[0], objects.points, 0, 7, objects.out_points);
+    transform_batch_points(world[0], objects.points, 7, OBJECT_COUNT, objects.out_points);
+
+    u32 compose_mismatches = 0;
+    u32 mul_mismatches = 0;
+    u32 point_mismatches = 0;
+    for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+        mat4 expected = compose_reference(&objects, i);
+        compose_mismatches += mat4_mismatches(world[i], expected);
+        mul_mismatches += mat4_mismatches(world_view_projection[i], mat4_mul_reference(world[i], matrix));
+        vec3 expected_point = mat4_transform_point_reference(world[0], (vec3){objects.points.x[i], objects.points.y[i], objects.points.z[i]});
+        point_mismatches += !close_enough(objects.out_points.x[i], expected_point.x) + !close_enough(objects.out_points.y[i], expected_point.y) +
+                            !close_enough(objects.out_points.z[i], expected_point.z);
+    }
+    expect_should_be(0, compose_mismatches);
+    expect_should_be(0, mul_mismatches);
+    expect_should_be(0, point_mismatches);
+
+    // In place.
+    mat4 expected = mat4_mul_reference(world[3], matrix);
+    transform_batch_mul(world, matrix, 0, OBJECT_COUNT, world);
+    expect_should_be(0, mat4_mismatches(world[3], expected));
+    vec3 expected_point = mat4_transform_point_reference(matrix, (vec3){objects.points.x[9], objects.points.y[9], objects.points.z[9]});
+    transform_batch_points(matrix, objects.points, 0, OBJECT_COUNT, objects.points);
+    expect_to_be_true(close_enough(objects.points.x[9], expected_point.x));
+    expect_to_be_true(close_enough(objects.points.z[9], expected_point.z));
+
+    kfree(world_view_projection, sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    kfree(world, sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    destroy_objects(OBJECT_COUNT, &objects);
+    return true;
+}
+
+// As renderer_draw_frame would build each object's matrix, with the engine's own mat4_mul.
+static void transform_per_object(const test_objects* objects, mat4 matrix, mat4* out_matrices) {
+    for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+        quat rotation = {objects->rotations.x[i], objects->rotations.y[i], objects->rotations.z[i], objects->rotations.w[i]};
+        mat4 scale = mat4_scale((vec3){objects->scales.x[i], objects->scales.y[i], objects->scales.z[i]});
+        mat4 translation = mat4_translation((vec3){objects->positions.x[i], objects->positions.y[i], objects->positions.z[i]});
+        out_matrices[i] = mat4_mul(mat4_mul(mat4_mul(scale, quat_to_mat4(rotation)), translation), matrix);
+    }
+}
+
+static void transform_batched(const test_objects* objects, mat4 matrix, mat4* out_matrices) {
+    transform_batch_compose(objects->positions, objects->rotations, objects->scales, 0, OBJECT_COUNT, out_matrices);
+    transform_batch_mul(out_matrices, matrix, 0, OBJECT_COUNT, out_matrices);
+}
+
+static void transform_batched_parallel(const test_objects* objects, mat4 matrix, mat4* out_matrices) {
+    transform_batch_compose_parallel(objects->positions, objects->rotations, objects->scales, OBJECT_COUNT, out_matrices);
+    transform_batch_mul_parallel(out_matrices, matrix, OBJECT_COUNT, out_matrices);
+}
+
+typedef void (*pfn_transform)(const test_objects* objects, mat4 matrix, mat4* out_matrices);
+
+// Best of BENCHMARK_RUNS, after a first run which warms the caches and wakes the workers.
+static f64 best_time(pfn_transform transform, const test_objects* objects, mat4 matrix, mat4* out_matrices) {
+    transform(objects, matrix, out_matrices);
+    f64 best = 0;
+    for (u32 run = 0; run < BENCHMARK_RUNS; ++run) {
+        f64 start = platform_get_absolute_time();
+        transform(objects, matrix, out_matrices);
+        f64 time = platform_get_absolute_time() - start;
+        best = (run == 0 || time < best) ? time : best;
+    }
+    return best;
+}
+
+u8 transform_batch_parallel_benchmark_against_per_object() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    test_objects objects;
+    create_objects(OBJECT_COUNT, &objects);
+    mat4* expected = kallocate(sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    mat4* world = kallocate(sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    mat4* parallel_world = kallocate(sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    mat4 matrix = view_projection();
+
+    f64 per_object_time = best_time(transform_per_object, &objects, matrix, expected);
+    f64 batch_time = best_time(transform_batched, &objects, matrix, world);
+    f64 parallel_time = best_time(transform_batched_parallel, &objects, matrix, parallel_world);
+
+    transform_batch_points_parallel(matrix, objects.points, OBJECT_COUNT, objects.out_points);
+
+    // Each object is done the same way whichever thread it lands on.
+    u32 parallel_mismatches = 0;
+    u32 expected_mismatches = 0;
+    u32 point_mismatches = 0;
+    for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+        for (u32 j = 0; j < 16; ++j) {
+            parallel_mismatches += parallel_world[i].data[j] != world[i].data[j];
+        }
+        expected_mismatches += mat4_mismatches(world[i], expected[i]);
+        vec3 expected_point = mat4_transform_point_reference(matrix, (vec3){objects.points.x[i], objects.points.y[i], objects.points.z[i]});
+        point_mismatches += !close_enough(objects.out_points.y[i], expected_point.y);
+    }
+    expect_should_be(0, parallel_mismatches);
+    expect_should_be(0, expected_mismatches);
+    expect_should_be(0, point_mismatches);
+
+    // Times only; how they compare depends on the compiler, flags and machine.
+    KINFO("%u world-view-projection matrices, best of %u: per object %.3f ms, batched %.3f ms, batched on %u threads %.3f ms.",
+          OBJECT_COUNT, BENCHMARK_RUNS, per_object_time * 1000.0, batch_time * 1000.0, job_system_worker_count() + 1, parallel_time * 1000.0);
+
+    kfree(parallel_world, sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    kfree(world, sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    kfree(expected, sizeof(mat4) * OBJECT_COUNT, MEMORY_TAG_ARRAY);
+    destroy_objects(OBJECT_COUNT, &objects);
+    test_system_stop(&system);
+    return true;
+}
+
+void transform_batch_register_tests() {
+    test_manager_register_test(transform_batch_should_match_per_object, "Transform batches match transforming one object at a time");
+    test_manager_register_test(transform_batch_parallel_benchmark_against_per_object, "Transform batches split across jobs, against one object at a time");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void transform_batch_register_tests();
\ No newline at end of file
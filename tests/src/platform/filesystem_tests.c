@@ -0,0 +1,191 @@
+#include "filesystem_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <platform/filesystem.h>
+#include <platform/kfile_watcher.h>
+#include <platform/platform.h>
+#include <memory/linear_allocator.h>
+#include <core/kstring.h>
+
+#define TEST_FILE_PATH "filesystem_test.tmp"
+
+u8 filesystem_writer_should_combine_writes() {
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle));
+
+    u8 buffer[64];
+    file_writer writer;
+    expect_to_be_true(filesystem_writer_create(&handle, sizeof(buffer), buffer, &writer));
+
+    // Small writes stay in the buffer until flushed.
+    u32 value = 0xDEADBEEF;
+    expect_to_be_true(filesystem_writer_write(&writer, sizeof(u32), &value));
+    expect_to_be_true(filesystem_writer_write_line(&writer, "line"));
+    expect_should_be(sizeof(u32) + 5, writer.used);
+
+    u64 size = 0;
+    expect_to_be_true(filesystem_size(&handle, &size));
+    expect_should_be(0, size);
+
+    // Writes larger than the buffer go straight through, after what was pending.
+    u8 large[200];
+    for (u32 i = 0; i < 200; ++i) {
+        large[i] = (u8)i;
+    }
+    expect_to_be_true(filesystem_writer_write(&writer, sizeof(large), large));
+    expect_should_be(0, writer.used);
+
+    expect_to_be_true(filesystem_writer_write_line(&writer, "end"));
+    filesystem_writer_destroy(&writer);
+    expect_to_be_true(filesystem_size(&handle, &size));
+    expect_should_be(sizeof(u32) + 5 + 200 + 4, size);
+
+    filesystem_close(&handle);
+    return true;
+}
+
+u8 filesystem_reader_should_read_lines_and_bytes() {
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_READ, true, &handle));
+
+    // A buffer smaller than the file, so reads have to refill it.
+    u8 buffer[16];
+    file_reader reader;
+    expect_to_be_true(filesystem_reader_create(&handle, sizeof(buffer), buffer, &reader));
+
+    u32 value = 0;
+    u64 read = 0;
+    expect_to_be_true(filesystem_reader_read(&reader, sizeof(u32), &value, &read));
+    expect_should_be(0xDEADBEEF, value);
+
+    char line[32];
+    u64 length = 0;
+    expect_to_be_true(filesystem_reader_read_line(&reader, sizeof(line), line, &length));
+    expect_should_be(5, length);
+    expect_to_be_true(strings_equal(line, "line\n"));
+
+    u8 large[200];
+    expect_to_be_true(filesystem_reader_read(&reader, sizeof(large), large, &read));
+    for (u32 i = 0; i < 200; ++i) {
+        expect_should_be(i, large[i]);
+    }
+
+    expect_to_be_true(filesystem_reader_read_line(&reader, sizeof(line), line, &length));
+    expect_to_be_true(strings_equal(line, "end\n"));
+    expect_to_be_false(filesystem_reader_read_line(&reader, sizeof(line), line, &length));
+
+    filesystem_reader_destroy(&reader);
+    filesystem_close(&handle);
+    return true;
+}
+
+u8 filesystem_should_read_all_bytes_into_linear_allocator() {
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_READ, true, &handle));
+
+    linear_allocator alloc;
+    linear_allocator_create(1024, 0, &alloc);
+
+    u8* bytes = 0;
+    u64 read = 0;
+    expect_to_be_true(filesystem_read_all_bytes_linear(&handle, &alloc, &bytes, &read));
+    expect_should_be(sizeof(u32) + 5 + 200 + 4, read);
+    expect_should_be(read, alloc.allocated);
+    expect_should_be(0xEF, bytes[0]);
+
+    // Does not fit.
+    u8 small[8];
+    expect_to_be_false(filesystem_read_all_bytes_into(&handle, sizeof(small), small, &read));
+
+    linear_allocator_destroy(&alloc);
+    filesystem_close(&handle);
+    expect_to_be_true(filesystem_delete(TEST_FILE_PATH));
+    expect_to_be_false(filesystem_exists(TEST_FILE_PATH));
+    // Already gone.
+    expect_to_be_false(filesystem_delete(TEST_FILE_PATH));
+    return true;
+}
+
+u8 filesystem_should_map_file_readonly() {
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle));
+    u8 data[5000];
+    for (u32 i = 0; i < sizeof(data); ++i) {
+        data[i] = (u8)(i * 7);
+    }
+    u64 written = 0;
+    expect_to_be_true(filesystem_write(&handle, sizeof(data), data, &written));
+    filesystem_close(&handle);
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map_readonly(TEST_FILE_PATH, FILE_ACCESS_HINT_SEQUENTIAL, &mapping));
+    expect_should_be(sizeof(data), mapping.size);
+    u32 wrong = 0;
+    const u8* mapped = mapping.data;
+    for (u32 i = 0; i < sizeof(data); ++i) {
+        wrong += mapped[i] != data[i];
+    }
+    expect_should_be(0, wrong);
+    filesystem_unmap(&mapping);
+    expect_should_be(0, mapping.data);
+
+    // Empty files map to nothing, rather than failing.
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle));
+    filesystem_close(&handle);
+    expect_to_be_true(filesystem_map_readonly(TEST_FILE_PATH, FILE_ACCESS_HINT_WILL_NEED, &mapping));
+    expect_should_be(0, mapping.size);
+    filesystem_unmap(&mapping);
+
+    expect_to_be_false(filesystem_map_readonly("does_not_exist.tmp", FILE_ACCESS_HINT_NORMAL, &mapping));
+    filesystem_delete(TEST_FILE_PATH);
+    return true;
+}
+
+static void on_test_file_changed(const char* path, void* user_data) {
+    if (strings_equal(path, TEST_FILE_PATH)) {
+        (*(u32*)user_data)++;
+    }
+}
+
+u8 filesystem_should_watch_for_changes() {
+    kfile_watcher watcher;
+    expect_to_be_true(kfile_watcher_create(".", &watcher));
+
+    // Nothing has changed yet.
+    u32 seen = 0;
+    kfile_watcher_poll(&watcher, on_test_file_changed, &seen);
+    expect_should_be(0, seen);
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle));
+    u64 written = 0;
+    expect_to_be_true(filesystem_write(&handle, 4, "test", &written));
+    filesystem_close(&handle);
+
+    // Changes are delivered by the OS, so may take a moment to show up.
+    for (u32 i = 0; i < 100 && seen == 0; ++i) {
+        kfile_watcher_poll(&watcher, on_test_file_changed, &seen);
+        if (seen == 0) {
+            platform_sleep(10);
+        }
+    }
+    b8 reported = seen > 0;
+    expect_to_be_true(reported);
+
+    kfile_watcher_destroy(&watcher);
+    expect_should_be(0, watcher.internal_data);
+    expect_to_be_false(kfile_watcher_create("does_not_exist", &watcher));
+    filesystem_delete(TEST_FILE_PATH);
+    return true;
+}
+
+void filesystem_register_tests() {
+    test_manager_register_test(filesystem_writer_should_combine_writes, "Filesystem writer combines small writes");
+    test_manager_register_test(filesystem_reader_should_read_lines_and_bytes, "Filesystem reader reads lines and bytes");
+    test_manager_register_test(filesystem_should_read_all_bytes_into_linear_allocator, "Filesystem reads whole file into linear allocator");
+    test_manager_register_test(filesystem_should_map_file_readonly, "Filesystem maps files read only");
+    test_manager_register_test(filesystem_should_watch_for_changes, "Filesystem watcher reports written files");
+}
@@ -0,0 +1,202 @@
+#include "threading_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <platform/kthread.h>
+#include <platform/kmutex.h>
+#include <platform/ksemaphore.h>
+#include <platform/kcondition.h>
+#include <platform/katomic.h>
+#include <platform/platform.h>
+
+#define TEST_THREAD_COUNT 4
+#define TEST_ITERATIONS 10000
+
+static u32 return_param(void* params) {
+    return *(u32*)params;
+}
+
+u8 kthread_should_return_exit_code() {
+    u32 value = 1234;
+    kthread thread;
+    expect_to_be_true(kthread_create(return_param, &value, false, &thread));
+    expect_should_not_be(0, thread.internal_data);
+
+    u32 exit_code = 0;
+    expect_to_be_true(kthread_wait(&thread, &exit_code));
+    expect_should_be(1234, exit_code);
+    expect_should_be(0, thread.internal_data);
+
+    // Already waited on.
+    expect_to_be_false(kthread_wait(&thread, &exit_code));
+    return true;
+}
+
+typedef struct counter_test {
+    kmutex mutex;
+    // Only changed under the mutex.
+    u64 locked_count;
+    // Only changed atomically.
+    volatile u64 atomic_count;
+} counter_test;
+
+static u32 count_up(void* params) {
+    counter_test* test = params;
+    for (u32 i = 0; i < TEST_ITERATIONS; ++i) {
+        kmutex_lock(&test->mutex);
+        test->locked_count++;
+        kmutex_unlock(&test->mutex);
+
+        katomic_fetch_add_u64(&test->atomic_count, 1, KATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+u8 kmutex_and_katomic_should_not_lose_updates() {
+    counter_test test = {};
+    expect_to_be_true(kmutex_create(&test.mutex));
+
+    kthread threads[TEST_THREAD_COUNT];
+    for (u32 i = 0; i < TEST_THREAD_COUNT; ++i) {
+        expect_to_be_true(kthread_create(count_up, &test, false, &threads[i]));
+    }
+    for (u32 i = 0; i < TEST_THREAD_COUNT; ++i) {
+        expect_to_be_true(kthread_wait(&threads[i], 0));
+    }
+
+    expect_should_be(TEST_THREAD_COUNT * TEST_ITERATIONS, test.locked_count);
+    expect_should_be(TEST_THREAD_COUNT * TEST_ITERATIONS, katomic_load_u64(&test.atomic_count, KATOMIC_ACQUIRE));
+
+    u32 expected = 5;
+    volatile u32 value = 5;
+    expect_to_be_true(katomic_compare_exchange_u32(&value, &expected, 7, KATOMIC_SEQ_CST));
+    expect_should_be(7, value);
+    expect_to_be_false(katomic_compare_exchange_u32(&value, &expected, 9, KATOMIC_SEQ_CST));
+    expect_should_be(7, expected);
+
+    kmutex_destroy(&test.mutex);
+    return true;
+}
+
+u8 ksemaphore_should_count_and_time_out() {
+    ksemaphore semaphore;
+    expect_to_be_true(ksemaphore_create(&semaphore, 2, 1));
+
+    expect_to_be_true(ksemaphore_wait(&semaphore, 0));
+    // Empty, so this times out.
+    f64 start = platform_get_absolute_time();
+    expect_to_be_false(ksemaphore_wait(&semaphore, 20));
+    b8 waited = (platform_get_absolute_time() - start) >= 0.015;
+    expect_to_be_true(waited);
+
+    expect_to_be_true(ksemaphore_signal(&semaphore));
+    expect_to_be_true(ksemaphore_signal(&semaphore));
+    // Past the max count.
+    expect_to_be_false(ksemaphore_signal(&semaphore));
+    expect_to_be_true(ksemaphore_wait(&semaphore, KWAIT_FOREVER));
+    expect_to_be_true(ksemaphore_wait(&semaphore, KWAIT_FOREVER));
+    expect_to_be_false(ksemaphore_wait(&semaphore, 0));
+
+    ksemaphore_destroy(&semaphore);
+    return true;
+}
+
+typedef struct queue_test {
+    kmutex mutex;
+    kcondition not_empty;
+    u32 items[TEST_ITERATIONS];
+    u32 count;
+    u32 sum;
+} queue_test;
+
+static u32 consume(void* params) {
+    queue_test* test = params;
+    u32 consumed = 0;
+    kmutex_lock(&test->mutex);
+    while (consumed < TEST_ITERATIONS) {
+        while (test->count == 0) {
+            kcondition_wait(&test->not_empty, &test->mutex, KWAIT_FOREVER);
+        }
+        test->sum += test->items[--test->count];
+        consumed++;
+    }
+    kmutex_unlock(&test->mutex);
+    return consumed;
+}
+
+u8 kcondition_should_wake_waiting_thread() {
+    // Too large for the stack.
+    static queue_test test;
+    test.count = 0;
+    test.sum = 0;
+    expect_to_be_true(kmutex_create(&test.mutex));
+    expect_to_be_true(kcondition_create(&test.not_empty));
+
+    kthread consumer;
+    expect_to_be_true(kthread_create(consume, &test, false, &consumer));
+    u32 expected_sum = 0;
+    for (u32 i = 0; i < TEST_ITERATIONS; ++i) {
+        kmutex_lock(&test.mutex);
+        test.items[test.count++] = i;
+        kcondition_signal(&test.not_empty);
+        kmutex_unlock(&test.mutex);
+        expected_sum += i;
+    }
+
+    u32 consumed = 0;
+    expect_to_be_true(kthread_wait(&consumer, &consumed));
+    expect_should_be(TEST_ITERATIONS, consumed);
+    expect_should_be(expected_sum, test.sum);
+
+    // Nobody signals, so this times out with the mutex locked again.
+    kmutex_lock(&test.mutex);
+    expect_to_be_false(kcondition_wait(&test.not_empty, &test.mutex, 10));
+    expect_to_be_true(kmutex_unlock(&test.mutex));
+
+    kcondition_destroy(&test.not_empty);
+    kmutex_destroy(&test.mutex);
+    return true;
+}
+
+static ktls_key test_key;
+static KTHREAD_LOCAL u32 test_thread_local;
+
+static u32 use_thread_local(void* params) {
+    // Every thread starts with its own zeroed value.
+    u32 result = (ktls_get(&test_key) == 0 && test_thread_local == 0) ? 1 : 0;
+    ktls_set(&test_key, params);
+    test_thread_local = 99;
+    return result && ktls_get(&test_key) == params;
+}
+
+u8 ktls_should_hold_value_per_thread() {
+    expect_to_be_true(ktls_create(&test_key));
+    u32 value = 1;
+    expect_to_be_true(ktls_set(&test_key, &value));
+    test_thread_local = 5;
+
+    u32 other = 2;
+    kthread thread;
+    expect_to_be_true(kthread_create(use_thread_local, &other, false, &thread));
+    u32 exit_code = 0;
+    expect_to_be_true(kthread_wait(&thread, &exit_code));
+    expect_should_be(1, exit_code);
+
+    // Untouched by the other thread.
+    expect_should_be(&value, ktls_get(&test_key));
+    expect_should_be(5, test_thread_local);
+    expect_should_not_be(0, kthread_current_id());
+
+    ktls_destroy(&test_key);
+    return true;
+}
+
+void threading_register_tests() {
+    test_manager_register_test(kthread_should_return_exit_code, "Thread returns its exit code when waited on");
+    test_manager_register_test(kmutex_and_katomic_should_not_lose_updates, "Mutex and atomics do not lose concurrent updates");
+    test_manager_register_test(ksemaphore_should_count_and_time_out, "Semaphore counts up to its max and times out");
+    test_manager_register_test(kcondition_should_wake_waiting_thread, "Condition variable wakes a waiting thread");
+    test_manager_register_test(ktls_should_hold_value_per_thread, "Thread local storage holds a value per thread");
+}
@@ -0,0 +1,69 @@
+#include "material_file_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <resources/material_file.h>
+#include <core/kstring.h>
+
+static const char* test_text =
+    "#material file\n"
+    "\n"
+    "version=0.1\n"
+    "name = test_material\r\n"
+    "diffuse_colour=0.5 0.25 1.0 1.0\n"
+    "not a key\n"
+    "diffuse_map_name=paving";
+
+u8 material_file_should_parse_text() {
+    material_config config;
+    expect_to_be_true(material_file_parse_text(test_text, string_length(test_text), "test.kmt", &config));
+    expect_to_be_true(strings_equal(config.name, "test_material"));
+    expect_to_be_true(strings_equal(config.diffuse_map_name, "paving"));
+    expect_float_to_be(0.5f, config.diffuse_colour.r);
+    expect_float_to_be(0.25f, config.diffuse_colour.g);
+    expect_float_to_be(1.0f, config.diffuse_colour.b);
+    expect_to_be_true(config.auto_release);
+
+    // Missing keys keep their defaults.
+    const char* empty = "name=empty";
+    expect_to_be_true(material_file_parse_text(empty, string_length(empty), "empty.kmt", &config));
+    expect_to_be_true(strings_equal(config.diffuse_map_name, ""));
+    expect_float_to_be(1.0f, config.diffuse_colour.r);
+    return true;
+}
+
+u8 material_file_should_round_trip_binary() {
+    material_config config;
+    expect_to_be_true(material_file_parse_text(test_text, string_length(test_text), "test.kmt", &config));
+    config.auto_release = false;
+
+    material_binary binary;
+    material_file_to_binary(&config, &binary);
+    expect_should_be(MATERIAL_BINARY_MAGIC, binary.magic);
+
+    material_config read;
+    expect_to_be_true(material_file_parse_binary(&binary, sizeof(binary), "test.kmb", &read));
+    expect_to_be_true(strings_equal(read.name, config.name));
+    expect_to_be_true(strings_equal(read.diffuse_map_name, config.diffuse_map_name));
+    expect_float_to_be(config.diffuse_colour.r, read.diffuse_colour.r);
+    expect_float_to_be(config.diffuse_colour.g, read.diffuse_colour.g);
+    expect_float_to_be(config.diffuse_colour.b, read.diffuse_colour.b);
+    expect_float_to_be(config.diffuse_colour.a, read.diffuse_colour.a);
+    expect_to_be_false(read.auto_release);
+
+    // Truncated files, other files and other versions are rejected.
+    expect_to_be_false(material_file_parse_binary(&binary, sizeof(binary) - 1, "test.kmb", &read));
+    binary.version++;
+    expect_to_be_false(material_file_parse_binary(&binary, sizeof(binary), "test.kmb", &read));
+    binary.version--;
+    binary.magic = 0;
+    expect_to_be_false(material_file_parse_binary(&binary, sizeof(binary), "test.kmb", &read));
+    return true;
+}
+
+void material_file_register_tests() {
+    test_manager_register_test(material_file_should_parse_text, "Material file parses text materials");
+    test_manager_register_test(material_file_should_round_trip_binary, "Material file round trips binary materials");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void material_file_register_tests();
\ No newline at end of file
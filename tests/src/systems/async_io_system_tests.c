@@ -0,0 +1,168 @@
+#include "async_io_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <systems/job_system.h>
+#include <systems/async_io_system.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+
+#define TEST_FILE_PATH "async_io_test.tmp"
+#define TEST_FILE_SIZE 100000
+// Longest the tests wait on callbacks, in seconds.
+#define TEST_TIMEOUT 5.0
+
+typedef struct async_io_test {
+    test_system jobs;
+    u64 io_size;
+    void* io_state;
+} async_io_test;
+
+static void start_systems(async_io_test* test, b8 disable_kernel_queue) {
+    test_job_system_start(&test->jobs, 2);
+
+    async_io_system_config io_config;
+    io_config.disable_kernel_queue = disable_kernel_queue;
+    async_io_system_initialize(&test->io_size, 0, io_config);
+    test->io_state = kallocate(test->io_size, MEMORY_TAG_FILE);
+    async_io_system_initialize(&test->io_size, test->io_state, io_config);
+}
+
+static void stop_systems(async_io_test* test) {
+    async_io_system_shutdown(test->io_state);
+    kfree(test->io_state, test->io_size, MEMORY_TAG_FILE);
+    test_system_stop(&test->jobs);
+}
+
+static b8 write_test_file() {
+    file_handle handle;
+    if (!filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle)) {
+        return false;
+    }
+    u8* data = kallocate(TEST_FILE_SIZE, MEMORY_TAG_FILE);
+    for (u32 i = 0; i < TEST_FILE_SIZE; ++i) {
+        data[i] = (u8)(i * 31 + 7);
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&handle, TEST_FILE_SIZE, data, &written);
+    filesystem_close(&handle);
+    kfree(data, TEST_FILE_SIZE, MEMORY_TAG_FILE);
+    return result;
+}
+
+// Number of bytes which do not hold the test file's contents, as if read from offset.
+static u32 count_wrong_bytes(const u8* data, u64 size, u64 offset) {
+    u32 wrong = 0;
+    for (u64 i = 0; i < size; ++i) {
+        wrong += data[i] != (u8)((offset + i) * 31 + 7);
+    }
+    return wrong;
+}
+
+u8 async_io_should_complete_polled_reads() {
+    expect_to_be_true(write_test_file());
+
+    // Through the kernel queue where there is one, and on workers.
+    for (u32 pass = 0; pass < 2; ++pass) {
+        async_io_test test;
+        start_systems(&test, pass == 1);
+        if (pass == 1) {
+            expect_to_be_false(async_io_uses_kernel_queue());
+        }
+
+        u8 range[1000];
+        async_read_request requests[3] = {};
+        requests[0].path = TEST_FILE_PATH;
+        requests[1].path = TEST_FILE_PATH;
+        requests[1].offset = 5000;
+        requests[1].size = sizeof(range);
+        requests[1].buffer = range;
+        requests[2].path = "does_not_exist.tmp";
+        async_read_handle handles[3];
+        expect_to_be_true(async_io_submit(requests, 3, handles));
+
+        expect_should_be(ASYNC_READ_COMPLETE, async_io_wait(handles[0]));
+        expect_should_be(ASYNC_READ_COMPLETE, async_io_wait(handles[1]));
+        expect_should_be(ASYNC_READ_FAILED, async_io_wait(handles[2]));
+
+        async_read_result result;
+        expect_to_be_true(async_io_result(handles[0], &result));
+        expect_to_be_true(result.succeeded);
+        expect_should_be(TEST_FILE_SIZE, result.size);
+        expect_should_be(0, count_wrong_bytes(result.data, result.size, 0));
+
+        expect_to_be_true(async_io_result(handles[1], &result));
+        expect_should_be(sizeof(range), result.size);
+        expect_should_be((void*)range, result.data);
+        expect_should_be(0, count_wrong_bytes(range, sizeof(range), 5000));
+
+        for (u32 i = 0; i < 3; ++i) {
+            async_io_release(handles[i]);
+        }
+        stop_systems(&test);
+    }
+
+    filesystem_delete(TEST_FILE_PATH);
+    return true;
+}
+
+typedef struct callback_test {
+    u32 calls;
+    u32 wrong_bytes;
+    u64 total_size;
+} callback_test;
+
+static void on_read(const async_read_result* result) {
+    callback_test* test = result->user_data;
+    test->calls++;
+    if (result->succeeded) {
+        test->wrong_bytes += count_wrong_bytes(result->data, result->size, 0);
+        test->total_size += result->size;
+    }
+}
+
+u8 async_io_should_call_back_on_update() {
+    expect_to_be_true(write_test_file());
+
+    for (u32 pass = 0; pass < 2; ++pass) {
+        async_io_test test;
+        start_systems(&test, pass == 1);
+
+        callback_test callbacks = {0};
+        async_read_request requests[8] = {};
+        for (u32 i = 0; i < 8; ++i) {
+            requests[i].path = TEST_FILE_PATH;
+            requests[i].callback = on_read;
+            requests[i].user_data = &callbacks;
+        }
+        expect_to_be_true(async_io_submit(requests, 8, 0));
+
+        // Callbacks only happen on update, as they would once a frame.
+        f64 start = platform_get_absolute_time();
+        while (callbacks.calls < 8 && platform_get_absolute_time() - start < TEST_TIMEOUT) {
+            async_io_system_update();
+            platform_sleep(1);
+        }
+        expect_should_be(8, callbacks.calls);
+        expect_should_be(0, callbacks.wrong_bytes);
+        expect_should_be(TEST_FILE_SIZE * 8, callbacks.total_size);
+
+        // Reads left in flight are cleaned up on shutdown, without callbacks.
+        expect_to_be_true(async_io_submit(requests, 8, 0));
+        stop_systems(&test);
+        b8 no_late_calls = callbacks.calls == 8;
+        expect_to_be_true(no_late_calls);
+    }
+
+    filesystem_delete(TEST_FILE_PATH);
+    return true;
+}
+
+void async_io_system_register_tests() {
+    test_manager_register_test(async_io_should_complete_polled_reads, "Async IO completes polled reads");
+    test_manager_register_test(async_io_should_call_back_on_update, "Async IO calls back on update");
+}
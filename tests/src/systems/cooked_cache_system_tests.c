@@ -0,0 +1,123 @@
+#include "cooked_cache_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <systems/cooked_cache_system.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <platform/filesystem.h>
+
+#define TEST_TYPE "cooktest"
+#define TEST_SOURCE "source bytes"
+
+u8 cooked_cache_should_store_and_map() {
+    u64 key = cooked_cache_key(TEST_SOURCE, sizeof(TEST_SOURCE), 1);
+
+    // Nothing is cached before the system is started.
+    file_mapping mapping;
+    expect_to_be_false(cooked_cache_map(TEST_TYPE, key, &mapping));
+    expect_to_be_false(cooked_cache_store(TEST_TYPE, key, "h", 1, "d", 1));
+
+    cooked_cache_config config;
+    config.cache_directory = ".";
+    config.max_size = 0;
+    u64 size = 0;
+    cooked_cache_system_initialize(&size, 0, config);
+    void* state = kallocate(size, MEMORY_TAG_FILE);
+    expect_to_be_true(cooked_cache_system_initialize(&size, state, config));
+
+    expect_to_be_false(cooked_cache_map(TEST_TYPE, key, &mapping));
+    u32 header = 0xC00CED;
+    u8 data[3000];
+    for (u32 i = 0; i < sizeof(data); ++i) {
+        data[i] = (u8)(i * 13);
+    }
+    expect_to_be_true(cooked_cache_store(TEST_TYPE, key, &header, sizeof(header), data, sizeof(data)));
+
+    // Stored as the header, then the data.
+    expect_to_be_true(cooked_cache_map(TEST_TYPE, key, &mapping));
+    expect_should_be(sizeof(header) + sizeof(data), mapping.size);
+    expect_should_be(header, *(const u32*)mapping.data);
+    const u8* mapped = (const u8*)mapping.data + sizeof(header);
+    u32 wrong = 0;
+    for (u32 i = 0; i < sizeof(data); ++i) {
+        wrong += mapped[i] != data[i];
+    }
+    expect_should_be(0, wrong);
+    filesystem_unmap(&mapping);
+
+    // An edited source, or a new version of its cooker, misses.
+    u64 edited_key = cooked_cache_key("source byteZ", sizeof(TEST_SOURCE), 1);
+    u64 version_key = cooked_cache_key(TEST_SOURCE, sizeof(TEST_SOURCE), 2);
+    expect_should_not_be(key, edited_key);
+    expect_should_not_be(key, version_key);
+    expect_to_be_false(cooked_cache_map(TEST_TYPE, edited_key, &mapping));
+    expect_to_be_false(cooked_cache_map(TEST_TYPE, version_key, &mapping));
+
+    cooked_cache_system_shutdown(state);
+    kfree(state, size, MEMORY_TAG_FILE);
+
+    char path[64];
+    string_format(path, "./%016llx.%s", key, TEST_TYPE);
+    filesystem_delete(path);
+    return true;
+}
+
+static void* start_cache(u64 max_size, u64* out_size) {
+    cooked_cache_config config;
+    config.cache_directory = ".";
+    config.max_size = max_size;
+    cooked_cache_system_initialize(out_size, 0, config);
+    void* state = kallocate(*out_size, MEMORY_TAG_FILE);
+    cooked_cache_system_initialize(out_size, state, config);
+    return state;
+}
+
+u8 cooked_cache_should_trim_at_startup() {
+    u64 size = 0;
+    void* state = start_cache(0, &size);
+    u8 data[1000] = {0};
+    u64 keys[3];
+    for (u32 i = 0; i < 3; ++i) {
+        keys[i] = cooked_cache_key(&i, sizeof(i), 1);
+        expect_to_be_true(cooked_cache_store(TEST_TYPE, keys[i], 0, 0, data, sizeof(data)));
+    }
+    cooked_cache_system_shutdown(state);
+    kfree(state, size, MEMORY_TAG_FILE);
+
+    // As a store cut short would leave behind.
+    char temp_path[96];
+    string_format(temp_path, "./%016llx.%s.0123456789abcdef.tmp", keys[0], TEST_TYPE);
+    file_handle handle;
+    expect_to_be_true(filesystem_open(temp_path, FILE_MODE_WRITE, true, &handle));
+    filesystem_close(&handle);
+
+    // Room for two of the three.
+    state = start_cache(2500, &size);
+    expect_to_be_false(filesystem_exists(temp_path));
+    u32 cached = 0;
+    for (u32 i = 0; i < 3; ++i) {
+        file_mapping mapping;
+        if (cooked_cache_map(TEST_TYPE, keys[i], &mapping)) {
+            cached++;
+            filesystem_unmap(&mapping);
+        }
+    }
+    expect_should_be(2, cached);
+    cooked_cache_system_shutdown(state);
+    kfree(state, size, MEMORY_TAG_FILE);
+
+    for (u32 i = 0; i < 3; ++i) {
+        char path[64];
+        string_format(path, "./%016llx.%s", keys[i], TEST_TYPE);
+        filesystem_delete(path);
+    }
+    return true;
+}
+
+void cooked_cache_system_register_tests() {
+    test_manager_register_test(cooked_cache_should_store_and_map, "Cooked cache stores and maps by source hash");
+    test_manager_register_test(cooked_cache_should_trim_at_startup, "Cooked cache removes leftovers and trims to its size at startup");
+}
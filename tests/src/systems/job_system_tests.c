@@ -0,0 +1,116 @@
+#include "job_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <systems/job_system.h>
+#include <core/kmemory.h>
+#include <platform/katomic.h>
+
+#define TEST_JOB_COUNT 2000
+#define TEST_RANGE_SIZE 100000
+
+static void increment(void* params) {
+    katomic_fetch_add_u32((volatile u32*)params, 1, KATOMIC_RELAXED);
+}
+
+u8 job_system_should_run_every_submitted_job() {
+    test_system system;
+    test_job_system_start(&system, 4);
+    expect_should_be(4, job_system_worker_count());
+
+    volatile u32 run_count = 0;
+    job_info jobs[TEST_JOB_COUNT];
+    for (u32 i = 0; i < TEST_JOB_COUNT; ++i) {
+        jobs[i].entry_point = increment;
+        jobs[i].params = (void*)&run_count;
+        jobs[i].priority = (job_priority)(i % JOB_PRIORITY_COUNT);
+    }
+
+    // More than fit in the queues, so some run right away.
+    job_counter counter = {0};
+    job_system_submit(jobs, TEST_JOB_COUNT, &counter);
+    job_system_submit(jobs, TEST_JOB_COUNT, &counter);
+    job_system_wait(&counter);
+    expect_to_be_true(job_counter_done(&counter));
+    expect_should_be(TEST_JOB_COUNT * 2, run_count);
+
+    test_system_stop(&system);
+    return true;
+}
+
+static void mark_range(u32 begin, u32 end, void* params) {
+    u8* hits = params;
+    for (u32 i = begin; i < end; ++i) {
+        hits[i]++;
+    }
+}
+
+u8 job_system_parallel_for_should_cover_range_once() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    u8* hits = kallocate(TEST_RANGE_SIZE, MEMORY_TAG_JOB);
+    job_system_parallel_for(TEST_RANGE_SIZE, 0, mark_range, hits, JOB_PRIORITY_HIGH);
+    job_system_parallel_for(TEST_RANGE_SIZE, 7, mark_range, hits, JOB_PRIORITY_NORMAL);
+    u32 wrong = 0;
+    for (u32 i = 0; i < TEST_RANGE_SIZE; ++i) {
+        wrong += hits[i] != 2;
+    }
+    expect_should_be(0, wrong);
+
+    kfree(hits, TEST_RANGE_SIZE, MEMORY_TAG_JOB);
+    test_system_stop(&system);
+    return true;
+}
+
+typedef struct nested_test {
+    volatile u32 run_count;
+} nested_test;
+
+static void spawn_and_wait(void* params) {
+    nested_test* test = params;
+    job_info jobs[8];
+    for (u32 i = 0; i < 8; ++i) {
+        jobs[i].entry_point = increment;
+        jobs[i].params = (void*)&test->run_count;
+        jobs[i].priority = JOB_PRIORITY_HIGH;
+    }
+    job_counter counter = {0};
+    job_system_submit(jobs, 8, &counter);
+    job_system_wait(&counter);
+}
+
+u8 job_system_should_let_jobs_wait_on_jobs() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    nested_test test = {0};
+    job_info jobs[16];
+    for (u32 i = 0; i < 16; ++i) {
+        jobs[i].entry_point = spawn_and_wait;
+        jobs[i].params = &test;
+        jobs[i].priority = JOB_PRIORITY_LOW;
+    }
+    job_counter counter = {0};
+    job_system_submit(jobs, 16, &counter);
+    job_system_wait(&counter);
+    expect_should_be(16 * 8, test.run_count);
+
+    test_system_stop(&system);
+
+    // Not initialized, so jobs run on submit.
+    job_counter inline_counter = {0};
+    job_system_submit(jobs, 1, &inline_counter);
+    expect_to_be_true(job_counter_done(&inline_counter));
+    expect_should_be(16 * 8 + 8, test.run_count);
+    return true;
+}
+
+void job_system_register_tests() {
+    test_manager_register_test(job_system_should_run_every_submitted_job, "Job system runs every submitted job");
+    test_manager_register_test(job_system_parallel_for_should_cover_range_once, "Job system parallel_for covers each index once");
+    test_manager_register_test(job_system_should_let_jobs_wait_on_jobs, "Job system lets jobs wait on jobs");
+}
@@ -0,0 +1,186 @@
+#include "task_graph_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <systems/job_system.h>
+#include <systems/task_graph.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+#include <platform/kthread.h>
+#include <platform/katomic.h>
+
+#include <stdio.h>
+
+#define TEST_GRAPH_RUNS 50
+
+typedef struct order_test {
+    volatile u32 sequence;
+    u32 order[8];
+    u64 thread_ids[8];
+} order_test;
+
+typedef struct order_task {
+    order_test* test;
+    u32 index;
+    u32 sleep_ms;
+    b8 result;
+} order_task;
+
+static b8 record_order(void* params) {
+    order_task* t = params;
+    if (t->sleep_ms > 0) {
+        platform_sleep(t->sleep_ms);
+    }
+    t->test->order[t->index] = katomic_fetch_add_u32(&t->test->sequence, 1, KATOMIC_RELAXED);
+    t->test->thread_ids[t->index] = kthread_current_id();
+    return t->result;
+}
+
+u8 task_graph_should_order_tasks_by_resource_access() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    task_graph* graph = kallocate(sizeof(task_graph), MEMORY_TAG_JOB);
+    order_test test;
+    order_task tasks[5];
+    for (u32 run = 0; run < TEST_GRAPH_RUNS; ++run) {
+        kzero_memory(&test, sizeof(order_test));
+        for (u32 i = 0; i < 5; ++i) {
+            tasks[i].test = &test;
+            tasks[i].index = i;
+            tasks[i].sleep_ms = 0;
+            tasks[i].result = true;
+        }
+
+        task_graph_reset(graph);
+        task_id a = task_graph_add(graph, "write", record_order, &tasks[0], TASK_FLAG_NONE);
+        task_graph_writes(graph, a, "x");
+        task_id b = task_graph_add(graph, "read 1", record_order, &tasks[1], TASK_FLAG_NONE);
+        task_graph_reads(graph, b, "x");
+        task_id c = task_graph_add(graph, "read 2", record_order, &tasks[2], TASK_FLAG_NONE);
+        task_graph_reads(graph, c, "x");
+        task_id d = task_graph_add(graph, "write again", record_order, &tasks[3], TASK_FLAG_NONE);
+        task_graph_writes(graph, d, "x");
+        task_id e = task_graph_add(graph, "read on main", record_order, &tasks[4], TASK_FLAG_MAIN_THREAD);
+        task_graph_reads(graph, e, "x");
+
+        expect_to_be_true(task_graph_execute(graph));
+        expect_should_be(5, test.sequence);
+
+        // Readers wait on the writer, and the next writer on both readers; the readers are free to overlap.
+        b8 ordered = test.order[a] < test.order[b] && test.order[a] < test.order[c] &&
+                     test.order[b] < test.order[d] && test.order[c] < test.order[d] && test.order[d] < test.order[e];
+        expect_to_be_true(ordered);
+        expect_should_be(kthread_current_id(), test.thread_ids[e]);
+    }
+
+    expect_should_be(0, graph->tasks[0].dependencies);
+    expect_should_be(1ULL << 0, graph->tasks[1].dependencies);
+    expect_should_be(1ULL << 0, graph->tasks[2].dependencies);
+    u64 writer_dependencies = (1ULL << 0) | (1ULL << 1) | (1ULL << 2);
+    expect_should_be(writer_dependencies, graph->tasks[3].dependencies);
+    expect_should_be(1ULL << 3, graph->tasks[4].dependencies);
+
+    kfree(graph, sizeof(task_graph), MEMORY_TAG_JOB);
+    test_system_stop(&system);
+    return true;
+}
+
+u8 task_graph_should_skip_tasks_after_a_failure() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    task_graph* graph = kallocate(sizeof(task_graph), MEMORY_TAG_JOB);
+    order_test test = {0};
+    order_task tasks[3];
+    for (u32 i = 0; i < 3; ++i) {
+        tasks[i].test = &test;
+        tasks[i].index = i;
+        tasks[i].sleep_ms = 0;
+        tasks[i].result = i != 0;
+    }
+
+    task_graph_reset(graph);
+    task_id failing = task_graph_add(graph, "failing", record_order, &tasks[0], TASK_FLAG_NONE);
+    task_id dependent = task_graph_add(graph, "dependent", record_order, &tasks[1], TASK_FLAG_MAIN_THREAD);
+    task_graph_depends_on(graph, dependent, failing);
+    task_id independent = task_graph_add(graph, "independent", record_order, &tasks[2], TASK_FLAG_NONE);
+
+    expect_to_be_false(task_graph_execute(graph));
+    // The failing and independent tasks ran, the dependent one did not.
+    expect_should_be(2, test.sequence);
+    expect_to_be_false(graph->tasks[dependent].succeeded);
+    expect_to_be_true(graph->tasks[independent].succeeded);
+
+    // A dependency on a later task would allow cycles, so is refused.
+    task_graph_reset(graph);
+    task_id first = task_graph_add(graph, "first", record_order, &tasks[1], TASK_FLAG_NONE);
+    task_id second = task_graph_add(graph, "second", record_order, &tasks[2], TASK_FLAG_NONE);
+    task_graph_depends_on(graph, first, second);
+    expect_to_be_true(graph->invalid);
+    expect_to_be_false(task_graph_execute(graph));
+
+    kfree(graph, sizeof(task_graph), MEMORY_TAG_JOB);
+    test_system_stop(&system);
+    return true;
+}
+
+u8 task_graph_should_find_critical_path() {
+    test_system system;
+    test_job_system_start(&system, 4);
+
+    task_graph* graph = kallocate(sizeof(task_graph), MEMORY_TAG_JOB);
+    order_test test = {0};
+    order_task tasks[4];
+    u32 sleeps[4] = {1, 20, 1, 1};
+    for (u32 i = 0; i < 4; ++i) {
+        tasks[i].test = &test;
+        tasks[i].index = i;
+        tasks[i].sleep_ms = sleeps[i];
+        tasks[i].result = true;
+    }
+
+    // A diamond, where the slow side is the critical one.
+    task_graph_reset(graph);
+    task_id a = task_graph_add(graph, "a", record_order, &tasks[0], TASK_FLAG_NONE);
+    task_graph_writes(graph, a, "x");
+    task_id slow = task_graph_add(graph, "slow", record_order, &tasks[1], TASK_FLAG_NONE);
+    task_graph_reads(graph, slow, "x");
+    task_graph_writes(graph, slow, "y");
+    task_id fast = task_graph_add(graph, "fast", record_order, &tasks[2], TASK_FLAG_NONE);
+    task_graph_reads(graph, fast, "x");
+    task_graph_writes(graph, fast, "z");
+    task_id d = task_graph_add(graph, "d", record_order, &tasks[3], TASK_FLAG_MAIN_THREAD);
+    task_graph_reads(graph, d, "y");
+    task_graph_reads(graph, d, "z");
+    expect_to_be_true(task_graph_execute(graph));
+
+    task_id path[TASK_GRAPH_MAX_TASKS];
+    u32 path_count = 0;
+    f64 path_time = task_graph_critical_path(graph, path, &path_count);
+    expect_should_be(3, path_count);
+    expect_should_be(a, path[0]);
+    expect_should_be(slow, path[1]);
+    expect_should_be(d, path[2]);
+    b8 plausible = path_time >= 0.020 && path_time <= graph->execute_time;
+    expect_to_be_true(plausible);
+
+    const char* dump_path = "task_graph_test.dot";
+    expect_to_be_true(task_graph_dump(graph, dump_path));
+    expect_to_be_true(filesystem_exists(dump_path));
+    remove(dump_path);
+
+    kfree(graph, sizeof(task_graph), MEMORY_TAG_JOB);
+    test_system_stop(&system);
+    return true;
+}
+
+void task_graph_register_tests() {
+    test_manager_register_test(task_graph_should_order_tasks_by_resource_access, "Task graph orders tasks by resource access");
+    test_manager_register_test(task_graph_should_skip_tasks_after_a_failure, "Task graph skips tasks after a failure");
+    test_manager_register_test(task_graph_should_find_critical_path, "Task graph finds the critical path");
+}
@@ -0,0 +1,300 @@
+#include "vfs_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <systems/vfs_system.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <core/lz4.h>
+#include <systems/job_system.h>
+#include <platform/filesystem.h>
+
+#define TEST_PACK_PATH "vfs_test.kpak"
+// Also written loose, relative to the working directory, with other contents.
+#define TEST_TEXT_PATH "vfs_test_asset.txt"
+#define TEST_TEXT "packed text"
+#define TEST_LOOSE_TEXT "loose text"
+#define TEST_BINARY_PATH "binaries/vfs_test.bin"
+#define TEST_BINARY_SIZE 5000
+#define TEST_COMPRESSED_PATH "binaries/vfs_test.lz4"
+#define TEST_COMPRESSED_SIZE (ASSET_PACK_CHUNK_SIZE * 3 + 1000)
+#define TEST_COMPRESSED_CAPACITY (TEST_COMPRESSED_SIZE * 2)
+
+static b8 write_file(const char* path, u64 size, const void* data) {
+    file_handle handle;
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &handle)) {
+        return false;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&handle, size, data, &written);
+    filesystem_close(&handle);
+    return result;
+}
+
+// Made of three chunks which compress well, and a short one which does not.
+static u8 compressed_file_byte(u64 i) {
+    return i < ASSET_PACK_CHUNK_SIZE * 3 ? (u8)((i % 1000) / 4) : (u8)((i * 2654435761U) >> 24);
+}
+
+// Compresses the compressed file as "tools pack" would.
+static u8* compress_test_file(u64* out_stored_size) {
+    u64 chunk_count = (TEST_COMPRESSED_SIZE + ASSET_PACK_CHUNK_SIZE - 1) / ASSET_PACK_CHUNK_SIZE;
+    u8* data = kallocate(TEST_COMPRESSED_SIZE, MEMORY_TAG_FILE);
+    for (u64 i = 0; i < TEST_COMPRESSED_SIZE; ++i) {
+        data[i] = compressed_file_byte(i);
+    }
+    u8* stored = kallocate(TEST_COMPRESSED_CAPACITY, MEMORY_TAG_FILE);
+    u32* chunk_sizes = (u32*)stored;
+    u64 offset = chunk_count * sizeof(u32);
+    for (u64 i = 0; i < chunk_count; ++i) {
+        u64 chunk_start = i * ASSET_PACK_CHUNK_SIZE;
+        u64 chunk_size = TEST_COMPRESSED_SIZE - chunk_start < ASSET_PACK_CHUNK_SIZE ? TEST_COMPRESSED_SIZE - chunk_start : ASSET_PACK_CHUNK_SIZE;
+        u64 compressed_size = lz4_compress(data + chunk_start, chunk_size, stored + offset, TEST_COMPRESSED_CAPACITY - offset);
+        if (compressed_size == 0 || compressed_size >= chunk_size) {
+            kcopy_memory(stored + offset, data + chunk_start, chunk_size);
+            compressed_size = chunk_size;
+        }
+        chunk_sizes[i] = (u32)compressed_size;
+        offset += compressed_size;
+    }
+    kfree(data, TEST_COMPRESSED_SIZE, MEMORY_TAG_FILE);
+    *out_stored_size = offset;
+    return stored;
+}
+
+// Writes a pack as "tools pack" would, holding the text, binary and compressed files.
+static b8 write_test_pack() {
+    u64 compressed_size = 0;
+    u8* compressed = compress_test_file(&compressed_size);
+
+    const char* paths[3] = {TEST_TEXT_PATH, TEST_BINARY_PATH, TEST_COMPRESSED_PATH};
+    u64 sizes[3] = {sizeof(TEST_TEXT) - 1, TEST_BINARY_SIZE, TEST_COMPRESSED_SIZE};
+    u64 stored_sizes[3] = {sizes[0], sizes[1], compressed_size};
+    // The binary file spans two pages.
+    u64 offsets[3] = {ASSET_PACK_ALIGNMENT, ASSET_PACK_ALIGNMENT * 2, ASSET_PACK_ALIGNMENT * 4};
+    u64 string_table_size = 0;
+    for (u32 i = 0; i < 3; ++i) {
+        string_table_size += string_length(paths[i]) + 1;
+    }
+    u64 pack_size = offsets[2] + compressed_size;
+    u8* pack = kallocate(pack_size, MEMORY_TAG_FILE);
+
+    asset_pack_header* header = (asset_pack_header*)pack;
+    header->magic = ASSET_PACK_MAGIC;
+    header->version = ASSET_PACK_VERSION;
+    header->entry_count = 3;
+    header->string_table_size = (u32)string_table_size;
+
+    // The directory is sorted by hash.
+    u32 order[3] = {0, 1, 2};
+    for (u32 i = 1; i < 3; ++i) {
+        for (u32 j = i; j > 0 && vfs_hash_path(paths[order[j - 1]]) > vfs_hash_path(paths[order[j]]); --j) {
+            u32 swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+    asset_pack_entry* entries = (asset_pack_entry*)(header + 1);
+    char* string_table = (char*)(entries + 3);
+    u32 path_offset = 0;
+    for (u32 i = 0; i < 3; ++i) {
+        u32 source = order[i];
+        entries[i].hash = vfs_hash_path(paths[source]);
+        entries[i].offset = offsets[source];
+        entries[i].size = sizes[source];
+        entries[i].stored_size = stored_sizes[source];
+        entries[i].path_offset = path_offset;
+        entries[i].flags = source == 2 ? ASSET_PACK_ENTRY_FLAG_LZ4 : ASSET_PACK_ENTRY_FLAG_NONE;
+        string_copy(string_table + path_offset, paths[source]);
+        path_offset += string_length(paths[source]) + 1;
+    }
+
+    kcopy_memory(pack + offsets[0], TEST_TEXT, sizes[0]);
+    for (u32 i = 0; i < TEST_BINARY_SIZE; ++i) {
+        pack[offsets[1] + i] = (u8)(i * 13 + 1);
+    }
+    kcopy_memory(pack + offsets[2], compressed, compressed_size);
+    kfree(compressed, TEST_COMPRESSED_CAPACITY, MEMORY_TAG_FILE);
+
+    b8 result = write_file(TEST_PACK_PATH, pack_size, pack);
+    kfree(pack, pack_size, MEMORY_TAG_FILE);
+    return result;
+}
+
+static b8 contents_equal(const void* data, const char* text, u64 size) {
+    for (u64 i = 0; i < size; ++i) {
+        if (((const char*)data)[i] != text[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct vfs_test {
+    u64 size;
+    void* state;
+} vfs_test;
+
+static b8 start_vfs(vfs_test* test, const char* pack_path, b8 prefer_loose_files) {
+    vfs_system_config config;
+    config.asset_directory = ".";
+    config.pack_path = pack_path;
+    config.prefer_loose_files = prefer_loose_files;
+    config.watch_for_changes = false;
+    vfs_system_initialize(&test->size, 0, config);
+    test->state = kallocate(test->size, MEMORY_TAG_FILE);
+    return vfs_system_initialize(&test->size, test->state, config);
+}
+
+static void stop_vfs(vfs_test* test) {
+    vfs_system_shutdown(test->state);
+    kfree(test->state, test->size, MEMORY_TAG_FILE);
+}
+
+u8 vfs_should_read_files_from_pack() {
+    expect_to_be_true(write_test_pack());
+    vfs_test test;
+    expect_to_be_true(start_vfs(&test, TEST_PACK_PATH, false));
+
+    file_mapping mapping;
+    expect_to_be_true(vfs_map(TEST_BINARY_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    expect_should_be(TEST_BINARY_SIZE, mapping.size);
+    // Entries start on their own pages.
+    u64 misalignment = (u64)mapping.data % ASSET_PACK_ALIGNMENT;
+    expect_should_be(0, misalignment);
+    u32 wrong = 0;
+    for (u32 i = 0; i < TEST_BINARY_SIZE; ++i) {
+        wrong += ((const u8*)mapping.data)[i] != (u8)(i * 13 + 1);
+    }
+    expect_should_be(0, wrong);
+    // Only forgotten, as the pack stays mapped.
+    vfs_unmap(&mapping);
+    b8 unmapped = mapping.data == 0;
+    expect_to_be_true(unmapped);
+
+    expect_to_be_true(vfs_map(TEST_TEXT_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    expect_should_be(sizeof(TEST_TEXT) - 1, mapping.size);
+    expect_to_be_true(contents_equal(mapping.data, TEST_TEXT, mapping.size));
+    vfs_unmap(&mapping);
+
+    // Found for reading elsewhere, i.e. by the async IO system.
+    vfs_location location;
+    expect_to_be_true(vfs_locate(TEST_BINARY_PATH, &location));
+    expect_to_be_true(strings_equal(location.file_path, TEST_PACK_PATH));
+    expect_should_be(ASSET_PACK_ALIGNMENT * 2, location.offset);
+    expect_should_be(TEST_BINARY_SIZE, location.size);
+
+    expect_to_be_false(vfs_exists("binaries/missing.bin"));
+    expect_to_be_false(vfs_map("binaries/missing.bin", FILE_ACCESS_HINT_NORMAL, &mapping));
+
+    stop_vfs(&test);
+    filesystem_delete(TEST_PACK_PATH);
+    return true;
+}
+
+u8 vfs_should_fall_back_to_loose_files() {
+    expect_to_be_true(write_test_pack());
+    expect_to_be_true(write_file(TEST_TEXT_PATH, sizeof(TEST_LOOSE_TEXT) - 1, TEST_LOOSE_TEXT));
+
+    // Loose files first, as in development.
+    vfs_test test;
+    expect_to_be_true(start_vfs(&test, TEST_PACK_PATH, true));
+    file_mapping mapping;
+    expect_to_be_true(vfs_map(TEST_TEXT_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    expect_to_be_true(contents_equal(mapping.data, TEST_LOOSE_TEXT, sizeof(TEST_LOOSE_TEXT) - 1));
+    vfs_unmap(&mapping);
+    // Files only in the pack are still found.
+    expect_to_be_true(vfs_exists(TEST_BINARY_PATH));
+    stop_vfs(&test);
+
+    // The pack first.
+    expect_to_be_true(start_vfs(&test, TEST_PACK_PATH, false));
+    expect_to_be_true(vfs_map(TEST_TEXT_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    expect_to_be_true(contents_equal(mapping.data, TEST_TEXT, sizeof(TEST_TEXT) - 1));
+    vfs_unmap(&mapping);
+    stop_vfs(&test);
+
+    // Without a valid pack, only loose files.
+    expect_to_be_true(write_file(TEST_PACK_PATH, 5, "KPAK!"));
+    expect_to_be_true(start_vfs(&test, TEST_PACK_PATH, false));
+    expect_to_be_true(vfs_exists(TEST_TEXT_PATH));
+    expect_to_be_false(vfs_exists(TEST_BINARY_PATH));
+    vfs_location location;
+    expect_to_be_true(vfs_locate(TEST_TEXT_PATH, &location));
+    expect_should_be(0, location.offset);
+    expect_should_be(0, location.size);
+    stop_vfs(&test);
+
+    filesystem_delete(TEST_PACK_PATH);
+    filesystem_delete(TEST_TEXT_PATH);
+    return true;
+}
+
+u8 vfs_should_decompress_files_in_parallel() {
+    expect_to_be_true(write_test_pack());
+    // Chunks are decompressed across the workers.
+    test_system jobs;
+    test_job_system_start(&jobs, 2);
+    vfs_test test;
+    expect_to_be_true(start_vfs(&test, TEST_PACK_PATH, false));
+
+    u64 size = 0;
+    expect_to_be_true(vfs_size(TEST_COMPRESSED_PATH, &size));
+    expect_should_be(TEST_COMPRESSED_SIZE, size);
+
+    // Straight into the destination, as it would be a staging buffer.
+    u8* buffer = kallocate(TEST_COMPRESSED_SIZE, MEMORY_TAG_FILE);
+    u64 read = 0;
+    expect_to_be_false(vfs_read(TEST_COMPRESSED_PATH, TEST_COMPRESSED_SIZE - 1, buffer, &read));
+    expect_to_be_true(vfs_read(TEST_COMPRESSED_PATH, TEST_COMPRESSED_SIZE, buffer, &read));
+    expect_should_be(TEST_COMPRESSED_SIZE, read);
+    u32 wrong = 0;
+    for (u64 i = 0; i < TEST_COMPRESSED_SIZE; ++i) {
+        wrong += buffer[i] != compressed_file_byte(i);
+    }
+    expect_should_be(0, wrong);
+
+    file_mapping mapping;
+    expect_to_be_true(vfs_map(TEST_COMPRESSED_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    expect_should_be(TEST_COMPRESSED_SIZE, mapping.size);
+    wrong = 0;
+    for (u64 i = 0; i < TEST_COMPRESSED_SIZE; ++i) {
+        wrong += ((const u8*)mapping.data)[i] != compressed_file_byte(i);
+    }
+    expect_should_be(0, wrong);
+    vfs_unmap(&mapping);
+
+    // Read elsewhere, then decompressed.
+    vfs_location location;
+    expect_to_be_true(vfs_locate(TEST_COMPRESSED_PATH, &location));
+    expect_to_be_true(location.compressed);
+    expect_should_be(TEST_COMPRESSED_SIZE, location.uncompressed_size);
+    b8 smaller = location.size < TEST_COMPRESSED_SIZE;
+    expect_to_be_true(smaller);
+    expect_to_be_true(vfs_map(TEST_COMPRESSED_PATH, FILE_ACCESS_HINT_NORMAL, &mapping));
+    kzero_memory(buffer, TEST_COMPRESSED_SIZE);
+    file_mapping pack;
+    expect_to_be_true(filesystem_map_readonly(TEST_PACK_PATH, FILE_ACCESS_HINT_NORMAL, &pack));
+    const u8* stored = (const u8*)pack.data + location.offset;
+    expect_to_be_true(vfs_decompress(stored, location.size, buffer, TEST_COMPRESSED_SIZE));
+    expect_to_be_true(contents_equal(buffer, mapping.data, TEST_COMPRESSED_SIZE));
+    // Malformed, as if cut short.
+    expect_to_be_false(vfs_decompress(stored, location.size - 1, buffer, TEST_COMPRESSED_SIZE));
+    filesystem_unmap(&pack);
+    vfs_unmap(&mapping);
+
+    kfree(buffer, TEST_COMPRESSED_SIZE, MEMORY_TAG_FILE);
+    stop_vfs(&test);
+    test_system_stop(&jobs);
+    filesystem_delete(TEST_PACK_PATH);
+    return true;
+}
+
+void vfs_system_register_tests() {
+    test_manager_register_test(vfs_should_read_files_from_pack, "VFS reads files from a pack");
+    test_manager_register_test(vfs_should_fall_back_to_loose_files, "VFS falls back to loose files");
+    test_manager_register_test(vfs_should_decompress_files_in_parallel, "VFS decompresses files in parallel");
+}
@@ -0,0 +1,30 @@
+#include "test_systems.h"
+
+#include <systems/job_system.h>
+
+void test_system_start(test_system* system, PFN_test_system_initialize initialize, PFN_test_system_shutdown shutdown, memory_tag tag) {
+    system->size = 0;
+    system->tag = tag;
+    system->shutdown = shutdown;
+    initialize(&system->size, 0);
+    system->state = kallocate(system->size, tag);
+    initialize(&system->size, system->state);
+}
+
+void test_job_system_start(test_system* system, u32 worker_count) {
+    job_system_config config;
+    config.worker_count = worker_count;
+    system->size = 0;
+    system->tag = MEMORY_TAG_JOB;
+    system->shutdown = job_system_shutdown;
+    job_system_initialize(&system->size, 0, config);
+    system->state = kallocate(system->size, MEMORY_TAG_JOB);
+    job_system_initialize(&system->size, system->state, config);
+}
+
+void test_system_stop(test_system* system) {
+    system->shutdown(system->state);
+    kfree(system->state, system->size, system->tag);
+    system->state = 0;
+    system->size = 0;
+}
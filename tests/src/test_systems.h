@@ -0,0 +1,33 @@
+#pragma once
+
+#include <defines.h>
+#include <core/kmemory.h>
+
+typedef b8 (*PFN_test_system_initialize)(u64* memory_requirement, void* state);
+typedef void (*PFN_test_system_shutdown)(void* state);
+
+/**
+ * @brief A subsystem started for the length of a single test.
+ */
+typedef struct test_system {
+    void* state;
+    u64 size;
+    memory_tag tag;
+    PFN_test_system_shutdown shutdown;
+} test_system;
+
+/**
+ * @brief Sizes, allocates and initializes a subsystem using the usual
+ * two-phase initialize call.
+ */
+void test_system_start(test_system* system, PFN_test_system_initialize initialize, PFN_test_system_shutdown shutdown, memory_tag tag);
+
+/**
+ * @brief Starts the job system with the given number of workers.
+ */
+void test_job_system_start(test_system* system, u32 worker_count);
+
+/**
+ * @brief Shuts down and frees a subsystem started by one of the functions above.
+ */
+void test_system_stop(test_system* system);
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "log_decoder.h"
+
+#include <core/logger.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <containers/darray.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+
+static const char* level_strings[6] = {
+    "[FATAL]",
+    "[ERROR]",
+    "[WARN]",
+    "[INFO]",
+    "[DEBUG]",
+    "[TRACE]"};
+
+// Reads size bytes at offset from a buffer of buffer_size bytes, advancing offset. False if out of range.
+static b8 read_bytes(const u8* buffer, u64 buffer_size, u64* offset, void* out, u64 size) {
+    if (*offset + size > buffer_size) {
+        return false;
+    }
+    kcopy_memory(out, buffer + *offset, size);
+    *offset += size;
+    return true;
+}
+
+i32 log_decoder_run(i32 argc, char** argv) {
+    if (argc < 1) {
+        printf("Usage: tools decode_log <input.klog> [output.log]\n");
+        return 1;
+    }
+
+    file_handle input;
+    if (!filesystem_open(argv[0], FILE_MODE_READ, true, &input)) {
+        printf("Unable to open '%s' for reading.\n", argv[0]);
+        return 2;
+    }
+    u8* bytes = 0;
+    u64 size = 0;
+    b8 read = filesystem_read_all_bytes(&input, &bytes, &size);
+    filesystem_close(&input);
+    if (!read) {
+        printf("Unable to read '%s'.\n", argv[0]);
+        return 2;
+    }
+
+    file_handle output;
+    file_writer writer;
+    b8 to_file = argc > 1;
+    if (to_file) {
+        if (!filesystem_open(argv[1], FILE_MODE_WRITE, false, &output)) {
+            printf("Unable to open '%s' for writing.\n", argv[1]);
+            kfree(bytes, size, MEMORY_TAG_STRING);
+            return 2;
+        }
+        filesystem_writer_create(&output, 65536, 0, &writer);
+    }
+
+    i32 result = 0;
+    u64 offset = 0;
+    log_binary_header header;
+    if (!read_bytes(bytes, size, &offset, &header, sizeof(log_binary_header)) || header.magic != LOG_BINARY_MAGIC) {
+        printf("'%s' is not a binary log.\n", argv[0]);
+        result = 3;
+    } else if (header.version != LOG_BINARY_VERSION) {
+        printf("Unsupported binary log version %u (expected %u).\n", header.version, LOG_BINARY_VERSION);
+        result = 3;
+    }
+
+    // Format strings, indexed by id.
+    char** formats = darray_create(char*);
+    char* message = kallocate(32000, MEMORY_TAG_STRING);
+    char* line = kallocate(32000, MEMORY_TAG_STRING);
+    u64 message_count = 0;
+
+    while (result == 0 && offset < size) {
+        u8 type = 0;
+        read_bytes(bytes, size, &offset, &type, sizeof(u8));
+
+        if (type == LOG_BINARY_RECORD_FORMAT) {
+            u32 id = 0;
+            u32 length = 0;
+            if (!read_bytes(bytes, size, &offset, &id, sizeof(u32)) ||
+                !read_bytes(bytes, size, &offset, &length, sizeof(u32)) ||
+                offset + length > size) {
+                printf("Truncated format record at offset %llu.\n", offset);
+                break;
+            }
+
+            char* format = kallocate(length + 1, MEMORY_TAG_STRING);
+            kcopy_memory(format, bytes + offset, length);
+            offset += length;
+
+            char* empty = 0;
+            while (darray_length(formats) <= id) {
+                darray_push(formats, empty);
+            }
+            formats[id] = format;
+        } else if (type == LOG_BINARY_RECORD_MESSAGE) {
+            u8 channel = 0;
+            u8 level = 0;
+            f64 timestamp = 0;
+            u32 id = 0;
+            u32 argument_size = 0;
+            if (!read_bytes(bytes, size, &offset, &channel, sizeof(u8)) ||
+                !read_bytes(bytes, size, &offset, &level, sizeof(u8)) ||
+                !read_bytes(bytes, size, &offset, &timestamp, sizeof(f64)) ||
+                !read_bytes(bytes, size, &offset, &id, sizeof(u32)) ||
+                !read_bytes(bytes, size, &offset, &argument_size, sizeof(u32)) ||
+                offset + argument_size > size) {
+                printf("Truncated message record at offset %llu.\n", offset);
+                break;
+            }
+
+            const char* format = id < darray_length(formats) ? formats[id] : 0;
+            if (!format) {
+                string_format(message, "<unknown format id %u>", id);
+            } else {
+                log_format_packed(format, bytes + offset, argument_size, message, 32000);
+            }
+            offset += argument_size;
+
+            const char* level_string = level_strings[level < 6 ? level : LOG_LEVEL_TRACE];
+            if (channel == LOG_CHANNEL_GENERAL) {
+                snprintf(line, 32000, "[%.6f]%s: %s", timestamp, level_string, message);
+            } else {
+                snprintf(line, 32000, "[%.6f]%s[%s]: %s", timestamp, level_string, log_channel_name(channel), message);
+            }
+            if (to_file) {
+                filesystem_writer_write_line(&writer, line);
+            } else {
+                printf("%s\n", line);
+            }
+            message_count++;
+        } else {
+            printf("Unknown record type %u at offset %llu.\n", type, offset - 1);
+            result = 3;
+        }
+    }
+
+    if (to_file) {
+        filesystem_writer_destroy(&writer);
+        filesystem_close(&output);
+        printf("Decoded %llu messages to '%s'.\n", message_count, argv[1]);
+    }
+
+    u64 format_count = darray_length(formats);
+    for (u64 i = 0; i < format_count; ++i) {
+        if (formats[i]) {
+            kfree(formats[i], string_length(formats[i]) + 1, MEMORY_TAG_STRING);
+        }
+    }
+    darray_destroy(formats);
+    kfree(message, 32000, MEMORY_TAG_STRING);
+    kfree(line, 32000, MEMORY_TAG_STRING);
+    kfree(bytes, size, MEMORY_TAG_STRING);
+    return result;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Decodes a binary log (console.klog) written by the logger in binary
+ * mode back into text.
+ *
+ * @param argc The number of arguments. Expects <input.klog> [output.log].
+ * @param argv The arguments.
+ * @return 0 on success; otherwise a non-zero error code.
+ */
+i32 log_decoder_run(i32 argc, char** argv);
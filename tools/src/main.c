@@ -0,0 +1,49 @@
+#include "log_decoder.h"
+#include "telemetry_viewer.h"
+#include "pack_builder.h"
+#include "material_compiler.h"
+
+#include <defines.h>
+#include <core/kstring.h>
+
+#include <stdio.h>
+
+typedef struct tool_command {
+    const char* name;
+    const char* usage;
+    i32 (*run)(i32 argc, char** argv);
+} tool_command;
+
+static tool_command commands[] = {
+    {"decode_log", "decode_log <input.klog> [output.log]", log_decoder_run},
+    {"telemetry", "telemetry <application name> [refresh count]", telemetry_viewer_run},
+    {"pack", "pack <asset directory> <output.kpak> [--no-compress]", pack_builder_run},
+    {"compile_material", "compile_material <input.kmt | directory> [output.kmb]", material_compiler_run},
+};
+
+static void print_usage() {
+    printf("Usage: tools <command> [arguments]\nCommands:\n");
+    u32 count = sizeof(commands) / sizeof(tool_command);
+    for (u32 i = 0; i < count; ++i) {
+        printf("  %s\n", commands[i].usage);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+
+    u32 count = sizeof(commands) / sizeof(tool_command);
+    for (u32 i = 0; i < count; ++i) {
+        if (strings_equali(argv[1], commands[i].name)) {
+            // Pass the command its own arguments only.
+            return commands[i].run(argc - 2, argv + 2);
+        }
+    }
+
+    printf("Unknown command '%s'.\n", argv[1]);
+    print_usage();
+    return 1;
+}
@@ -0,0 +1,101 @@
+#include "material_compiler.h"
+
+#include <core/kstring.h>
+#include <platform/filesystem.h>
+#include <resources/material_file.h>
+
+#include <stdio.h>
+
+typedef struct compile_walk {
+    const char* directory;
+    u32 compiled;
+    b8 failed;
+} compile_walk;
+
+static b8 compile_material(const char* input_path, const char* output_path) {
+    file_mapping mapping;
+    if (!filesystem_map_readonly(input_path, FILE_ACCESS_HINT_SEQUENTIAL, &mapping)) {
+        printf("Unable to read '%s'.\n", input_path);
+        return false;
+    }
+    material_config config;
+    b8 parsed = material_file_parse_text(mapping.data, mapping.size, input_path, &config);
+    filesystem_unmap(&mapping);
+    if (!parsed) {
+        printf("Unable to parse '%s'.\n", input_path);
+        return false;
+    }
+    if (!config.name[0]) {
+        printf("'%s' has no name.\n", input_path);
+        return false;
+    }
+
+    material_binary binary;
+    material_file_to_binary(&config, &binary);
+    file_handle output;
+    if (!filesystem_open(output_path, FILE_MODE_WRITE, true, &output)) {
+        printf("Unable to open '%s' for writing.\n", output_path);
+        return false;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&output, sizeof(material_binary), &binary, &written);
+    filesystem_close(&output);
+    if (!result) {
+        printf("Unable to write '%s'.\n", output_path);
+        return false;
+    }
+    printf("%s -> %s\n", input_path, output_path);
+    return true;
+}
+
+// Swaps the text extension for the binary one.
+static b8 binary_path(const char* input_path, char* out_path, u64 capacity) {
+    u64 length = string_length(input_path);
+    u64 extension_length = string_length(MATERIAL_TEXT_EXTENSION);
+    if (length <= extension_length || !strings_equal(input_path + length - extension_length, MATERIAL_TEXT_EXTENSION)) {
+        return false;
+    }
+    i32 written = snprintf(out_path, capacity, "%.*s%s", (i32)(length - extension_length), input_path, MATERIAL_BINARY_EXTENSION);
+    return written > 0 && (u64)written < capacity;
+}
+
+static b8 on_directory_entry(const char* name, b8 is_directory, void* user_data) {
+    compile_walk* walk = user_data;
+    char input_path[512];
+    char output_path[512];
+    snprintf(input_path, sizeof(input_path), "%s/%s", walk->directory, name);
+    if (is_directory || !binary_path(input_path, output_path, sizeof(output_path))) {
+        return true;
+    }
+    if (compile_material(input_path, output_path)) {
+        walk->compiled++;
+    } else {
+        walk->failed = true;
+    }
+    return true;
+}
+
+i32 material_compiler_run(i32 argc, char** argv) {
+    if (argc < 1) {
+        printf("Usage: tools compile_material <input.kmt | directory> [output.kmb]\n");
+        return 1;
+    }
+
+    // A directory is compiled file by file; listing fails for anything else.
+    compile_walk walk = {};
+    walk.directory = argv[0];
+    if (filesystem_list_directory(argv[0], on_directory_entry, &walk)) {
+        printf("Compiled %u materials.\n", walk.compiled);
+        return walk.failed ? 2 : 0;
+    }
+
+    char output_path[512];
+    if (argc > 1) {
+        string_ncopy(output_path, argv[1], sizeof(output_path) - 1);
+        output_path[sizeof(output_path) - 1] = 0;
+    } else if (!binary_path(argv[0], output_path, sizeof(output_path))) {
+        printf("'%s' is not a .%s file; give an output path.\n", argv[0], MATERIAL_TEXT_EXTENSION);
+        return 1;
+    }
+    return compile_material(argv[0], output_path) ? 0 : 2;
+}
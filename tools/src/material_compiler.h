@@ -0,0 +1,14 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Compiles text materials (.kmt) to binary ones (.kmb), which the engine
+ * reads in place of the text when both exist. Given a directory, compiles every
+ * text material in it, writing each binary alongside.
+ *
+ * @param argc The number of arguments. Expects <input.kmt | directory> [output.kmb].
+ * @param argv The arguments.
+ * @return 0 on success; otherwise a non-zero error code.
+ */
+i32 material_compiler_run(i32 argc, char** argv);
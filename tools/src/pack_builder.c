@@ -0,0 +1,272 @@
+#include "pack_builder.h"
+
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <core/lz4.h>
+#include <containers/darray.h>
+#include <platform/filesystem.h>
+#include <systems/vfs_system.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct pack_source {
+    // Relative to the asset directory, with forward slashes.
+    char* path;
+    u64 hash;
+    u64 size;
+    // The entry as stored, when compressed. Otherwise the file is copied in as is.
+    u8* stored;
+    u64 stored_size;
+    u64 stored_capacity;
+} pack_source;
+
+typedef struct pack_walk {
+    const char* root;
+    // The directory being listed, relative to root. Empty for root itself.
+    char relative[VFS_MAX_PATH_LENGTH];
+    pack_source** sources;
+    b8 failed;
+} pack_walk;
+
+static b8 walk_directory(pack_walk* walk);
+
+static b8 on_directory_entry(const char* name, b8 is_directory, void* user_data) {
+    pack_walk* walk = user_data;
+    char relative[VFS_MAX_PATH_LENGTH];
+    i32 length = snprintf(relative, VFS_MAX_PATH_LENGTH, "%s%s%s", walk->relative, walk->relative[0] ? "/" : "", name);
+    if (length < 0 || length >= VFS_MAX_PATH_LENGTH) {
+        printf("Path too long to pack: '%s/%s'.\n", walk->relative, name);
+        walk->failed = true;
+        return false;
+    }
+
+    if (is_directory) {
+        pack_walk child = *walk;
+        string_ncopy(child.relative, relative, VFS_MAX_PATH_LENGTH);
+        b8 result = walk_directory(&child);
+        walk->failed = child.failed;
+        return result;
+    }
+
+    // Do not pack a previous pack, i.e. when writing it inside the directory.
+    u64 name_length = string_length(name);
+    if (name_length > 5 && strings_equal(name + name_length - 5, ".kpak")) {
+        return true;
+    }
+
+    pack_source source = {};
+    source.path = string_duplicate(relative);
+    source.hash = vfs_hash_path(relative);
+    darray_push(*walk->sources, source);
+    return true;
+}
+
+static b8 walk_directory(pack_walk* walk) {
+    char directory[VFS_MAX_PATH_LENGTH * 2];
+    string_format(directory, "%s%s%s", walk->root, walk->relative[0] ? "/" : "", walk->relative);
+    if (!filesystem_list_directory(directory, on_directory_entry, walk)) {
+        printf("Unable to list directory '%s'.\n", directory);
+        walk->failed = true;
+    }
+    return !walk->failed;
+}
+
+// The order of the directory; by hash, then by path for entries sharing one.
+static int compare_sources(const void* a, const void* b) {
+    const pack_source* left = a;
+    const pack_source* right = b;
+    if (left->hash != right->hash) {
+        return left->hash < right->hash ? -1 : 1;
+    }
+    const char* l = left->path;
+    const char* r = right->path;
+    while (*l && *l == *r) {
+        l++;
+        r++;
+    }
+    return (i32)(u8)*l - (i32)(u8)*r;
+}
+
+// Compresses a file in chunks, keeping the result only if it is worth decompressing on load.
+static void compress_source(const u8* data, pack_source* source) {
+    u64 chunk_count = (source->size + ASSET_PACK_CHUNK_SIZE - 1) / ASSET_PACK_CHUNK_SIZE;
+    u64 capacity = chunk_count * sizeof(u32) + chunk_count * lz4_compress_bound(ASSET_PACK_CHUNK_SIZE);
+    u8* stored = kallocate(capacity, MEMORY_TAG_FILE);
+    u32* chunk_sizes = (u32*)stored;
+    u64 offset = chunk_count * sizeof(u32);
+    for (u64 i = 0; i < chunk_count; ++i) {
+        u64 chunk_start = i * ASSET_PACK_CHUNK_SIZE;
+        u64 chunk_size = source->size - chunk_start < ASSET_PACK_CHUNK_SIZE ? source->size - chunk_start : ASSET_PACK_CHUNK_SIZE;
+        u64 compressed_size = lz4_compress(data + chunk_start, chunk_size, stored + offset, capacity - offset);
+        if (compressed_size == 0 || compressed_size >= chunk_size) {
+            // Stored as is, which the reader tells from its size.
+            kcopy_memory(stored + offset, data + chunk_start, chunk_size);
+            compressed_size = chunk_size;
+        }
+        chunk_sizes[i] = (u32)compressed_size;
+        offset += compressed_size;
+    }
+
+    // Already compressed formats (i.e. png) barely shrink, and are not worth the time to decompress.
+    if (offset > source->size - source->size / 8) {
+        kfree(stored, capacity, MEMORY_TAG_FILE);
+        return;
+    }
+    source->stored = stored;
+    source->stored_size = offset;
+    source->stored_capacity = capacity;
+}
+
+static void free_sources(pack_source* sources) {
+    u64 count = darray_length(sources);
+    for (u64 i = 0; i < count; ++i) {
+        kfree(sources[i].path, string_length(sources[i].path) + 1, MEMORY_TAG_STRING);
+        if (sources[i].stored) {
+            kfree(sources[i].stored, sources[i].stored_capacity, MEMORY_TAG_FILE);
+        }
+    }
+    darray_destroy(sources);
+}
+
+static u64 align_up(u64 value, u64 alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Writes zeros up to offset.
+static b8 write_padding(file_writer* writer, u64* written, u64 offset) {
+    static const u8 zeros[ASSET_PACK_ALIGNMENT] = {};
+    while (*written < offset) {
+        u64 size = offset - *written;
+        if (size > ASSET_PACK_ALIGNMENT) {
+            size = ASSET_PACK_ALIGNMENT;
+        }
+        if (!filesystem_writer_write(writer, size, zeros)) {
+            return false;
+        }
+        *written += size;
+    }
+    return true;
+}
+
+i32 pack_builder_run(i32 argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: tools pack <asset directory> <output.kpak> [--no-compress]\n");
+        return 1;
+    }
+    b8 compress = !(argc > 2 && strings_equal(argv[2], "--no-compress"));
+
+    pack_source* sources = darray_create(pack_source);
+    pack_walk walk = {};
+    walk.root = argv[0];
+    walk.sources = &sources;
+    i32 result = walk_directory(&walk) ? 0 : 2;
+    u64 count = darray_length(sources);
+
+    // Paths are written one after another into the string table.
+    u64 string_table_size = 0;
+    for (u64 i = 0; result == 0 && i < count; ++i) {
+        char path[VFS_MAX_PATH_LENGTH * 2];
+        string_format(path, "%s/%s", argv[0], sources[i].path);
+        file_mapping mapping;
+        if (!filesystem_map_readonly(path, FILE_ACCESS_HINT_SEQUENTIAL, &mapping)) {
+            printf("Unable to read '%s'.\n", path);
+            result = 2;
+            break;
+        }
+        sources[i].size = mapping.size;
+        sources[i].stored_size = mapping.size;
+        if (compress && mapping.size > 0) {
+            compress_source(mapping.data, &sources[i]);
+        }
+        filesystem_unmap(&mapping);
+        string_table_size += string_length(sources[i].path) + 1;
+    }
+    if (result == 0 && string_table_size > 0xFFFFFFFF) {
+        printf("Too many paths to pack.\n");
+        result = 3;
+    }
+
+    file_handle output;
+    if (result == 0 && !filesystem_open(argv[1], FILE_MODE_WRITE, true, &output)) {
+        printf("Unable to open '%s' for writing.\n", argv[1]);
+        result = 2;
+    }
+    if (result != 0) {
+        free_sources(sources);
+        return result;
+    }
+
+    qsort(sources, count, sizeof(pack_source), compare_sources);
+
+    file_writer writer;
+    filesystem_writer_create(&output, 65536, 0, &writer);
+    b8 ok = true;
+
+    asset_pack_header header = {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entry_count = (u32)count;
+    header.string_table_size = (u32)string_table_size;
+    ok = ok && filesystem_writer_write(&writer, sizeof(asset_pack_header), &header);
+
+    // The directory, with each entry's data laid out after it on its own pages.
+    u64 data_offset = align_up(sizeof(asset_pack_header) + count * sizeof(asset_pack_entry) + string_table_size, ASSET_PACK_ALIGNMENT);
+    u32 path_offset = 0;
+    for (u64 i = 0; i < count; ++i) {
+        asset_pack_entry entry = {};
+        entry.hash = sources[i].hash;
+        entry.offset = data_offset;
+        entry.size = sources[i].size;
+        entry.stored_size = sources[i].stored_size;
+        entry.path_offset = path_offset;
+        entry.flags = sources[i].stored ? ASSET_PACK_ENTRY_FLAG_LZ4 : ASSET_PACK_ENTRY_FLAG_NONE;
+        ok = ok && filesystem_writer_write(&writer, sizeof(asset_pack_entry), &entry);
+        path_offset += (u32)string_length(sources[i].path) + 1;
+        data_offset = align_up(data_offset + sources[i].stored_size, ASSET_PACK_ALIGNMENT);
+    }
+    for (u64 i = 0; i < count; ++i) {
+        ok = ok && filesystem_writer_write(&writer, string_length(sources[i].path) + 1, sources[i].path);
+    }
+
+    u64 written = sizeof(asset_pack_header) + count * sizeof(asset_pack_entry) + string_table_size;
+    u64 total_size = 0;
+    u32 compressed_count = 0;
+    for (u64 i = 0; ok && i < count; ++i) {
+        ok = write_padding(&writer, &written, align_up(written, ASSET_PACK_ALIGNMENT));
+        total_size += sources[i].size;
+        if (sources[i].stored) {
+            ok = ok && filesystem_writer_write(&writer, sources[i].stored_size, sources[i].stored);
+            written += sources[i].stored_size;
+            compressed_count++;
+            continue;
+        }
+
+        char path[VFS_MAX_PATH_LENGTH * 2];
+        string_format(path, "%s/%s", argv[0], sources[i].path);
+        file_mapping mapping;
+        if (!filesystem_map_readonly(path, FILE_ACCESS_HINT_SEQUENTIAL, &mapping) || mapping.size != sources[i].size) {
+            printf("Unable to read '%s', or it changed while packing.\n", path);
+            filesystem_unmap(&mapping);
+            ok = false;
+            break;
+        }
+        if (mapping.size) {
+            ok = ok && filesystem_writer_write(&writer, mapping.size, mapping.data);
+        }
+        filesystem_unmap(&mapping);
+        written += sources[i].size;
+    }
+
+    filesystem_writer_destroy(&writer);
+    filesystem_close(&output);
+    if (ok) {
+        printf("Packed %llu files (%llu bytes, %u compressed) into '%s' (%llu bytes).\n", count, total_size, compressed_count, argv[1], written);
+    } else {
+        printf("Failed to write '%s'.\n", argv[1]);
+        result = 2;
+    }
+
+    free_sources(sources);
+    return result;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Packs every file under an asset directory into a single pack, to be
+ * read by the virtual filesystem. Paths in the pack are relative to the directory.
+ *
+ * @param argc The number of arguments. Expects <asset directory> <output.kpak>.
+ * @param argv The arguments.
+ * @return 0 on success; otherwise a non-zero error code.
+ */
+i32 pack_builder_run(i32 argc, char** argv);
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "telemetry_viewer.h"
+
+#include <core/telemetry.h>
+#include <core/kstring.h>
+#include <platform/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Time between refreshes, in milliseconds.
+#define TELEMETRY_VIEWER_INTERVAL_MS 1000
+
+static void print_summary(const char* label, const frame_time_summary* summary) {
+    printf("  %-7s min %7.2f  mean %7.2f  p50 %7.2f  p95 %7.2f  p99 %7.2f  max %7.2f ms\n",
+           label,
+           summary->min * 1000.0,
+           summary->mean * 1000.0,
+           summary->p50 * 1000.0,
+           summary->p95 * 1000.0,
+           summary->p99 * 1000.0,
+           summary->max * 1000.0);
+}
+
+static void print_page(const telemetry_page* page, const telemetry_page* previous) {
+    printf("Frame %llu", page->frame_number);
+    if (previous && page->time > previous->time) {
+        f64 fps = (page->frame_number - previous->frame_number) / (page->time - previous->time);
+        printf(" (%.1f fps)", fps);
+    }
+    if (page->pacing_interval > 0) {
+        printf(", paced at %.2f ms", page->pacing_interval * 1000.0);
+    }
+    printf("\n");
+
+    const frame_stats* stats = &page->frame_stats;
+    printf("Frame times over the last %u frames, %u hitches:\n", stats->sample_count, stats->hitch_count);
+    print_summary("update", &stats->update);
+    print_summary("render", &stats->render);
+    print_summary("frame", &stats->frame);
+
+    const renderer_stats* renderer = &page->renderer;
+    printf("Renderer: %llu frames drawn, %llu skipped, %ux%u\n",
+           renderer->frame_number,
+           renderer->skipped_frames,
+           renderer->framebuffer_width,
+           renderer->framebuffer_height);
+
+    printf("Memory: %.2f MiB in %llu allocations\n", page->memory.total_allocated / (1024.0 * 1024.0), page->memory_allocation_count);
+    for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        if (page->memory.tagged_allocations[i]) {
+            printf("  %-20s %12llu B\n", page->memory_tag_names[i], page->memory.tagged_allocations[i]);
+        }
+    }
+
+    if (page->counter_count > 0) {
+        printf("Counters (last frame):\n");
+        for (u32 i = 0; i < page->counter_count && i < TELEMETRY_MAX_COUNTERS; ++i) {
+            printf("  %-24s %12llu\n", page->counters[i].name, page->counters[i].value);
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+i32 telemetry_viewer_run(i32 argc, char** argv) {
+    if (argc < 1) {
+        printf("Usage: tools telemetry <application name> [refresh count]\n");
+        return 1;
+    }
+    // 0 refreshes forever.
+    u32 refresh_count = argc > 1 ? (u32)strtoul(argv[1], 0, 10) : 0;
+
+    char name[256];
+    telemetry_shared_memory_name(argv[0], name);
+    shared_memory memory;
+    if (!platform_shared_memory_open(name, sizeof(telemetry_page), false, &memory)) {
+        printf("No telemetry published under '%s'. Is the application running with publish_telemetry set?\n", name);
+        return 2;
+    }
+
+    const telemetry_page* shared = memory.block;
+    if (shared->magic != TELEMETRY_MAGIC || shared->version != TELEMETRY_VERSION || shared->size != sizeof(telemetry_page)) {
+        printf("Telemetry version %u is not supported (expected %u).\n", shared->version, TELEMETRY_VERSION);
+        platform_shared_memory_close(&memory);
+        return 3;
+    }
+
+    telemetry_page pages[2];
+    telemetry_page* previous = 0;
+    u32 stalled = 0;
+    for (u32 refresh = 0; refresh_count == 0 || refresh < refresh_count; ++refresh) {
+        // Always read into the buffer not holding the last printed page, so a
+        // skipped or stalled read can never overwrite it.
+        telemetry_page* page = previous == &pages[0] ? &pages[1] : &pages[0];
+        if (!telemetry_read(shared, page)) {
+            printf("Telemetry page kept changing while being read; skipped.\n");
+        } else if (previous && page->frame_number == previous->frame_number) {
+            // The page outlives the application while this still has it open.
+            if (++stalled == 5) {
+                printf("No new frames for %u seconds. Has the application exited?\n", stalled * TELEMETRY_VIEWER_INTERVAL_MS / 1000);
+                break;
+            }
+        } else {
+            stalled = 0;
+            print_page(page, previous);
+            previous = page;
+        }
+        platform_sleep(TELEMETRY_VIEWER_INTERVAL_MS);
+    }
+
+    platform_shared_memory_close(&memory);
+    return 0;
+}
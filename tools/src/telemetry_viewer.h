@@ -0,0 +1,13 @@
+#pragma once
+
+#include <defines.h>
+
+/**
+ * @brief Prints the live telemetry an application publishes to shared memory,
+ * refreshing once a second.
+ *
+ * @param argc The number of arguments. Expects <application name> [refresh count].
+ * @param argv The arguments.
+ * @return 0 on success; otherwise a non-zero error code.
+ */
+i32 telemetry_viewer_run(i32 argc, char** argv);